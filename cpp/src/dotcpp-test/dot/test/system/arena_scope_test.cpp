@@ -0,0 +1,149 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/test/implement.hpp>
+#include <approvals/ApprovalTests.hpp>
+#include <approvals/Catch.hpp>
+#include <dot/system/arena_scope.hpp>
+#include <dot/system/object.hpp>
+#include <dot/system/string.hpp>
+#include <dot/system/collections/generic/list.hpp>
+#include <thread>
+
+namespace dot
+{
+    TEST_CASE("Smoke")
+    {
+        REQUIRE(arena_scope::current() == nullptr);
+        {
+            arena_scope scope;
+            REQUIRE(arena_scope::current() == &scope);
+
+            object value = make_object();
+            string str = make_string("abc");
+            list<object> items = make_list<object>();
+            items->add(value);
+            items->add(str);
+            REQUIRE(scope.live_count() == 3);
+            REQUIRE(scope.reserved_bytes() > 0);
+
+            REQUIRE(object::ReferenceEquals(items[0], value));
+            REQUIRE(string(items[1]) == "abc");
+
+            items = nullptr;
+            REQUIRE(scope.live_count() == 2);
+        }
+        REQUIRE(arena_scope::current() == nullptr);
+    }
+
+    TEST_CASE("Nested")
+    {
+        arena_scope outer;
+        object outer_value = make_object();
+        {
+            arena_scope inner;
+            REQUIRE(arena_scope::current() == &inner);
+
+            object inner_value = make_object();
+            REQUIRE(inner.live_count() == 1);
+            REQUIRE(outer.live_count() == 1);
+        }
+        REQUIRE(arena_scope::current() == &outer);
+        REQUIRE(outer.live_count() == 1);
+    }
+
+    TEST_CASE("Escape")
+    {
+        object escaped;
+        {
+            arena_scope scope;
+            for (int i = 0; i < 10000; ++i)
+            {
+                object value = make_string("temporary");
+            }
+            REQUIRE(scope.live_count() == 0);
+
+            escaped = make_string("escaped");
+            REQUIRE(scope.live_count() == 1);
+        }
+
+        // Chunk holding the escaped object is kept until the object is deleted
+        REQUIRE(escaped->to_string() == "escaped");
+
+        // Escaped object can be released by another thread
+        std::thread([&escaped]() { escaped = nullptr; }).join();
+        REQUIRE(escaped == nullptr);
+    }
+
+    /// Build and discard a list of boxed values and strings,
+    /// similar to the work done for a single request.
+    void arena_scope_benchmark_request(int count)
+    {
+        list<object> items = make_list<object>();
+        for (int i = 0; i < count; ++i)
+        {
+            items->add(double(i));
+            items->add(make_string("abc"));
+        }
+    }
+
+    TEST_CASE("Benchmark", "[.benchmark]")
+    {
+        const int requests = 100;
+        const int count = 10000;
+
+        BENCHMARK("Requests (no scope)")
+        {
+            for (int i = 0; i < requests; ++i)
+            {
+                arena_scope_benchmark_request(count);
+            }
+        }
+
+        BENCHMARK("Requests (arena)")
+        {
+            for (int i = 0; i < requests; ++i)
+            {
+                arena_scope scope;
+                arena_scope_benchmark_request(count);
+            }
+        }
+
+        BENCHMARK("Allocation (no scope)")
+        {
+            for (int i = 0; i < requests * count; ++i)
+            {
+                object value = make_object();
+            }
+        }
+
+        BENCHMARK("Allocation (arena)")
+        {
+            arena_scope scope;
+            for (int i = 0; i < requests * count; ++i)
+            {
+                object value = make_object();
+            }
+        }
+    }
+}
@@ -0,0 +1,254 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/test/implement.hpp>
+#include <approvals/ApprovalTests.hpp>
+#include <approvals/Catch.hpp>
+#include <dot/system/atomic_ptr.hpp>
+#include <dot/system/string.hpp>
+#include <dot/system/collections/generic/list.hpp>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dot
+{
+    /// Number of atomic_ptr_sample objects not yet deleted.
+    static std::atomic<int> atomic_ptr_sample_live = 0;
+
+    class atomic_ptr_sample_impl; using atomic_ptr_sample = ptr<atomic_ptr_sample_impl>;
+
+    /// Immutable snapshot published by a writer thread.
+    class atomic_ptr_sample_impl : public virtual object_impl
+    {
+    public: // FIELDS
+
+        int version;
+        list<int> values;
+
+    public: // CONSTRUCTORS
+
+        atomic_ptr_sample_impl(int v) : version(v), values(make_list<int>())
+        {
+            for (int i = 0; i < 16; ++i) values->add(v);
+            ++atomic_ptr_sample_live;
+        }
+
+    public: // DESTRUCTOR
+
+        ~atomic_ptr_sample_impl() { --atomic_ptr_sample_live; }
+    };
+
+    atomic_ptr_sample make_atomic_ptr_sample(int version) { return new atomic_ptr_sample_impl(version); }
+
+    TEST_CASE("AtomicPtr")
+    {
+        {
+            atomic_ptr<atomic_ptr_sample_impl> slot;
+            REQUIRE(slot.load() == nullptr);
+            REQUIRE(slot.is_lock_free());
+
+            atomic_ptr_sample first = make_atomic_ptr_sample(1);
+            slot.store(first);
+            REQUIRE(first->reference_count() == 2);
+            REQUIRE(slot.load() == first);
+            REQUIRE(first->reference_count() == 2);
+
+            atomic_ptr_sample second = make_atomic_ptr_sample(2);
+            atomic_ptr_sample previous = slot.exchange(second);
+            REQUIRE(previous == first);
+            REQUIRE(first->reference_count() == 2);
+            previous = nullptr;
+            REQUIRE(first->reference_count() == 1);
+
+            // Compare exchange fails and loads the current value
+            atomic_ptr_sample expected = first;
+            REQUIRE(!slot.compare_exchange(expected, first));
+            REQUIRE(expected == second);
+            REQUIRE(first->reference_count() == 1);
+
+            REQUIRE(slot.compare_exchange(expected, first));
+            REQUIRE(slot.load() == first);
+            REQUIRE(second->reference_count() == 2);
+
+            expected = nullptr;
+            second = nullptr;
+            first = nullptr;
+            REQUIRE(atomic_ptr_sample_live == 1);
+
+            atomic_ptr_sample current = slot;
+            REQUIRE(current->version == 1);
+            slot = nullptr;
+            REQUIRE(current->reference_count() == 1);
+        }
+        REQUIRE(atomic_ptr_sample_live == 0);
+
+        // Released by the destructor of the slot
+        {
+            atomic_ptr<atomic_ptr_sample_impl> slot = make_atomic_ptr_sample(3);
+            REQUIRE(atomic_ptr_sample_live == 1);
+        }
+        REQUIRE(atomic_ptr_sample_live == 0);
+    }
+
+    TEST_CASE("AtomicObject")
+    {
+        atomic_object slot(42);
+        REQUIRE(int(slot.load()) == 42);
+
+        object previous = slot.exchange(make_string("abc"));
+        REQUIRE(int(previous) == 42);
+        REQUIRE(slot.load()->to_string() == "abc");
+
+        object expected = previous;
+        REQUIRE(!slot.compare_exchange(expected, object(1)));
+        REQUIRE(expected->to_string() == "abc");
+        REQUIRE(slot.compare_exchange(expected, object(1)));
+        REQUIRE(int(object(slot)) == 1);
+
+        // Inline values whose payload uses the high bits of the word
+        slot.store(object(-1));
+        REQUIRE(int(slot.load()) == -1);
+        slot.store(object(1.5));
+        REQUIRE(double(slot.load()) == 1.5);
+        slot.store(object(int64_t(-5000000000)));
+        REQUIRE(int64_t(slot.load()) == -5000000000);
+
+        atomic_object negative(-42);
+        REQUIRE(int(negative.exchange(object(-0.25))) == -42);
+        object loaded = negative.load();
+        REQUIRE(double(loaded) == -0.25);
+        REQUIRE(negative.compare_exchange(loaded, object(int64_t(1) << 60)));
+        REQUIRE(int64_t(negative.load()) == int64_t(1) << 60);
+    }
+
+    TEST_CASE("AtomicPtrConcurrent")
+    {
+        const int reader_count = 4;
+        const int version_count = 20000;
+        {
+            atomic_ptr<atomic_ptr_sample_impl> slot = make_atomic_ptr_sample(0);
+            std::atomic<bool> done = false;
+            std::atomic<int> errors = 0;
+
+            std::vector<std::thread> readers;
+            for (int i = 0; i < reader_count; ++i)
+            {
+                readers.emplace_back([&slot, &done, &errors]()
+                {
+                    int last = 0;
+                    while (!done.load())
+                    {
+                        atomic_ptr_sample snapshot = slot.load();
+
+                        // Each snapshot is complete and versions never go back
+                        if (snapshot->version < last || snapshot->values[15] != snapshot->version) ++errors;
+                        last = snapshot->version;
+                    }
+                });
+            }
+
+            // Writer replaces the snapshot, alternating store and compare exchange
+            for (int version = 1; version <= version_count; ++version)
+            {
+                if (version % 2)
+                {
+                    slot.store(make_atomic_ptr_sample(version));
+                }
+                else
+                {
+                    atomic_ptr_sample expected = slot.load();
+                    REQUIRE(slot.compare_exchange(expected, make_atomic_ptr_sample(version)));
+                }
+            }
+
+            done = true;
+            for (std::thread& reader : readers) reader.join();
+            REQUIRE(errors == 0);
+            REQUIRE(slot.load()->version == version_count);
+
+            // Objects last released by the readers are deleted when merged by this thread
+            reference_counter::merge_queued_reference_counts();
+            REQUIRE(atomic_ptr_sample_live == 1);
+        }
+        REQUIRE(atomic_ptr_sample_live == 0);
+    }
+
+    TEST_CASE("AtomicPtrBenchmark", "[.benchmark]")
+    {
+        const int reader_count = 8;
+        const int count = 1000000;
+
+        // Readers load the snapshot while a writer replaces it
+        auto run = [&](auto&& read, auto&& write)
+        {
+            std::atomic<bool> done = false;
+            std::thread writer([&]()
+            {
+                for (int version = 1; !done.load(); ++version) write(version);
+            });
+
+            std::vector<std::thread> readers;
+            for (int i = 0; i < reader_count; ++i)
+            {
+                readers.emplace_back([&]()
+                {
+                    for (int j = 0; j < count; ++j) read();
+                });
+            }
+            for (std::thread& reader : readers) reader.join();
+            done = true;
+            writer.join();
+        };
+
+        BENCHMARK("Readers (mutex)")
+        {
+            std::mutex mutex;
+            atomic_ptr_sample current = make_atomic_ptr_sample(0);
+            run([&]()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                atomic_ptr_sample snapshot = current;
+            },
+            [&](int version)
+            {
+                atomic_ptr_sample snapshot = make_atomic_ptr_sample(version);
+                std::lock_guard<std::mutex> lock(mutex);
+                current = snapshot;
+            });
+        }
+
+        BENCHMARK("Readers (atomic_ptr)")
+        {
+            atomic_ptr<atomic_ptr_sample_impl> current = make_atomic_ptr_sample(0);
+            run([&]()
+            {
+                atomic_ptr_sample snapshot = current.load();
+            },
+            [&](int version)
+            {
+                current.store(make_atomic_ptr_sample(version));
+            });
+        }
+    }
+}
@@ -32,6 +32,8 @@ limitations under the License.
 #include <dot/noda_time/local_date.hpp>
 #include <dot/noda_time/local_date_time.hpp>
 #include <dot/system/type.hpp>
+#include <dot/system/object_pool.hpp>
+#include <limits>
 
 namespace dot
 {
@@ -165,4 +167,202 @@ namespace dot
             REQUIRE((local_date_time) boxed == date2);
         }
     }
+
+    TEST_CASE("Inline")
+    {
+        object_pool::reset_stats();
+
+        {
+            // Values that fit into the pointer are stored inline
+            object boxed = 1;
+            REQUIRE(boxed.is_inline());
+            REQUIRE((int)boxed == 1);
+            boxed = std::numeric_limits<int>::min();
+            REQUIRE((int)boxed == std::numeric_limits<int>::min());
+            boxed = true;
+            REQUIRE(boxed.is_inline());
+            REQUIRE((bool)boxed == true);
+            boxed = 'x';
+            REQUIRE(boxed.is_inline());
+            REQUIRE((char)boxed == 'x');
+            boxed = (int64_t)-123456789012345;
+            REQUIRE(boxed.is_inline());
+            REQUIRE((int64_t)boxed == -123456789012345);
+            boxed = -2.5;
+            REQUIRE(boxed.is_inline());
+            REQUIRE((double)boxed == -2.5);
+            boxed = 0.0;
+            REQUIRE(boxed.is_inline());
+            REQUIRE((double)boxed == 0.0);
+        }
+
+        // Inline values do not allocate memory
+        REQUIRE(object_pool::get_stats().allocation_count == 0);
+
+        {
+            // Values that do not fit into the pointer are stored on the heap
+            object boxed = std::numeric_limits<int64_t>::max();
+            REQUIRE(!boxed.is_inline());
+            REQUIRE((int64_t)boxed == std::numeric_limits<int64_t>::max());
+            boxed = std::numeric_limits<int64_t>::min();
+            REQUIRE((int64_t)boxed == std::numeric_limits<int64_t>::min());
+            boxed = 1e300;
+            REQUIRE(!boxed.is_inline());
+            REQUIRE((double)boxed == 1e300);
+            boxed = std::numeric_limits<double>::denorm_min();
+            REQUIRE(!boxed.is_inline());
+            REQUIRE((double)boxed == std::numeric_limits<double>::denorm_min());
+            boxed = std::numeric_limits<double>::quiet_NaN();
+            REQUIRE(!boxed.is_inline());
+            REQUIRE(std::isnan((double)boxed));
+            boxed = local_date(2005, 1, 1);
+            REQUIRE(!boxed.is_inline());
+            REQUIRE((local_date)boxed == local_date(2005, 1, 1));
+        }
+
+        {
+            // Methods of the boxed type are available for inline values
+            object boxed = 42;
+            REQUIRE(boxed->to_string() == "42");
+            REQUIRE(boxed->get_type() == typeof<int>());
+            REQUIRE(boxed->equals(42));
+            REQUIRE(!boxed->equals((int64_t)42));
+            REQUIRE(boxed->hash_code() == object(42)->hash_code());
+            REQUIRE(object(new int_impl(42))->equals(boxed));
+
+            // Type checks and casts
+            REQUIRE(boxed.is<ptr<int_impl>>());
+            REQUIRE(!boxed.is<ptr<double_impl>>());
+            REQUIRE(boxed.as<ptr<double_impl>>() == nullptr);
+            REQUIRE(boxed.as<ptr<int_impl>>()->to_string() == "42");
+            REQUIRE(ptr<int_impl>(boxed)->to_string() == "42");
+            CHECK_THROWS(ptr<double_impl>(boxed));
+            CHECK_THROWS((double)boxed);
+            CHECK_THROWS((string)boxed);
+        }
+
+        {
+            // The first dereference replaces the inline value by a heap object, which later dereferences reuse
+            object boxed = 42;
+            object copy = boxed;
+            object_pool::reset_stats();
+            object_impl& value = *boxed;
+            REQUIRE(!boxed.is_inline());
+            REQUIRE(&value == &(*boxed));
+            REQUIRE(boxed.operator->() == &value);
+            REQUIRE(boxed->hash_code() == std::hash<int>()(42));
+            REQUIRE(object_pool::get_stats().allocation_count == 1);
+            REQUIRE(boxed->to_string() == "42");
+            REQUIRE(value.reference_count() == 1);
+            REQUIRE((int)boxed == 42);
+
+            // Copies made before the dereference keep the inline value
+            REQUIRE(copy.is_inline());
+            REQUIRE(copy->equals(boxed));
+            REQUIRE(boxed->equals(copy));
+        }
+
+        {
+            // Separately boxed values are different instances, as in C#
+            REQUIRE(!object::ReferenceEquals(object(5), object(5)));
+            REQUIRE(!object::ReferenceEquals(object(new int_impl(5)), object(new int_impl(5))));
+            object boxed = new int_impl(5);
+            REQUIRE(object::ReferenceEquals(boxed, boxed));
+
+            // Boxed dates are compared by reference
+            object date = local_date(2005, 1, 1);
+            REQUIRE(date->equals(date));
+            REQUIRE(!date->equals(object(local_date(2005, 1, 1))));
+        }
+    }
+
+    TEST_CASE("InlineHash")
+    {
+        std::hash<object> hash;
+        std::equal_to<object> equal;
+
+        // Hash codes are the same as for the heap objects holding the values
+        object heap_int = new int_impl(-7);
+        object heap_long = new long_impl(5);
+        object heap_double = new double_impl(-0.0);
+        object heap_string = make_string("1");
+        object values[] = { true, 'x', -7, int64_t(5), 2.5, 0.0 };
+
+        object_pool::reset_stats();
+
+        REQUIRE(hash(object(-7)) == std::hash<int>()(-7));
+        REQUIRE(hash(object(-7)) == hash(heap_int));
+        REQUIRE(hash(object(int64_t(5))) == hash(heap_long));
+        REQUIRE(hash(object(0.0)) == hash(heap_double));
+        REQUIRE(hash(object(true)) == std::hash<bool>()(true));
+        REQUIRE(hash(object('x')) == std::hash<char>()('x'));
+
+        // Inline values are equal to the same value of the same type
+        for (object& value : values) REQUIRE(equal(value, value));
+        REQUIRE(equal(object(-7), object(-7)));
+        REQUIRE(!equal(object(-7), object(7)));
+        REQUIRE(!equal(object(5), object(int64_t(5))));
+        REQUIRE(equal(object(0.0), object(-0.0)));
+
+        // Inline values compared to heap objects in both directions
+        REQUIRE(equal(object(-7), heap_int));
+        REQUIRE(equal(heap_int, object(-7)));
+        REQUIRE(equal(object(int64_t(5)), heap_long));
+        REQUIRE(!equal(object(5), heap_long));
+        REQUIRE(equal(object(0.0), heap_double));
+        REQUIRE(!equal(object(1), heap_string));
+        REQUIRE(!equal(object(1), object()));
+
+        // No heap copies of inline values are created
+        REQUIRE(object_pool::get_stats().allocation_count == 0);
+    }
+
+    TEST_CASE("InlineBenchmark", "[.benchmark]")
+    {
+        const int count = 10000000;
+
+        BENCHMARK("Boxing int (inline)")
+        {
+            int64_t sum = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                object boxed = i;
+                sum += (int)boxed;
+            }
+            REQUIRE(sum > 0);
+        }
+
+        BENCHMARK("Boxing int (heap)")
+        {
+            int64_t sum = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                object boxed = new int_impl(i);
+                sum += (int)boxed;
+            }
+            REQUIRE(sum > 0);
+        }
+
+        BENCHMARK("Boxing double (inline)")
+        {
+            double sum = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                object boxed = i + 0.5;
+                sum += (double)boxed;
+            }
+            REQUIRE(sum > 0);
+        }
+
+        BENCHMARK("Boxing double (heap)")
+        {
+            double sum = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                object boxed = new double_impl(i + 0.5);
+                sum += (double)boxed;
+            }
+            REQUIRE(sum > 0);
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,163 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/test/implement.hpp>
+#include <approvals/ApprovalTests.hpp>
+#include <approvals/Catch.hpp>
+#include <dot/system/char.hpp>
+#include <dot/system/string.hpp>
+#include <dot/system/exception.hpp>
+
+namespace dot
+{
+    TEST_CASE("Properties")
+    {
+        REQUIRE(sizeof(Char) == 2);
+        REQUIRE(Char('A') == u'A');
+        REQUIRE(Char('\xe9') == u'é');
+        REQUIRE(Char() == 0);
+
+        // ASCII
+        REQUIRE(Char::is_digit('7'));
+        REQUIRE(!Char::is_digit('x'));
+        REQUIRE(Char::is_letter('x'));
+        REQUIRE(Char::is_letter('Q'));
+        REQUIRE(!Char::is_letter('@'));
+        REQUIRE(!Char::is_letter('['));
+        REQUIRE(Char::is_letter_or_digit('0'));
+        REQUIRE(Char::is_white_space(' '));
+        REQUIRE(Char::is_white_space('\t'));
+        REQUIRE(Char::is_white_space('\r'));
+        REQUIRE(!Char::is_white_space('\x0e'));
+        REQUIRE(Char::is_punctuation('!'));
+        REQUIRE(!Char::is_punctuation('+'));
+        REQUIRE(Char::is_upper('Z'));
+        REQUIRE(Char::is_lower('z'));
+        REQUIRE(Char::to_upper('a') == u'A');
+        REQUIRE(Char::to_upper('1') == u'1');
+        REQUIRE(Char::to_lower('Z') == u'z');
+
+        // Other scripts
+        REQUIRE(Char::is_digit(u'٣'));
+        REQUIRE(Char::is_letter(u'é'));
+        REQUIRE(Char::is_letter(u'中'));
+        REQUIRE(!Char::is_letter(u'×'));
+        REQUIRE(Char::is_white_space(u' '));
+        REQUIRE(Char::is_white_space(u'　'));
+        REQUIRE(Char::is_upper(u'Ж'));
+        REQUIRE(Char::to_upper(u'é') == u'É');
+        REQUIRE(Char::to_upper(u'ÿ') == u'Ÿ');
+        REQUIRE(Char::to_upper(u'ß') == u'ß');
+        REQUIRE(Char::to_upper(u'ω') == u'Ω');
+        REQUIRE(Char::to_lower(u'Ж') == u'ж');
+        REQUIRE(Char::to_upper(u'ǅ') == u'Ǆ');
+        REQUIRE(Char::to_lower(u'ǅ') == u'ǆ');
+
+        // Simple mappings of letters whose full mapping has more than one code unit
+        REQUIRE(Char::to_upper(u'\x1f80') == u'\x1f88');
+        REQUIRE(Char::to_upper(u'\x1f97') == u'\x1f9f');
+        REQUIRE(Char::to_upper(u'\x1fa7') == u'\x1faf');
+        REQUIRE(Char::to_upper(u'\x1fb3') == u'\x1fbc');
+        REQUIRE(Char::to_upper(u'\x1fc3') == u'\x1fcc');
+        REQUIRE(Char::to_upper(u'\x1ff3') == u'\x1ffc');
+        REQUIRE(Char::to_lower(u'\x1f88') == u'\x1f80');
+        REQUIRE(Char::to_upper(u'\x1f88') == u'\x1f88');
+        REQUIRE(Char::to_lower(u'\x0130') == u'i');
+
+        // Surrogates
+        Char high = u'\xd83d';
+        Char low = u'\xde00';
+        REQUIRE(Char::is_surrogate(high));
+        REQUIRE(Char::is_high_surrogate(high));
+        REQUIRE(Char::is_low_surrogate(low));
+        REQUIRE(Char::is_surrogate_pair(high, low));
+        REQUIRE(Char::convert_to_utf32(high, low) == 0x1f600);
+        REQUIRE(!Char::is_letter(high));
+
+        REQUIRE(Char('a').to_string() == "a");
+        REQUIRE(Char(u'é').to_string() == "\xc3\xa9");
+        REQUIRE(high.to_string() == "\xef\xbf\xbd");
+    }
+
+    TEST_CASE("StringIndexing")
+    {
+        string ascii = make_string("a1 b");
+        REQUIRE(ascii->is_ascii());
+        REQUIRE(ascii->utf16_length() == 4);
+        REQUIRE(ascii[0] == u'a');
+        REQUIRE(Char::is_digit(ascii[1]));
+        REQUIRE(Char::is_white_space(ascii[2]));
+        REQUIRE_THROWS(ascii[4]);
+
+        // e with acute accent, CJK character and a character outside the BMP
+        string text = make_string("\xc3\xa9\xe4\xb8\xad\xf0\x9f\x98\x80z");
+        REQUIRE(!text->is_ascii());
+        REQUIRE(text->length() == 10);
+        REQUIRE(text->utf16_length() == 5);
+        REQUIRE(text[0] == u'é');
+        REQUIRE(text[1] == u'中');
+        REQUIRE(text[2] == u'\xd83d');
+        REQUIRE(text[3] == u'\xde00');
+        REQUIRE(text[4] == u'z');
+        REQUIRE_THROWS(text[5]);
+        REQUIRE_THROWS(text[-1]);
+
+        std::u16string units;
+        for (Char c : text->utf16()) units.push_back(c);
+        REQUIRE(units == u"é中\xd83d\xde00z");
+
+        // Invalid sequences decode as replacement characters
+        std::u16string invalid;
+        for (Char c : make_string("a\xff\xc3")->utf16()) invalid.push_back(c);
+        REQUIRE(invalid == u"a\xfffd\xfffd");
+    }
+
+    TEST_CASE("CharBenchmark", "[.benchmark]")
+    {
+        std::string line;
+        while (line.size() < 100000) line += "trade=12345 book=EQ-LDN price=101.25; ";
+        string s = make_string(line);
+
+        BENCHMARK("std::string digits")
+        {
+            int count = 0;
+            for (size_t i = 0; i < line.size(); ++i) if (std::isdigit(static_cast<unsigned char>(line[i]))) ++count;
+            REQUIRE(count > 0);
+        }
+
+        BENCHMARK("string operator[] digits")
+        {
+            int count = 0;
+            int length = static_cast<int>(s->length());
+            for (int i = 0; i < length; ++i) if (Char::is_digit(s[i])) ++count;
+            REQUIRE(count > 0);
+        }
+
+        BENCHMARK("string utf16() digits")
+        {
+            int count = 0;
+            for (Char c : s->utf16()) if (Char::is_digit(c)) ++count;
+            REQUIRE(count > 0);
+        }
+    }
+}
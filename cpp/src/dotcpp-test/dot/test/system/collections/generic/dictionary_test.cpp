@@ -26,7 +26,10 @@ limitations under the License.
 #include <approvals/Catch.hpp>
 #include <dot/system/string.hpp>
 #include <dot/system/collections/generic/dictionary.hpp>
+#include <dot/system/collections/generic/hash_set.hpp>
 #include <dot/system/type.hpp>
+#include <random>
+#include <unordered_map>
 
 namespace dot
 {
@@ -41,6 +44,20 @@ namespace dot
         return dict;
     }
 
+    /// Value whose copy constructor throws if the source is marked.
+    struct dictionary_test_throwing_value
+    {
+        bool throws = false;
+
+        dictionary_test_throwing_value() = default;
+        dictionary_test_throwing_value(const dictionary_test_throwing_value& other)
+        {
+            if (other.throws) throw exception("Copy of a marked value.");
+        }
+
+        bool operator==(const dictionary_test_throwing_value& other) const { return throws == other.throws; }
+    };
+
     TEST_CASE("Properties")
     {
         dictionary<string, string> dict = Createdictionary();
@@ -48,18 +65,30 @@ namespace dot
         REQUIRE(dict->count() == 3);
 
         // Keys
-        list<string> keys = dict->keys();
-        REQUIRE(keys->count() == 3);
-        //REQUIRE(keys->contains("a"));  // TODO uncomment when implemented
-        //REQUIRE(keys->contains("c"));
-        //REQUIRE(keys->contains(""));
+        auto keys = dict->keys();
+        REQUIRE(keys.count() == 3);
+        REQUIRE(keys.contains("a"));
+        REQUIRE(keys.contains("c"));
+        REQUIRE(keys.contains(""));
+        REQUIRE(keys.contains("b") == false);
 
         // Values
-        list<string> values = dict->values();
-        REQUIRE(values->count() == 3);
-        //REQUIRE(values->contains("b"));  // TODO uncomment when implemented
-        //REQUIRE(values->contains("d"));
-        //REQUIRE(values->contains(""));
+        auto values = dict->values();
+        REQUIRE(values.count() == 3);
+        REQUIRE(values.contains("b"));
+        REQUIRE(values.contains("d"));
+        REQUIRE(values.contains(""));
+        REQUIRE(values.contains("a") == false);
+
+        // Views reflect subsequent changes and support queries
+        dict->add("e", "f");
+        REQUIRE(keys.count() == 4);
+        REQUIRE(keys.contains("e"));
+        REQUIRE(keys.where([](const string& x) { return x->length() > 0; }).count() == 3);
+        list<string> sorted = values.order_by([](const string& x) { return x; }).to_list();
+        REQUIRE(string::join(",", sorted) == ",b,d,f");
+        REQUIRE(keys.to_list()->count() == 4);
+        REQUIRE(std::distance(values.begin(), values.end()) == 4);
     }
 
     TEST_CASE("Methods")
@@ -110,6 +139,163 @@ namespace dot
         REQUIRE(dict["e"] == "f");
     }
 
+    TEST_CASE("FlatHashTable")
+    {
+        // Random insertions and removals compared to std::unordered_map,
+        // including reuse of deleted slots and rehashing without growth
+        std::minstd_rand random(7);
+        dictionary<int, int> dict = make_dictionary<int, int>();
+        std::unordered_map<int, int> expected;
+        for (int i = 0; i < 100000; ++i)
+        {
+            int key = int(random() % 5000) * 1024;
+            if (random() % 3 == 0)
+            {
+                REQUIRE(dict->remove(key) == (expected.erase(key) != 0));
+            }
+            else
+            {
+                dict[key] = i;
+                expected[key] = i;
+            }
+        }
+        REQUIRE(dict->count() == static_cast<int>(expected.size()));
+        for (auto& x : *dict) REQUIRE(expected.at(x.first) == x.second);
+        for (auto& x : expected)
+        {
+            int value = -1;
+            REQUIRE(dict->try_get_value(x.first, value));
+            REQUIRE(value == x.second);
+        }
+
+        // Erase during iteration
+        for (auto iter = dict->begin(); iter != dict->end();)
+        {
+            if (iter->first % 2048 == 0) iter = dict->erase(iter);
+            else ++iter;
+        }
+        for (auto& x : *dict) REQUIRE(x.first % 2048 != 0);
+
+        dict->trim_excess();
+        REQUIRE(dict->ensure_capacity(100000) >= 100000);
+        CHECK_THROWS(dict->ensure_capacity(-1));
+        CHECK_THROWS(dict->reserve(std::numeric_limits<size_t>::max()));
+        dict->clear();
+        REQUIRE(dict->count() == 0);
+        REQUIRE(dict->begin() == dict->end());
+        dict->trim_excess();
+        REQUIRE(dict->contains_key(0) == false);
+
+        // Keys with reference counts are moved when the table grows
+        string key = make_string("a key held by the dictionary and the test");
+        dictionary<string, int> strings = make_dictionary<string, int>();
+        strings->add(key, 0);
+        for (int i = 1; i < 1000; ++i) strings->add(to_string(i), i);
+        REQUIRE(key->reference_count() == 2);
+        REQUIRE(strings[key] == 0);
+        REQUIRE(strings["999"] == 999);
+
+        hash_set<string> set = make_hash_set<string>();
+        for (int i = 0; i < 1000; ++i) set->add(to_string(i % 100));
+        REQUIRE(set->count() == 100);
+        REQUIRE(set->contains("99"));
+        REQUIRE(set->remove("99"));
+        REQUIRE(set->contains("99") == false);
+        set->add("99");
+        REQUIRE(set->count() == 100);
+
+        // Elements of the set are keys and cannot be modified through the iterator
+        static_assert(std::is_same<hash_set_impl<string>::iterator, hash_set_impl<string>::const_iterator>::value);
+        static_assert(std::is_same<decltype(*set->begin()), const string&>::value);
+        static_assert(std::is_same<decltype(*dict->begin()), std::pair<const int, int>&>::value);
+        hash_set_impl<string>::const_iterator first = set->begin();
+        first = set->end();
+        REQUIRE(first == set->end());
+
+        // Copy of an element inserted when the table is full, so that the
+        // copy is made after the table grows past the element
+        dictionary<int, string> copies = make_dictionary<int, string>();
+        copies->add(0, make_string("first value"));
+        for (int i = 1; i < 1000; ++i)
+        {
+            size_t max_load = copies->max_load();
+            copies->add(i, copies[0]);
+            if (copies->max_load() != max_load) REQUIRE(copies[i] == "first value");
+        }
+        REQUIRE(copies->count() == 1000);
+        for (auto& x : *copies) REQUIRE(x.second == "first value");
+
+        // Table is unchanged if the constructor of the element throws,
+        // with and without growing
+        dictionary<int, dictionary_test_throwing_value> throwing = make_dictionary<int, dictionary_test_throwing_value>();
+        dictionary_test_throwing_value marked;
+        marked.throws = true;
+        throwing->ensure_capacity(100);
+        size_t full_load = throwing->max_load();
+        while (throwing->count() < static_cast<int>(full_load) - 1) throwing[throwing->count()];
+        CHECK_THROWS(throwing->add(-1, marked));
+        throwing[throwing->count()];
+        REQUIRE(throwing->max_load() == full_load);
+        CHECK_THROWS(throwing->add(-1, marked));
+        REQUIRE(throwing->max_load() == full_load);
+        REQUIRE(throwing->count() == static_cast<int>(full_load));
+        REQUIRE(!throwing->contains_key(-1));
+    }
+
+    TEST_CASE("DictionaryBenchmark", "[.benchmark]")
+    {
+        const int count = 1000000;
+        std::vector<string> keys;
+        std::vector<string> probes;
+        for (int i = 0; i < count; ++i) keys.push_back(make_string("Symbol." + std::to_string(i)));
+        for (int i = 0; i < count; ++i) probes.push_back(keys[(int64_t(i) * 7919) % count]);
+
+        std::unordered_map<string, double> std_map;
+        dictionary<string, double> dict = make_dictionary<string, double>();
+        for (int i = 0; i < count; ++i)
+        {
+            std_map[keys[i]] = i;
+            dict[keys[i]] = i;
+        }
+
+        BENCHMARK("std::unordered_map insert")
+        {
+            std::unordered_map<string, double> map;
+            for (int i = 0; i < count; ++i) map[keys[i]] = i;
+            REQUIRE(map.size() == count);
+        }
+
+        BENCHMARK("dictionary insert")
+        {
+            dictionary<string, double> map = make_dictionary<string, double>();
+            for (int i = 0; i < count; ++i) map[keys[i]] = i;
+            REQUIRE(map->count() == count);
+        }
+
+        BENCHMARK("std::unordered_map find")
+        {
+            double sum = 0;
+            for (int i = 0; i < count; ++i) sum += std_map.find(probes[i])->second;
+            REQUIRE(sum > 0);
+        }
+
+        BENCHMARK("dictionary try_get_value")
+        {
+            double sum = 0;
+            double value = 0;
+            for (int i = 0; i < count; ++i)
+                if (dict->try_get_value(probes[i], value)) sum += value;
+            REQUIRE(sum > 0);
+        }
+
+        BENCHMARK("dictionary values() sum")
+        {
+            double sum = 0;
+            for (double x : dict->values()) sum += x;
+            REQUIRE(sum > 0);
+        }
+    }
+
     TEST_CASE("object key")
     {
         object obj0 = make_object();
@@ -27,6 +27,12 @@ limitations under the License.
 #include <dot/system/collections/generic/list.hpp>
 #include <dot/system/string.hpp>
 #include <dot/system/type.hpp>
+#include <dot/system/exception.hpp>
+#include <dot/noda_time/local_date.hpp>
+#include <dot/detail/work_stealing_pool.hpp>
+#include <cmath>
+#include <numeric>
+#include <random>
 
 namespace dot
 {
@@ -44,6 +50,30 @@ namespace dot
         received << " ]" << std::endl;
     }
 
+    class sort_sample_impl; using sort_sample = ptr<sort_sample_impl>;
+
+    /// Sample class with fields used as keys by sort(...) and order_by(...).
+    class sort_sample_impl : public virtual object_impl
+    {
+    public:
+
+        string name;
+        double value;
+        int index;
+
+        sort_sample_impl(string name, double value, int index) : name(name), value(value), index(index) {}
+    };
+
+    /// List of samples with random names from a small set and random values.
+    static list<sort_sample> make_sort_samples(int count)
+    {
+        std::minstd_rand random(count);
+        list<sort_sample> result = make_list<sort_sample>();
+        for (int i = 0; i < count; ++i)
+            result->add(new sort_sample_impl(to_string(int(random() % 100)), double(random() % 1000) / 8 - 50, i));
+        return result;
+    }
+
     TEST_CASE("Smoke")
     {
         list<double> a = make_list<double>();
@@ -117,4 +147,244 @@ namespace dot
         // TODO string_list.findLast([](std::string const& s) { return s == "222"; }) = "57";
         // TODO REQUIRE(string_list.findLastIndex([](std::string const& s) { return s == "111"; }) == 0);
     }
+
+    TEST_CASE("Span")
+    {
+        list<double> a = make_list<double>({ 0.0, 1.0, 2.0, 3.0 });
+
+        span<double> s = a->as_span();
+        REQUIRE(s.length() == 4);
+        REQUIRE(s.is_empty() == false);
+        REQUIRE(s.data() == a->data());
+
+        // Writes through the span are visible in the list
+        s[1] = 10.0;
+        REQUIRE(a[1] == 10.0);
+        REQUIRE(std::accumulate(s.begin(), s.end(), 0.0) == 15.0);
+
+        span<double> tail = s.slice(2);
+        REQUIRE(tail.length() == 2);
+        REQUIRE(tail[0] == 2.0);
+        REQUIRE(s.slice(1, 2)[1] == 2.0);
+        REQUIRE(s.slice(4).is_empty());
+        REQUIRE_THROWS_AS(s.slice(5), exception);
+        REQUIRE_THROWS_AS(s.slice(3, 2), exception);
+        REQUIRE_THROWS_AS(s.slice(-1, 1), exception);
+
+        // Read-only span from const list or from span of non-const elements
+        const list_impl<double>& c = *a;
+        span<const double> read_only = c.as_span();
+        span<const double> converted = s;
+        REQUIRE(read_only.data() == converted.data());
+
+        REQUIRE(span<double>().is_empty());
+        REQUIRE(make_list<double>()->as_span().length() == 0);
+    }
+
+    TEST_CASE("Sort")
+    {
+        // Doubles are sorted by comparison below the radix threshold and by radix sort above it
+        for (int count : { 10, 1000 })
+        {
+            std::minstd_rand random(count);
+            list<double> values = make_list<double>();
+            for (int i = 0; i < count; ++i) values->add(double(int(random() % 2001) - 1000) / 4);
+            values[1] = std::nan("");
+            values[3] = -0.0;
+            values[5] = -INFINITY;
+            values[7] = INFINITY;
+
+            values->sort();
+            REQUIRE(std::isnan(values[0]));
+            REQUIRE(values[1] == -INFINITY);
+            REQUIRE(values[count - 1] == INFINITY);
+            REQUIRE(std::is_sorted(values->begin() + 1, values->end()));
+        }
+
+        std::minstd_rand random;
+        list<int> integers = make_list<int>();
+        for (int i = 0; i < 1000; ++i) integers->add(int(random()) - 1000000000);
+        std::vector<int> expected = *integers;
+        std::sort(expected.begin(), expected.end());
+        integers->sort();
+        REQUIRE(*integers == expected);
+
+        list<local_date> dates = make_list<local_date>();
+        for (int i = 0; i < 500; ++i) dates->add(local_date(2000, 1, 1).plus_days(int(random() % 10000)));
+        dates->sort();
+        REQUIRE(std::is_sorted(dates->begin(), dates->end()));
+
+        // Comparison
+        list<string> words = make_list<string>({ "pear", "fig", "apple", "kiwi" });
+        words->sort();
+        REQUIRE(string::join(",", words) == "apple,fig,kiwi,pear");
+        words->sort([](const string& lhs, const string& rhs) { return rhs->compare_to(lhs); });
+        REQUIRE(string::join(",", words) == "pear,kiwi,fig,apple");
+
+        // Null is less than other strings
+        words->add(string());
+        words->add(string());
+        words->sort();
+        REQUIRE(words[0] == nullptr);
+        REQUIRE(words[1] == nullptr);
+        REQUIRE(words[2] == "apple");
+        REQUIRE(words[5] == "pear");
+        REQUIRE(words->binary_search(string()) >= 0);
+        REQUIRE(words->binary_search("fig") == 3);
+        words->sort([](const string& x) { return x; });
+        REQUIRE(words[1] == nullptr);
+        REQUIRE(words[2] == "apple");
+
+        // Sort by key is stable for radix and comparison keys
+        for (int count : { 20, 1000 })
+        {
+            list<sort_sample> samples = make_sort_samples(count);
+            std::vector<sort_sample> by_value = *samples;
+            std::stable_sort(by_value.begin(), by_value.end(), [](const sort_sample& lhs, const sort_sample& rhs) { return lhs->value < rhs->value; });
+            samples->sort(&sort_sample_impl::value);
+            REQUIRE(*samples == by_value);
+
+            std::vector<sort_sample> by_name = *samples;
+            std::stable_sort(by_name.begin(), by_name.end(), [](const sort_sample& lhs, const sort_sample& rhs) { return lhs->name < rhs->name; });
+            samples->sort([](const sort_sample& x) { return x->name; });
+            REQUIRE(*samples == by_name);
+        }
+
+        // Radix sort of several keys sorts by the least significant key first
+        list<int> numbers = make_list<int>();
+        for (int i = 0; i < 2000; ++i) numbers->add(int(random() % 1000) - 500);
+        std::vector<int> by_digits = *numbers;
+        std::stable_sort(by_digits.begin(), by_digits.end(), [](int lhs, int rhs) { return std::make_tuple(lhs % 10, -(lhs / 10)) < std::make_tuple(rhs % 10, -(rhs / 10)); });
+        list<int> ordered = numbers->order_by([](int x) { return x % 10; }).then_by_descending([](int x) { return x / 10; }).to_list();
+        REQUIRE(*ordered == by_digits);
+    }
+
+    TEST_CASE("ParallelSort")
+    {
+        int previous = detail::work_stealing_pool::worker_count();
+        detail::work_stealing_pool::set_worker_count(4);
+
+        const int count = detail::parallel_sort_threshold + 1000;
+        list<sort_sample> samples = make_sort_samples(count);
+        std::vector<sort_sample> expected = *samples;
+        auto less = [](const sort_sample& lhs, const sort_sample& rhs) { return std::make_tuple(lhs->name, -lhs->value) < std::make_tuple(rhs->name, -rhs->value); };
+        std::stable_sort(expected.begin(), expected.end(), less);
+
+        list<sort_sample> ordered = samples->order_by(&sort_sample_impl::name).then_by_descending(&sort_sample_impl::value).to_list();
+        REQUIRE(*ordered == expected);
+
+        samples->sort(&sort_sample_impl::name);
+        REQUIRE(std::is_sorted(samples->begin(), samples->end(), [](const sort_sample& lhs, const sort_sample& rhs) { return lhs->name < rhs->name; }));
+        for (int i = 1; i < count; ++i)
+            if (samples[i - 1]->name == samples[i]->name) REQUIRE(samples[i - 1]->index < samples[i]->index);
+
+        list<string> names = samples->select(&sort_sample_impl::name).to_list();
+        std::reverse(names->begin(), names->end());
+        names->sort();
+        REQUIRE(std::is_sorted(names->begin(), names->end()));
+
+        detail::work_stealing_pool::set_worker_count(previous);
+    }
+
+    TEST_CASE("BinarySearch")
+    {
+        list<int> a = make_list<int>({ 1, 3, 3, 5 });
+        REQUIRE(a->binary_search(1) == 0);
+        REQUIRE(a->binary_search(3) == 1);
+        REQUIRE(a->binary_search(5) == 3);
+        REQUIRE(a->binary_search(0) == ~0);
+        REQUIRE(a->binary_search(4) == ~3);
+        REQUIRE(a->binary_search(6) == ~4);
+        REQUIRE(make_list<int>()->binary_search(1) == ~0);
+
+        list<string> words = make_list<string>({ "pear", "kiwi", "fig" });
+        auto descending = [](const string& lhs, const string& rhs) { return rhs->compare_to(lhs); };
+        REQUIRE(words->binary_search("kiwi", descending) == 1);
+        REQUIRE(words->binary_search("grape", descending) == ~2);
+    }
+
+    TEST_CASE("SortBenchmark", "[.benchmark]")
+    {
+        const int count = 1000000;
+        list<sort_sample> samples = make_sort_samples(count);
+        std::vector<double> values(count);
+        for (int i = 0; i < count; ++i) values[i] = samples[i]->value;
+
+        BENCHMARK("std::stable_sort by field")
+        {
+            std::vector<sort_sample> sorted = *samples;
+            std::stable_sort(sorted.begin(), sorted.end(), [](const sort_sample& lhs, const sort_sample& rhs) { return lhs->value < rhs->value; });
+            REQUIRE(sorted.size() == count);
+        }
+
+        BENCHMARK("order_by double field")
+        {
+            list<sort_sample> sorted = samples->order_by(&sort_sample_impl::value).to_list();
+            REQUIRE(sorted->count() == count);
+        }
+
+        BENCHMARK("order_by string field then_by double field")
+        {
+            list<sort_sample> sorted = samples->order_by(&sort_sample_impl::name).then_by(&sort_sample_impl::value).to_list();
+            REQUIRE(sorted->count() == count);
+        }
+
+        BENCHMARK("std::sort double")
+        {
+            std::vector<double> sorted = values;
+            std::sort(sorted.begin(), sorted.end());
+            REQUIRE(sorted.size() == count);
+        }
+
+        BENCHMARK("list sort() double")
+        {
+            list<double> sorted = make_list<double>(values);
+            sorted->sort();
+            REQUIRE(sorted->count() == count);
+        }
+    }
+
+    TEST_CASE("ListBenchmark", "[.benchmark]")
+    {
+        const int count = 1000000;
+        const int repeat = 10;
+        std::vector<double> vector(count);
+        for (int i = 0; i < count; ++i) vector[i] = i % 100;
+        list<double> values = make_list<double>(vector);
+        list_base base = values;
+
+        BENCHMARK("std::vector operator[]")
+        {
+            double sum = 0;
+            for (int r = 0; r < repeat; ++r)
+                for (int i = 0; i < count; ++i) sum += vector[i];
+            REQUIRE(sum > 0);
+        }
+
+        BENCHMARK("list operator[]")
+        {
+            double sum = 0;
+            for (int r = 0; r < repeat; ++r)
+                for (int i = 0; i < values->count(); ++i) sum += values[i];
+            REQUIRE(sum > 0);
+        }
+
+        BENCHMARK("list as_span()")
+        {
+            double sum = 0;
+            for (int r = 0; r < repeat; ++r)
+            {
+                span<const double> s = values->as_span();
+                for (int i = 0; i < s.length(); ++i) sum += s[i];
+            }
+            REQUIRE(sum > 0);
+        }
+
+        BENCHMARK("list_base get_item()")
+        {
+            double sum = 0;
+            for (int i = 0; i < base->get_length(); ++i) sum += (double)base->get_item(i);
+            REQUIRE(sum > 0);
+        }
+    }
 }
@@ -0,0 +1,303 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/test/implement.hpp>
+#include <approvals/ApprovalTests.hpp>
+#include <approvals/Catch.hpp>
+#include <dot/system/cycle_collector.hpp>
+#include <dot/system/atomic_ptr.hpp>
+#include <dot/system/string.hpp>
+#include <dot/system/type.hpp>
+#include <dot/system/collections/generic/list.hpp>
+
+namespace dot
+{
+    class cycle_node_sample_impl; using cycle_node_sample = ptr<cycle_node_sample_impl>;
+
+    /// Number of cycle_node_sample objects deleted.
+    static int cycle_node_sample_deleted = 0;
+
+    class cycle_node_sample_impl : public virtual object_impl
+    {
+        typedef cycle_node_sample_impl self;
+
+    public: // FIELDS
+
+        int int_field = 0;
+        string name;
+        cycle_node_sample next;
+        cycle_node_sample other;
+        list<object> items;
+
+    public: // DESTRUCTOR
+
+        ~cycle_node_sample_impl() { ++cycle_node_sample_deleted; }
+
+    public: // STATIC
+
+        static type typeof()
+        {
+            static type result = []()-> type
+            {
+                type t = make_type_builder<self>("System.Test", "cycle_node_sample")
+                    ->with_field("int_field", &self::int_field)
+                    ->with_field("name", &self::name)
+                    ->with_field("next", &self::next)
+                    ->with_field("other", &self::other)
+                    ->build();
+
+                return t;
+            }();
+
+            return result;
+        }
+
+        type get_type() override
+        {
+            return typeof();
+        }
+    };
+
+    cycle_node_sample make_cycle_node_sample() { return new cycle_node_sample_impl; }
+
+    /// Enables the collector for the lifetime of the object and collects
+    /// the remaining garbage when disabled.
+    class cycle_collector_sample_scope
+    {
+    public:
+
+        cycle_collector_sample_scope()
+        {
+            // Register the type before tracking starts so that type
+            // metadata is not tracked by the collector
+            cycle_node_sample_impl::typeof();
+            cycle_collector::enable();
+            cycle_node_sample_deleted = 0;
+        }
+
+        ~cycle_collector_sample_scope()
+        {
+            cycle_collector::disable();
+            cycle_collector::collect();
+        }
+    };
+
+    /// Create a ring of the specified number of nodes and release the
+    /// last external reference to it.
+    void make_cycle_node_sample_ring(int size)
+    {
+        cycle_node_sample first = make_cycle_node_sample();
+        cycle_node_sample last = first;
+        for (int i = 1; i < size; ++i)
+        {
+            cycle_node_sample node = make_cycle_node_sample();
+            last->next = node;
+            last = node;
+        }
+        last->next = first;
+    }
+
+    TEST_CASE("CycleCollector")
+    {
+        cycle_collector_sample_scope scope;
+        REQUIRE(cycle_collector::is_enabled());
+
+        // Two nodes referencing each other
+        {
+            cycle_node_sample a = make_cycle_node_sample();
+            cycle_node_sample b = make_cycle_node_sample();
+            a->next = b;
+            b->next = a;
+            a->name = "a";
+            REQUIRE(a->get_reference_count_mode() == reference_count_mode::single_threaded);
+        }
+        REQUIRE(cycle_node_sample_deleted == 0);
+        REQUIRE(cycle_collector::possible_root_count() > 0);
+
+        cycle_collector_stats stats = cycle_collector::collect();
+        REQUIRE(cycle_node_sample_deleted == 2);
+        REQUIRE(stats.cycle_count == 1);
+        REQUIRE(stats.object_count == 3);
+        REQUIRE(stats.reclaimed_bytes >= 2 * (sizeof(cycle_node_sample_impl) + alignof(std::max_align_t)));
+        REQUIRE(stats.pending_root_count == 0);
+        REQUIRE(cycle_collector::possible_root_count() == 0);
+
+        // Self reference and two separate rings
+        {
+            cycle_node_sample a = make_cycle_node_sample();
+            a->other = a;
+        }
+        make_cycle_node_sample_ring(3);
+        make_cycle_node_sample_ring(5);
+        cycle_node_sample_deleted = 0;
+        stats = cycle_collector::collect();
+        REQUIRE(cycle_node_sample_deleted == 9);
+        REQUIRE(stats.cycle_count == 3);
+        REQUIRE(stats.object_count == 9);
+
+        // Objects without cycles are deleted by reference counting
+        {
+            cycle_node_sample a = make_cycle_node_sample();
+            a->next = make_cycle_node_sample();
+        }
+        REQUIRE(cycle_node_sample_deleted == 11);
+        REQUIRE(cycle_collector::possible_root_count() == 0);
+    }
+
+    /// Type registering the same field twice.
+    class cycle_duplicate_field_sample_impl : public virtual object_impl
+    {
+    public: // FIELDS
+
+        cycle_node_sample next;
+        cycle_node_sample other;
+    };
+
+    TEST_CASE("CycleCollectorShared")
+    {
+        cycle_collector_sample_scope scope;
+
+        // Tracked objects cannot be stored where other threads would update their counts
+        {
+            cycle_node_sample node = make_cycle_node_sample();
+            atomic_ptr<cycle_node_sample_impl> slot;
+            CHECK_THROWS(slot.store(node));
+            REQUIRE(slot.load() == nullptr);
+            REQUIRE(node->reference_count() == 1);
+
+            atomic_object value;
+            CHECK_THROWS(value.store(object(5)));
+            REQUIRE(value.load() == nullptr);
+        }
+
+        // Fields registered twice would be counted twice by trial deletion
+        typedef cycle_duplicate_field_sample_impl sample;
+        CHECK_THROWS(make_type_builder<sample>("System.Test", "cycle_duplicate_field_sample")
+            ->with_field("next", &sample::next)
+            ->with_field("next", &sample::other));
+        CHECK_THROWS(make_type_builder<sample>("System.Test", "cycle_duplicate_field_sample")
+            ->with_field("next", &sample::next)
+            ->with_field("other", &sample::next));
+    }
+
+    TEST_CASE("CycleCollectorLive")
+    {
+        cycle_collector_sample_scope scope;
+
+        // Cycle referenced from a variable
+        cycle_node_sample a = make_cycle_node_sample();
+        a->next = make_cycle_node_sample();
+        a->next->next = a;
+        a->next->other = make_cycle_node_sample();
+        a->next->other->other = a->next;
+
+        cycle_collector_stats stats = cycle_collector::collect();
+        REQUIRE(stats.object_count == 0);
+        REQUIRE(cycle_node_sample_deleted == 0);
+        REQUIRE(a->next->next == a);
+
+        // Cycle referenced from a list is treated as alive
+        list<object> items = make_list<object>();
+        items->add(a);
+        a = nullptr;
+        stats = cycle_collector::collect();
+        REQUIRE(stats.object_count == 0);
+        REQUIRE(cycle_node_sample_deleted == 0);
+
+        // Releasing the list leaves the cycle as garbage
+        items = nullptr;
+        stats = cycle_collector::collect();
+        REQUIRE(stats.object_count == 3);
+        REQUIRE(cycle_node_sample_deleted == 3);
+    }
+
+    TEST_CASE("CycleCollectorUntracked")
+    {
+        // Objects created while the collector is disabled are not tracked
+        cycle_node_sample_impl::typeof();
+        cycle_node_sample_deleted = 0;
+        REQUIRE(!cycle_collector::is_enabled());
+        {
+            cycle_node_sample a = make_cycle_node_sample();
+            REQUIRE(a->get_reference_count_mode() != reference_count_mode::single_threaded);
+            a->next = make_cycle_node_sample();
+            a->next->next = a;
+
+            // Break the cycle manually
+            a->next->next = nullptr;
+        }
+        REQUIRE(cycle_node_sample_deleted == 2);
+        REQUIRE(cycle_collector::possible_root_count() == 0);
+    }
+
+    TEST_CASE("CycleCollectorIncremental")
+    {
+        cycle_collector_sample_scope scope;
+        for (int i = 0; i < 1000; ++i)
+        {
+            make_cycle_node_sample_ring(2);
+        }
+        REQUIRE(cycle_collector::possible_root_count() >= 1000);
+
+        // Zero pause processes a single batch of roots
+        cycle_collector_stats stats = cycle_collector::collect(std::chrono::microseconds(0));
+        REQUIRE(stats.object_count > 0);
+        REQUIRE(stats.pending_root_count > 0);
+        REQUIRE(stats.pending_root_count == cycle_collector::possible_root_count());
+
+        size_t object_count = stats.object_count;
+        while (cycle_collector::possible_root_count() > 0)
+        {
+            stats = cycle_collector::collect(std::chrono::microseconds(100));
+            object_count += stats.object_count;
+        }
+        REQUIRE(object_count == 2000);
+        REQUIRE(cycle_node_sample_deleted == 2000);
+    }
+
+    TEST_CASE("CycleCollectorBenchmark", "[.benchmark]")
+    {
+        const int count = 100000;
+
+        BENCHMARK("Rings (collect)")
+        {
+            cycle_collector_sample_scope scope;
+            for (int i = 0; i < count; ++i)
+            {
+                make_cycle_node_sample_ring(4);
+            }
+            cycle_collector::collect();
+        }
+
+        BENCHMARK("Chains (no cycles)")
+        {
+            cycle_collector_sample_scope scope;
+            for (int i = 0; i < count; ++i)
+            {
+                cycle_node_sample a = make_cycle_node_sample();
+                a->next = make_cycle_node_sample();
+                a->next->next = make_cycle_node_sample();
+            }
+        }
+    }
+}
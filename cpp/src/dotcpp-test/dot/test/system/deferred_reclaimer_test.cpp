@@ -0,0 +1,164 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/test/implement.hpp>
+#include <approvals/ApprovalTests.hpp>
+#include <approvals/Catch.hpp>
+#include <dot/system/deferred_reclaimer.hpp>
+#include <dot/system/string.hpp>
+#include <dot/system/collections/generic/list.hpp>
+#include <dot/system/collections/generic/dictionary.hpp>
+#include <thread>
+
+namespace dot
+{
+    /// Number of deferred_reclaimer_sample objects deleted.
+    static std::atomic<int> deferred_reclaimer_sample_deleted = 0;
+
+    /// Number of deferred_reclaimer_sample objects deleted by the thread that created them.
+    static std::atomic<int> deferred_reclaimer_sample_deleted_inline = 0;
+
+    class deferred_reclaimer_sample_impl; using deferred_reclaimer_sample = ptr<deferred_reclaimer_sample_impl>;
+
+    class deferred_reclaimer_sample_impl : public virtual object_impl
+    {
+    public: // FIELDS
+
+        std::thread::id creator = std::this_thread::get_id();
+        list<deferred_reclaimer_sample> children;
+
+    public: // DESTRUCTOR
+
+        ~deferred_reclaimer_sample_impl()
+        {
+            ++deferred_reclaimer_sample_deleted;
+            if (std::this_thread::get_id() == creator) ++deferred_reclaimer_sample_deleted_inline;
+        }
+    };
+
+    deferred_reclaimer_sample make_deferred_reclaimer_sample() { return new deferred_reclaimer_sample_impl; }
+
+    /// Create a tree of samples with the specified depth and number of children per node.
+    deferred_reclaimer_sample make_deferred_reclaimer_sample_tree(int depth, int width)
+    {
+        deferred_reclaimer_sample result = make_deferred_reclaimer_sample();
+        if (depth > 1)
+        {
+            result->children = make_list<deferred_reclaimer_sample>();
+            for (int i = 0; i < width; ++i) result->children->add(make_deferred_reclaimer_sample_tree(depth - 1, width));
+        }
+        return result;
+    }
+
+    TEST_CASE("DeferredReclaimer")
+    {
+        deferred_reclaimer_sample_deleted = 0;
+        deferred_reclaimer_sample_deleted_inline = 0;
+        REQUIRE(!deferred_reclaimer::is_enabled());
+
+        // Deleted immediately when not enabled
+        make_deferred_reclaimer_sample_tree(2, 3);
+        REQUIRE(deferred_reclaimer_sample_deleted == 4);
+        REQUIRE(deferred_reclaimer_sample_deleted_inline == 4);
+
+        // The whole tree is deleted by the background thread, including
+        // children returned to this thread for merge
+        deferred_reclaimer::enable();
+        REQUIRE(deferred_reclaimer::is_enabled());
+        deferred_reclaimer_sample tree = make_deferred_reclaimer_sample_tree(4, 4);
+        tree = nullptr;
+        deferred_reclaimer::flush();
+        REQUIRE(deferred_reclaimer::pending_count() == 0);
+        REQUIRE(deferred_reclaimer_sample_deleted == 4 + 85);
+        REQUIRE(deferred_reclaimer_sample_deleted_inline == 4);
+
+        // Objects in single_threaded mode are deleted immediately
+        reference_count_mode default_mode = reference_counter::default_reference_count_mode();
+        reference_counter::set_default_reference_count_mode(reference_count_mode::single_threaded);
+        make_deferred_reclaimer_sample();
+        reference_counter::set_default_reference_count_mode(default_mode);
+        REQUIRE(deferred_reclaimer_sample_deleted == 4 + 85 + 1);
+        REQUIRE(deferred_reclaimer_sample_deleted_inline == 4 + 1);
+
+        deferred_reclaimer::disable();
+        REQUIRE(!deferred_reclaimer::is_enabled());
+    }
+
+    TEST_CASE("DeferredReclaimerThreads")
+    {
+        deferred_reclaimer_sample_deleted = 0;
+
+        // Threads releasing objects created by other threads
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i)
+        {
+            threads.emplace_back([]()
+            {
+                deferred_reclaimer::enable();
+                deferred_reclaimer_sample shared = make_deferred_reclaimer_sample_tree(3, 4);
+                std::thread([shared]() mutable
+                {
+                    deferred_reclaimer::enable();
+                    shared = nullptr;
+                }).join();
+                shared = nullptr;
+                deferred_reclaimer::flush();
+            });
+        }
+        for (std::thread& thread : threads) thread.join();
+
+        deferred_reclaimer::flush();
+        REQUIRE(deferred_reclaimer_sample_deleted == 4 * 21);
+    }
+
+    TEST_CASE("DeferredReclaimerBenchmark", "[.benchmark]")
+    {
+        const int count = 100000;
+        auto make_snapshot = [count]()
+        {
+            dictionary<string, object> result = make_dictionary<string, object>();
+            for (int i = 0; i < count; ++i)
+            {
+                list<double> values = make_list<double>();
+                values->add(i);
+                result->add(make_string("key" + std::to_string(i)), values);
+            }
+            return result;
+        };
+
+        dictionary<string, object> snapshot = make_snapshot();
+        BENCHMARK("Release (inline)")
+        {
+            snapshot = nullptr;
+        }
+
+        snapshot = make_snapshot();
+        deferred_reclaimer::enable();
+        BENCHMARK("Release (deferred)")
+        {
+            snapshot = nullptr;
+        }
+        deferred_reclaimer::flush();
+        deferred_reclaimer::disable();
+    }
+}
@@ -26,6 +26,11 @@ limitations under the License.
 #include <approvals/Catch.hpp>
 #include <dot/system/string.hpp>
 #include <dot/system/nullable.hpp>
+#include <dot/system/to_string.hpp>
+#include <dot/system/exception.hpp>
+#include <cmath>
+#include <limits>
+#include <random>
 
 namespace dot
 {
@@ -34,4 +39,153 @@ namespace dot
         dot::nullable<double> x;
         REQUIRE(x.has_value() == false);
     }
+
+    TEST_CASE("DoubleFormat")
+    {
+        REQUIRE(to_string(0.0) == "0");
+        REQUIRE(to_string(-0.0) == "-0");
+        REQUIRE(to_string(1.0) == "1");
+        REQUIRE(to_string(-2.5) == "-2.5");
+        REQUIRE(to_string(0.1) == "0.1");
+        REQUIRE(to_string(0.1 + 0.2) == "0.30000000000000004");
+        REQUIRE(to_string(123.456) == "123.456");
+        REQUIRE(to_string(1e14) == "100000000000000");
+        REQUIRE(to_string(1e15) == "1E+15");
+        REQUIRE(to_string(1.5e300) == "1.5E+300");
+        REQUIRE(to_string(0.0001) == "0.0001");
+        REQUIRE(to_string(0.00012) == "0.00012");
+        REQUIRE(to_string(1e-5) == "1E-05");
+        REQUIRE(to_string(-1.25e-10) == "-1.25E-10");
+        REQUIRE(to_string(std::numeric_limits<double>::max()) == "1.7976931348623157E+308");
+        REQUIRE(to_string(std::numeric_limits<double>::denorm_min()) == "5E-324");
+        REQUIRE(to_string(std::numeric_limits<double>::infinity()) == "Infinity");
+        REQUIRE(to_string(-std::numeric_limits<double>::infinity()) == "-Infinity");
+        REQUIRE(to_string(std::numeric_limits<double>::quiet_NaN()) == "NaN");
+
+        // Boxed value uses the same format
+        object boxed = 0.1;
+        REQUIRE(boxed->to_string() == "0.1");
+
+        char buffer[double_impl::max_chars];
+        double longest = -1.2345678901234567e-300;
+        REQUIRE(double_impl::to_chars(buffer, longest) - buffer == double_impl::max_chars);
+    }
+
+    TEST_CASE("DoubleParse")
+    {
+        REQUIRE(double_impl::parse("1.5") == 1.5);
+        REQUIRE(double_impl::parse("  -1.5e3 ") == -1500.0);
+        REQUIRE(double_impl::parse("+.5") == 0.5);
+        REQUIRE(double_impl::parse("5.") == 5.0);
+        REQUIRE(double_impl::parse("1,234,567.5") == 1234567.5);
+        REQUIRE(double_impl::parse("1E+15") == 1e15);
+        REQUIRE(double_impl::parse("Infinity") == std::numeric_limits<double>::infinity());
+        REQUIRE(double_impl::parse("-infinity") == -std::numeric_limits<double>::infinity());
+        REQUIRE(std::isnan(double_impl::parse("NaN")));
+
+        // Out of range values become infinity or zero
+        REQUIRE(double_impl::parse("1e400") == std::numeric_limits<double>::infinity());
+        REQUIRE(double_impl::parse("-1e400") == -std::numeric_limits<double>::infinity());
+        REQUIRE(double_impl::parse("0.001e-400") == 0.0);
+        REQUIRE(double_impl::parse("1000e-400") == 0.0);
+
+        double result = 42;
+        for (const char* invalid : { "", " ", "-", "abc", "1.5x", "1e", "0x10", "inf", ",5", "1.5,0", "1 5", "--1" })
+        {
+            INFO(invalid);
+            REQUIRE(double_impl::try_parse(invalid, result) == false);
+            REQUIRE(result == 42);
+        }
+        REQUIRE_THROWS_AS(double_impl::parse("abc"), exception);
+        REQUIRE_THROWS_AS(double_impl::parse(string()), exception);
+    }
+
+    TEST_CASE("DoubleRoundTrip")
+    {
+        std::mt19937_64 engine(0);
+        char buffer[double_impl::max_chars];
+        for (int i = 0; i < 100000; ++i)
+        {
+            // Random bit patterns cover the entire range including subnormals
+            uint64_t bits = engine();
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            if (std::isnan(value)) continue;
+
+            std::string_view text(buffer, double_impl::to_chars(buffer, value) - buffer);
+            double parsed;
+            REQUIRE(double_impl::try_parse(text, parsed));
+            REQUIRE(std::memcmp(&parsed, &value, sizeof(value)) == 0);
+        }
+    }
+
+    TEST_CASE("IntegerParse")
+    {
+        REQUIRE(to_string(0) == "0");
+        REQUIRE(to_string(-123) == "-123");
+        REQUIRE(to_string(INT32_MIN) == "-2147483648");
+        REQUIRE(to_string(INT64_MIN) == "-9223372036854775808");
+        REQUIRE(to_string(INT64_MAX) == "9223372036854775807");
+
+        REQUIRE(int_impl::parse(" 42 ") == 42);
+        REQUIRE(int_impl::parse("+42") == 42);
+        REQUIRE(int_impl::parse("-2147483648") == INT32_MIN);
+        REQUIRE(int_impl::parse("2147483647") == INT32_MAX);
+        REQUIRE(long_impl::parse("-9223372036854775808") == INT64_MIN);
+        REQUIRE(long_impl::parse("9223372036854775807") == INT64_MAX);
+
+        int result = 42;
+        for (const char* invalid : { "", "-", "2147483648", "-2147483649", "99999999999", "1.0", "1e3", "0x10", "1 2", "1,000" })
+        {
+            INFO(invalid);
+            REQUIRE(int_impl::try_parse(invalid, result) == false);
+            REQUIRE(result == 42);
+        }
+        int64_t long_result = 42;
+        REQUIRE(long_impl::try_parse("9223372036854775808", long_result) == false);
+        REQUIRE(long_result == 42);
+        REQUIRE_THROWS_AS(int_impl::parse("abc"), exception);
+    }
+
+    TEST_CASE("NumberBenchmark", "[.benchmark]")
+    {
+        const int count = 10000000;
+        std::mt19937_64 engine(0);
+        std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+        std::vector<double> values(count);
+        for (double& value : values) value = distribution(engine);
+
+        std::vector<std::string> texts(count);
+        BENCHMARK("std::to_string")
+        {
+            for (int i = 0; i < count; ++i) texts[i] = std::to_string(values[i]);
+            REQUIRE(texts.back().size() > 0);
+        }
+
+        BENCHMARK("double_impl::to_chars")
+        {
+            char buffer[double_impl::max_chars];
+            for (int i = 0; i < count; ++i) texts[i].assign(buffer, double_impl::to_chars(buffer, values[i]));
+            REQUIRE(texts.back().size() > 0);
+        }
+
+        BENCHMARK("std::stod")
+        {
+            double sum = 0;
+            for (int i = 0; i < count; ++i) sum += std::stod(texts[i]);
+            REQUIRE(sum != 0);
+        }
+
+        BENCHMARK("double_impl::try_parse")
+        {
+            double sum = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                double value;
+                double_impl::try_parse(texts[i], value);
+                sum += value;
+            }
+            REQUIRE(sum != 0);
+        }
+    }
 }
@@ -102,4 +102,20 @@ namespace dot
 
         Approvals::verify(*received);
     }
+
+    TEST_CASE("EnumEqualsInline")
+    {
+        dot::object boxed = apples_sample::red;
+        REQUIRE(boxed->equals(boxed));
+        REQUIRE(boxed->equals(dot::object(apples_sample::red)));
+        REQUIRE_FALSE(boxed->equals(dot::object(apples_sample::gala)));
+
+        // Inline values are not enums and compare as not equal
+        REQUIRE(dot::object(1).is_inline());
+        REQUIRE_FALSE(boxed->equals(dot::object(1)));
+        REQUIRE_FALSE(boxed->equals(dot::object(-1)));
+        REQUIRE_FALSE(boxed->equals(dot::object(int64_t(1))));
+        REQUIRE_FALSE(boxed->equals(dot::object(1.5)));
+        REQUIRE_FALSE(boxed->equals(dot::object(true)));
+    }
 }
@@ -0,0 +1,184 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/test/implement.hpp>
+#include <approvals/ApprovalTests.hpp>
+#include <approvals/Catch.hpp>
+#include <dot/system/string.hpp>
+#include <dot/system/collections/generic/list.hpp>
+#include <dot/system/linq/parallel_query.hpp>
+#include <dot/detail/work_stealing_pool.hpp>
+#include <atomic>
+#include <cmath>
+
+namespace dot
+{
+    /// Sets the number of workers for the duration of a test and restores it afterwards.
+    class worker_count_scope
+    {
+        int previous_;
+
+    public:
+
+        explicit worker_count_scope(int count) : previous_(detail::work_stealing_pool::worker_count())
+        {
+            detail::work_stealing_pool::set_worker_count(count);
+        }
+
+        ~worker_count_scope() { detail::work_stealing_pool::set_worker_count(previous_); }
+    };
+
+    TEST_CASE("ParallelQuery")
+    {
+        worker_count_scope workers(4);
+
+        const int count = 100000;
+        list<int> values = make_list<int>(count);
+        for (int i = 0; i < count; ++i) values[i] = i;
+
+        auto even = [](int x) { return x % 2 == 0; };
+        auto square = [](int x) { return int64_t(x) * x; };
+
+        REQUIRE(values->as_parallel().count() == count);
+        REQUIRE(values->as_parallel().where(even).count() == count / 2);
+        REQUIRE(values->as_parallel().select(square).sum() == values->select(square).sum());
+        REQUIRE(values->as_parallel().where(even).select(square).sum() == values->where(even).select(square).sum());
+        REQUIRE(values->as_parallel().aggregate(int64_t(0), [](int64_t acc, int x) { return acc + x; }, std::plus<int64_t>()) == int64_t(count) * (count - 1) / 2);
+
+        // Ordered results keep the order of the source
+        list<int> ordered = values->as_parallel().as_ordered().where(even).to_list();
+        REQUIRE(*ordered == *values->where(even).to_list());
+
+        // Unordered results have the same elements in some order
+        list<int> unordered = values->as_parallel().where(even).to_list();
+        std::sort(unordered->begin(), unordered->end());
+        REQUIRE(*unordered == *ordered);
+
+        std::atomic<int64_t> total(0);
+        values->as_parallel().for_each([&total](int x) { total += x; });
+        REQUIRE(total == int64_t(count) * (count - 1) / 2);
+
+        // Ordered floating point sums are identical between runs
+        list<double> doubles = make_list<double>(count);
+        for (int i = 0; i < count; ++i) doubles[i] = std::sin(i);
+        double first = doubles->as_parallel().as_ordered().sum();
+        for (int i = 0; i < 10; ++i) REQUIRE(doubles->as_parallel().as_ordered().sum() == first);
+
+        // Nested query runs on the worker that started it
+        std::atomic<int64_t> nested(0);
+        values->as_parallel().where([](int x) { return x < 10; }).for_each([&](int x) { nested += values->as_parallel().where([x](int y) { return y < x; }).count(); });
+        REQUIRE(nested == 45);
+
+        list<int> empty = make_list<int>();
+        REQUIRE(empty->as_parallel().sum() == 0);
+        REQUIRE(empty->as_parallel().to_list()->count() == 0);
+
+        // Exception thrown by any chunk is rethrown to the caller
+        REQUIRE_THROWS_AS(values->as_parallel().for_each([](int x) { if (x == count / 2) throw exception("Chunk failed."); }), exception);
+        REQUIRE(values->as_parallel().count() == count);
+
+        // Chunks run on at most the specified number of workers, which parallel
+        // queries read once and use to size the results of the workers
+        std::atomic<int> max_worker(0);
+        auto record_worker = [&max_worker](int worker, int)
+        {
+            int previous = max_worker.load();
+            while (worker > previous && !max_worker.compare_exchange_weak(previous, worker)) {}
+        };
+        detail::work_stealing_pool::run(1000, 2, record_worker);
+        REQUIRE(max_worker < 2);
+        detail::work_stealing_pool::run(1000, 1, record_worker);
+        REQUIRE(max_worker < 2);
+        REQUIRE_THROWS(detail::work_stealing_pool::run(10, 0, record_worker));
+    }
+
+    TEST_CASE("ParallelOrderBy")
+    {
+        worker_count_scope workers(3);
+
+        const int count = 50000;
+        list<string> values = make_list<string>();
+        for (int i = 0; i < count; ++i) values->add(to_string((i * 7919) % 1000));
+
+        // Stable sort by length then by descending value, compared with the sequential query
+        auto length = [](const string& x) { return x->length(); };
+        auto parallel = values->as_parallel().order_by(length).then_by_descending([](const string& x) { return x; }).to_list();
+        auto sequential = values->order_by(length).then_by_descending([](const string& x) { return x; }).to_list();
+        REQUIRE(parallel->count() == count);
+        for (int i = 0; i < count; ++i) REQUIRE(&*parallel[i] == &*sequential[i]);
+
+        list<int> numbers = make_list<int>({ 3, 1, 2 });
+        REQUIRE(*numbers->as_parallel().order_by_descending([](int x) { return x; }).to_list() == std::vector<int>({ 3, 2, 1 }));
+    }
+
+    TEST_CASE("ParallelQuerySingleThreaded")
+    {
+        worker_count_scope workers(4);
+
+        // Objects whose reference counts are not atomic cannot be copied by the workers
+        list<object> values = make_list<object>();
+        for (int i = 0; i < 1000; ++i) values->add(make_object());
+        REQUIRE(values->as_parallel().count() == 1000);
+
+        reference_count_mode default_mode = reference_counter::default_reference_count_mode();
+        reference_counter::set_default_reference_count_mode(reference_count_mode::single_threaded);
+        values[500] = make_object();
+        reference_counter::set_default_reference_count_mode(default_mode);
+
+        REQUIRE(values[500]->get_reference_count_mode() == reference_count_mode::single_threaded);
+        REQUIRE_THROWS_AS(values->as_parallel().count(), exception);
+        REQUIRE_THROWS_AS(values->as_parallel().for_each([](const object&) {}), exception);
+
+        // Inline values have no reference count
+        values[500] = 1;
+        REQUIRE(values->as_parallel().count() == 1000);
+    }
+
+    TEST_CASE("ParallelQueryBenchmark", "[.benchmark]")
+    {
+        const int count = 10000000;
+        list<double> values = make_list<double>(count);
+        for (int i = 0; i < count; ++i) values[i] = i % 1000 + 1;
+
+        // Stand-in for the valuation of a trade
+        auto value = [](double x) { return std::exp(-0.01 * x) * std::sqrt(x); };
+
+        BENCHMARK("Sequential")
+        {
+            double sum = values->select(value).sum();
+            REQUIRE(sum > 0);
+        }
+
+        BENCHMARK("Parallel")
+        {
+            double sum = values->as_parallel().select(value).sum();
+            REQUIRE(sum > 0);
+        }
+
+        BENCHMARK("Parallel ordered")
+        {
+            double sum = values->as_parallel().as_ordered().select(value).sum();
+            REQUIRE(sum > 0);
+        }
+    }
+}
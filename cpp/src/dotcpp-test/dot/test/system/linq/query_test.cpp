@@ -0,0 +1,203 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/test/implement.hpp>
+#include <approvals/ApprovalTests.hpp>
+#include <approvals/Catch.hpp>
+#include <dot/system/string.hpp>
+#include <dot/system/string_comparer.hpp>
+#include <dot/system/collections/generic/dictionary.hpp>
+#include <dot/system/collections/generic/hash_set.hpp>
+#include <dot/system/linq/query.hpp>
+
+namespace dot
+{
+    class query_sample_impl; using query_sample = ptr<query_sample_impl>;
+
+    /// Sample class with two fields used as keys by order_by(...) and then_by(...).
+    class query_sample_impl : public virtual object_impl
+    {
+    public:
+
+        string name;
+        int rank;
+
+        query_sample_impl(string name, int rank) : name(name), rank(rank) {}
+    };
+
+    query_sample make_query_sample(string name, int rank) { return new query_sample_impl(name, rank); }
+
+    TEST_CASE("QueryOperators")
+    {
+        list<int> a = make_list<int>({ 5, 1, 4, 1, 5, 9, 2, 6 });
+
+        list<int> even = a->where([](int x) { return x % 2 == 0; }).to_list();
+        REQUIRE(*even == std::vector<int>({ 4, 2, 6 }));
+
+        list<string> text = a->take(3).select([](int x) { return to_string(x); }).to_list();
+        REQUIRE(text->count() == 3);
+        REQUIRE(text[2] == "4");
+
+        REQUIRE(a->skip(6).sum() == 8);
+        REQUIRE(a->skip(100).any() == false);
+        REQUIRE(a->take(0).count() == 0);
+        REQUIRE(*a->distinct().to_list() == std::vector<int>({ 5, 1, 4, 9, 2, 6 }));
+        REQUIRE(a->select_many([](int x) { return make_list<int>({ x, -x }); }).sum() == 0);
+        REQUIRE(a->take(2).select_many([](int x) { return make_list<int>({ x, x })->as_enumerable().take(1); }).count() == 2);
+
+        REQUIRE(a->any());
+        REQUIRE(a->any([](int x) { return x > 8; }));
+        REQUIRE(a->all([](int x) { return x > 0; }));
+        REQUIRE(a->where([](int x) { return x > 1; }).count([](int x) { return x == 5; }) == 2);
+        REQUIRE(a->sum() == 33);
+        REQUIRE(a->sum([](int x) { return x * 0.5; }) == 16.5);
+        REQUIRE(a->min() == 1);
+        REQUIRE(a->max() == 9);
+        REQUIRE(a->max([](int x) { return -x; }) == -1);
+        REQUIRE(a->aggregate([](int acc, int x) { return acc * 10 + x; }) == 51415926);
+        REQUIRE(a->aggregate(string("x"), [](string acc, int x) -> string { return acc + to_string(x); }) == "x51415926");
+        REQUIRE(a->first_or_default() == 5);
+        REQUIRE(a->first_or_default([](int x) { return x > 5; }) == 9);
+        REQUIRE(a->first_or_default([](int x) { return x > 100; }) == 0);
+
+        // Queries are evaluated every time they are read
+        auto query = a->where([](int x) { return x > 4; });
+        REQUIRE(query.count() == 4);
+        a->add(7);
+        REQUIRE(query.count() == 5);
+
+        list<int> empty = make_list<int>();
+        REQUIRE(empty->sum() == 0);
+        REQUIRE(empty->first_or_default() == 0);
+        REQUIRE_THROWS_AS(empty->min(), exception);
+        REQUIRE_THROWS_AS(empty->aggregate([](int acc, int x) { return acc + x; }), exception);
+
+        // Query keeps the collection alive
+        auto temporary = make_list<int>({ 1, 2, 3 })->select([](int x) { return x * 2; });
+        REQUIRE(temporary.sum() == 12);
+    }
+
+    TEST_CASE("QueryOrdering")
+    {
+        list<query_sample> samples = make_list<query_sample>();
+        samples->add(make_query_sample("b", 2));
+        samples->add(make_query_sample("a", 2));
+        samples->add(make_query_sample("c", 1));
+        samples->add(make_query_sample("a", 1));
+
+        auto names = [](auto query) { return string::join(",", query.select([](const query_sample& x) -> string { return x->name + to_string(x->rank); }).to_list()); };
+
+        REQUIRE(names(samples->order_by(&query_sample_impl::rank)) == "c1,a1,b2,a2");
+        REQUIRE(names(samples->order_by(&query_sample_impl::rank).then_by(&query_sample_impl::name)) == "a1,c1,a2,b2");
+        REQUIRE(names(samples->order_by_descending(&query_sample_impl::rank).then_by_descending(&query_sample_impl::name)) == "b2,a2,c1,a1");
+        REQUIRE(names(samples->order_by([](const query_sample& x) { return x->name; }).then_by_descending(&query_sample_impl::rank)) == "a2,a1,b2,c1");
+        REQUIRE(names(samples->order_by(&query_sample_impl::name).take(2)) == "a2,a1");
+        REQUIRE(names(samples->where([](const query_sample& x) { return x->rank == 2; }).order_by(&query_sample_impl::name)) == "a2,b2");
+    }
+
+    TEST_CASE("QueryGroupBy")
+    {
+        list<string> words = make_list<string>({ "apple", "avocado", "banana", "cherry", "blueberry", "apricot" });
+
+        auto groups = words->group_by([](const string& x) { return x->substring(0, 1); }).to_list();
+        REQUIRE(groups->count() == 3);
+        REQUIRE(groups[0]->key() == "a");
+        REQUIRE(groups[0]->elements()->count() == 3);
+        REQUIRE(groups[1]->key() == "b");
+        REQUIRE(groups[1]->elements()[1] == "blueberry");
+        REQUIRE(groups[2]->elements()->count() == 1);
+
+        dictionary<string, int> counts = words
+            ->group_by([](const string& x) { return x->substring(0, 1); })
+            .to_dictionary([](const auto& g) { return g->key(); }, [](const auto& g) { return g->elements()->count(); });
+        REQUIRE(counts["a"] == 3);
+        REQUIRE(counts["c"] == 1);
+
+        dictionary<int, string> by_length = words->where([](const string& x) { return x->substring(0, 1) == "b"; }).to_dictionary([](const string& x) { return static_cast<int>(x->length()); });
+        REQUIRE(by_length[9] == "blueberry");
+        REQUIRE_THROWS_AS(words->to_dictionary([](const string& x) { return static_cast<int>(x->length()); }), exception);
+    }
+
+    TEST_CASE("QueryCollections")
+    {
+        dictionary<string, int> dict = make_dictionary<string, int>();
+        dict->add("a", 1);
+        dict->add("b", 2);
+        dict->add("c", 3);
+        REQUIRE(dict->sum([](const auto& x) { return x.second; }) == 6);
+        REQUIRE(dict->where([](const auto& x) { return x.second > 1; }).count() == 2);
+        REQUIRE(dict->order_by_descending([](const auto& x) { return x.second; }).first_or_default().first == "c");
+
+        hash_set<int> set = make_hash_set<int>();
+        set->add(3);
+        set->add(4);
+        REQUIRE(set->sum() == 7);
+        REQUIRE(set->select([](int x) { return x * x; }).to_hash_set()->contains(16));
+
+        list<string> words = make_list<string>({ "Apple", "apple", "APPLE", "pear" });
+        REQUIRE(words->distinct().count() == 4);
+        REQUIRE(words->distinct<string_comparer::ordinal_ignore_case, string_comparer::ordinal_ignore_case>().count() == 2);
+        REQUIRE(words->to_hash_set<string_comparer::ordinal_ignore_case, string_comparer::ordinal_ignore_case>()->count() == 2);
+    }
+
+    TEST_CASE("QueryBenchmark", "[.benchmark]")
+    {
+        const int count = 10000000;
+        list<double> values = make_list<double>(count);
+        for (int i = 0; i < count; ++i) values[i] = i % 1000;
+
+        BENCHMARK("Loop")
+        {
+            double sum = 0;
+            for (double x : *values)
+                if (x > 500) sum += x * 2;
+            REQUIRE(sum > 0);
+        }
+
+        BENCHMARK("where select sum")
+        {
+            double sum = values->where([](double x) { return x > 500; }).select([](double x) { return x * 2; }).sum();
+            REQUIRE(sum > 0);
+        }
+
+        BENCHMARK("Loop first")
+        {
+            double first = 0;
+            for (double x : *values)
+            {
+                if (x > 998)
+                {
+                    first = x;
+                    break;
+                }
+            }
+            REQUIRE(first > 0);
+        }
+
+        BENCHMARK("where first_or_default")
+        {
+            double first = values->first_or_default([](double x) { return x > 998; });
+            REQUIRE(first > 0);
+        }
+    }
+}
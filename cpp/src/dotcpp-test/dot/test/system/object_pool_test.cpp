@@ -0,0 +1,133 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/test/implement.hpp>
+#include <approvals/ApprovalTests.hpp>
+#include <approvals/Catch.hpp>
+#include <dot/system/object_pool.hpp>
+#include <dot/system/object.hpp>
+#include <dot/system/string.hpp>
+#include <dot/system/collections/generic/list.hpp>
+#include <atomic>
+#include <thread>
+
+namespace dot
+{
+    TEST_CASE("Smoke")
+    {
+        object_pool::reset_stats();
+        for (int i = 0; i < 1000; ++i)
+        {
+            object value = make_object();
+        }
+
+        // The first allocation reserves memory, the rest are served from the free list
+        object_pool_stats stats = object_pool::get_stats();
+        REQUIRE(stats.allocation_count >= 1000);
+        REQUIRE(stats.hit_count >= 999);
+        REQUIRE(stats.miss_count == stats.allocation_count - stats.hit_count);
+        REQUIRE(stats.hit_rate() > 0.99);
+        REQUIRE(stats.reserved_bytes > 0);
+    }
+
+    TEST_CASE("RemoteRelease")
+    {
+        object_pool::reset_stats();
+
+        // Objects allocated by the current thread and deleted by another thread,
+        // biased reference counting would defer deletion to the current thread
+        reference_count_mode default_mode = reference_counter::default_reference_count_mode();
+        reference_counter::set_default_reference_count_mode(reference_count_mode::atomic);
+        list<object> items = make_list<object>();
+        for (int i = 0; i < 100; ++i) items->add(make_string("abc"));
+        reference_counter::set_default_reference_count_mode(default_mode);
+        std::thread([&items]() { items = nullptr; }).join();
+
+        object_pool_stats stats = object_pool::get_stats();
+        REQUIRE(stats.remote_release_count >= 101);
+
+        // Released memory is reused by the allocating thread
+        size_t reserved_bytes = stats.reserved_bytes;
+        for (int i = 0; i < 100; ++i)
+        {
+            string value = make_string("abc");
+        }
+        REQUIRE(object_pool::get_stats().reserved_bytes == reserved_bytes);
+    }
+
+    TEST_CASE("ResetStatsConcurrent")
+    {
+        // Reset while another thread allocates, which keeps counting from the reset values
+        std::atomic<bool> done = false;
+        std::thread allocator([&done]()
+        {
+            while (!done.load())
+            {
+                object value = make_object();
+            }
+        });
+        for (int i = 0; i < 1000; ++i)
+        {
+            object_pool::reset_stats();
+            REQUIRE(object_pool::get_stats().allocation_count < size_t(1) << 40);
+        }
+        done = true;
+        allocator.join();
+
+        object_pool::reset_stats();
+        REQUIRE(object_pool::get_stats().allocation_count == 0);
+        for (int i = 0; i < 10; ++i)
+        {
+            object value = make_object();
+        }
+        REQUIRE(object_pool::get_stats().allocation_count == 10);
+    }
+
+    TEST_CASE("Benchmark", "[.benchmark]")
+    {
+        const int thread_count = 4;
+        const int count = 1000000;
+        object_pool::reset_stats();
+
+        BENCHMARK("Boxing in parallel threads")
+        {
+            std::vector<std::thread> threads;
+            for (int i = 0; i < thread_count; ++i)
+            {
+                threads.emplace_back([count]()
+                {
+                    list<object> items = make_list<object>();
+                    for (int j = 0; j < count; ++j)
+                    {
+                        items->add(make_object());
+                        if (items->count() == 1000) items->clear();
+                    }
+                });
+            }
+            for (std::thread& thread : threads) thread.join();
+        }
+
+        object_pool_stats stats = object_pool::get_stats();
+        WARN("Pool hit rate: " << stats.hit_rate() << ", reserved bytes: " << stats.reserved_bytes);
+    }
+}
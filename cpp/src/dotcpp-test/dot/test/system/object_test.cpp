@@ -26,6 +26,13 @@ limitations under the License.
 #include <approvals/Catch.hpp>
 #include <dot/system/object.hpp>
 #include <dot/system/string.hpp>
+#include <dot/system/bool.hpp>
+#include <dot/system/char.hpp>
+#include <dot/system/double.hpp>
+#include <dot/system/int.hpp>
+#include <dot/system/long.hpp>
+#include <dot/noda_time/local_date.hpp>
+#include <dot/noda_time/local_date_time.hpp>
 
 namespace dot
 {
@@ -53,4 +60,52 @@ namespace dot
         REQUIRE(a->hash_code() == b->hash_code());
         REQUIRE(a->hash_code() != c->hash_code());
     }
+
+    TEST_CASE("Size")
+    {
+        // Object header is the virtual table pointer and the reference count word
+        REQUIRE(sizeof(object_impl) == sizeof(void*) + 8);
+
+        // Boxed values derive from object_impl virtually, which adds one pointer
+        REQUIRE(sizeof(int_impl) <= sizeof(object_impl) + 2 * sizeof(void*));
+        REQUIRE(sizeof(double_impl) <= sizeof(object_impl) + sizeof(void*) + sizeof(double));
+        REQUIRE(sizeof(struct_wrapper_impl<local_date>) <= sizeof(object_impl) + 2 * sizeof(void*));
+
+        // Strings hold the cached hash code and the length, the characters follow in the same allocation
+        REQUIRE(sizeof(string_impl) == sizeof(object_impl) + sizeof(void*) + 2 * sizeof(size_t));
+
+        // Allocated size includes the allocation header that precedes each object
+        const size_t header_size = alignof(std::max_align_t);
+        REQUIRE(make_object()->allocated_size() == sizeof(object_impl) + header_size);
+        REQUIRE(object(new int_impl(1))->allocated_size() == sizeof(int_impl) + header_size);
+        REQUIRE(object(new double_impl(1e300))->allocated_size() == sizeof(double_impl) + header_size);
+        REQUIRE(object(new struct_wrapper_impl<local_date>(local_date()))->allocated_size() == sizeof(struct_wrapper_impl<local_date>) + header_size);
+    }
+
+    TEST_CASE("SizeReport", "[.benchmark]")
+    {
+        // Sizes before the compact object header were measured on 64-bit Linux
+        // with GCC, they are reported only when the current build is the same.
+        // Current sizes are reported both without and with the allocation header.
+        bool is_64_bit = sizeof(void*) == 8;
+        auto report = [is_64_bit](const char* name, size_t before, size_t after, object sample)
+        {
+            std::stringstream ss;
+            ss << std::left << std::setw(40) << name;
+            if (is_64_bit) ss << std::right << std::setw(8) << before;
+            ss << std::right << std::setw(8) << after;
+            ss << std::right << std::setw(8) << sample->allocated_size();
+            WARN(ss.str());
+        };
+
+        report("object_impl", 24, sizeof(object_impl), make_object());
+        report("bool_impl", 40, sizeof(bool_impl), new bool_impl(false));
+        report("char_impl", 40, sizeof(char_impl), new char_impl(0));
+        report("int_impl", 40, sizeof(int_impl), new int_impl(0));
+        report("long_impl", 40, sizeof(long_impl), new long_impl(0));
+        report("double_impl", 40, sizeof(double_impl), new double_impl(0.0));
+        report("string_impl", 64, sizeof(string_impl), make_string(""));
+        report("struct_wrapper_impl<local_date>", 56, sizeof(struct_wrapper_impl<local_date>), new struct_wrapper_impl<local_date>(local_date()));
+        report("struct_wrapper_impl<local_date_time>", 56, sizeof(struct_wrapper_impl<local_date_time>), new struct_wrapper_impl<local_date_time>(local_date_time()));
+    }
 }
@@ -26,6 +26,10 @@ limitations under the License.
 #include <approvals/Catch.hpp>
 #include <dot/system/string.hpp>
 #include <dot/system/object.hpp>
+#include <dot/system/borrowed_ptr.hpp>
+#include <dot/system/collections/generic/list.hpp>
+#include <dot/system/text/string_builder.hpp>
+#include <thread>
 
 namespace dot
 {
@@ -56,6 +60,77 @@ namespace dot
     using derived = ptr<derived_impl>;
     derived make_derived() { return new derived_impl; }
 
+    class reference_count_sample_impl : public virtual object_impl
+    {
+    public:
+
+        bool* deleted_;
+
+        reference_count_sample_impl(bool* deleted) : deleted_(deleted) {}
+
+        ~reference_count_sample_impl() { *deleted_ = true; }
+    };
+
+    using reference_count_sample = ptr<reference_count_sample_impl>;
+    reference_count_sample make_reference_count_sample(bool* deleted) { return new reference_count_sample_impl(deleted); }
+
+    class single_threaded_sample_impl : public virtual object_impl,
+        public reference_count_policy<reference_count_mode::single_threaded>
+    {
+    };
+
+    using single_threaded_sample = ptr<single_threaded_sample_impl>;
+    single_threaded_sample make_single_threaded_sample() { return new single_threaded_sample_impl; }
+
+    class interface_sample_impl : public virtual object_impl
+    {
+    public:
+
+        int interface_value_ = 1;
+    };
+
+    using interface_sample = ptr<interface_sample_impl>;
+
+    /// Derives from two classes so that casts to interface_sample_impl adjust the pointer.
+    class multiple_sample_impl : public derived_impl, public interface_sample_impl
+    {
+    };
+
+    using multiple_sample = ptr<multiple_sample_impl>;
+    multiple_sample make_multiple_sample() { return new multiple_sample_impl; }
+
+    /// Base repeated non-virtually in repeated_sample_impl.
+    class repeated_base_impl : public virtual object_impl
+    {
+    };
+
+    class repeated_left_impl : public repeated_base_impl
+    {
+    };
+
+    class repeated_right_impl : public repeated_base_impl
+    {
+    };
+
+    /// Contains two repeated_base_impl subobjects, so that casts from them to
+    /// repeated_left_impl have different offsets for the same dynamic type.
+    class repeated_sample_impl : public repeated_left_impl, public repeated_right_impl
+    {
+    };
+
+    /// Sample of a deep hierarchy in which every level inherits object_impl virtually.
+    template <int N>
+    class deep_sample_impl : public deep_sample_impl<N - 1>, public virtual object_impl
+    {
+    };
+
+    template <>
+    class deep_sample_impl<0> : public virtual object_impl
+    {
+    };
+
+    template <int N> using deep_sample = ptr<deep_sample_impl<N>>;
+
     TEST_CASE("Smoke")
     {
         base b = make_base();
@@ -106,4 +181,352 @@ namespace dot
         REQUIRE((base)d != nullptr);
         REQUIRE((derived)d != nullptr);
     }
+
+    TEST_CASE("Move")
+    {
+        derived d = make_derived();
+        REQUIRE(d->reference_count() == 1);
+
+        // Move constructor takes over the reference
+        derived d2 = std::move(d);
+        REQUIRE(d == nullptr);
+        REQUIRE(d2->reference_count() == 1);
+
+        // Move conversion from derived to base
+        base b = std::move(d2);
+        REQUIRE(d2 == nullptr);
+        REQUIRE(b->reference_count() == 1);
+        REQUIRE(b->foo() == "derived");
+
+        // Move assignment releases the previously held object
+        base b2 = make_base();
+        b2 = std::move(b);
+        REQUIRE(b == nullptr);
+        REQUIRE(b2->reference_count() == 1);
+        REQUIRE(b2->foo() == "derived");
+
+        // Self move leaves the pointer unchanged
+        base& b2_ref = b2;
+        b2 = std::move(b2_ref);
+        REQUIRE(b2->reference_count() == 1);
+
+        // Self copy assignment does not delete the object
+        b2 = b2_ref;
+        REQUIRE(b2->reference_count() == 1);
+
+        // Move into object and string
+        object obj = std::move(b2);
+        REQUIRE(b2 == nullptr);
+        REQUIRE(obj->reference_count() == 1);
+
+        string s = make_string("abc");
+        string s2 = std::move(s);
+        REQUIRE(s == nullptr);
+        REQUIRE(s2->reference_count() == 1);
+        REQUIRE(s2 == "abc");
+    }
+
+    TEST_CASE("Borrow")
+    {
+        derived d = make_derived();
+
+        // Borrowing does not change the reference count
+        borrowed_ptr<base_impl> b = d;
+        borrowed_ptr<object_impl> obj = b;
+        REQUIRE(d->reference_count() == 1);
+        REQUIRE(b->foo() == "derived");
+
+        // Cast to derived and is/as work as for ptr
+        borrowed_ptr<derived_impl> d2(obj);
+        REQUIRE(d2->reference_count() == 1);
+        REQUIRE(obj.is<derived>());
+        REQUIRE(obj.as<derived>() == d);
+
+        base b2_owner = make_base();
+        borrowed_ptr<base_impl> b2 = b2_owner;
+        CHECK_THROWS_AS(borrowed_ptr<derived_impl>(b2), std::runtime_error);
+
+        // Conversion to ptr takes a new reference
+        base owner = b;
+        REQUIRE(d->reference_count() == 2);
+
+        borrowed_ptr<base_impl> empty;
+        REQUIRE(empty.is_empty());
+        CHECK_THROWS_AS(empty->foo(), std::runtime_error);
+    }
+
+    TEST_CASE("ReferenceCountMode")
+    {
+        reference_count_mode default_mode = reference_counter::default_reference_count_mode();
+
+        reference_counter::set_default_reference_count_mode(reference_count_mode::atomic);
+        base atomic_obj = make_base();
+        REQUIRE(atomic_obj->get_reference_count_mode() == reference_count_mode::atomic);
+
+        reference_counter::set_default_reference_count_mode(reference_count_mode::biased);
+        base biased_obj = make_base();
+        REQUIRE(biased_obj->get_reference_count_mode() == reference_count_mode::biased);
+
+        // Policy takes precedence over the default mode
+        single_threaded_sample single_threaded_obj = make_single_threaded_sample();
+        REQUIRE(single_threaded_obj->get_reference_count_mode() == reference_count_mode::single_threaded);
+
+        reference_counter::set_default_reference_count_mode(default_mode);
+
+        for (object obj : { object(atomic_obj), object(biased_obj), object(single_threaded_obj) })
+        {
+            REQUIRE(obj->reference_count() == 3);
+            object copy = obj;
+            REQUIRE(obj->reference_count() == 4);
+            copy = nullptr;
+            REQUIRE(obj->reference_count() == 3);
+        }
+    }
+
+    TEST_CASE("BiasedReferenceCount")
+    {
+        reference_count_mode default_mode = reference_counter::default_reference_count_mode();
+        reference_counter::set_default_reference_count_mode(reference_count_mode::biased);
+
+        // Last reference released by another thread after the owner releases its references
+        bool deleted = false;
+        {
+            reference_count_sample obj = make_reference_count_sample(&deleted);
+            reference_count_sample copy;
+            std::thread([&obj, &copy]() { copy = obj; }).join();
+            obj = nullptr;
+            REQUIRE(!deleted);
+            std::thread([&copy]() { copy = nullptr; }).join();
+        }
+        REQUIRE(deleted);
+
+        // Release by another thread makes the shared count negative, the object
+        // is queued and merged by the owner
+        deleted = false;
+        {
+            reference_count_sample obj = make_reference_count_sample(&deleted);
+            reference_count_sample copy = obj;
+            std::thread([copy = std::move(copy)]() mutable { copy = nullptr; }).join();
+            REQUIRE(obj->reference_count() == 1);
+            reference_counter::merge_queued_reference_counts();
+            REQUIRE(obj->reference_count() == 1);
+            REQUIRE(!deleted);
+        }
+        REQUIRE(deleted);
+
+        // Queued object whose biased count reaches zero before the merge
+        deleted = false;
+        {
+            reference_count_sample obj = make_reference_count_sample(&deleted);
+            reference_count_sample copy = obj;
+            reference_count_sample other;
+            std::thread([&obj, &copy, &other]() { copy = nullptr; other = obj; }).join();
+            obj = nullptr;
+            other = nullptr;
+            REQUIRE(!deleted);
+            reference_counter::merge_queued_reference_counts();
+        }
+        REQUIRE(deleted);
+
+        // Object created by a thread that has exited
+        deleted = false;
+        {
+            reference_count_sample obj;
+            std::thread([&obj, &deleted]() { obj = make_reference_count_sample(&deleted); }).join();
+            REQUIRE(obj->get_reference_count_mode() == reference_count_mode::biased);
+            REQUIRE(!deleted);
+        }
+        REQUIRE(deleted);
+
+        // Concurrent copies in several threads
+        deleted = false;
+        {
+            reference_count_sample obj = make_reference_count_sample(&deleted);
+            std::vector<std::thread> threads;
+            for (int i = 0; i < 4; ++i)
+            {
+                threads.emplace_back([obj]()
+                {
+                    for (int j = 0; j < 10000; ++j)
+                    {
+                        reference_count_sample copy = obj;
+                    }
+                });
+            }
+            for (std::thread& thread : threads) thread.join();
+            reference_counter::merge_queued_reference_counts();
+            REQUIRE(obj->reference_count() == 1);
+        }
+        REQUIRE(deleted);
+
+        reference_counter::set_default_reference_count_mode(default_mode);
+    }
+
+    TEST_CASE("BiasedReferenceCountOverflow")
+    {
+        reference_count_mode default_mode = reference_counter::default_reference_count_mode();
+        reference_counter::set_default_reference_count_mode(reference_count_mode::biased);
+        base b = make_base();
+        reference_counter::set_default_reference_count_mode(default_mode);
+
+        // References beyond the capacity of the biased counter go to the shared counter
+        const int count = 3 << 19;
+        std::vector<base> copies(count, b);
+        REQUIRE(b->reference_count() == count + 1);
+
+        // Releasing the copies from another thread and then from the owner thread
+        std::thread([&copies, count]() { copies.resize(count / 2); }).join();
+        REQUIRE(b->reference_count() == count / 2 + 1);
+        copies.clear();
+        REQUIRE(b->reference_count() == 1);
+        REQUIRE(b->foo() == "base");
+    }
+
+    TEST_CASE("ReferenceCountBenchmark", "[.benchmark]")
+    {
+        reference_count_mode default_mode = reference_counter::default_reference_count_mode();
+        const int count = 1000000;
+
+        for (reference_count_mode mode : { reference_count_mode::atomic, reference_count_mode::biased, reference_count_mode::single_threaded })
+        {
+            reference_counter::set_default_reference_count_mode(mode);
+            std::string suffix = mode == reference_count_mode::atomic ? " (atomic)"
+                : mode == reference_count_mode::biased ? " (biased)" : " (single_threaded)";
+
+            BENCHMARK("Boxing" + suffix)
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    object obj = i;
+                    object copy = obj;
+                    int value = copy;
+                }
+            }
+
+            BENCHMARK("List churn" + suffix)
+            {
+                list<object> items = make_list<object>();
+                for (int i = 0; i < count; ++i)
+                {
+                    items->add(i);
+                    if (items->count() == 1000) items->clear();
+                }
+            }
+
+            BENCHMARK("String building" + suffix)
+            {
+                for (int i = 0; i < count / 100; ++i)
+                {
+                    string_builder builder = make_string_builder();
+                    for (int j = 0; j < 100; ++j)
+                    {
+                        string part = make_string("abc");
+                        builder->append(part);
+                    }
+                    string result = builder->to_string();
+                }
+            }
+        }
+
+        reference_counter::set_default_reference_count_mode(default_mode);
+    }
+
+    TEST_CASE("CastCache")
+    {
+        // Cast to the second base requires pointer adjustment, repeat to use the cached offset
+        for (int i = 0; i < 3; ++i)
+        {
+            object obj = make_multiple_sample();
+            REQUIRE(obj.is<interface_sample>());
+            REQUIRE(obj.as<interface_sample>()->interface_value_ == 1);
+            REQUIRE(interface_sample(obj)->interface_value_ == 1);
+            REQUIRE(obj.as<interface_sample>().operator->() == dynamic_cast<interface_sample_impl*>(&*obj));
+
+            // Cross cast between the two bases
+            base b = obj.as<base>();
+            REQUIRE(b->foo() == "derived");
+            REQUIRE(b.as<interface_sample>()->interface_value_ == 1);
+            REQUIRE(interface_sample(b).operator->() == dynamic_cast<interface_sample_impl*>(&*obj));
+        }
+
+        // Failed cast is cached for the dynamic type
+        for (int i = 0; i < 3; ++i)
+        {
+            object obj = make_derived();
+            REQUIRE(!obj.is<interface_sample>());
+            REQUIRE(obj.as<interface_sample>() == nullptr);
+            CHECK_THROWS_AS(interface_sample(obj), std::runtime_error);
+        }
+
+        // Cast from a repeated base depends on the subobject, not only on the dynamic type
+        ptr<repeated_sample_impl> repeated = new repeated_sample_impl;
+        repeated_left_impl* left = &*repeated;
+        repeated_right_impl* right = &*repeated;
+        repeated_base_impl* left_base = left;
+        repeated_base_impl* right_base = right;
+        for (int i = 0; i < 3; ++i)
+        {
+            REQUIRE(detail::fast_cast<repeated_left_impl>(left_base) == left);
+            REQUIRE(detail::fast_cast<repeated_left_impl>(right_base) == left);
+            REQUIRE(detail::fast_cast<repeated_right_impl>(left_base) == right);
+        }
+
+        // Null pointer casts to null
+        object empty;
+        REQUIRE(!empty.is<base>());
+        REQUIRE(empty.as<base>() == nullptr);
+    }
+
+    TEST_CASE("CastBenchmark", "[.benchmark]")
+    {
+        const int count = 10000000;
+        object hit = make_multiple_sample();
+        object miss = make_base();
+        object deep = new deep_sample_impl<8>();
+        object_impl* hit_ptr = &*hit;
+        object_impl* miss_ptr = &*miss;
+        object_impl* deep_ptr = &*deep;
+
+        BENCHMARK("Hit (dynamic_cast)")
+        {
+            int found = 0;
+            for (int i = 0; i < count; ++i) found += dynamic_cast<interface_sample_impl*>(hit_ptr) != nullptr;
+            REQUIRE(found == count);
+        }
+
+        BENCHMARK("Hit (is)")
+        {
+            int found = 0;
+            for (int i = 0; i < count; ++i) found += hit.is<interface_sample>();
+            REQUIRE(found == count);
+        }
+
+        BENCHMARK("Miss (dynamic_cast)")
+        {
+            int found = 0;
+            for (int i = 0; i < count; ++i) found += dynamic_cast<derived_impl*>(miss_ptr) != nullptr;
+            REQUIRE(found == 0);
+        }
+
+        BENCHMARK("Miss (is)")
+        {
+            int found = 0;
+            for (int i = 0; i < count; ++i) found += miss.is<derived>();
+            REQUIRE(found == 0);
+        }
+
+        BENCHMARK("Deep hierarchy (dynamic_cast)")
+        {
+            int found = 0;
+            for (int i = 0; i < count; ++i) found += dynamic_cast<deep_sample_impl<1>*>(deep_ptr) != nullptr;
+            REQUIRE(found == count);
+        }
+
+        BENCHMARK("Deep hierarchy (is)")
+        {
+            int found = 0;
+            for (int i = 0; i < count; ++i) found += deep.is<deep_sample<1>>();
+            REQUIRE(found == count);
+        }
+    }
 }
@@ -128,4 +128,144 @@ namespace dot
         //Approvals::verify(received.str());
         received.clear();
     }
+    class reflection_invoke_sample_impl; using reflection_invoke_sample = ptr<reflection_invoke_sample_impl>;
+    reflection_invoke_sample make_reflection_invoke_sample();
+
+    class reflection_invoke_sample_impl : public virtual object_impl
+    {
+        typedef reflection_invoke_sample_impl self;
+
+    public: // FIELDS
+
+        /// Reference count observed inside the last reflected call.
+        int observed_reference_count = 0;
+
+    public: // METHODS
+
+        int sample_method(int param)
+        {
+            observed_reference_count = reference_count();
+            return 42 + param;
+        }
+
+        DOT_TYPE_BEGIN("System.Test", "reflection_invoke_sample")
+            DOT_TYPE_CTOR(make_reflection_invoke_sample)
+            ->with_field("observed_reference_count", &self::observed_reference_count)
+            DOT_TYPE_METHOD(sample_method, "param")
+        DOT_TYPE_END()
+    };
+
+    reflection_invoke_sample make_reflection_invoke_sample() { return new reflection_invoke_sample_impl; }
+
+    TEST_CASE("invoke_reference_count")
+    {
+        reflection_invoke_sample obj = make_reflection_invoke_sample();
+        list<object> params = make_list<object>(1);
+        params[0] = 15;
+
+        // Reflected call should not take additional references to the
+        // instance, each of which costs an atomic increment and decrement
+        method_info method = obj->get_type()->get_method("sample_method");
+        REQUIRE(int(method->invoke(obj, params)) == 42 + 15);
+        REQUIRE(obj->observed_reference_count == 1);
+
+        field_info field = obj->get_type()->get_field("observed_reference_count");
+        REQUIRE(int(field->get_value(obj)) == 1);
+        field->set_value(obj, 7);
+        REQUIRE(obj->observed_reference_count == 7);
+        REQUIRE(obj->reference_count() == 1);
+    }
+
+    TEST_CASE("invoke_benchmark", "[.benchmark]")
+    {
+        reflection_invoke_sample obj = make_reflection_invoke_sample();
+        list<object> params = make_list<object>(1);
+        params[0] = 15;
+        method_info method = obj->get_type()->get_method("sample_method");
+        field_info field = obj->get_type()->get_field("observed_reference_count");
+        const int count = 1000000;
+
+        BENCHMARK("method_info::invoke")
+        {
+            for (int i = 0; i < count; ++i) method->invoke(obj, params);
+        }
+
+        BENCHMARK("field_info::get_value")
+        {
+            for (int i = 0; i < count; ++i) field->get_value(obj);
+        }
+
+        // Each additional owning reference taken during the call
+        // is one atomic increment and one atomic decrement
+        WARN("Atomic RMW operations on the instance per invoke: " << 2 * (obj->observed_reference_count - 1));
+    }
+
+    class hierarchy_root_sample_impl; using hierarchy_root_sample = ptr<hierarchy_root_sample_impl>;
+    class hierarchy_middle_sample_impl; using hierarchy_middle_sample = ptr<hierarchy_middle_sample_impl>;
+    class hierarchy_leaf_sample_impl; using hierarchy_leaf_sample = ptr<hierarchy_leaf_sample_impl>;
+    class hierarchy_sibling_sample_impl; using hierarchy_sibling_sample = ptr<hierarchy_sibling_sample_impl>;
+
+    class hierarchy_root_sample_impl : public virtual object_impl
+    {
+        typedef hierarchy_root_sample_impl self;
+
+        DOT_TYPE_BEGIN("System.Test", "hierarchy_root_sample")
+        DOT_TYPE_END()
+    };
+
+    class hierarchy_middle_sample_impl : public hierarchy_root_sample_impl
+    {
+        typedef hierarchy_middle_sample_impl self;
+
+        DOT_TYPE_BEGIN("System.Test", "hierarchy_middle_sample")
+            DOT_TYPE_BASE(hierarchy_root_sample)
+        DOT_TYPE_END()
+    };
+
+    class hierarchy_leaf_sample_impl : public hierarchy_middle_sample_impl
+    {
+        typedef hierarchy_leaf_sample_impl self;
+
+        DOT_TYPE_BEGIN("System.Test", "hierarchy_leaf_sample")
+            DOT_TYPE_BASE(hierarchy_middle_sample)
+        DOT_TYPE_END()
+    };
+
+    class hierarchy_sibling_sample_impl : public hierarchy_root_sample_impl
+    {
+        typedef hierarchy_sibling_sample_impl self;
+
+        DOT_TYPE_BEGIN("System.Test", "hierarchy_sibling_sample")
+            DOT_TYPE_BASE(hierarchy_root_sample)
+        DOT_TYPE_END()
+    };
+
+    TEST_CASE("type_hierarchy")
+    {
+        // Derived types are registered first, their bases are registered by with_base
+        type leaf = typeof<hierarchy_leaf_sample>();
+        type sibling = typeof<hierarchy_sibling_sample>();
+        type middle = typeof<hierarchy_middle_sample>();
+        type root = typeof<hierarchy_root_sample>();
+
+        REQUIRE(leaf->is_subclass_of(middle));
+        REQUIRE(leaf->is_subclass_of(root));
+        REQUIRE(middle->is_subclass_of(root));
+        REQUIRE(sibling->is_subclass_of(root));
+        REQUIRE(!leaf->is_subclass_of(leaf));
+        REQUIRE(!root->is_subclass_of(leaf));
+        REQUIRE(!leaf->is_subclass_of(sibling));
+        REQUIRE(!sibling->is_subclass_of(middle));
+        REQUIRE(!leaf->is_subclass_of(typeof<string>()));
+
+        list<type> derived = type_impl::get_derived_types(root);
+        REQUIRE(derived->count() == 3);
+        REQUIRE(derived->contains(middle));
+        REQUIRE(derived->contains(leaf));
+        REQUIRE(derived->contains(sibling));
+
+        REQUIRE(type_impl::get_derived_types("System.Test.hierarchy_middle_sample")->count() == 1);
+        REQUIRE(type_impl::get_derived_types(leaf) == nullptr);
+        REQUIRE(type_impl::get_derived_types("System.Test.unknown_sample") == nullptr);
+    }
 }
@@ -0,0 +1,154 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/test/implement.hpp>
+#include <approvals/ApprovalTests.hpp>
+#include <approvals/Catch.hpp>
+#include <dot/system/string_comparer.hpp>
+#include <dot/system/object.hpp>
+#include <dot/system/collections/generic/dictionary.hpp>
+#include <dot/system/collections/generic/hash_set.hpp>
+#include <dot/detail/string_kernels.hpp>
+
+namespace dot
+{
+    TEST_CASE("Ordinal")
+    {
+        typedef string_comparer::ordinal comparer;
+        REQUIRE(comparer::equals("abc", make_string("abc")));
+        REQUIRE(!comparer::equals("abc", "ABC"));
+        REQUIRE(comparer::equals(string(), string()));
+        REQUIRE(!comparer::equals(string(), ""));
+        REQUIRE(comparer::hash_code("abc") == make_string("abc")->hash_code());
+        REQUIRE(comparer::compare("abc", "abd") < 0);
+        REQUIRE(comparer::compare("b", "abc") > 0);
+        REQUIRE(comparer::compare(string(), "") < 0);
+        REQUIRE(comparer::compare(string(), string()) == 0);
+    }
+
+    TEST_CASE("OrdinalIgnoreCase")
+    {
+        typedef string_comparer::ordinal_ignore_case comparer;
+
+        // Compare all instruction sets against each other
+        std::vector<detail::simd_level> levels = { detail::simd_level::scalar };
+        if (detail::supported_simd_level() >= detail::simd_level::sse2) levels.push_back(detail::simd_level::sse2);
+        if (detail::supported_simd_level() >= detail::simd_level::avx2) levels.push_back(detail::simd_level::avx2);
+        detail::simd_level original = detail::get_simd_level();
+
+        std::string long_value;
+        for (int i = 0; i < 10; ++i) long_value += "Symbol.Identifier_";
+        std::string long_upper = long_value;
+        for (char& c : long_upper) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+
+        std::vector<size_t> hashes;
+        for (detail::simd_level level : levels)
+        {
+            detail::set_simd_level(level);
+
+            REQUIRE(comparer::equals("Symbol", "sYMBOL"));
+            REQUIRE(!comparer::equals("Symbol", "Symbol1"));
+            REQUIRE(!comparer::equals("a[", "A{"));
+            REQUIRE(comparer::equals(long_value, long_upper));
+            REQUIRE(!comparer::equals(long_value, long_upper + "X"));
+            REQUIRE(comparer::hash_code(long_value) == comparer::hash_code(long_upper));
+            REQUIRE(comparer::hash_code("abc") != comparer::hash_code("abd"));
+            REQUIRE(comparer::compare("abc", "ABD") < 0);
+            REQUIRE(comparer::compare("ABC", "abc") == 0);
+            REQUIRE(comparer::compare("abc", "AB") > 0);
+            REQUIRE(comparer::compare("_", "a") > 0); // Compared as uppercase, '_' follows 'A'
+            REQUIRE(comparer::compare(string(), "") < 0);
+            hashes.push_back(comparer::hash_code(long_value));
+
+            // Non-ASCII characters, including those equal to ASCII letters ignoring case
+            REQUIRE(comparer::equals("\xc3\xa9t\xc3\xa9", "\xc3\x89T\xc3\x89"));
+            REQUIRE(comparer::hash_code("\xc3\xa9t\xc3\xa9") == comparer::hash_code("\xc3\x89T\xc3\x89"));
+            REQUIRE(comparer::equals("\xc5\xbf", "s"));
+            REQUIRE(comparer::hash_code("\xc5\xbf") == comparer::hash_code("S"));
+            REQUIRE(comparer::compare("\xc3\xa9", "\xc3\x89") == 0);
+            REQUIRE(comparer::compare("\xc3\xa9", "f") > 0);
+        }
+        detail::set_simd_level(original);
+
+        // Hash codes do not depend on the instruction set
+        for (size_t hash : hashes) REQUIRE(hash == hashes.front());
+    }
+
+    TEST_CASE("ComparerCollections")
+    {
+        typedef string_comparer::ordinal_ignore_case comparer;
+
+        dictionary<string, int, comparer, comparer> dict = make_dictionary<string, int, comparer, comparer>();
+        dict->add("EUR", 1);
+        dict->add("usd", 2);
+        REQUIRE(dict->contains_key("eur"));
+        REQUIRE(dict["USD"] == 2);
+        REQUIRE_THROWS(dict->add("Eur", 3));
+
+        hash_set<string, comparer, comparer> set = make_hash_set<string, comparer, comparer>();
+        set->add("Symbol");
+        set->add("SYMBOL");
+        REQUIRE(set->count() == 1);
+        REQUIRE(set->contains("symbol"));
+    }
+
+    TEST_CASE("ComparerBenchmark", "[.benchmark]")
+    {
+        typedef string_comparer::ordinal_ignore_case comparer;
+
+        const int count = 1000;
+        std::vector<string> keys;
+        std::vector<string> probes;
+        for (int i = 0; i < count; ++i)
+        {
+            std::string key = "Exchange.Symbol." + std::to_string(i);
+            keys.push_back(make_string(key));
+            for (char& c : key) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            probes.push_back(make_string(key));
+        }
+
+        dictionary<string, int> lowered = make_dictionary<string, int>();
+        dictionary<string, int, comparer, comparer> ignore_case = make_dictionary<string, int, comparer, comparer>();
+        for (int i = 0; i < count; ++i)
+        {
+            lowered->add(keys[i]->to_lower(), i);
+            ignore_case->add(keys[i], i);
+        }
+
+        BENCHMARK("Lookup of to_lower() copy")
+        {
+            int found = 0;
+            for (int repeat = 0; repeat < 100; ++repeat)
+                for (const string& probe : probes) found += lowered->contains_key(probe->to_lower());
+            REQUIRE(found == 100 * count);
+        }
+
+        BENCHMARK("Lookup with ordinal_ignore_case")
+        {
+            int found = 0;
+            for (int repeat = 0; repeat < 100; ++repeat)
+                for (const string& probe : probes) found += ignore_case->contains_key(probe);
+            REQUIRE(found == 100 * count);
+        }
+    }
+}
@@ -0,0 +1,138 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/test/implement.hpp>
+#include <approvals/ApprovalTests.hpp>
+#include <approvals/Catch.hpp>
+#include <dot/system/string.hpp>
+#include <dot/system/string_slice.hpp>
+#include <dot/system/exception.hpp>
+#include <dot/system/object.hpp>
+#include <dot/system/collections/generic/list.hpp>
+#include <unordered_set>
+
+namespace dot
+{
+    TEST_CASE("StringSlice")
+    {
+        string s = make_string("abc,def,ghi");
+        REQUIRE(s->reference_count() == 1);
+
+        // Slices share the storage of the parent
+        string_slice slice = s->slice(4, 3);
+        REQUIRE(slice == "def");
+        REQUIRE(slice.data() == s->data() + 4);
+        REQUIRE(slice.offset() == 4);
+        REQUIRE(slice.parent() == s);
+        REQUIRE(s->reference_count() == 2);
+
+        // Slice of a slice shares the same parent
+        string_slice inner = slice.slice(1);
+        REQUIRE(inner == "ef");
+        REQUIRE(inner != "def");
+
+        // Slice is not equal to null, including an empty slice
+        const char* null_text = nullptr;
+        REQUIRE(!(slice == null_text));
+        REQUIRE(slice != null_text);
+        REQUIRE(!(slice.slice(3) == null_text));
+        REQUIRE(inner.offset() == 5);
+        REQUIRE(s->reference_count() == 3);
+
+        // Slice keeps the parent alive
+        const string_impl* parent = &*s;
+        s = string();
+        REQUIRE(&*slice.parent() == parent);
+        REQUIRE(slice.parent()->reference_count() == 2);
+
+        // Interop with std::string_view
+        std::string_view view = slice;
+        REQUIRE(view == "def");
+        REQUIRE(std::string(slice.begin(), slice.end()) == "def");
+
+        // Materialized string does not refer to the parent
+        string copy = slice.materialize();
+        REQUIRE(copy == "def");
+        REQUIRE(copy->data() != slice.data());
+        REQUIRE(slice.parent()->reference_count() == 2);
+
+        // Slice of the entire string materializes to the parent
+        string whole = make_string("xyz");
+        REQUIRE(string_slice(whole).materialize() == whole);
+        REQUIRE(&*string_slice(whole).materialize() == &*whole);
+
+        // Empty slices
+        REQUIRE(string_slice().empty());
+        REQUIRE(string_slice().materialize() == "");
+        REQUIRE(string_slice(string()).empty());
+        REQUIRE(whole->slice(3, 0).empty());
+
+        // Range checks
+        CHECK_THROWS_AS(whole->slice(2, 2), exception);
+        CHECK_THROWS_AS(whole->slice(4, 0), exception);
+        CHECK_THROWS_AS(string_slice(whole).slice(4), exception);
+
+        // Hashing and comparison by value
+        std::unordered_set<string_slice> set;
+        set.insert(make_string("ab,ab")->slice(0, 2));
+        set.insert(make_string("ab,ab")->slice(3, 2));
+        REQUIRE(set.size() == 1);
+        REQUIRE(make_string("a")->slice(0, 1) < make_string("b")->slice(0, 1));
+    }
+
+    TEST_CASE("StringSliceTokenize")
+    {
+        // Delimited fields
+        string line = make_string("id, name ,,value");
+        string_slice remaining = line;
+        std::vector<std::string> fields;
+        while (!remaining.empty())
+        {
+            string_slice field = remaining.take_token(',');
+            REQUIRE(field.parent() == line);
+            fields.push_back(std::string(field.trim().view()));
+        }
+        REQUIRE(fields == std::vector<std::string>{ "id", "name", "", "value" });
+
+        // Fixed-width fields
+        string record = make_string("AAPL  0000150.25");
+        REQUIRE(string_slice(record).slice(0, 6).trim() == "AAPL");
+        REQUIRE(string_slice(record).slice(6) == "0000150.25");
+        REQUIRE(string_slice(record).slice(6).starts_with("0000"));
+        REQUIRE(string_slice(record).ends_with(".25"));
+
+        // Trim removes the same white space as string::trim regardless of the locale
+        string padded = make_string(" \t\n\v\f\r\xa0value\xa0\r\n ");
+        REQUIRE(string_slice(padded).trim() == "\xa0value\xa0");
+        REQUIRE(string_slice(padded).trim() == std::string_view(padded->trim()->view()));
+
+        // Split copies each field into a new string
+        list<string> parts = make_string("a,,b,")->split(',');
+        REQUIRE(parts->count() == 4);
+        REQUIRE(parts[0] == "a");
+        REQUIRE(parts[1] == "");
+        REQUIRE(parts[2] == "b");
+        REQUIRE(parts[3] == "");
+        REQUIRE(make_string("")->split(',')->count() == 1);
+    }
+}
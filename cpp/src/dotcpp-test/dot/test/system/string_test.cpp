@@ -26,6 +26,13 @@ limitations under the License.
 #include <approvals/Catch.hpp>
 #include <dot/system/string.hpp>
 #include <dot/system/object.hpp>
+#include <dot/system/type.hpp>
+#include <dot/system/collections/generic/dictionary.hpp>
+#include <dot/system/collections/generic/list.hpp>
+#include <dot/system/string_split_options.hpp>
+#include <dot/detail/string_kernels.hpp>
+#include <random>
+#include <thread>
 
 namespace dot
 {
@@ -100,4 +107,423 @@ namespace dot
         // TODO - fix by implemnenting Equals(...) REQUIRE((object)str == str2);
         // TODO - fix by implemnenting Equals(...) REQUIRE((object)str == (object)str2);
     }
+
+    /// Accepts std::string to check that existing code passing *s still compiles.
+    static size_t string_test_std_string_length(const std::string& value) { return value.size(); }
+
+    TEST_CASE("Layout")
+    {
+        // Characters follow the object in the same allocation
+        std::string long_value(1000, 'x');
+        string s = make_string(long_value);
+        REQUIRE(s->length() == 1000);
+        REQUIRE(s->data() == reinterpret_cast<const char*>(&*s + 1));
+        REQUIRE(s->c_str()[1000] == 0);
+        REQUIRE(s == long_value);
+
+        string empty = make_string("");
+        REQUIRE(empty->empty());
+        REQUIRE(empty->c_str()[0] == 0);
+        REQUIRE(make_string(nullptr)->empty());
+
+        // Methods that create strings
+        string a = make_string("abc");
+        string b = make_string("def");
+        REQUIRE(string(a + b) == "abcdef");
+        REQUIRE(string(a + "") == "abc");
+        REQUIRE((a + b)->substring(2, 3) == "cde");
+        REQUIRE((a + b)->remove(2) == "ab");
+        REQUIRE((a + b)->remove(2, 3) == "abf");
+        REQUIRE((a + b)->remove(2, 100) == "ab");
+        REQUIRE(make_string("a.b.c")->replace('.', '/') == "a/b/c");
+        REQUIRE(string::format("{0}-{1}", a, 42) == "abc-42");
+        REQUIRE(string::format(make_string(long_value) + "{0}", 1)->length() == 1001);
+        REQUIRE((a + b)->starts_with("abc"));
+        REQUIRE((a + b)->ends_with("def"));
+        REQUIRE(!a->ends_with("abcd"));
+
+        // Migration path for code that used *s as std::string
+        std::string copy = *a;
+        std::string_view view = *a;
+        REQUIRE(copy == "abc");
+        REQUIRE(view == "abc");
+        REQUIRE(string_test_std_string_length(*a) == 3);
+        REQUIRE(a->find('c') == 2);
+        REQUIRE(a->substr(1) == "bc");
+        REQUIRE(*a < *b);
+        std::stringstream stream;
+        stream << *a;
+        REQUIRE(stream.str() == "abc");
+    }
+
+    /// Instruction sets supported by the processor and the build.
+    static std::vector<detail::simd_level> string_test_simd_levels()
+    {
+        std::vector<detail::simd_level> result;
+        for (int level = 0; level <= static_cast<int>(detail::supported_simd_level()); ++level)
+            result.push_back(static_cast<detail::simd_level>(level));
+        return result;
+    }
+
+    TEST_CASE("Search")
+    {
+        detail::simd_level original = detail::get_simd_level();
+        for (detail::simd_level level : string_test_simd_levels())
+        {
+            detail::set_simd_level(level);
+            REQUIRE(detail::get_simd_level() == level);
+
+            // Compare kernels with std::string_view for all positions and lengths
+            // that cross the 16 and 32 byte vector boundaries
+            std::mt19937 random(12345);
+            for (size_t size = 0; size < 80; ++size)
+            {
+                std::string value(size, 'a');
+                for (char& c : value) c = "abcA.,"[random() % 6];
+                std::string_view view = value;
+
+                for (char c : std::string("abcA.,x"))
+                {
+                    REQUIRE(detail::find_byte(value.data(), size, c) == view.find(c));
+                    REQUIRE(detail::find_last_byte(value.data(), size, c) == view.rfind(c));
+                }
+                REQUIRE(detail::find_any_byte(value.data(), size, ".,", 2) == view.find_first_of(".,"));
+                REQUIRE(detail::find_any_byte(value.data(), size, "xyz.,A0123", 10) == view.find_first_of("xyz.,A0123"));
+
+                for (size_t count = 0; count < 5 && count <= size; ++count)
+                {
+                    std::string needle = value.substr((size - count) / 2, count);
+                    REQUIRE(detail::find_bytes(value.data(), size, needle.data(), count) == view.find(needle));
+                    REQUIRE(detail::find_last_bytes(value.data(), size, needle.data(), count) == view.rfind(needle));
+                }
+                REQUIRE(detail::find_bytes(value.data(), size, "abcabc,", 7) == view.find("abcabc,"));
+
+                std::string lower(size, 0), upper(size, 0);
+                detail::to_lower_ascii(value.data(), lower.data(), size);
+                detail::to_upper_ascii(value.data(), upper.data(), size);
+                for (size_t i = 0; i < size; ++i)
+                {
+                    REQUIRE(lower[i] == std::tolower(value[i]));
+                    REQUIRE(upper[i] == std::toupper(value[i]));
+                }
+            }
+
+            // Bytes of multibyte UTF-8 characters are not changed
+            string utf8 = make_string("Stra\xc3\x9f" "e \xc3\x84pfel ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz");
+            REQUIRE(utf8->to_lower() == "stra\xc3\x9f" "e \xc3\x84pfel abcdefghijklmnopqrstuvwxyz abcdefghijklmnopqrstuvwxyz");
+            REQUIRE(utf8->to_upper() == "STRA\xc3\x9f" "E \xc3\x84PFEL ABCDEFGHIJKLMNOPQRSTUVWXYZ ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+        }
+        detail::set_simd_level(original);
+
+        string s = make_string("The quick brown fox jumps over the lazy dog");
+        REQUIRE(s->index_of('q') == 4);
+        REQUIRE(s->index_of('z') == 37);
+        REQUIRE(s->index_of('!') == -1);
+        REQUIRE(s->index_of('o', 13) == 17);
+        REQUIRE(s->index_of(make_string("the")) == 31);
+        REQUIRE(s->index_of(make_string("The"), 1) == -1);
+        REQUIRE(s->index_of(make_string("")) == 0);
+        REQUIRE(s->last_index_of('o') == 41);
+        REQUIRE(s->last_index_of(make_string("o")) == 41);
+        REQUIRE(s->last_index_of(make_string("The")) == 0);
+        REQUIRE(s->contains("lazy"));
+        REQUIRE(!s->contains("Lazy"));
+        REQUIRE(s->index_of_any(make_list<char>({ 'x', 'j' })) == 18);
+        REQUIRE(s->index_of_any(make_list<char>({ '!' })) == -1);
+        CHECK_THROWS_AS(s->index_of('a', 100), exception);
+
+        REQUIRE(make_string("abc")->compare_to("abd") == -1);
+        REQUIRE(make_string("abc")->compare_to("abc") == 0);
+        REQUIRE(make_string("abc")->compare_to("ab") == 1);
+        REQUIRE(make_string("")->compare_to(string()) == 1);
+
+        REQUIRE(make_string("a-b-c")->replace("-", "--") == "a--b--c");
+        REQUIRE(make_string("a-b-c")->replace("-", string()) == "abc");
+        REQUIRE(make_string("aaaa")->replace("aa", "b") == "bb");
+        REQUIRE(make_string("abc")->replace("x", "y") == "abc");
+        CHECK_THROWS_AS(make_string("abc")->replace("", "y"), exception);
+
+        REQUIRE(make_string("  \t abc \r\n")->trim() == "abc");
+        REQUIRE(make_string("   ")->trim() == "");
+        string trimmed = make_string("abc");
+        REQUIRE(&*trimmed->trim() == &*trimmed);
+
+        list<string> parts = make_string("a, b,,c;d")->split(make_list<string>({ ",", ", ", ";" }), string_split_options::None);
+        REQUIRE(parts->count() == 5);
+        REQUIRE(parts[0] == "a");
+        REQUIRE(parts[1] == " b");
+        REQUIRE(parts[2] == "");
+        REQUIRE(parts[3] == "c");
+        REQUIRE(parts[4] == "d");
+
+        parts = make_string("a, b,,c;d")->split(make_list<string>({ ", ", ",", ";" }), string_split_options::RemoveEmptyEntries);
+        REQUIRE(parts->count() == 4);
+        REQUIRE(parts[1] == "b");
+
+        parts = make_string(" a \tb\n")->split(list<string>(), string_split_options::RemoveEmptyEntries);
+        REQUIRE(parts->count() == 2);
+        REQUIRE(parts[0] == "a");
+        REQUIRE(parts[1] == "b");
+    }
+
+    TEST_CASE("Concat")
+    {
+        string a = make_string("abc");
+        string b = make_string("def");
+        std::string c = "ghi";
+
+        // Expressions with any number of operands are converted to string once
+        string s = a + "." + b + std::string_view("/") + c;
+        REQUIRE(s == "abc.def/ghi");
+        REQUIRE(string("<" + a + ">") == "<abc>");
+        REQUIRE(("<" + a + ">" == "<abc>"));
+        REQUIRE(string(c + a) == "ghiabc");
+        REQUIRE((a + b + a)->length() == 9);
+        REQUIRE(string::intern(a + "." + b) == "abc.def");
+        REQUIRE(string(a + string() + "") == "abc");
+
+        std::ostringstream stream;
+        stream << a + "-" + b;
+        REQUIRE(stream.str() == "abc-def");
+
+        // Expressions convert to object, and cannot be copied or used after they are stored
+        object o = a + "-" + b;
+        REQUIRE(o.is<string>());
+        REQUIRE((string)o == "abc-def");
+        typedef decltype(a + b) concat_type;
+        static_assert(!std::is_copy_constructible<concat_type>::value);
+        static_assert(!std::is_move_constructible<concat_type>::value);
+        static_assert(std::is_convertible<concat_type, string>::value);
+        static_assert(!std::is_convertible<concat_type&, string>::value);
+        static_assert(!std::is_convertible<const concat_type&, object>::value);
+
+        // Static methods use a single allocation for all operands
+        REQUIRE(string::concat(a, ".", b, c) == "abc.defghi");
+        REQUIRE(string::concat() == "");
+        list<string> parts = make_list<string>({ "x", "y", string(), "z" });
+        REQUIRE(string::concat(parts) == "xyz");
+        REQUIRE(string::join(", ", parts) == "x, y, , z");
+        REQUIRE(string::join('/', parts) == "x/y//z");
+        REQUIRE(string::join(string(), parts) == "xyz");
+        REQUIRE(string::join(",", make_list<string>()) == "");
+        REQUIRE_THROWS(string::join(",", list<string>()));
+    }
+
+    TEST_CASE("ConcatBenchmark", "[.benchmark]")
+    {
+        string name_space = make_string("Namespace.Nested");
+        string name = make_string("TypeName");
+        const int repeat = 100000;
+
+        BENCHMARK("Pairwise operator+")
+        {
+            size_t length = 0;
+            for (int i = 0; i < repeat; ++i)
+            {
+                string s = name_space;
+                s = s + ".";
+                s = s + name;
+                s = s + ".";
+                s = s + name;
+                length += s->length();
+            }
+            REQUIRE(length > 0);
+        }
+
+        BENCHMARK("Concatenation expression")
+        {
+            size_t length = 0;
+            for (int i = 0; i < repeat; ++i)
+            {
+                string s = name_space + "." + name + "." + name;
+                length += s->length();
+            }
+            REQUIRE(length > 0);
+        }
+    }
+
+    TEST_CASE("SearchBenchmark", "[.benchmark]")
+    {
+        // Line of a log file with the field searched for near the end
+        std::string line;
+        while (line.size() < 200) line += "2019-05-01 12:00:00.000 INFO  trade=12345 book=EQ-LDN ";
+        line += "status=REJECTED";
+        string s = make_string(line);
+        string needle = make_string("status=");
+        const int repeat = 10000;
+
+        BENCHMARK("Naive index_of(char)")
+        {
+            size_t found = 0;
+            for (int i = 0; i < repeat; ++i)
+            {
+                const char* data = s->data();
+                size_t pos = 0;
+                while (pos < s->length() && data[pos] != 'R') ++pos;
+                found += pos;
+            }
+            REQUIRE(found > 0);
+        }
+
+        BENCHMARK("Naive index_of(string)")
+        {
+            size_t found = 0;
+            for (int i = 0; i < repeat; ++i)
+            {
+                const char* data = s->data();
+                size_t pos = 0;
+                while (pos + needle->length() <= s->length() && std::memcmp(data + pos, needle->data(), needle->length()) != 0) ++pos;
+                found += pos;
+            }
+            REQUIRE(found > 0);
+        }
+
+        BENCHMARK("Naive to_upper")
+        {
+            std::string upper(line.size(), 0);
+            for (int i = 0; i < repeat; ++i)
+            {
+                for (size_t j = 0; j < line.size(); ++j) upper[j] = char(std::toupper(line[j]));
+            }
+            REQUIRE(upper.size() == line.size());
+        }
+
+        detail::simd_level original = detail::get_simd_level();
+        for (detail::simd_level level : string_test_simd_levels())
+        {
+            detail::set_simd_level(level);
+            std::string name = level == detail::simd_level::avx2 ? "AVX2" : level == detail::simd_level::sse2 ? "SSE2" : "Scalar";
+
+            BENCHMARK(name + " index_of(char)")
+            {
+                int found = 0;
+                for (int i = 0; i < repeat; ++i) found += s->index_of('R');
+                REQUIRE(found > 0);
+            }
+
+            BENCHMARK(name + " index_of(string)")
+            {
+                int found = 0;
+                for (int i = 0; i < repeat; ++i) found += s->index_of(needle);
+                REQUIRE(found > 0);
+            }
+
+            BENCHMARK(name + " to_upper")
+            {
+                for (int i = 0; i < repeat; ++i) s->to_upper();
+            }
+        }
+        detail::set_simd_level(original);
+    }
+
+    TEST_CASE("HashCode")
+    {
+        string a = make_string("hash code");
+        string b = make_string("hash code");
+        string c = make_string("other");
+
+        // Cached value is returned on subsequent calls
+        size_t hash = a->hash_code();
+        REQUIRE(a->hash_code() == hash);
+        REQUIRE(b->hash_code() == hash);
+        REQUIRE(a == b);
+        REQUIRE(a != c);
+
+        dictionary<string, int> dict = make_dictionary<string, int>();
+        dict->add(a, 1);
+        dict->add(c, 2);
+        REQUIRE(dict[b] == 1);
+        REQUIRE(dict["other"] == 2);
+    }
+
+    TEST_CASE("Intern")
+    {
+        string a = make_string("interned value");
+        string b = make_string("interned value");
+        REQUIRE(string::is_interned(a) == nullptr);
+        REQUIRE(!a->is_interned());
+
+        // The first string added becomes the instance held by the pool
+        string ia = string::intern(a);
+        REQUIRE(&*ia == &*a);
+        REQUIRE(a->is_interned());
+        REQUIRE(&*string::intern(b) == &*a);
+        REQUIRE(&*string::is_interned(b) == &*a);
+        REQUIRE(!b->is_interned());
+
+        // Interned strings compare by address
+        string other = string::intern(make_string("other interned value"));
+        REQUIRE(ia == string::intern("interned value"));
+        REQUIRE(ia != other);
+        REQUIRE(ia == b);
+
+        // Names are interned at registration
+        type t = string_impl::typeof();
+        REQUIRE(t->full_name()->is_interned());
+        REQUIRE(t->name->is_interned());
+        REQUIRE(&*string::intern("System.string") == &*t->full_name());
+
+        // Concurrent interning of the same values returns the same instances
+        const int thread_count = 4;
+        const int value_count = 1000;
+        std::vector<std::vector<string_impl*>> results(thread_count);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < thread_count; ++i)
+        {
+            threads.emplace_back([i, &results]()
+            {
+                for (int j = 0; j < value_count; ++j)
+                {
+                    results[i].push_back(&*string::intern(make_string("concurrent " + std::to_string(j))));
+                }
+            });
+        }
+        for (std::thread& thread : threads) thread.join();
+        for (int i = 1; i < thread_count; ++i) REQUIRE(results[i] == results[0]);
+
+        REQUIRE_THROWS(string::intern(string()));
+    }
+
+    TEST_CASE("InternBenchmark", "[.benchmark]")
+    {
+        const int count = 1000;
+        const int lookups = 1000;
+        std::vector<string> keys, interned_keys;
+        dictionary<string, int> dict = make_dictionary<string, int>();
+        for (int i = 0; i < count; ++i)
+        {
+            string key = make_string("field_name_" + std::to_string(i));
+            keys.push_back(make_string(*key));
+            interned_keys.push_back(string::intern(key));
+            dict->add(string::intern(key), i);
+        }
+
+        BENCHMARK("Lookup (new strings)")
+        {
+            for (int j = 0; j < lookups; ++j)
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    string key = make_string(*keys[i]);
+                    dict[key];
+                }
+            }
+        }
+
+        BENCHMARK("Lookup (cached hash)")
+        {
+            for (int j = 0; j < lookups; ++j)
+            {
+                for (const string& key : keys) dict[key];
+            }
+        }
+
+        BENCHMARK("Lookup (interned)")
+        {
+            for (int j = 0; j < lookups; ++j)
+            {
+                for (const string& key : interned_keys) dict[key];
+            }
+        }
+    }
 }
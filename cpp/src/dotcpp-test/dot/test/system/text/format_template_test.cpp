@@ -0,0 +1,127 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/test/implement.hpp>
+#include <approvals/ApprovalTests.hpp>
+#include <approvals/Catch.hpp>
+#include <dot/system/text/format_template.hpp>
+#include <dot/system/text/string_builder.hpp>
+#include <dot/system/object.hpp>
+#include <dot/system/nullable.hpp>
+#include <dot/system/exception.hpp>
+#include <dot/noda_time/local_date.hpp>
+#include <dot/noda_time/local_time.hpp>
+#include <dot/noda_time/local_date_time.hpp>
+
+namespace dot
+{
+    TEST_CASE("FormatTemplate")
+    {
+        format_template t = make_format_template("{{{0}}} {1:.2f} {0:>5}|{2}");
+        REQUIRE(t->minimum_argument_count() == 3);
+        REQUIRE(t->format_string() == "{{{0}}} {1:.2f} {0:>5}|{2}");
+        REQUIRE(t->format("ab", 3.14159, 42) == "{ab} 3.14    ab|42");
+        REQUIRE(string::format(t, make_string("x"), 1.0, "y") == "{x} 1.00     x|y");
+
+        // Automatic indexing and text only
+        REQUIRE(make_format_template("{}-{}")->format(1, 2) == "1-2");
+        REQUIRE(make_format_template("text")->format() == "text");
+        REQUIRE(make_format_template("")->format() == "");
+
+        // Errors are reported when the template is created
+        CHECK_THROWS_AS(make_format_template("{0"), exception);
+        CHECK_THROWS_AS(make_format_template("0}"), exception);
+        CHECK_THROWS_AS(make_format_template("{a}"), exception);
+        CHECK_THROWS_AS(make_format_template("{1000000}"), exception);
+        CHECK_THROWS_AS(make_format_template("{99999999999}"), exception);
+        REQUIRE(make_format_template("{999999}")->minimum_argument_count() == 1000000);
+        CHECK_THROWS_AS(make_format_template("{}{1}"), exception);
+        CHECK_THROWS_AS(make_format_template("{0:{1}}"), exception);
+        CHECK_THROWS_AS(t->format(1, 2), exception);
+
+        // Appending to string_builder
+        string_builder builder = make_string_builder();
+        builder->append_format(make_format_template("{0}={1}"), "a", 1);
+        builder->append(';');
+        builder->append_format("{0}={1}", "b", 2);
+        REQUIRE(builder->to_string() == "a=1;b=2");
+    }
+
+    TEST_CASE("Formatter")
+    {
+        // String with format specification
+        string s = make_string("abc");
+        REQUIRE(string::format("[{0:>5}]", s) == "[  abc]");
+        REQUIRE(string::format("[{0}]", string()) == "[]");
+
+        // Object written using to_string()
+        object boxed = 42;
+        REQUIRE(string::format("{0}", boxed) == "42");
+        REQUIRE(string::format("[{0:<4}]", boxed) == "[42  ]");
+        REQUIRE(string::format("[{0}]", object()) == "[]");
+
+        // Nullable written using the format specification of the value
+        nullable<double> value = 1.5;
+        REQUIRE(string::format("{0:.2f}", value) == "1.50");
+        REQUIRE(string::format("{0}", nullable<int>()) == string::format("{0}", int()));
+
+        // Dates and times written in the format of to_string()
+        local_date date(2005, 1, 10);
+        local_time time(10, 15, 30, 5);
+        local_date_time date_time(2005, 1, 10, 10, 15, 30, 5);
+        REQUIRE(string::format("{0}", date) == "2005-01-10");
+        REQUIRE(string::format("{0}", time) == "10:15:30.005");
+        REQUIRE(string::format("{0}", date_time) == "2005-01-10 10:15:30.005");
+        REQUIRE(string::format("[{0:>12}]", date) == "[  2005-01-10]");
+        REQUIRE(date.to_string() == "2005-01-10");
+        REQUIRE(time.to_string() == "10:15:30.005");
+        REQUIRE(date_time.to_string() == "2005-01-10 10:15:30.005");
+
+        // The same values formatted by a template
+        REQUIRE(make_format_template("{0} {1} {2} {3}")->format(date, time, s, boxed) == "2005-01-10 10:15:30.005 abc 42");
+    }
+
+    TEST_CASE("FormatTemplateBenchmark", "[.benchmark]")
+    {
+        const int count = 10000;
+        string format = "Trade {0} in book {1} for {2} at {3:.4f} on {4}";
+        format_template compiled = make_format_template(format);
+        string book = make_string("EQ-LDN");
+        local_date date(2019, 5, 1);
+
+        BENCHMARK("string::format")
+        {
+            for (int i = 0; i < count; ++i) string::format(format, i, book, "EUR", 101.25, date);
+        }
+
+        BENCHMARK("format_template")
+        {
+            for (int i = 0; i < count; ++i) compiled->format(i, book, "EUR", 101.25, date);
+        }
+
+        BENCHMARK("local_date::to_string")
+        {
+            for (int i = 0; i < count; ++i) date.to_string();
+        }
+    }
+}
@@ -49,4 +49,120 @@ namespace dot
 
         Approvals::verify(*result);
     }
+
+    TEST_CASE("Chunks")
+    {
+        // Appends that exceed the capacity add chunks without moving previous characters
+        std::string expected;
+        string_builder builder = make_string_builder();
+        for (int i = 0; i < 1000; ++i)
+        {
+            builder->append(i);
+            builder->append(',');
+            expected += std::to_string(i) + ",";
+        }
+        builder->append(string());
+        builder->append(std::string(3000, 'x'));
+        expected += std::string(3000, 'x');
+
+        REQUIRE(builder->length() == static_cast<int>(expected.size()));
+        REQUIRE(builder->capacity() >= builder->length());
+        REQUIRE(builder->to_string() == expected);
+
+        std::ostringstream stream;
+        stream << *builder;
+        REQUIRE(stream.str() == expected);
+
+        // Formatted value that does not fit into the free space is moved to a new chunk
+        string_builder formatted = make_string_builder(4);
+        formatted->append("ab");
+        formatted->append_format("{0}-{1}", 12345678, "xyz");
+        formatted->append(2.5);
+        REQUIRE(formatted->to_string() == "ab12345678-xyz2.5");
+
+        // Concatenation is copied without creating the string, in the free space or a new chunk
+        string a = make_string("abc");
+        string_builder concatenated = make_string_builder(8);
+        concatenated->append(a + "-" + a);
+        concatenated->append(a + std::string(20, 'x'));
+        concatenated->append_line(a + "/", 1, '/', a);
+        REQUIRE(concatenated->to_string() == "abc-abcabc" + std::string(20, 'x') + "abc/1/abc" + std::string(environment::make_line->view()));
+
+        // Clear keeps the last chunk
+        builder->clear();
+        REQUIRE(builder->length() == 0);
+        REQUIRE(builder->to_string() == "");
+        builder->append("abc");
+        REQUIRE(builder->to_string() == "abc");
+    }
+
+    TEST_CASE("MoveToString")
+    {
+        // Single chunk is returned without copying
+        string_builder builder = make_string_builder(6);
+        REQUIRE(builder->capacity() == 6);
+        builder->append("abc");
+        builder->append(123);
+        const char* data = builder->to_string()->data();
+        string result = builder->move_to_string();
+        REQUIRE(result == "abc123");
+        REQUIRE(result->data() != data);
+        REQUIRE(result->data()[result->length()] == 0);
+        REQUIRE(builder->length() == 0);
+        REQUIRE(builder->capacity() == 0);
+
+        // Builder remains usable after the move
+        builder->append("x");
+        REQUIRE(builder->move_to_string() == "x");
+
+        // Multiple chunks are copied
+        string_builder chunked = make_string_builder(2);
+        chunked->append("abcdef");
+        chunked->append("ghijkl");
+        REQUIRE(chunked->move_to_string() == "abcdefghijkl");
+        REQUIRE(chunked->length() == 0);
+        REQUIRE(make_string_builder()->move_to_string() == "");
+
+        // Empty values appended before the first chunk and after the move
+        string_builder empty = make_string_builder();
+        empty->append("");
+        empty->append(string::empty);
+        empty->append(string::empty + "");
+        empty->append_format("{0}", "");
+        REQUIRE(empty->length() == 0);
+        empty->append("a");
+        REQUIRE(empty->move_to_string() == "a");
+        empty->append("");
+        empty->append(string::empty + "");
+        REQUIRE(empty->to_string() == "");
+    }
+
+    TEST_CASE("StringBuilderBenchmark", "[.benchmark]")
+    {
+        const int count = 100000;
+
+        BENCHMARK("std::string")
+        {
+            std::string result;
+            for (int i = 0; i < count; ++i)
+            {
+                result += "item";
+                result += std::to_string(i);
+                result += ';';
+            }
+            REQUIRE(result.size() > 0);
+        }
+
+        BENCHMARK("string_builder")
+        {
+            string_builder builder = make_string_builder();
+            for (int i = 0; i < count; ++i)
+            {
+                builder->append("item");
+                builder->append(i);
+                builder->append(';');
+            }
+            REQUIRE(builder->move_to_string()->length() > 0);
+        }
+    }
 }
@@ -0,0 +1,151 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <typeinfo>
+
+namespace dot
+{
+    namespace detail
+    {
+        /// Result of casting from T to R recorded for one dynamic type and
+        /// one T subobject of that type.
+        struct cast_cache_entry
+        {
+            /// Dynamic (most derived) type of the argument.
+            const std::type_info* type_;
+
+            /// Offset from the most derived object to the argument, which
+            /// identifies the T subobject when T is a repeated base.
+            std::ptrdiff_t source_offset_;
+
+            /// Offset from the argument to the result, or no_cast if the cast fails.
+            std::ptrdiff_t offset_;
+        };
+
+        /// Replaces dynamic_cast from T* to R* by a lookup keyed by the dynamic type
+        /// of the argument and the position of the argument within the object.
+        ///
+        /// Because object_impl is a virtual base, dynamic_cast has to search the
+        /// inheritance graph of the dynamic type on every call. The layout of an
+        /// object is however fixed by its dynamic type, so the offset between the
+        /// argument and the result (or the failure of the cast) is the same for
+        /// all objects of that type. When T is a non-virtual base repeated in the
+        /// dynamic type, the outcome also depends on which T subobject the argument
+        /// points to, so the offset of the argument from the most derived object
+        /// is part of the key. The first cast for each key uses dynamic_cast and
+        /// records the outcome; subsequent casts cost two virtual table loads,
+        /// a hash and two comparisons.
+        ///
+        /// Each pair of T and R has a fixed size open addressing table. Entries are
+        /// immutable and published with a single compare-and-swap, so lookups are
+        /// lock free. When the table is full the cast falls back to dynamic_cast.
+        template <class R, class T>
+        class cast_cache
+        {
+        private: // CONSTANTS
+
+            /// Number of dynamic types recorded for each pair of T and R, must be a power of two.
+            static constexpr std::size_t capacity = 32;
+
+            /// Offset recorded when the cast fails.
+            static constexpr std::ptrdiff_t no_cast = PTRDIFF_MIN;
+
+        private: // FIELDS
+
+            static inline std::atomic<const cast_cache_entry*> entries_[capacity] = {};
+
+        public: // STATIC
+
+            /// Returns the result of dynamic_cast<R*>(p).
+            static R* cast(T* p)
+            {
+                if (!p) return nullptr;
+
+                const std::type_info* type = &typeid(*p);
+                std::ptrdiff_t source_offset = reinterpret_cast<char*>(p) - static_cast<char*>(dynamic_cast<void*>(p));
+                std::size_t index = slot(type, source_offset);
+                for (std::size_t probe = 0; probe < capacity; ++probe, index = (index + 1) & (capacity - 1))
+                {
+                    const cast_cache_entry* entry = entries_[index].load(std::memory_order_acquire);
+                    if (entry == nullptr) return record(p, type, source_offset, index);
+                    if (entry->type_ == type && entry->source_offset_ == source_offset) return apply(p, entry->offset_);
+                }
+
+                // The table is full, this happens only for very wide hierarchies
+                return dynamic_cast<R*>(p);
+            }
+
+        private: // STATIC
+
+            /// Initial slot for the type and the offset of the argument within the object.
+            static std::size_t slot(const std::type_info* type, std::ptrdiff_t source_offset)
+            {
+                std::uint64_t h = (static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(type)) + static_cast<std::uint64_t>(source_offset)) * 0x9E3779B97F4A7C15ull;
+                return static_cast<std::size_t>(h >> 32) & (capacity - 1);
+            }
+
+            /// Applies recorded offset to the argument.
+            static R* apply(T* p, std::ptrdiff_t offset)
+            {
+                if (offset == no_cast) return nullptr;
+                return reinterpret_cast<R*>(reinterpret_cast<char*>(p) + offset);
+            }
+
+            /// Performs dynamic_cast and records the outcome starting from the first empty slot.
+            static R* record(T* p, const std::type_info* type, std::ptrdiff_t source_offset, std::size_t index)
+            {
+                R* result = dynamic_cast<R*>(p);
+                std::ptrdiff_t offset = result ? reinterpret_cast<char*>(result) - reinterpret_cast<char*>(p) : no_cast;
+
+                // Entries are never deleted, their number is bounded by the table capacity
+                cast_cache_entry* entry = new cast_cache_entry{ type, source_offset, offset };
+                for (std::size_t probe = 0; probe < capacity; ++probe, index = (index + 1) & (capacity - 1))
+                {
+                    const cast_cache_entry* expected = nullptr;
+                    if (entries_[index].compare_exchange_strong(expected, entry, std::memory_order_acq_rel)) return result;
+
+                    // Another thread recorded the same key concurrently
+                    if (expected->type_ == type && expected->source_offset_ == source_offset) break;
+                }
+
+                delete entry;
+                return result;
+            }
+        };
+
+        /// Dynamic cast from T* to R* using cast_cache, or a static cast if R is a base of T.
+        template <class R, class T>
+        R* fast_cast(T* p)
+        {
+            if constexpr (std::is_base_of<R, T>::value) return p;
+            else return cast_cache<R, T>::cast(p);
+        }
+    }
+}
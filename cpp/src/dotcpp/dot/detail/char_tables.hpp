@@ -0,0 +1,112 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+#include <cstdint>
+
+namespace dot
+{
+    namespace detail
+    {
+        /// Unicode properties of UTF-16 code units used by Char.
+        ///
+        /// The properties of each code unit are stored in a 16-bit entry, with
+        /// the flags in the low byte and the index of the case mapping delta in
+        /// case_deltas_ in the high byte. Entries are grouped into blocks of
+        /// block_size_ code units, identical blocks are stored once, and
+        /// block_index_ maps the high bits of the code unit to its block.
+        ///
+        /// The tables in char_tables.cpp are generated by char_tables.py from
+        /// UnicodeData.txt of the Unicode Character Database version 14.0.0.
+        class DOT_CLASS char_tables
+        {
+        public: // CONSTANTS
+
+            /// Code unit is a decimal digit (category Nd).
+            static constexpr std::uint16_t digit_flag = 1;
+
+            /// Code unit is a letter (categories Lu, Ll, Lt, Lm, Lo).
+            static constexpr std::uint16_t letter_flag = 2;
+
+            /// Code unit is an uppercase letter (category Lu).
+            static constexpr std::uint16_t upper_flag = 4;
+
+            /// Code unit is a lowercase letter (category Ll).
+            static constexpr std::uint16_t lower_flag = 8;
+
+            /// Code unit is white space (categories Zs, Zl, Zp and U+0009 to U+000D, U+0085).
+            static constexpr std::uint16_t white_space_flag = 16;
+
+            /// Code unit is punctuation (categories Pc, Pd, Ps, Pe, Pi, Pf, Po).
+            static constexpr std::uint16_t punctuation_flag = 32;
+
+            /// Code unit has an uppercase mapping.
+            static constexpr std::uint16_t to_upper_flag = 64;
+
+            /// Code unit has a lowercase mapping. If it also has an uppercase
+            /// mapping, which is only the case for titlecase letters, the delta
+            /// is that of the uppercase mapping and the lowercase mapping follows
+            /// the uppercase mapping by two code units.
+            static constexpr std::uint16_t to_lower_flag = 128;
+
+            /// Number of code units in a block.
+            static constexpr int block_size_ = 64;
+
+            /// Number of blocks covering all code units.
+            static constexpr int block_count_ = 0x10000 / block_size_;
+
+        private: // STATIC
+
+            static const std::uint8_t block_index_[block_count_];
+            static const std::uint16_t blocks_[][block_size_];
+            static const std::int32_t case_deltas_[];
+
+        public: // STATIC
+
+            /// Entry for the code unit.
+            static std::uint16_t entry(char16_t value)
+            {
+                return blocks_[block_index_[value / block_size_]][value % block_size_];
+            }
+
+            /// Uppercase equivalent of the code unit, or the code unit itself if it has none.
+            static char16_t to_upper(char16_t value)
+            {
+                std::uint16_t e = entry(value);
+                if (!(e & to_upper_flag)) return value;
+                return static_cast<char16_t>(value + case_deltas_[e >> 8]);
+            }
+
+            /// Lowercase equivalent of the code unit, or the code unit itself if it has none.
+            static char16_t to_lower(char16_t value)
+            {
+                std::uint16_t e = entry(value);
+                if (!(e & to_lower_flag)) return value;
+                if (e & to_upper_flag) return static_cast<char16_t>(value + case_deltas_[e >> 8] + 2);
+                return static_cast<char16_t>(value + case_deltas_[e >> 8]);
+            }
+        };
+    }
+}
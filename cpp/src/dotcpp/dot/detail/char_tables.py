@@ -0,0 +1,192 @@
+# Copyright (C) 2015-present The DotCpp Authors.
+#
+# This file is part of .C++, a native C++ implementation of
+# popular .NET class library APIs developed to facilitate
+# code reuse between C# and C++.
+#
+#     http://github.com/dotcpp/dotcpp (source)
+#     http://dotcpp.org (documentation)
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generates char_tables.cpp from the Unicode Character Database.
+
+Usage: python char_tables.py UnicodeData.txt > char_tables.cpp
+
+The tables are generated from UnicodeData.txt of UCD version 14.0.0,
+available from https://www.unicode.org/Public/14.0.0/ucd/UnicodeData.txt
+See char_tables.hpp for the layout of the tables.
+"""
+
+import sys
+
+ucd_version = '14.0.0'
+
+# Flags, must match the constants in char_tables.hpp
+digit_flag = 1
+letter_flag = 2
+upper_flag = 4
+lower_flag = 8
+white_space_flag = 16
+punctuation_flag = 32
+to_upper_flag = 64
+to_lower_flag = 128
+
+block_size = 64
+
+license_header = '''﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+'''
+
+
+def read_unicode_data(path):
+    """Returns general category, simple uppercase and simple lowercase mapping of each BMP code point."""
+    category = ['Cn'] * 0x10000
+    upper = list(range(0x10000))
+    lower = list(range(0x10000))
+    range_first = None
+    with open(path, encoding='utf-8') as f:
+        for line in f:
+            fields = line.rstrip('\n').split(';')
+            code = int(fields[0], 16)
+            if code >= 0x10000:
+                continue
+            if fields[1].endswith(', First>'):
+                range_first = code
+                continue
+            first = code
+            if fields[1].endswith(', Last>'):
+                first = range_first
+            for c in range(first, code + 1):
+                category[c] = fields[2]
+                if fields[12]:
+                    upper[c] = int(fields[12], 16)
+                if fields[13]:
+                    lower[c] = int(fields[13], 16)
+    return category, upper, lower
+
+
+def make_entries(category, upper, lower):
+    """Returns the entry of each code unit and the list of case mapping deltas."""
+    deltas = [0]
+    entries = []
+    for c in range(0x10000):
+        cat = category[c]
+        flags = 0
+        if cat == 'Nd':
+            flags |= digit_flag
+        if cat in ('Lu', 'Ll', 'Lt', 'Lm', 'Lo'):
+            flags |= letter_flag
+        if cat == 'Lu':
+            flags |= upper_flag
+        if cat == 'Ll':
+            flags |= lower_flag
+        if cat in ('Zs', 'Zl', 'Zp') or c in (0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x85):
+            flags |= white_space_flag
+        if cat[0] == 'P':
+            flags |= punctuation_flag
+
+        # Mappings outside of the BMP cannot be represented by a single code unit
+        delta = 0
+        has_upper = upper[c] != c and upper[c] < 0x10000
+        has_lower = lower[c] != c and lower[c] < 0x10000
+        if has_upper:
+            flags |= to_upper_flag
+            delta = upper[c] - c
+        if has_lower:
+            flags |= to_lower_flag
+            if has_upper:
+                if lower[c] != upper[c] + 2:
+                    raise ValueError('Unsupported case mappings of U+%04X.' % c)
+            else:
+                delta = lower[c] - c
+
+        if delta not in deltas:
+            deltas.append(delta)
+        entries.append(flags | (deltas.index(delta) << 8))
+    if len(deltas) > 256:
+        raise ValueError('Too many case mapping deltas.')
+    return entries, deltas
+
+
+def make_blocks(entries):
+    """Returns the distinct blocks of entries and the index of the block of each code unit."""
+    blocks = []
+    block_index = []
+    for i in range(0, len(entries), block_size):
+        block = tuple(entries[i:i + block_size])
+        if block not in blocks:
+            blocks.append(block)
+        block_index.append(blocks.index(block))
+    if len(blocks) > 256:
+        raise ValueError('Too many distinct blocks.')
+    return blocks, block_index
+
+
+def write_tables(out, blocks, block_index, deltas):
+    w = out.write
+    w(license_header)
+    w('\n#include <dot/precompiled.hpp>\n#include <dot/implement.hpp>\n#include <dot/detail/char_tables.hpp>\n\n')
+    w('namespace dot\n{\n    namespace detail\n    {\n')
+    w('        // Generated from the Unicode Character Database version %s by char_tables.py,\n' % ucd_version)
+    w('        // see char_tables.hpp for the layout. Case mappings are the simple mappings of\n')
+    w('        // UTF-16 code units.\n\n')
+    w('        const std::uint8_t char_tables::block_index_[block_count_] =\n        {\n')
+    for i in range(0, len(block_index), 16):
+        w('            ' + ', '.join('%d' % x for x in block_index[i:i + 16]) + ',\n')
+    w('        };\n\n')
+    w('        const std::uint16_t char_tables::blocks_[][block_size_] =\n        {\n')
+    for block in blocks:
+        w('            {\n')
+        for i in range(0, block_size, 16):
+            w('                ' + ', '.join('0x%04x' % x for x in block[i:i + 16]) + ',\n')
+        w('            },\n')
+    w('        };\n\n')
+    w('        const std::int32_t char_tables::case_deltas_[] =\n        {\n')
+    for i in range(0, len(deltas), 12):
+        w('            ' + ', '.join('%d' % x for x in deltas[i:i + 12]) + ',\n')
+    w('        };\n    }\n}\n')
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit('Usage: python char_tables.py UnicodeData.txt > char_tables.cpp')
+    category, upper, lower = read_unicode_data(sys.argv[1])
+    entries, deltas = make_entries(category, upper, lower)
+    blocks, block_index = make_blocks(entries)
+    sys.stdout.reconfigure(encoding='utf-8', newline='\n')
+    write_tables(sys.stdout, blocks, block_index, deltas)
+
+
+if __name__ == '__main__':
+    main()
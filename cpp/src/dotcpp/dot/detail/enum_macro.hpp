@@ -60,7 +60,7 @@ protected:                                                              \
 
 
 #define DOT_ENUM_VALUE(value) \
-    map_[#value] = value;
+    map_[dot::string::intern(#value)] = value;
 
 
 #define DOT_ENUM_END()                                                  \
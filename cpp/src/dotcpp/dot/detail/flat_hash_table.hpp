@@ -0,0 +1,635 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <dot/declare.hpp>
+#include <dot/system/exception.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/// Control bytes are probed sixteen at a time using SSE2 on x86-64 unless
+/// DOT_DISABLE_SIMD is defined, and eight at a time using 64-bit integer
+/// operations otherwise.
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(DOT_DISABLE_SIMD)
+#   define DOT_FLAT_HASH_SIMD 1
+#   include <emmintrin.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#   include <intrin.h>
+#endif
+
+namespace dot
+{
+    namespace detail
+    {
+        /// Control byte of a slot of flat_hash_table. A full slot holds the low
+        /// seven bits of the hash of its key, empty and deleted slots have the
+        /// high bit set.
+        typedef std::int8_t flat_hash_control;
+
+        /// Control byte of a slot that has never been full since the last rehash.
+        constexpr flat_hash_control flat_hash_empty = -128;
+
+        /// Control byte of a slot whose element has been removed, which does
+        /// not end the probe sequence of a lookup.
+        constexpr flat_hash_control flat_hash_deleted = -2;
+
+        /// Index of the lowest set bit, mask must not be zero.
+        inline int flat_hash_lowest_bit(std::uint64_t mask)
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long result;
+            _BitScanForward64(&result, mask);
+            return static_cast<int>(result);
+#else
+            return __builtin_ctzll(mask);
+#endif
+        }
+
+#ifdef DOT_FLAT_HASH_SIMD
+
+        /// Group of control bytes starting at any position, compared to a
+        /// value in one instruction. Each method returns a mask with one bit
+        /// per matching byte, bit i corresponding to byte i.
+        class flat_hash_group
+        {
+            __m128i control_;
+
+        public:
+
+            /// Number of control bytes in a group.
+            static constexpr int width = 16;
+
+            explicit flat_hash_group(const flat_hash_control* control) : control_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control))) {}
+
+            /// Position of the byte corresponding to the lowest bit of a non-zero mask.
+            static int lowest(std::uint64_t mask) { return flat_hash_lowest_bit(mask); }
+
+            /// Full slots whose control byte equals the seven bits of the hash.
+            std::uint64_t match(flat_hash_control h2) const { return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), control_))); }
+
+            /// Empty slots.
+            std::uint64_t match_empty() const { return match(flat_hash_empty); }
+
+            /// Empty or deleted slots.
+            std::uint64_t match_free() const { return static_cast<std::uint32_t>(_mm_movemask_epi8(control_)); }
+
+            /// Full slots.
+            std::uint64_t match_full() const { return match_free() ^ 0xFFFF; }
+        };
+
+#else
+
+        /// Group of control bytes starting at any position, compared to a
+        /// value using 64-bit integer operations. Each method returns a mask
+        /// with the high bit of each matching byte set. Assumes little-endian
+        /// byte order.
+        class flat_hash_group
+        {
+            static constexpr std::uint64_t lsbs_ = 0x0101010101010101ull;
+            static constexpr std::uint64_t msbs_ = 0x8080808080808080ull;
+
+            std::uint64_t control_;
+
+        public:
+
+            /// Number of control bytes in a group.
+            static constexpr int width = 8;
+
+            explicit flat_hash_group(const flat_hash_control* control) { std::memcpy(&control_, control, sizeof(control_)); }
+
+            /// Position of the byte corresponding to the lowest bit of a non-zero mask.
+            static int lowest(std::uint64_t mask) { return flat_hash_lowest_bit(mask) >> 3; }
+
+            /// Full slots whose control byte equals the seven bits of the hash. May also
+            /// return bytes above a matching byte, which are rejected by the key comparison.
+            std::uint64_t match(flat_hash_control h2) const
+            {
+                std::uint64_t x = control_ ^ (lsbs_ * static_cast<std::uint8_t>(h2));
+                return (x - lsbs_) & ~x & msbs_;
+            }
+
+            /// Empty slots, which unlike deleted slots have the second lowest bit clear.
+            std::uint64_t match_empty() const { return control_ & ~(control_ << 6) & msbs_; }
+
+            /// Empty or deleted slots.
+            std::uint64_t match_free() const { return control_ & msbs_; }
+
+            /// Full slots.
+            std::uint64_t match_full() const { return ~control_ & msbs_; }
+        };
+
+#endif
+
+        /// Policy of flat_hash_table whose elements are the keys.
+        template <class T>
+        struct flat_hash_set_policy
+        {
+            typedef T key_type;
+            typedef T value_type;
+
+            /// Elements are the keys and cannot be modified in place, so iterator is const_iterator.
+            static constexpr bool mutable_elements = false;
+
+            static const T& key(const T& value) { return value; }
+
+            /// Move the element to uninitialized memory and destroy the source.
+            static void transfer(T* target, T* source)
+            {
+                new (target) T(std::move(*source));
+                source->~T();
+            }
+        };
+
+        /// Policy of flat_hash_table whose elements are pairs of a const key and a value.
+        template <class K, class V>
+        struct flat_hash_map_policy
+        {
+            typedef K key_type;
+            typedef std::pair<const K, V> value_type;
+
+            /// Values can be modified in place, keys are const.
+            static constexpr bool mutable_elements = true;
+
+            static const K& key(const value_type& value) { return value.first; }
+
+            /// Move the element to uninitialized memory and destroy the source. The key
+            /// is moved through a non-const reference, which is safe because the source
+            /// is destroyed immediately after, so that growing the table does not copy
+            /// keys such as string or update their reference counts.
+            static void transfer(value_type* target, value_type* source)
+            {
+                new (target) value_type(std::move(const_cast<K&>(source->first)), std::move(source->second));
+                source->~value_type();
+            }
+        };
+
+        /// Hash table with open addressing in the layout of Swiss tables, the
+        /// storage of dictionary and hash_set.
+        ///
+        /// Elements are stored in a single array of slots, without a separate
+        /// allocation per element, and a parallel array holds one control byte
+        /// per slot. Lookup computes the position of the first group of slots
+        /// from the high bits of the hash and compares the seven low bits to
+        /// all control bytes of the group at once, so that keys are compared
+        /// only for slots that match, usually one. Groups are probed with
+        /// quadratically increasing steps until a group with an empty slot.
+        ///
+        /// The capacity is a power of two and the table grows when seven eighths
+        /// of the slots are full or deleted. The first group_width control bytes
+        /// are repeated after the last, so that a group may start at any slot.
+        /// Removing an element marks its slot as deleted. Deleted slots are reused
+        /// by insertion and discarded when the table is rehashed. Growing the table
+        /// invalidates iterators and references to elements, removing an element
+        /// invalidates only those to the element itself.
+        template <class policy_t, class hash_t, class equal_t>
+        class flat_hash_table
+        {
+            template <bool is_const> class iterator_base;
+
+        public: // TYPEDEF
+
+            typedef typename policy_t::key_type key_type;
+            typedef typename policy_t::value_type value_type;
+            typedef hash_t hasher;
+            typedef equal_t key_equal;
+            typedef size_t size_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef value_type& reference;
+            typedef const value_type& const_reference;
+            typedef std::conditional_t<policy_t::mutable_elements, iterator_base<false>, iterator_base<true>> iterator;
+            typedef iterator_base<true> const_iterator;
+
+        private: // CONSTANTS
+
+            /// Number of control bytes probed together.
+            static constexpr size_t group_width = flat_hash_group::width;
+
+            /// Index returned by lookup when the key is not found.
+            static constexpr size_t npos = ~size_t(0);
+
+            /// Largest capacity whose slots can be allocated.
+            static constexpr size_t max_capacity = std::numeric_limits<std::ptrdiff_t>::max() / sizeof(value_type);
+
+        private: // TYPEDEF
+
+            /// Control bytes and slots of the table.
+            struct storage
+            {
+                flat_hash_control* control;
+                value_type* slots;
+                size_t capacity;
+            };
+
+        private: // FIELDS
+
+            flat_hash_control* control_ = nullptr;
+            value_type* slots_ = nullptr;
+            size_t capacity_ = 0;
+            size_t size_ = 0;
+            size_t growth_left_ = 0;
+            hash_t hash_;
+            equal_t equal_;
+
+        public: // CONSTRUCTORS
+
+            /// Create empty table, which does not allocate memory until the first insertion.
+            flat_hash_table() = default;
+
+            /// Destroy the elements and release memory.
+            ~flat_hash_table()
+            {
+                destroy_elements();
+                deallocate(control_, slots_, capacity_);
+            }
+
+            flat_hash_table(const flat_hash_table&) = delete;
+            flat_hash_table& operator=(const flat_hash_table&) = delete;
+
+        public: // METHODS
+
+            /// Number of elements.
+            size_t size() const { return size_; }
+
+            /// True if there are no elements.
+            bool empty() const { return size_ == 0; }
+
+            /// Number of elements the table can hold without growing.
+            size_t max_load() const { return max_load(capacity_); }
+
+            iterator begin() { return iterator(this, next_full(0)); }
+            iterator end() { return iterator(this, capacity_); }
+            const_iterator begin() const { return const_iterator(this, next_full(0)); }
+            const_iterator end() const { return const_iterator(this, capacity_); }
+            const_iterator cbegin() const { return begin(); }
+            const_iterator cend() const { return end(); }
+
+            /// Iterator to the element with the key, or end() if not found.
+            iterator find(const key_type& key)
+            {
+                size_t index = find_index(key, hash_key(key));
+                return index != npos ? iterator(this, index) : end();
+            }
+
+            /// Iterator to the element with the key, or end() if not found.
+            const_iterator find(const key_type& key) const
+            {
+                size_t index = find_index(key, hash_key(key));
+                return index != npos ? const_iterator(this, index) : end();
+            }
+
+            /// Number of elements with the key, zero or one.
+            size_t count(const key_type& key) const { return find_index(key, hash_key(key)) != npos ? 1 : 0; }
+
+            /// Inserts the element if there is no element with the same key. Returns
+            /// the iterator to the element with the key and true if it was inserted.
+            std::pair<iterator, bool> insert(const value_type& value) { return emplace_key(policy_t::key(value), value); }
+
+            /// Inserts the element if there is no element with the same key.
+            std::pair<iterator, bool> insert(value_type&& value) { return emplace_key(policy_t::key(value), std::move(value)); }
+
+            /// Constructs the element from the arguments if there is no element with
+            /// the key, which must be the key of the constructed element. Returns the
+            /// iterator to the element with the key and true if it was inserted.
+            ///
+            /// The arguments may refer to elements of the table. If the table grows,
+            /// the element is constructed in the new arrays before the existing
+            /// elements are moved. If the constructor throws, the table is unchanged.
+            template <class... args_t>
+            std::pair<iterator, bool> emplace_key(const key_type& key, args_t&&... args)
+            {
+                size_t hash = hash_key(key);
+                size_t index = find_index(key, hash);
+                if (index != npos) return std::make_pair(iterator(this, index), false);
+
+                index = capacity_ != 0 ? find_free(hash) : npos;
+                if (index == npos || (growth_left_ == 0 && control_[index] == flat_hash_empty))
+                {
+                    // Discard deleted slots without growing if at least half of the load is deleted
+                    storage old = replace_storage(capacity_ != 0 && size_ < max_load(capacity_) / 2 ? capacity_ : capacity_for(size_ + 1));
+                    index = find_free(hash);
+                    try
+                    {
+                        new (slots_ + index) value_type(std::forward<args_t>(args)...);
+                    }
+                    catch (...)
+                    {
+                        restore_storage(old);
+                        throw;
+                    }
+                    set_control(index, h2(hash));
+                    ++size_;
+                    transfer_from(old);
+                }
+                else
+                {
+                    new (slots_ + index) value_type(std::forward<args_t>(args)...);
+                    if (control_[index] == flat_hash_empty) --growth_left_;
+                    set_control(index, h2(hash));
+                    ++size_;
+                }
+                return std::make_pair(iterator(this, index), true);
+            }
+
+            /// Removes the element with the key and returns the number of removed elements.
+            size_t erase(const key_type& key)
+            {
+                size_t index = find_index(key, hash_key(key));
+                if (index == npos) return 0;
+                erase_at(index);
+                return 1;
+            }
+
+            /// Removes the element and returns the iterator to the next element.
+            iterator erase(const_iterator position)
+            {
+                erase_at(position.index_);
+                return iterator(this, next_full(position.index_ + 1));
+            }
+
+            /// Removes all elements without releasing memory.
+            void clear()
+            {
+                destroy_elements();
+                if (capacity_ != 0) std::memset(control_, flat_hash_empty, capacity_ + group_width);
+                size_ = 0;
+                growth_left_ = max_load(capacity_);
+            }
+
+            /// Grows the table if necessary to hold count elements without growing again.
+            /// Error if the table cannot hold count elements.
+            void reserve(size_t count)
+            {
+                if (count > max_load(capacity_)) resize(capacity_for(count));
+            }
+
+            /// Resizes the table to the smallest capacity that holds count elements and
+            /// the current elements, discarding deleted slots. Rehash with zero count
+            /// shrinks the table to fit, and releases memory if the table is empty.
+            void rehash(size_t count)
+            {
+                if (count == 0 && size_ == 0)
+                {
+                    deallocate(control_, slots_, capacity_);
+                    control_ = nullptr;
+                    slots_ = nullptr;
+                    capacity_ = 0;
+                    growth_left_ = 0;
+                }
+                else
+                {
+                    resize(capacity_for(std::max(count, size_)));
+                }
+            }
+
+            /// Copy of the hash function.
+            hasher hash_function() const { return hash_; }
+
+            /// Copy of the key equality function.
+            key_equal key_eq() const { return equal_; }
+
+        private: // METHODS
+
+            /// Maximum number of full and deleted slots before the table grows.
+            static size_t max_load(size_t capacity) { return capacity - capacity / 8; }
+
+            /// Smallest capacity whose maximum load is at least count,
+            /// error if it would exceed max_capacity.
+            static size_t capacity_for(size_t count)
+            {
+                size_t capacity = group_width;
+                while (max_load(capacity) < count)
+                {
+                    if (capacity > max_capacity / 2) throw exception("Number of elements exceeds the maximum size of the hash table.");
+                    capacity *= 2;
+                }
+                return capacity;
+            }
+
+            /// Hash of the key mixed so that all bits depend on all bits of the hash,
+            /// because hashes such as std::hash for integers are not randomized.
+            size_t hash_key(const key_type& key) const
+            {
+                std::uint64_t hash = static_cast<std::uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull;
+                return static_cast<size_t>(hash ^ (hash >> 32));
+            }
+
+            /// Position of the first group probed for the hash.
+            static size_t h1(size_t hash) { return hash >> 7; }
+
+            /// Bits of the hash stored in the control byte.
+            static flat_hash_control h2(size_t hash) { return static_cast<flat_hash_control>(hash & 0x7F); }
+
+            /// Index of the slot holding the key, or npos if not found.
+            size_t find_index(const key_type& key, size_t hash) const
+            {
+                if (capacity_ == 0) return npos;
+
+                size_t mask = capacity_ - 1;
+                size_t position = h1(hash) & mask;
+                flat_hash_control control = h2(hash);
+                for (size_t step = group_width; ; step += group_width)
+                {
+                    flat_hash_group group(control_ + position);
+                    for (std::uint64_t match = group.match(control); match != 0; match &= match - 1)
+                    {
+                        size_t index = (position + flat_hash_group::lowest(match)) & mask;
+                        if (equal_(policy_t::key(slots_[index]), key)) return index;
+                    }
+                    if (group.match_empty() != 0) return npos;
+                    position = (position + step) & mask;
+                }
+            }
+
+            /// Index of the first empty or deleted slot in the probe sequence of the hash.
+            size_t find_free(size_t hash) const
+            {
+                size_t mask = capacity_ - 1;
+                size_t position = h1(hash) & mask;
+                for (size_t step = group_width; ; step += group_width)
+                {
+                    std::uint64_t match = flat_hash_group(control_ + position).match_free();
+                    if (match != 0) return (position + flat_hash_group::lowest(match)) & mask;
+                    position = (position + step) & mask;
+                }
+            }
+
+            /// Set the control byte of the slot and its copy after the last slot.
+            void set_control(size_t index, flat_hash_control control)
+            {
+                control_[index] = control;
+                if (index < group_width) control_[capacity_ + index] = control;
+            }
+
+            /// Destroy the element in the slot and mark the slot as deleted.
+            void erase_at(size_t index)
+            {
+                slots_[index].~value_type();
+                set_control(index, flat_hash_deleted);
+                --size_;
+            }
+
+            /// Index of the first full slot at or after the index, or capacity if none.
+            size_t next_full(size_t index) const
+            {
+                for (; index < capacity_; index += group_width)
+                {
+                    std::uint64_t match = flat_hash_group(control_ + index).match_full();
+                    if (match != 0) return std::min(capacity_, index + flat_hash_group::lowest(match));
+                }
+                return capacity_;
+            }
+
+            /// Destroy all elements without changing the control bytes.
+            void destroy_elements()
+            {
+                if constexpr (!std::is_trivially_destructible<value_type>::value)
+                {
+                    for (size_t i = 0; i < capacity_; ++i)
+                        if (control_[i] >= 0) slots_[i].~value_type();
+                }
+            }
+
+            /// Move the elements to new arrays with the specified capacity.
+            void resize(size_t capacity)
+            {
+                transfer_from(replace_storage(capacity));
+            }
+
+            /// Replace the arrays by empty arrays with the specified capacity and
+            /// return the previous arrays, whose elements are not moved.
+            storage replace_storage(size_t capacity)
+            {
+                storage old{ control_, slots_, capacity_ };
+
+                flat_hash_control* control = new flat_hash_control[capacity + group_width];
+                try
+                {
+                    slots_ = std::allocator<value_type>().allocate(capacity);
+                }
+                catch (...)
+                {
+                    delete[] control;
+                    throw;
+                }
+                std::memset(control, flat_hash_empty, capacity + group_width);
+                control_ = control;
+                capacity_ = capacity;
+                return old;
+            }
+
+            /// Release the arrays created by replace_storage, which must not
+            /// hold elements, and restore the previous arrays.
+            void restore_storage(const storage& old)
+            {
+                deallocate(control_, slots_, capacity_);
+                control_ = old.control;
+                slots_ = old.slots;
+                capacity_ = old.capacity;
+            }
+
+            /// Move the elements of the previous arrays returned by replace_storage
+            /// to the current arrays and release the previous arrays.
+            void transfer_from(const storage& old)
+            {
+                for (size_t i = 0; i < old.capacity; ++i)
+                {
+                    if (old.control[i] < 0) continue;
+                    size_t hash = hash_key(policy_t::key(old.slots[i]));
+                    size_t index = find_free(hash);
+                    set_control(index, h2(hash));
+                    policy_t::transfer(slots_ + index, old.slots + i);
+                }
+
+                growth_left_ = max_load(capacity_) - size_;
+                deallocate(old.control, old.slots, old.capacity);
+            }
+
+            /// Release the arrays without destroying the elements.
+            static void deallocate(flat_hash_control* control, value_type* slots, size_t capacity)
+            {
+                if (capacity == 0) return;
+                delete[] control;
+                std::allocator<value_type>().deallocate(slots, capacity);
+            }
+
+        private: // ITERATOR
+
+            /// Forward iterator over the full slots in the order of the slots.
+            template <bool is_const>
+            class iterator_base
+            {
+                friend class flat_hash_table;
+                template <bool> friend class iterator_base;
+                typedef std::conditional_t<is_const, const flat_hash_table, flat_hash_table> table_type;
+
+                table_type* table_ = nullptr;
+                size_t index_ = 0;
+
+                iterator_base(table_type* table, size_t index) : table_(table), index_(index) {}
+
+            public:
+
+                typedef std::forward_iterator_tag iterator_category;
+                typedef typename flat_hash_table::value_type value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef std::conditional_t<is_const, const value_type*, value_type*> pointer;
+                typedef std::conditional_t<is_const, const value_type&, value_type&> reference;
+
+                iterator_base() = default;
+                iterator_base(const iterator_base&) = default;
+                iterator_base& operator=(const iterator_base&) = default;
+
+                /// Conversion of iterator to const_iterator.
+                template <bool other_is_const, class = std::enable_if_t<is_const && !other_is_const>>
+                iterator_base(const iterator_base<other_is_const>& other) : table_(other.table_), index_(other.index_) {}
+
+                reference operator*() const { return table_->slots_[index_]; }
+                pointer operator->() const { return table_->slots_ + index_; }
+
+                iterator_base& operator++()
+                {
+                    index_ = table_->next_full(index_ + 1);
+                    return *this;
+                }
+
+                iterator_base operator++(int)
+                {
+                    iterator_base result = *this;
+                    ++*this;
+                    return result;
+                }
+
+                friend bool operator==(const iterator_base& lhs, const iterator_base& rhs) { return lhs.index_ == rhs.index_; }
+                friend bool operator!=(const iterator_base& lhs, const iterator_base& rhs) { return lhs.index_ != rhs.index_; }
+            };
+        };
+    }
+}
@@ -0,0 +1,79 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+namespace dot
+{
+    namespace detail
+    {
+        /// Removes the leading and trailing white space allowed by NumberStyles.Integer
+        /// and NumberStyles.Float of the invariant culture, which is U+0009 to U+000D and
+        /// U+0020.
+        inline std::string_view trim_number_white_space(std::string_view value)
+        {
+            auto is_white = [](char c) { return c == ' ' || (c >= '\t' && c <= '\r'); };
+            while (!value.empty() && is_white(value.front())) value.remove_prefix(1);
+            while (!value.empty() && is_white(value.back())) value.remove_suffix(1);
+            return value;
+        }
+
+        /// Converts the string representation of an integer using the rules of
+        /// NumberStyles.Integer and the invariant culture: optional white space,
+        /// an optional leading sign and decimal digits. Returns false and leaves
+        /// the result unchanged if the format is invalid or the value overflows.
+        template <class T>
+        bool try_parse_integer(std::string_view value, T& result)
+        {
+            typedef std::make_unsigned_t<T> unsigned_t;
+
+            value = trim_number_white_space(value);
+            bool negative = false;
+            if (!value.empty() && (value.front() == '+' || value.front() == '-'))
+            {
+                negative = value.front() == '-';
+                value.remove_prefix(1);
+            }
+            if (value.empty()) return false;
+
+            // Magnitude of the minimum value is one more than that of the maximum
+            unsigned_t limit = static_cast<unsigned_t>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+            unsigned_t magnitude = 0;
+            for (char c : value)
+            {
+                unsigned digit = static_cast<unsigned char>(c) - unsigned('0');
+                if (digit > 9) return false;
+                if (magnitude > (limit - digit) / 10) return false;
+                magnitude = magnitude * 10 + digit;
+            }
+
+            result = negative ? static_cast<T>(unsigned_t(0) - magnitude) : static_cast<T>(magnitude);
+            return true;
+        }
+    }
+}
@@ -0,0 +1,451 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/precompiled.hpp>
+#include <dot/implement.hpp>
+#include <dot/detail/reference_counter.hpp>
+#include <dot/system/arena_scope.hpp>
+#include <dot/system/cycle_collector.hpp>
+#include <dot/system/deferred_reclaimer.hpp>
+#include <dot/system/exception.hpp>
+#include <dot/system/object_pool.hpp>
+#include <dot/system/string.hpp>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+namespace dot
+{
+    namespace detail
+    {
+        /// Biased reference counting record of a thread.
+        ///
+        /// Objects created by a thread may outlive it, therefore records
+        /// are never deleted. The record of an exited thread is reused
+        /// by the next thread that creates biased objects.
+        class reference_count_owner
+        {
+        private: // FIELDS
+
+            /// Protects queue_ and alive_.
+            std::mutex mutex_;
+
+            /// Objects released by other threads whose counters must be merged.
+            std::vector<reference_counter*> queue_;
+
+            /// True if queue_ may be non-empty, read by the owner without locking.
+            std::atomic<bool> pending_ = false;
+
+            /// True while the record is attached to a running thread.
+            bool alive_ = false;
+
+            /// Next record in the list of records available for reuse.
+            reference_count_owner* next_free_ = nullptr;
+
+            /// Identifier stored in the biased counter of the objects owned by this record.
+            std::uint32_t id_ = 0;
+
+        public: // METHODS
+
+            /// Queue object for merge by the owner thread, or merge
+            /// immediately if the owner thread has exited. Called by
+            /// the thread that has set the queued flag of the object.
+            void enqueue(reference_counter* obj)
+            {
+                bool release = false;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (alive_)
+                    {
+                        queue_.push_back(obj);
+                        pending_.store(true, std::memory_order_release);
+                    }
+                    else
+                    {
+                        release = obj->merge_queued_count();
+                    }
+                }
+
+                // Delete outside the lock because the destructor may release
+                // other objects created by the same thread
+                if (release) obj->destroy();
+            }
+
+            /// Merge counters of the queued objects. Called by the owner thread.
+            void merge_queue()
+            {
+                std::vector<reference_counter*> queue;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    queue.swap(queue_);
+                    pending_.store(false, std::memory_order_relaxed);
+                }
+
+                for (reference_counter* obj : queue)
+                {
+                    if (obj->merge_queued_count()) obj->destroy();
+                }
+            }
+
+            /// True if queue_ may be non-empty.
+            bool is_pending() const
+            {
+                return pending_.load(std::memory_order_relaxed);
+            }
+
+        public: // STATIC
+
+            /// Record of the current thread, attaching one if necessary.
+            /// Returns nullptr if the thread is exiting.
+            static reference_count_owner* attach();
+
+            /// Merge remaining queued objects and release the record
+            /// of the current thread. Called on thread exit.
+            static void detach();
+
+            /// Record with the specified identifier.
+            static reference_count_owner* get(std::uint32_t id);
+        };
+
+        namespace
+        {
+            /// Source of the memory of an object.
+            enum allocation_source : size_t
+            {
+                heap_allocation = 0,
+                arena_allocation = 1,
+                pool_allocation = 2
+            };
+
+            /// Number of low bits of allocation_header::size_ holding the source.
+            const int allocation_source_bits = 2;
+
+            /// Header that precedes each object and records where its memory
+            /// was allocated from.
+            struct allocation_header
+            {
+                /// Arena chunk or tag returned by object_pool::allocate(...), zero for the heap.
+                std::uintptr_t location_;
+
+                /// Size of the object excluding the header, shifted left by
+                /// allocation_source_bits, with the source in the low bits.
+                size_t size_;
+            };
+
+            /// Size of the header, preserves the alignment of the object.
+            const size_t allocation_header_size = alignof(std::max_align_t);
+
+            static_assert(sizeof(allocation_header) <= allocation_header_size, "Allocation header does not preserve alignment.");
+
+            /// Default reference counting mode for new objects.
+            std::atomic<reference_count_mode> default_reference_count_mode_ = reference_count_mode::DOT_REFERENCE_COUNT_MODE;
+
+            /// Records available for reuse and the table of all records by identifier.
+            struct reference_count_owner_pool
+            {
+                std::mutex mutex_;
+                reference_count_owner* first_free_ = nullptr;
+                std::uint32_t count_ = 0;
+                std::atomic<reference_count_owner*> records_[reference_counter::max_reference_count_owners + 1] = {};
+            };
+
+            /// Pool is never deleted so that it remains available
+            /// to threads exiting during static destruction.
+            reference_count_owner_pool& get_reference_count_owner_pool()
+            {
+                static reference_count_owner_pool* pool = new reference_count_owner_pool();
+                return *pool;
+            }
+
+            /// Set when the current thread has detached its record or could not
+            /// obtain one, objects created after this point use the atomic mode.
+            thread_local bool reference_count_owner_detached_ = false;
+
+            /// Detaches the record when the thread exits.
+            struct reference_count_owner_guard
+            {
+                ~reference_count_owner_guard() { reference_count_owner::detach(); }
+            };
+        }
+
+        reference_count_owner* reference_count_owner::attach()
+        {
+            reference_count_owner*& result = current_reference_count_owner();
+            if (result != nullptr || reference_count_owner_detached_) return result;
+
+            static thread_local reference_count_owner_guard guard;
+
+            reference_count_owner_pool& pool = get_reference_count_owner_pool();
+            {
+                std::lock_guard<std::mutex> lock(pool.mutex_);
+                result = pool.first_free_;
+                if (result != nullptr)
+                {
+                    pool.first_free_ = result->next_free_;
+                }
+                else if (pool.count_ < reference_counter::max_reference_count_owners)
+                {
+                    result = new reference_count_owner();
+                    result->id_ = ++pool.count_;
+                    pool.records_[result->id_].store(result, std::memory_order_release);
+                }
+                else
+                {
+                    // Identifiers are exhausted, the thread uses atomic mode
+                    reference_count_owner_detached_ = true;
+                    return nullptr;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(result->mutex_);
+            result->alive_ = true;
+            current_reference_count_owner_id() = result->id_ << reference_counter::owner_shift_;
+            return result;
+        }
+
+        reference_count_owner* reference_count_owner::get(std::uint32_t id)
+        {
+            return get_reference_count_owner_pool().records_[id].load(std::memory_order_acquire);
+        }
+
+        void reference_count_owner::detach()
+        {
+            reference_count_owner_detached_ = true;
+            reference_count_owner*& owner = current_reference_count_owner();
+            if (owner == nullptr) return;
+
+            // Objects queued while merging are merged by the next iteration,
+            // objects released after the record is no longer alive are merged
+            // by the releasing thread
+            while (true)
+            {
+                std::vector<reference_counter*> queue;
+                {
+                    std::lock_guard<std::mutex> lock(owner->mutex_);
+                    if (owner->queue_.empty())
+                    {
+                        owner->alive_ = false;
+                        owner->pending_.store(false, std::memory_order_relaxed);
+                        break;
+                    }
+                    queue.swap(owner->queue_);
+                }
+
+                for (reference_counter* obj : queue)
+                {
+                    if (obj->merge_queued_count()) obj->destroy();
+                }
+            }
+
+            reference_count_owner* record = owner;
+            owner = nullptr;
+            current_reference_count_owner_id() = 0;
+
+            reference_count_owner_pool& pool = get_reference_count_owner_pool();
+            std::lock_guard<std::mutex> lock(pool.mutex_);
+            record->next_free_ = pool.first_free_;
+            pool.first_free_ = record;
+        }
+    }
+
+    void* reference_counter::operator new(size_t size)
+    {
+        size_t total_size = size + detail::allocation_header_size;
+        detail::arena_chunk* chunk = nullptr;
+        std::uintptr_t pool_tag = 0;
+        std::uintptr_t location = 0;
+        detail::allocation_source source = detail::heap_allocation;
+
+        void* memory = arena_scope::allocate(total_size, chunk);
+        if (memory != nullptr)
+        {
+            location = reinterpret_cast<std::uintptr_t>(chunk);
+            source = detail::arena_allocation;
+        }
+        else if ((memory = object_pool::allocate(total_size, pool_tag)) != nullptr)
+        {
+            location = pool_tag;
+            source = detail::pool_allocation;
+        }
+        else
+        {
+            memory = ::operator new(total_size);
+        }
+
+        detail::allocation_header* header = static_cast<detail::allocation_header*>(memory);
+        header->location_ = location;
+        header->size_ = (size << detail::allocation_source_bits) | source;
+        return static_cast<char*>(memory) + detail::allocation_header_size;
+    }
+
+    void reference_counter::operator delete(void* p)
+    {
+        if (p == nullptr) return;
+
+        void* memory = static_cast<char*>(p) - detail::allocation_header_size;
+        detail::allocation_header* header = static_cast<detail::allocation_header*>(memory);
+        switch (header->size_ & ((size_t(1) << detail::allocation_source_bits) - 1))
+        {
+        case detail::arena_allocation: arena_scope::release(reinterpret_cast<detail::arena_chunk*>(header->location_)); break;
+        case detail::pool_allocation: object_pool::release(memory, header->location_); break;
+        default: ::operator delete(memory); break;
+        }
+    }
+
+    size_t reference_counter::allocated_size() const
+    {
+        // Header precedes the most derived object rather than this base class subobject
+        const void* p = dynamic_cast<const void*>(this);
+        const void* memory = static_cast<const char*>(p) - detail::allocation_header_size;
+        return (static_cast<const detail::allocation_header*>(memory)->size_ >> detail::allocation_source_bits) + detail::allocation_header_size;
+    }
+
+    reference_count_mode reference_counter::get_reference_count_mode() const
+    {
+        if (shared_count_.load(std::memory_order_relaxed) & single_threaded_flag_) return reference_count_mode::single_threaded;
+        else if (biased_count_.load(std::memory_order_relaxed) & ~biased_count_mask_) return reference_count_mode::biased;
+        else return reference_count_mode::atomic;
+    }
+
+    reference_count_mode reference_counter::default_reference_count_mode()
+    {
+        return detail::default_reference_count_mode_.load(std::memory_order_relaxed);
+    }
+
+    void reference_counter::set_default_reference_count_mode(reference_count_mode mode)
+    {
+        detail::default_reference_count_mode_.store(mode, std::memory_order_relaxed);
+    }
+
+    void reference_counter::merge_queued_reference_counts()
+    {
+        detail::reference_count_owner* owner = detail::current_reference_count_owner();
+        if (owner != nullptr) owner->merge_queue();
+    }
+
+    void reference_counter::set_reference_count_mode(reference_count_mode mode)
+    {
+        biased_count_.store(0, std::memory_order_relaxed);
+
+        switch (mode)
+        {
+        case reference_count_mode::atomic:
+            shared_count_.store(merged_flag_, std::memory_order_relaxed);
+            break;
+        case reference_count_mode::single_threaded:
+            shared_count_.store(single_threaded_flag_, std::memory_order_relaxed);
+            break;
+        case reference_count_mode::biased:
+        {
+            detail::reference_count_owner* owner = detail::reference_count_owner::attach();
+            if (owner != nullptr) biased_count_.store(detail::current_reference_count_owner_id(), std::memory_order_relaxed);
+            shared_count_.store(owner != nullptr ? 0 : merged_flag_, std::memory_order_relaxed);
+
+            // Creating objects is a convenient point for the owner
+            // to merge objects released by other threads
+            if (owner != nullptr && owner->is_pending()) owner->merge_queue();
+            break;
+        }
+        default:
+            throw exception("Unknown reference count mode.");
+        }
+    }
+
+    void reference_counter::initialize_reference_count_mode()
+    {
+        if (detail::is_cycle_collection_enabled())
+        {
+            biased_count_.store(0, std::memory_order_relaxed);
+            shared_count_.store(single_threaded_flag_ | tracked_flag_, std::memory_order_relaxed);
+        }
+        else
+        {
+            set_reference_count_mode(default_reference_count_mode());
+        }
+    }
+
+    void reference_counter::add_possible_root()
+    {
+        cycle_collector::add_possible_root(this);
+    }
+
+    void reference_counter::delete_possible_root()
+    {
+        cycle_collector::remove_possible_root(this);
+        delete this;
+    }
+
+    void reference_counter::defer_destroy()
+    {
+        deferred_reclaimer::enqueue(this);
+    }
+
+    void reference_counter::merge_biased_count()
+    {
+        // If the object is queued, deletion is left to merge_queued_count()
+        int previous = shared_count_.fetch_or(merged_flag_, std::memory_order_acq_rel);
+        if (previous == 0) destroy();
+    }
+
+    void reference_counter::decrement_shared_count()
+    {
+        // Set the queued flag in the same operation that makes the shared
+        // count negative, so that the object cannot be deleted before the
+        // owner thread merges its counters
+        int previous = shared_count_.load(std::memory_order_relaxed);
+        int desired;
+        do
+        {
+            desired = previous - count_unit_;
+            if (!(previous & merged_flag_) && desired < 0) desired |= queued_flag_;
+        }
+        while (!shared_count_.compare_exchange_weak(previous, desired, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+        if (previous & merged_flag_)
+        {
+            if (desired == merged_flag_) destroy();
+        }
+        else if ((desired & queued_flag_) && !(previous & queued_flag_))
+        {
+            std::uint32_t owner_id = biased_count_.load(std::memory_order_relaxed) >> owner_shift_;
+            detail::reference_count_owner::get(owner_id)->enqueue(this);
+        }
+    }
+
+    bool reference_counter::merge_queued_count()
+    {
+        int previous = shared_count_.load(std::memory_order_relaxed);
+        if (previous & merged_flag_)
+        {
+            // Already merged by the owner when its biased counter reached zero
+            previous = shared_count_.fetch_and(~queued_flag_, std::memory_order_acq_rel);
+            return (previous >> count_shift_) == 0;
+        }
+
+        std::uint32_t biased = biased_count_.load(std::memory_order_relaxed);
+        int biased_count = static_cast<int>(biased & biased_count_mask_);
+        biased_count_.store(biased & ~biased_count_mask_, std::memory_order_relaxed);
+        previous = shared_count_.fetch_add(biased_count * count_unit_ + merged_flag_ - queued_flag_, std::memory_order_acq_rel);
+        return (previous >> count_shift_) + biased_count == 0;
+    }
+}
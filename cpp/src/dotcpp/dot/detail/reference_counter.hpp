@@ -23,16 +23,139 @@ limitations under the License.
 
 #pragma once
 
+#include <dot/declare.hpp>
+#include <cstdint>
+
+/// Reference counting mode for new objects unless specified otherwise
+/// using reference_counter::set_default_reference_count_mode(...) or
+/// reference_count_policy. Defined as one of the enumerators of
+/// reference_count_mode, atomic unless biased counting is selected
+/// by defining it as biased.
+#ifndef DOT_REFERENCE_COUNT_MODE
+#   define DOT_REFERENCE_COUNT_MODE atomic
+#endif
+
 namespace dot
 {
+    namespace detail { class reference_count_owner; }
+    class cycle_collector;
+    class deferred_reclaimer;
+
+    /// Specifies how the reference count of an object is updated.
+    enum class reference_count_mode : int
+    {
+        /// Every increment and decrement is an atomic read-modify-write
+        /// operation on the shared counter.
+        atomic,
+
+        /// The thread that created the object increments and decrements
+        /// a separate biased counter using non-atomic operations. Other
+        /// threads use atomic operations on the shared counter, and the
+        /// two counters are merged when the biased counter reaches zero.
+        /// Objects in this mode may be shared between threads.
+        biased,
+
+        /// Every increment and decrement is a non-atomic operation.
+        /// Objects in this mode must never be shared between threads.
+        single_threaded
+    };
+
+    namespace detail
+    {
+        /// Biased reference counting record of the current thread,
+        /// or nullptr if the thread has not created biased objects.
+        inline reference_count_owner*& current_reference_count_owner()
+        {
+            static thread_local reference_count_owner* owner = nullptr;
+            return owner;
+        }
+
+        /// True if objects released by the current thread are destroyed by deferred_reclaimer.
+        inline bool& is_deferred_release_enabled()
+        {
+            static thread_local bool enabled = false;
+            return enabled;
+        }
+
+        /// True if objects created by the current thread are tracked by cycle_collector.
+        inline bool& is_cycle_collection_enabled()
+        {
+            static thread_local bool enabled = false;
+            return enabled;
+        }
+
+        /// Identifier of the record returned by current_reference_count_owner()
+        /// shifted to the position it occupies in the biased counter, or zero.
+        inline std::uint32_t& current_reference_count_owner_id()
+        {
+            static thread_local std::uint32_t owner_id = 0;
+            return owner_id;
+        }
+    }
+
     /// All classes with reference semantics should derive from this type.
     /// It works with ptr to provide an emulation of reference semantics in C++.
-    class reference_counter
+    ///
+    /// The reference counting state occupies a single 64-bit word after
+    /// the virtual table pointer, made of two 32-bit halves. The shared
+    /// counter holds the count shifted left by count_shift_ together with
+    /// the state flags in the low bits, so that the count and the flags
+    /// are always updated by a single atomic operation. The biased counter
+    /// holds the identifier of the owner thread record in the high bits
+    /// and the count of the owner thread in the low bits. The owner thread
+    /// updates it using plain loads and stores, and other threads only
+    /// read it to compare the owner with their own record.
+    class DOT_CLASS reference_counter
     {
+        friend class detail::reference_count_owner;
+        friend class cycle_collector;
+        friend class deferred_reclaimer;
+
+    private: // CONSTANTS
+
+        /// Biased counter has been merged into the shared counter and
+        /// all further updates are made to the shared counter.
+        static constexpr int merged_flag_ = 1;
+
+        /// Object has been queued for merge by the owner thread.
+        static constexpr int queued_flag_ = 2;
+
+        /// Object uses non-atomic updates of the shared counter.
+        static constexpr int single_threaded_flag_ = 4;
+
+        /// Object is tracked by cycle_collector, only set together
+        /// with single_threaded_flag_.
+        static constexpr int tracked_flag_ = 8;
+
+        /// Object is in the buffer of possible roots of garbage cycles.
+        static constexpr int buffered_flag_ = 16;
+
+        /// Shift of the count relative to the flags.
+        static constexpr int count_shift_ = 5;
+
+        /// Increment of the shared counter corresponding to one reference.
+        static constexpr int count_unit_ = 1 << count_shift_;
+
+        /// Shift of the owner identifier in the biased counter.
+        static constexpr int owner_shift_ = 20;
+
+        /// Mask of the count in the biased counter. When the count reaches
+        /// the mask, the owner thread increments the shared counter instead.
+        static constexpr std::uint32_t biased_count_mask_ = (1u << owner_shift_) - 1;
+
+    public: // CONSTANTS
+
+        /// Maximum number of threads with biased reference counting records
+        /// at the same time, objects created by other threads use atomic mode.
+        static constexpr std::uint32_t max_reference_count_owners = (1u << (32 - owner_shift_)) - 1;
+
     private: // FIELDS
 
-        /// Reference count for intrusive pointer.
-        std::atomic<unsigned int> reference_count_ = 0;
+        /// Owner identifier and count updated only by the owner thread.
+        std::atomic<std::uint32_t> biased_count_ = 0;
+
+        /// Shared counter updated by all other threads.
+        std::atomic<int> shared_count_ = merged_flag_;
 
     public: // DESTRUCTOR
 
@@ -45,22 +168,164 @@ namespace dot
         /// Increment reference count.
         void increment_reference_count()
         {
-            ++reference_count_;
+            int shared = shared_count_.load(std::memory_order_relaxed);
+            if (shared & single_threaded_flag_)
+            {
+                shared_count_.store(shared + count_unit_, std::memory_order_relaxed);
+            }
+            else
+            {
+                std::uint32_t biased = biased_count_.load(std::memory_order_relaxed);
+                if (!(shared & merged_flag_) && is_biased_increment(biased)) biased_count_.store(biased + 1, std::memory_order_relaxed);
+                else shared_count_.fetch_add(count_unit_, std::memory_order_relaxed);
+            }
         }
 
         /// Decrement reference count, deletes if decremented count is zero.
         void decrement_reference_count()
         {
-            if (!--reference_count_)
+            int shared = shared_count_.load(std::memory_order_relaxed);
+            if (shared & single_threaded_flag_)
+            {
+                if ((shared >> count_shift_) == 1)
+                {
+                    if (shared & buffered_flag_) delete_possible_root();
+                    else destroy();
+                }
+                else
+                {
+                    shared_count_.store(shared - count_unit_, std::memory_order_relaxed);
+
+                    // Object that survives a decrement may be part of a garbage cycle
+                    if ((shared & (tracked_flag_ | buffered_flag_)) == tracked_flag_) add_possible_root();
+                }
+            }
+            else if (shared & merged_flag_)
+            {
+                // Once set, the merged flag is never cleared
+                int previous = shared_count_.fetch_sub(count_unit_, std::memory_order_acq_rel);
+                if (previous == (count_unit_ | merged_flag_)) destroy();
+            }
+            else if ((biased_count_.load(std::memory_order_relaxed) & ~biased_count_mask_) == detail::current_reference_count_owner_id())
+            {
+                std::uint32_t biased = biased_count_.load(std::memory_order_relaxed) - 1;
+                biased_count_.store(biased, std::memory_order_relaxed);
+                if (!(biased & biased_count_mask_)) merge_biased_count();
+            }
+            else
             {
-                delete this;
+                decrement_shared_count();
             }
         }
 
+        /// Current value of the reference count.
+        ///
+        /// This method is intended for diagnostics and tests, and must be
+        /// called from the thread that created the object unless it uses
+        /// the atomic mode. When the object is shared between threads,
+        /// the returned value may be out of date by the time it is used.
+        unsigned int reference_count() const
+        {
+            int shared = shared_count_.load(std::memory_order_acquire);
+            int result = shared >> count_shift_;
+            if (!(shared & (merged_flag_ | single_threaded_flag_))) result += biased_count_.load(std::memory_order_relaxed) & biased_count_mask_;
+            return static_cast<unsigned int>(result);
+        }
+
+        /// Reference counting mode of the object.
+        reference_count_mode get_reference_count_mode() const;
+
+        /// Size of the memory block allocated for the object in bytes,
+        /// including the allocation header that precedes the object.
+        size_t allocated_size() const;
+
+    public: // STATIC
+
+        /// Reference counting mode for objects created after this call.
+        static reference_count_mode default_reference_count_mode();
+
+        /// Set reference counting mode for objects created after this call.
+        static void set_default_reference_count_mode(reference_count_mode mode);
+
+        /// Merge counters of the objects released by other threads since
+        /// the last call and delete those no longer referenced.
+        ///
+        /// Merge also happens when the current thread creates new objects
+        /// and when it exits. This method is only needed to reclaim memory
+        /// promptly in a thread that no longer creates objects.
+        static void merge_queued_reference_counts();
+
+    public: // OPERATORS
+
+        /// Allocate memory for an object from the innermost arena_scope
+        /// of the current thread if any, otherwise from object_pool, or
+        /// from the global heap if the object is too large for the pool.
+        static void* operator new(size_t size);
+
+        /// Release memory allocated by operator new of this class.
+        static void operator delete(void* p);
+
     protected: // CONSTRUCTORS
 
         /// Prevent construction on stack.
-        reference_counter() = default;
+        ///
+        /// If cycle_collector is enabled on the current thread, the object
+        /// uses single_threaded mode and is tracked by the collector.
+        reference_counter()
+        {
+            initialize_reference_count_mode();
+        }
+
+    protected: // METHODS
+
+        /// Set reference counting mode of the object.
+        ///
+        /// Must be called from the constructor of the derived type,
+        /// before the object is assigned to the first ptr.
+        void set_reference_count_mode(reference_count_mode mode);
+
+    private: // METHODS
+
+        /// Set the default reference counting mode, or the mode used by cycle_collector.
+        void initialize_reference_count_mode();
+
+        /// Add the object to the buffer of possible roots of cycle_collector.
+        void add_possible_root();
+
+        /// Remove the object from the buffer of possible roots and delete it.
+        void delete_possible_root();
+
+        /// Delete the object no longer referenced, or pass it to deferred_reclaimer
+        /// if deferred release is enabled on the current thread. Objects in
+        /// single_threaded mode are always deleted by the current thread.
+        void destroy()
+        {
+            if (detail::is_deferred_release_enabled() && !(shared_count_.load(std::memory_order_relaxed) & single_threaded_flag_)) defer_destroy();
+            else delete this;
+        }
+
+        /// Pass the object to deferred_reclaimer.
+        void defer_destroy();
+
+        /// True if the current thread owns the biased counter and its count
+        /// can be incremented without reaching the owner identifier bits.
+        static bool is_biased_increment(std::uint32_t biased)
+        {
+            return (biased & ~biased_count_mask_) == detail::current_reference_count_owner_id()
+                && (biased & biased_count_mask_) != biased_count_mask_;
+        }
+
+        /// Called by the owner thread when the biased counter reaches zero.
+        void merge_biased_count();
+
+        /// Called by a thread other than the owner to decrement the shared
+        /// counter of an object whose counters have not been merged yet.
+        void decrement_shared_count();
+
+        /// Called by the owner thread, or under the lock of a record whose
+        /// thread has exited, to merge the counters of a queued object.
+        /// Returns true if the object is no longer referenced and must be deleted.
+        bool merge_queued_count();
 
     private: // CONSTRUCTORS
 
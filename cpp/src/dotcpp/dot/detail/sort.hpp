@@ -0,0 +1,308 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <dot/declare.hpp>
+#include <dot/detail/work_stealing_pool.hpp>
+#include <dot/system/ptr.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace dot
+{
+    namespace detail
+    {
+        /// Minimum number of elements sorted by radix sort when the keys permit it,
+        /// smaller sequences are sorted by comparison.
+        constexpr int radix_sort_threshold = 256;
+
+        /// Minimum number of elements sorted by parallel merge sort when
+        /// work_stealing_pool has more than one worker.
+        constexpr int parallel_sort_threshold = 1 << 14;
+
+        /// Minimum number of elements in each block sorted by one worker.
+        constexpr int parallel_sort_block_size = 1024;
+
+        /// Mapping of a sort key to an unsigned integer with the same order,
+        /// used by radix sort. The primary template is used for keys that
+        /// are sorted by comparison, specializations define the type of
+        /// the integer and the method get(key).
+        template <class T, class = void>
+        struct radix_key
+        {
+            static constexpr bool value = false;
+        };
+
+        /// Integers other than bool are mapped by flipping the sign bit.
+        template <class T>
+        struct radix_key<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>>
+        {
+            static constexpr bool value = true;
+            typedef std::make_unsigned_t<T> type;
+
+            static type get(T key)
+            {
+                if constexpr (std::is_signed<T>::value) return static_cast<type>(static_cast<type>(key) ^ (type(1) << (sizeof(T) * 8 - 1)));
+                else return key;
+            }
+        };
+
+        /// Doubles are mapped by inverting negative values and setting the sign
+        /// bit of positive values. Negative zero is mapped as zero and NaN below
+        /// negative infinity, consistent with compare_sort_keys(...).
+        template <>
+        struct radix_key<double>
+        {
+            static constexpr bool value = true;
+            typedef std::uint64_t type;
+
+            static type get(double key)
+            {
+                if (key != key) return 0;
+                if (key == 0) key = 0;
+
+                type bits;
+                std::memcpy(&bits, &key, sizeof(bits));
+                return (bits >> 63) ? ~bits : bits | (type(1) << 63);
+            }
+        };
+
+        /// Compares two keys and returns a negative number, zero or a positive
+        /// number if lhs is less than, equal to or greater than rhs. NaN is equal
+        /// to itself and less than other floating point values, and null is equal
+        /// to itself and less than other references, as in C#.
+        template <class K>
+        int compare_sort_keys(const K& lhs, const K& rhs)
+        {
+            if constexpr (is_ptr<K>::value)
+            {
+                bool lhs_null = lhs == nullptr;
+                bool rhs_null = rhs == nullptr;
+                if (lhs_null || rhs_null) return int(rhs_null) - int(lhs_null);
+            }
+            if (lhs < rhs) return -1;
+            if (rhs < lhs) return 1;
+            if constexpr (std::is_floating_point<K>::value)
+            {
+                bool lhs_nan = lhs != lhs;
+                bool rhs_nan = rhs != rhs;
+                return int(rhs_nan) - int(lhs_nan);
+            }
+            return 0;
+        }
+
+        /// Stable radix sort of the positions in order by keys[position], one
+        /// byte at a time starting from the least significant. Bytes that are
+        /// the same for all keys are skipped.
+        template <bool descending, class K>
+        void radix_sort_order(std::vector<int>& order, const std::vector<K>& keys)
+        {
+            typedef typename radix_key<K>::type radix_t;
+            struct item { radix_t key; int position; };
+            constexpr int digit_count = sizeof(radix_t);
+
+            int count = static_cast<int>(order.size());
+            std::vector<item> items(count);
+            std::vector<item> buffer(count);
+            std::array<std::array<int, 256>, digit_count> histograms = {};
+            for (int i = 0; i < count; ++i)
+            {
+                radix_t key = radix_key<K>::get(keys[order[i]]);
+                if (descending) key = static_cast<radix_t>(~key);
+                items[i] = item{ key, order[i] };
+                for (int digit = 0; digit < digit_count; ++digit) ++histograms[digit][(key >> (8 * digit)) & 255];
+            }
+
+            for (int digit = 0; digit < digit_count && count > 0; ++digit)
+            {
+                std::array<int, 256>& histogram = histograms[digit];
+                int shift = 8 * digit;
+                if (histogram[(items[0].key >> shift) & 255] == count) continue;
+
+                int offset = 0;
+                for (int& bucket : histogram)
+                {
+                    int bucket_count = bucket;
+                    bucket = offset;
+                    offset += bucket_count;
+                }
+                for (const item& x : items) buffer[histogram[(x.key >> shift) & 255]++] = x;
+                items.swap(buffer);
+            }
+
+            for (int i = 0; i < count; ++i) order[i] = items[i].position;
+        }
+
+        /// Stable sort of the positions in order, in parallel on work_stealing_pool.
+        /// Blocks of positions are sorted by the workers and then merged pairwise,
+        /// each round of merges running in parallel. The comparison is called
+        /// concurrently from several threads.
+        template <class less_t>
+        void parallel_stable_sort(std::vector<int>& order, const less_t& less)
+        {
+            int count = static_cast<int>(order.size());
+            int block_count = std::max(1, std::min(work_stealing_pool::worker_count(), count / parallel_sort_block_size));
+            auto block_begin = [count, block_count](int block) { return static_cast<int>(std::int64_t(count) * block / block_count); };
+
+            auto sort_block = [&](int, int block)
+            {
+                std::stable_sort(order.begin() + block_begin(block), order.begin() + block_begin(block + 1), less);
+            };
+            work_stealing_pool::run(block_count, sort_block);
+
+            // Merge adjacent runs of width blocks until a single run remains
+            std::vector<int> buffer(count);
+            for (int width = 1; width < block_count; width *= 2)
+            {
+                auto merge_runs = [&](int, int merge)
+                {
+                    int begin = block_begin(std::min(block_count, 2 * merge * width));
+                    int middle = block_begin(std::min(block_count, (2 * merge + 1) * width));
+                    int end = block_begin(std::min(block_count, (2 * merge + 2) * width));
+                    std::merge(order.begin() + begin, order.begin() + middle, order.begin() + middle, order.begin() + end, buffer.begin() + begin, less);
+                };
+                work_stealing_pool::run((block_count + 2 * width - 1) / (2 * width), merge_runs);
+                order.swap(buffer);
+            }
+        }
+
+        /// Keys of a sort without keys, which considers all elements equal.
+        struct empty_sort_keys
+        {
+            static constexpr bool is_radix = true;
+
+            int compare(int, int) const { return 0; }
+
+            void radix_sort(std::vector<int>&) const {}
+        };
+
+        /// Keys of a sort extracted once per element, compared at positions
+        /// lhs and rhs when the elements are equal according to the previous keys.
+        template <class previous_t, class key_t, bool descending>
+        class sort_keys
+        {
+            previous_t previous_;
+            std::vector<key_t> keys_;
+
+        public:
+
+            /// True if all keys can be sorted by radix sort.
+            static constexpr bool is_radix = previous_t::is_radix && radix_key<key_t>::value;
+
+            sort_keys(previous_t previous, std::vector<key_t> keys) : previous_(std::move(previous)), keys_(std::move(keys)) {}
+
+            int compare(int lhs, int rhs) const
+            {
+                int result = previous_.compare(lhs, rhs);
+                if (result != 0) return result;
+                result = compare_sort_keys(keys_[lhs], keys_[rhs]);
+                return descending ? -result : result;
+            }
+
+            /// Sorts by the least significant keys first, so that the stable
+            /// sorts by the previous keys preserve their order.
+            void radix_sort(std::vector<int>& order) const
+            {
+                radix_sort_order<descending>(order, keys_);
+                previous_.radix_sort(order);
+            }
+        };
+
+        /// Keys of a sort of values by the values themselves.
+        template <class T>
+        class value_sort_keys
+        {
+            const std::vector<T>& values_;
+
+        public:
+
+            static constexpr bool is_radix = radix_key<T>::value;
+
+            explicit value_sort_keys(const std::vector<T>& values) : values_(values) {}
+
+            int compare(int lhs, int rhs) const { return compare_sort_keys(values_[lhs], values_[rhs]); }
+
+            void radix_sort(std::vector<int>& order) const { radix_sort_order<false>(order, values_); }
+        };
+
+        /// Positions of count elements in the order of a stable sort by the keys.
+        /// Radix sort is used if the keys permit it, otherwise parallel merge sort
+        /// if parallel is true, and merge sort on the current thread otherwise.
+        template <class keys_t>
+        std::vector<int> sort_order(const keys_t& keys, int count, bool parallel)
+        {
+            std::vector<int> order(count);
+            for (int i = 0; i < count; ++i) order[i] = i;
+
+            if constexpr (keys_t::is_radix)
+            {
+                if (count >= radix_sort_threshold)
+                {
+                    keys.radix_sort(order);
+                    return order;
+                }
+            }
+
+            auto less = [&keys](int lhs, int rhs) { return keys.compare(lhs, rhs) < 0; };
+            if (parallel && work_stealing_pool::worker_count() > 1) parallel_stable_sort(order, less);
+            else std::stable_sort(order.begin(), order.end(), less);
+            return order;
+        }
+
+        /// Rearrange the elements in the order of the positions returned by sort_order(...).
+        template <class T>
+        void apply_sort_order(std::vector<T>& items, const std::vector<int>& order)
+        {
+            std::vector<T> result;
+            result.reserve(items.size());
+            for (int i : order) result.push_back(std::move(items[i]));
+            items.swap(result);
+        }
+
+        /// Stable sort of the elements by the keys extracted from them, in parallel
+        /// if there are at least parallel_sort_threshold elements.
+        template <class T, class keys_t>
+        void sort_by_keys(std::vector<T>& items, const keys_t& keys)
+        {
+            int count = static_cast<int>(items.size());
+            apply_sort_order(items, sort_order(keys, count, count >= parallel_sort_threshold));
+        }
+
+        /// Sort of the elements by their values, which is not stable unless the
+        /// values are sorted by radix sort or there are at least parallel_sort_threshold
+        /// elements and more than one worker.
+        template <class T>
+        void sort_values(std::vector<T>& items)
+        {
+            int count = static_cast<int>(items.size());
+            bool radix = radix_key<T>::value && count >= radix_sort_threshold;
+            bool parallel = count >= parallel_sort_threshold && work_stealing_pool::worker_count() > 1;
+            if (radix || parallel) apply_sort_order(items, sort_order(value_sort_keys<T>(items), count, parallel));
+            else std::sort(items.begin(), items.end(), [](const T& lhs, const T& rhs) { return compare_sort_keys(lhs, rhs) < 0; });
+        }
+    }
+}
@@ -0,0 +1,639 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/precompiled.hpp>
+#include <dot/implement.hpp>
+#include <dot/detail/string_kernels.hpp>
+#include <dot/system/exception.hpp>
+#include <cstdint>
+#include <cstring>
+
+/// Vector kernels are compiled on x86-64 unless DOT_DISABLE_SIMD is defined.
+/// SSE2 is part of the x86-64 baseline and needs no compiler flags, AVX2
+/// kernels are compiled for that instruction set using a function attribute
+/// and selected at runtime if the processor supports them.
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(DOT_DISABLE_SIMD)
+#   define DOT_STRING_KERNELS_SIMD 1
+#   include <immintrin.h>
+#   if defined(_MSC_VER) && !defined(__clang__)
+#       include <intrin.h>
+#       define DOT_TARGET_AVX2
+#   else
+#       define DOT_TARGET_AVX2 __attribute__((target("avx2")))
+#   endif
+#endif
+
+namespace dot
+{
+    namespace detail
+    {
+        namespace
+        {
+            const size_t npos = std::string_view::npos;
+
+            /// Pointers to the kernels for one instruction set.
+            struct string_kernel_table
+            {
+                simd_level level;
+                size_t (*find_byte)(const char*, size_t, char);
+                size_t (*find_last_byte)(const char*, size_t, char);
+                size_t (*find_any_byte)(const char*, size_t, const char*, size_t);
+                size_t (*find_bytes)(const char*, size_t, const char*, size_t);
+                void (*to_lower_ascii)(const char*, char*, size_t);
+                void (*to_upper_ascii)(const char*, char*, size_t);
+                size_t (*find_mismatch_ignore_case_ascii)(const char*, const char*, size_t);
+                std::uint64_t (*hash_upper_ascii)(const char*, size_t, std::uint64_t);
+            };
+
+            // SCALAR
+
+            size_t find_byte_scalar(const char* data, size_t size, char value)
+            {
+                for (size_t i = 0; i < size; ++i) if (data[i] == value) return i;
+                return npos;
+            }
+
+            size_t find_last_byte_scalar(const char* data, size_t size, char value)
+            {
+                for (size_t i = size; i > 0; --i) if (data[i - 1] == value) return i - 1;
+                return npos;
+            }
+
+            size_t find_any_byte_scalar(const char* data, size_t size, const char* values, size_t count)
+            {
+                bool table[256] = {};
+                for (size_t i = 0; i < count; ++i) table[static_cast<unsigned char>(values[i])] = true;
+                for (size_t i = 0; i < size; ++i) if (table[static_cast<unsigned char>(data[i])]) return i;
+                return npos;
+            }
+
+            size_t find_bytes_scalar(const char* data, size_t size, const char* value, size_t count)
+            {
+                if (count == 0) return 0;
+                if (count > size) return npos;
+                for (size_t i = 0; i <= size - count; ++i)
+                {
+                    if (data[i] == value[0] && std::memcmp(data + i + 1, value + 1, count - 1) == 0) return i;
+                }
+                return npos;
+            }
+
+            void to_lower_ascii_scalar(const char* source, char* target, size_t size)
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    char c = source[i];
+                    target[i] = (c >= 'A' && c <= 'Z') ? char(c + ('a' - 'A')) : c;
+                }
+            }
+
+            void to_upper_ascii_scalar(const char* source, char* target, size_t size)
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    char c = source[i];
+                    target[i] = (c >= 'a' && c <= 'z') ? char(c - ('a' - 'A')) : c;
+                }
+            }
+
+            /// Convert the ASCII letters in the eight bytes of the word to uppercase.
+            inline std::uint64_t to_upper_ascii_word(std::uint64_t word)
+            {
+                // The high bit of each byte is set by the addition if the low seven
+                // bits are at least 'a' and above 'z' respectively, without carry
+                const std::uint64_t high = 0x8080808080808080ull;
+                std::uint64_t low_bits = word & ~high;
+                std::uint64_t at_least_a = low_bits + 0x1F1F1F1F1F1F1F1Full;
+                std::uint64_t above_z = low_bits + 0x0505050505050505ull;
+                std::uint64_t lower = at_least_a & ~above_z & ~word & high;
+                return word ^ (lower >> 2);
+            }
+
+            /// Mix the word into the hash state.
+            inline std::uint64_t mix_word(std::uint64_t state, std::uint64_t word)
+            {
+                state = (state ^ word) * 0x9E3779B97F4A7C15ull;
+                return state ^ (state >> 32);
+            }
+
+            /// Load eight bytes, or fewer padded with zeros, as a little-endian word.
+            inline std::uint64_t load_word(const char* data, size_t size)
+            {
+                std::uint64_t result = 0;
+                for (size_t i = 0; i < size; ++i) result |= std::uint64_t(static_cast<unsigned char>(data[i])) << (8 * i);
+                return result;
+            }
+
+            size_t find_mismatch_ignore_case_ascii_scalar(const char* lhs, const char* rhs, size_t size)
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    char a = lhs[i];
+                    char b = rhs[i];
+                    if (a == b) continue;
+                    if (a >= 'a' && a <= 'z') a -= 'a' - 'A';
+                    if (b >= 'a' && b <= 'z') b -= 'a' - 'A';
+                    if (a != b) return i;
+                }
+                return npos;
+            }
+
+            std::uint64_t hash_upper_ascii_scalar(const char* data, size_t size, std::uint64_t state)
+            {
+                size_t i = 0;
+                for (; i + 8 <= size; i += 8) state = mix_word(state, to_upper_ascii_word(load_word(data + i, 8)));
+                if (i < size) state = mix_word(state, to_upper_ascii_word(load_word(data + i, size - i)));
+                return state;
+            }
+
+            const string_kernel_table scalar_kernels =
+            {
+                simd_level::scalar,
+                find_byte_scalar, find_last_byte_scalar, find_any_byte_scalar,
+                find_bytes_scalar, to_lower_ascii_scalar, to_upper_ascii_scalar,
+                find_mismatch_ignore_case_ascii_scalar, hash_upper_ascii_scalar
+            };
+
+#ifdef DOT_STRING_KERNELS_SIMD
+
+            /// Index of the lowest set bit, mask must not be zero.
+            inline unsigned int lowest_bit(std::uint32_t mask)
+            {
+#if defined(_MSC_VER) && !defined(__clang__)
+                unsigned long result;
+                _BitScanForward(&result, mask);
+                return result;
+#else
+                return __builtin_ctz(mask);
+#endif
+            }
+
+            /// Index of the highest set bit, mask must not be zero.
+            inline unsigned int highest_bit(std::uint32_t mask)
+            {
+#if defined(_MSC_VER) && !defined(__clang__)
+                unsigned long result;
+                _BitScanReverse(&result, mask);
+                return result;
+#else
+                return 31 - __builtin_clz(mask);
+#endif
+            }
+
+            /// Maximum number of bytes compared using one vector each by find_any_byte,
+            /// larger sets use the lookup table of the scalar kernel.
+            const size_t max_vector_byte_set = 8;
+
+            // SSE2
+
+            size_t find_byte_sse2(const char* data, size_t size, char value)
+            {
+                __m128i needle = _mm_set1_epi8(value);
+                size_t i = 0;
+                for (; i + 16 <= size; i += 16)
+                {
+                    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    std::uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+                    if (mask) return i + lowest_bit(mask);
+                }
+                for (; i < size; ++i) if (data[i] == value) return i;
+                return npos;
+            }
+
+            size_t find_last_byte_sse2(const char* data, size_t size, char value)
+            {
+                __m128i needle = _mm_set1_epi8(value);
+                size_t i = size;
+                for (; i >= 16; i -= 16)
+                {
+                    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i - 16));
+                    std::uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+                    if (mask) return i - 16 + highest_bit(mask);
+                }
+                for (; i > 0; --i) if (data[i - 1] == value) return i - 1;
+                return npos;
+            }
+
+            size_t find_any_byte_sse2(const char* data, size_t size, const char* values, size_t count)
+            {
+                if (count > max_vector_byte_set) return find_any_byte_scalar(data, size, values, count);
+
+                __m128i needles[max_vector_byte_set];
+                for (size_t j = 0; j < count; ++j) needles[j] = _mm_set1_epi8(values[j]);
+
+                size_t i = 0;
+                for (; i + 16 <= size; i += 16)
+                {
+                    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    __m128i found = _mm_setzero_si128();
+                    for (size_t j = 0; j < count; ++j) found = _mm_or_si128(found, _mm_cmpeq_epi8(block, needles[j]));
+                    std::uint32_t mask = _mm_movemask_epi8(found);
+                    if (mask) return i + lowest_bit(mask);
+                }
+                size_t tail = find_any_byte_scalar(data + i, size - i, values, count);
+                return tail == npos ? npos : i + tail;
+            }
+
+            size_t find_bytes_sse2(const char* data, size_t size, const char* value, size_t count)
+            {
+                if (count <= 1) return count == 0 ? 0 : find_byte_sse2(data, size, value[0]);
+                if (count > size) return npos;
+
+                // Compare the first and the last byte of the value at 16 positions
+                // at once, then compare the remaining bytes at matching positions
+                __m128i first = _mm_set1_epi8(value[0]);
+                __m128i last = _mm_set1_epi8(value[count - 1]);
+                size_t i = 0;
+                for (; i + count - 1 + 16 <= size; i += 16)
+                {
+                    __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + count - 1));
+                    std::uint32_t mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last)));
+                    while (mask)
+                    {
+                        size_t pos = i + lowest_bit(mask);
+                        if (std::memcmp(data + pos + 1, value + 1, count - 2) == 0) return pos;
+                        mask &= mask - 1;
+                    }
+                }
+                size_t tail = find_bytes_scalar(data + i, size - i, value, count);
+                return tail == npos ? npos : i + tail;
+            }
+
+            /// Add delta to the bytes of block in the range from lo to hi, both
+            /// of which must be ASCII so that bytes above 127 are not changed.
+            inline __m128i shift_range_sse2(__m128i block, char lo, char hi, char delta)
+            {
+                __m128i in_range = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(block, _mm_set1_epi8(hi + 1)));
+                return _mm_add_epi8(block, _mm_and_si128(in_range, _mm_set1_epi8(delta)));
+            }
+
+            void to_lower_ascii_sse2(const char* source, char* target, size_t size)
+            {
+                size_t i = 0;
+                for (; i + 16 <= size; i += 16)
+                {
+                    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), shift_range_sse2(block, 'A', 'Z', 'a' - 'A'));
+                }
+                to_lower_ascii_scalar(source + i, target + i, size - i);
+            }
+
+            void to_upper_ascii_sse2(const char* source, char* target, size_t size)
+            {
+                size_t i = 0;
+                for (; i + 16 <= size; i += 16)
+                {
+                    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), shift_range_sse2(block, 'a', 'z', 'A' - 'a'));
+                }
+                to_upper_ascii_scalar(source + i, target + i, size - i);
+            }
+
+            size_t find_mismatch_ignore_case_ascii_sse2(const char* lhs, const char* rhs, size_t size)
+            {
+                size_t i = 0;
+                for (; i + 16 <= size; i += 16)
+                {
+                    __m128i a = shift_range_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i)), 'a', 'z', 'A' - 'a');
+                    __m128i b = shift_range_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i)), 'a', 'z', 'A' - 'a');
+                    std::uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xFFFF;
+                    if (mask) return i + lowest_bit(mask);
+                }
+                size_t tail = find_mismatch_ignore_case_ascii_scalar(lhs + i, rhs + i, size - i);
+                return tail == npos ? npos : i + tail;
+            }
+
+            std::uint64_t hash_upper_ascii_sse2(const char* data, size_t size, std::uint64_t state)
+            {
+                size_t i = 0;
+                for (; i + 16 <= size; i += 16)
+                {
+                    __m128i block = shift_range_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), 'a', 'z', 'A' - 'a');
+                    std::uint64_t words[2];
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(words), block);
+                    state = mix_word(mix_word(state, words[0]), words[1]);
+                }
+                return hash_upper_ascii_scalar(data + i, size - i, state);
+            }
+
+            const string_kernel_table sse2_kernels =
+            {
+                simd_level::sse2,
+                find_byte_sse2, find_last_byte_sse2, find_any_byte_sse2,
+                find_bytes_sse2, to_lower_ascii_sse2, to_upper_ascii_sse2,
+                find_mismatch_ignore_case_ascii_sse2, hash_upper_ascii_sse2
+            };
+
+            // AVX2
+
+            DOT_TARGET_AVX2 size_t find_byte_avx2(const char* data, size_t size, char value)
+            {
+                __m256i needle = _mm256_set1_epi8(value);
+                size_t i = 0;
+                for (; i + 32 <= size; i += 32)
+                {
+                    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                    std::uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle));
+                    if (mask) return i + lowest_bit(mask);
+                }
+                size_t tail = find_byte_sse2(data + i, size - i, value);
+                return tail == npos ? npos : i + tail;
+            }
+
+            DOT_TARGET_AVX2 size_t find_last_byte_avx2(const char* data, size_t size, char value)
+            {
+                __m256i needle = _mm256_set1_epi8(value);
+                size_t i = size;
+                for (; i >= 32; i -= 32)
+                {
+                    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i - 32));
+                    std::uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle));
+                    if (mask) return i - 32 + highest_bit(mask);
+                }
+                return find_last_byte_sse2(data, i, value);
+            }
+
+            DOT_TARGET_AVX2 size_t find_any_byte_avx2(const char* data, size_t size, const char* values, size_t count)
+            {
+                if (count > max_vector_byte_set) return find_any_byte_scalar(data, size, values, count);
+
+                __m256i needles[max_vector_byte_set];
+                for (size_t j = 0; j < count; ++j) needles[j] = _mm256_set1_epi8(values[j]);
+
+                size_t i = 0;
+                for (; i + 32 <= size; i += 32)
+                {
+                    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                    __m256i found = _mm256_setzero_si256();
+                    for (size_t j = 0; j < count; ++j) found = _mm256_or_si256(found, _mm256_cmpeq_epi8(block, needles[j]));
+                    std::uint32_t mask = _mm256_movemask_epi8(found);
+                    if (mask) return i + lowest_bit(mask);
+                }
+                size_t tail = find_any_byte_sse2(data + i, size - i, values, count);
+                return tail == npos ? npos : i + tail;
+            }
+
+            DOT_TARGET_AVX2 size_t find_bytes_avx2(const char* data, size_t size, const char* value, size_t count)
+            {
+                if (count <= 1) return count == 0 ? 0 : find_byte_avx2(data, size, value[0]);
+                if (count > size) return npos;
+
+                __m256i first = _mm256_set1_epi8(value[0]);
+                __m256i last = _mm256_set1_epi8(value[count - 1]);
+                size_t i = 0;
+                for (; i + count - 1 + 32 <= size; i += 32)
+                {
+                    __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                    __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + count - 1));
+                    std::uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last)));
+                    while (mask)
+                    {
+                        size_t pos = i + lowest_bit(mask);
+                        if (std::memcmp(data + pos + 1, value + 1, count - 2) == 0) return pos;
+                        mask &= mask - 1;
+                    }
+                }
+                size_t tail = find_bytes_sse2(data + i, size - i, value, count);
+                return tail == npos ? npos : i + tail;
+            }
+
+            DOT_TARGET_AVX2 inline __m256i shift_range_avx2(__m256i block, char lo, char hi, char delta)
+            {
+                __m256i in_range = _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8(lo - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), block));
+                return _mm256_add_epi8(block, _mm256_and_si256(in_range, _mm256_set1_epi8(delta)));
+            }
+
+            DOT_TARGET_AVX2 void to_lower_ascii_avx2(const char* source, char* target, size_t size)
+            {
+                size_t i = 0;
+                for (; i + 32 <= size; i += 32)
+                {
+                    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i), shift_range_avx2(block, 'A', 'Z', 'a' - 'A'));
+                }
+                to_lower_ascii_sse2(source + i, target + i, size - i);
+            }
+
+            DOT_TARGET_AVX2 void to_upper_ascii_avx2(const char* source, char* target, size_t size)
+            {
+                size_t i = 0;
+                for (; i + 32 <= size; i += 32)
+                {
+                    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i), shift_range_avx2(block, 'a', 'z', 'A' - 'a'));
+                }
+                to_upper_ascii_sse2(source + i, target + i, size - i);
+            }
+
+            DOT_TARGET_AVX2 size_t find_mismatch_ignore_case_ascii_avx2(const char* lhs, const char* rhs, size_t size)
+            {
+                size_t i = 0;
+                for (; i + 32 <= size; i += 32)
+                {
+                    __m256i a = shift_range_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i)), 'a', 'z', 'A' - 'a');
+                    __m256i b = shift_range_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i)), 'a', 'z', 'A' - 'a');
+                    std::uint32_t mask = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+                    if (mask) return i + lowest_bit(mask);
+                }
+
+                // The tail is compared here rather than by the SSE2 kernel, because
+                // the keys of hash tables are short and calling code compiled without
+                // VEX encoding from here costs more than the comparison
+                if (i + 16 <= size)
+                {
+                    __m128i a = shift_range_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i)), 'a', 'z', 'A' - 'a');
+                    __m128i b = shift_range_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i)), 'a', 'z', 'A' - 'a');
+                    std::uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xFFFF;
+                    if (mask) return i + lowest_bit(mask);
+                    i += 16;
+                }
+                size_t tail = find_mismatch_ignore_case_ascii_scalar(lhs + i, rhs + i, size - i);
+                return tail == npos ? npos : i + tail;
+            }
+
+            DOT_TARGET_AVX2 std::uint64_t hash_upper_ascii_avx2(const char* data, size_t size, std::uint64_t state)
+            {
+                size_t i = 0;
+                for (; i + 32 <= size; i += 32)
+                {
+                    __m256i block = shift_range_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), 'a', 'z', 'A' - 'a');
+                    std::uint64_t words[4];
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(words), block);
+                    state = mix_word(mix_word(mix_word(mix_word(state, words[0]), words[1]), words[2]), words[3]);
+                }
+
+                // The tail is hashed here for the same reason as in find_mismatch_ignore_case_ascii_avx2
+                if (i + 16 <= size)
+                {
+                    __m128i block = shift_range_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), 'a', 'z', 'A' - 'a');
+                    std::uint64_t words[2];
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(words), block);
+                    state = mix_word(mix_word(state, words[0]), words[1]);
+                    i += 16;
+                }
+                return hash_upper_ascii_scalar(data + i, size - i, state);
+            }
+
+            const string_kernel_table avx2_kernels =
+            {
+                simd_level::avx2,
+                find_byte_avx2, find_last_byte_avx2, find_any_byte_avx2,
+                find_bytes_avx2, to_lower_ascii_avx2, to_upper_ascii_avx2,
+                find_mismatch_ignore_case_ascii_avx2, hash_upper_ascii_avx2
+            };
+
+            /// True if the processor and the operating system support AVX2.
+            bool is_avx2_supported()
+            {
+#if defined(_MSC_VER) && !defined(__clang__)
+                int info[4];
+                __cpuid(info, 0);
+                if (info[0] < 7) return false;
+
+                // AVX enabled by the operating system for the upper halves of the registers
+                __cpuid(info, 1);
+                bool osxsave = (info[2] & (1 << 27)) != 0;
+                bool avx = (info[2] & (1 << 28)) != 0;
+                if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+
+                __cpuidex(info, 7, 0);
+                return (info[1] & (1 << 5)) != 0;
+#else
+                return __builtin_cpu_supports("avx2");
+#endif
+            }
+
+#endif
+
+            /// Kernels of the specified instruction set.
+            const string_kernel_table& get_string_kernels(simd_level level)
+            {
+                switch (level)
+                {
+#ifdef DOT_STRING_KERNELS_SIMD
+                case simd_level::avx2: return avx2_kernels;
+                case simd_level::sse2: return sse2_kernels;
+#endif
+                default: return scalar_kernels;
+                }
+            }
+
+            /// Kernels used by the public functions, initially those of
+            /// the highest supported instruction set.
+            std::atomic<const string_kernel_table*>& current_string_kernels()
+            {
+                static std::atomic<const string_kernel_table*> kernels(&get_string_kernels(supported_simd_level()));
+                return kernels;
+            }
+
+            const string_kernel_table& kernels()
+            {
+                return *current_string_kernels().load(std::memory_order_relaxed);
+            }
+        }
+
+        simd_level supported_simd_level()
+        {
+#ifdef DOT_STRING_KERNELS_SIMD
+            static simd_level result = is_avx2_supported() ? simd_level::avx2 : simd_level::sse2;
+            return result;
+#else
+            return simd_level::scalar;
+#endif
+        }
+
+        simd_level get_simd_level()
+        {
+            return kernels().level;
+        }
+
+        void set_simd_level(simd_level level)
+        {
+            if (static_cast<int>(level) > static_cast<int>(supported_simd_level()))
+                throw exception("Instruction set is not supported by the processor or the build.");
+            current_string_kernels().store(&get_string_kernels(level), std::memory_order_relaxed);
+        }
+
+        size_t find_byte(const char* data, size_t size, char value)
+        {
+            return kernels().find_byte(data, size, value);
+        }
+
+        size_t find_last_byte(const char* data, size_t size, char value)
+        {
+            return kernels().find_last_byte(data, size, value);
+        }
+
+        size_t find_any_byte(const char* data, size_t size, const char* values, size_t count)
+        {
+            if (count == 0) return npos;
+            if (count == 1) return kernels().find_byte(data, size, values[0]);
+            return kernels().find_any_byte(data, size, values, count);
+        }
+
+        size_t find_bytes(const char* data, size_t size, const char* value, size_t count)
+        {
+            return kernels().find_bytes(data, size, value, count);
+        }
+
+        size_t find_last_bytes(const char* data, size_t size, const char* value, size_t count)
+        {
+            if (count > size) return npos;
+            if (count == 0) return size;
+
+            // Search backwards for the first byte of the value among the
+            // positions where the whole value fits, then compare the rest
+            const string_kernel_table& k = kernels();
+            size_t end = size - count + 1;
+            while (end > 0)
+            {
+                size_t pos = k.find_last_byte(data, end, value[0]);
+                if (pos == npos) return npos;
+                if (std::memcmp(data + pos + 1, value + 1, count - 1) == 0) return pos;
+                end = pos;
+            }
+            return npos;
+        }
+
+        void to_lower_ascii(const char* source, char* target, size_t size)
+        {
+            kernels().to_lower_ascii(source, target, size);
+        }
+
+        void to_upper_ascii(const char* source, char* target, size_t size)
+        {
+            kernels().to_upper_ascii(source, target, size);
+        }
+
+        size_t find_mismatch_ignore_case_ascii(const char* lhs, const char* rhs, size_t size)
+        {
+            return kernels().find_mismatch_ignore_case_ascii(lhs, rhs, size);
+        }
+
+        std::uint64_t hash_upper_ascii(const char* data, size_t size, std::uint64_t state)
+        {
+            return kernels().hash_upper_ascii(data, size, state);
+        }
+    }
+}
@@ -0,0 +1,99 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+#include <cstdint>
+#include <string_view>
+
+namespace dot
+{
+    namespace detail
+    {
+        /// Instruction set used by the string kernels.
+        enum class simd_level : int
+        {
+            /// Portable implementation without vector instructions.
+            scalar,
+
+            /// 16-byte vectors, available on all x86-64 processors.
+            sse2,
+
+            /// 32-byte vectors, selected at startup if the processor supports them.
+            avx2
+        };
+
+        /// Highest instruction set supported by the processor and enabled in the build.
+        DOT_CLASS simd_level supported_simd_level();
+
+        /// Instruction set currently used by the string kernels.
+        DOT_CLASS simd_level get_simd_level();
+
+        /// Select the instruction set used by the string kernels, intended
+        /// for tests and benchmarks that compare the implementations.
+        ///
+        /// Error if the processor or the build does not support it.
+        DOT_CLASS void set_simd_level(simd_level level);
+
+        /// Position of the first byte equal to value, or npos.
+        DOT_CLASS size_t find_byte(const char* data, size_t size, char value);
+
+        /// Position of the last byte equal to value, or npos.
+        DOT_CLASS size_t find_last_byte(const char* data, size_t size, char value);
+
+        /// Position of the first byte equal to any of the count bytes at values, or npos.
+        DOT_CLASS size_t find_any_byte(const char* data, size_t size, const char* values, size_t count);
+
+        /// Position of the first occurrence of the count bytes at value, or npos.
+        /// Empty value is found at position zero.
+        DOT_CLASS size_t find_bytes(const char* data, size_t size, const char* value, size_t count);
+
+        /// Position of the last occurrence of the count bytes at value, or npos.
+        /// Empty value is found at position size.
+        DOT_CLASS size_t find_last_bytes(const char* data, size_t size, const char* value, size_t count);
+
+        /// Copy size bytes from source to target converting ASCII letters
+        /// to lowercase. Other bytes, including those of multibyte UTF-8
+        /// sequences, are copied unchanged.
+        DOT_CLASS void to_lower_ascii(const char* source, char* target, size_t size);
+
+        /// Copy size bytes from source to target converting ASCII letters
+        /// to uppercase. Other bytes, including those of multibyte UTF-8
+        /// sequences, are copied unchanged.
+        DOT_CLASS void to_upper_ascii(const char* source, char* target, size_t size);
+
+        /// Position of the first of size bytes that differ between lhs and rhs
+        /// after converting ASCII letters to uppercase, or npos. Other bytes,
+        /// including those of multibyte UTF-8 sequences, are compared unchanged.
+        DOT_CLASS size_t find_mismatch_ignore_case_ascii(const char* lhs, const char* rhs, size_t size);
+
+        /// Mix size bytes, with ASCII letters converted to uppercase, into the hash
+        /// state and return the new state. The bytes are mixed as little-endian
+        /// 64-bit words, the last partial word padded with zeros, so the result
+        /// is the same for all instruction sets, and consecutive calls give the
+        /// same result as a single call if all parts but the last have sizes
+        /// divisible by eight.
+        DOT_CLASS std::uint64_t hash_upper_ascii(const char* data, size_t size, std::uint64_t state);
+    }
+}
@@ -32,106 +32,43 @@ namespace dot
 
     namespace detail
     {
-        /// Empty structure.
-        class dummy_no_to_string : public virtual object_impl
-        {};
-
-        /// objects inherit this structure in case their inner struct class has method to_string
-        /// so object also have these method.
-        template <class W, class T>
-        class obj_to_string : public virtual object_impl
-        {
-        public:
-            virtual string to_string() override { return static_cast<T*>(static_cast<W*>(this))->to_string(); }
-        };
-
         /// Detects existance of to_string method.
         template<class T>
         struct has_to_string
         {
         private:
-            static dummy_no_to_string detect(...);
+            struct not_found {};
+            static not_found detect(...);
             template<class U> static decltype(std::declval<U>().to_string()) detect(const U&);
         public:
-            static constexpr bool value = !std::is_same<dummy_no_to_string, decltype(detect(std::declval<T>()))>::value;
+            static constexpr bool value = !std::is_same<not_found, decltype(detect(std::declval<T>()))>::value;
             typedef std::integral_constant<bool, value> type;
         };
 
-        /// For inheritance of to_string method.
-        template<class W, class T>
-        class inherit_to_string : public std::conditional<
-                has_to_string<T>::value,
-                obj_to_string<W, T>,
-                dummy_no_to_string
-            >::type
-        {};
-
-        /// Empty structure.
-        class dummy_no_get_hashcode : public virtual object_impl
-        {};
-
-        /// objects inherit this structure in case their inner struct class has method hash_code
-        /// so object also have these method.
-        template <class W, class T>
-        class obj_get_hashcode : public virtual object_impl
-        {
-        public:
-            virtual size_t hash_code() override { return static_cast<T*>(static_cast<W*>(this))->hash_code(); }
-        };
-
         /// Detects existance of hash_code method.
         template<class T>
         struct has_get_hashcode
         {
         private:
-            static dummy_no_get_hashcode detect(...);
+            struct not_found {};
+            static not_found detect(...);
             template<class U> static decltype(std::declval<U>().hash_code()) detect(const U&);
         public:
-            static constexpr bool value = !std::is_same<dummy_no_get_hashcode, decltype(detect(std::declval<T>()))>::value;
+            static constexpr bool value = !std::is_same<not_found, decltype(detect(std::declval<T>()))>::value;
             typedef std::integral_constant<bool, value> type;
         };
 
-        /// For inheritance of hash_code method.
-        template<class W, class T>
-        class inherit_get_hashcode : public std::conditional<
-            has_get_hashcode<T>::value,
-            obj_get_hashcode<W, T>,
-            dummy_no_get_hashcode
-        >::type
-        {};
-
-        /// Empty structure.
-        class dummy_no_equals : public virtual object_impl
-        {};
-
-        /// objects inherit this structure in case their inner struct class has method Equals
-        /// so object also have these method.
-        template <class W, class T>
-        class obj_equals : public virtual object_impl
-        {
-        public:
-            bool equals(object obj) override { return static_cast<T*>(static_cast<W*>(this))->equals(obj); }
-        };
-
         /// Detects existance of Equals method.
         template<class T>
         struct has_equals
         {
         private:
-            static dummy_no_equals detect(...);
+            struct not_found {};
+            static not_found detect(...);
             template<class U> static decltype(std::declval<U>().Equals(std::declval<object>())) detect(const U&);
         public:
-            static constexpr bool value = !std::is_same<dummy_no_equals, decltype(detect(std::declval<T>()))>::value;
+            static constexpr bool value = !std::is_same<not_found, decltype(detect(std::declval<T>()))>::value;
             typedef std::integral_constant<bool, value> type;
         };
-
-        /// For inheritance of Equals method.
-        template<class W, class T>
-        class inherit_equals : public std::conditional<
-            has_equals<T>::value,
-            obj_equals<W, T>,
-            dummy_no_equals
-        >::type
-        {};
     }
 }
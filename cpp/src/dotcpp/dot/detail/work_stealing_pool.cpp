@@ -0,0 +1,341 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/precompiled.hpp>
+#include <dot/implement.hpp>
+#include <dot/detail/work_stealing_pool.hpp>
+#include <dot/detail/reference_counter.hpp>
+#include <dot/system/exception.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <deque>
+#include <thread>
+
+namespace dot
+{
+    namespace detail
+    {
+        namespace
+        {
+            /// Range of chunks owned by a worker, packed into one word so that
+            /// the owner and the thieves update it with a single compare and
+            /// exchange. The low and high 24 bits hold the start and end of the
+            /// range, and the top 16 bits a tag incremented by every update,
+            /// which prevents a thief holding a stale value from succeeding
+            /// after the range has returned to the same bounds.
+            class chunk_range
+            {
+                static constexpr int bound_bits_ = 24;
+                static constexpr uint64_t bound_mask_ = (uint64_t(1) << bound_bits_) - 1;
+
+                alignas(64) std::atomic<uint64_t> value_{ 0 };
+
+                static uint64_t pack(uint64_t begin, uint64_t end, uint64_t tag)
+                {
+                    return begin | (end << bound_bits_) | (tag << (2 * bound_bits_));
+                }
+
+            public:
+
+                /// Replace the range, only called when no other thread can steal from it.
+                void reset(int begin, int end)
+                {
+                    uint64_t tag = value_.load(std::memory_order_relaxed) >> (2 * bound_bits_);
+                    value_.store(pack(begin, end, tag + 1), std::memory_order_release);
+                }
+
+                /// Take the first chunk of the range, returns false if the range is empty.
+                bool pop(int& chunk)
+                {
+                    uint64_t value = value_.load(std::memory_order_acquire);
+                    while (true)
+                    {
+                        uint64_t begin = value & bound_mask_;
+                        uint64_t end = (value >> bound_bits_) & bound_mask_;
+                        if (begin >= end) return false;
+
+                        uint64_t tag = value >> (2 * bound_bits_);
+                        if (value_.compare_exchange_weak(value, pack(begin + 1, end, tag + 1), std::memory_order_acq_rel))
+                        {
+                            chunk = static_cast<int>(begin);
+                            return true;
+                        }
+                    }
+                }
+
+                /// Take the second half of the range, or its only chunk, returns false if the range is empty.
+                bool steal(int& begin, int& end)
+                {
+                    uint64_t value = value_.load(std::memory_order_acquire);
+                    while (true)
+                    {
+                        uint64_t first = value & bound_mask_;
+                        uint64_t last = (value >> bound_bits_) & bound_mask_;
+                        if (first >= last) return false;
+
+                        uint64_t middle = first + (last - first) / 2;
+                        uint64_t tag = value >> (2 * bound_bits_);
+                        if (value_.compare_exchange_weak(value, pack(first, middle, tag + 1), std::memory_order_acq_rel))
+                        {
+                            begin = static_cast<int>(middle);
+                            end = static_cast<int>(last);
+                            return true;
+                        }
+                    }
+                }
+            };
+
+            /// State of the pool, which is never deleted so that it remains
+            /// available to the worker threads until the process exits.
+            class work_stealing_pool_state
+            {
+            public: // FIELDS
+
+                /// Serializes operations started by different threads.
+                std::mutex run_mutex_;
+
+                /// Protects the fields describing the current operation.
+                std::mutex mutex_;
+
+                /// Signaled when a new operation is published.
+                std::condition_variable work_;
+
+                /// Signaled when the last worker leaves an operation.
+                std::condition_variable idle_;
+
+                /// Signaled when the last chunk of an operation completes.
+                std::condition_variable done_;
+
+                /// Incremented when an operation is published.
+                uint64_t generation_ = 0;
+
+                /// Function and context of the current operation.
+                work_stealing_pool::chunk_function function_ = nullptr;
+                void* context_ = nullptr;
+
+                /// Number of workers of the current operation including the calling thread,
+                /// at most worker_count_.
+                int operation_worker_count_ = 0;
+
+                /// Number of pool threads that have joined the current operation and not yet left it.
+                int active_ = 0;
+
+                /// Number of chunks of the current operation that have not completed.
+                std::atomic<int> pending_{ 0 };
+
+                /// Set when a chunk throws, the remaining chunks are skipped.
+                std::atomic<bool> failed_{ false };
+
+                /// First exception thrown by a chunk.
+                std::exception_ptr exception_;
+
+                /// Range of chunks of each worker, the calling thread is worker zero.
+                /// Only grows, while no operation is running.
+                std::deque<chunk_range> ranges_;
+
+                /// Number of workers including the calling thread, pool threads
+                /// with greater indices do not join operations.
+                int worker_count_ = 0;
+
+                work_stealing_pool_state()
+                {
+                    resize(std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+                }
+
+                /// Set the number of workers, called while no operation is running.
+                void resize(int worker_count)
+                {
+                    for (int worker = static_cast<int>(ranges_.size()); worker < worker_count; ++worker)
+                    {
+                        ranges_.emplace_back();
+                        if (worker > 0) std::thread([this, worker]() { run_worker(worker); }).detach();
+                    }
+                    worker_count_ = worker_count;
+                }
+
+                /// Run chunks of the current operation until no worker has any left.
+                void participate(int worker, work_stealing_pool::chunk_function function, void* context)
+                {
+                    while (true)
+                    {
+                        int chunk;
+                        if (!ranges_[worker].pop(chunk))
+                        {
+                            // Steal from the other workers in turn, keeping all but the first stolen chunk
+                            int begin = 0, end = 0;
+                            for (int i = 1; i < operation_worker_count_ && begin == end; ++i)
+                                ranges_[(worker + i) % operation_worker_count_].steal(begin, end);
+                            if (begin == end) return;
+
+                            chunk = begin;
+                            ranges_[worker].reset(begin + 1, end);
+                        }
+
+                        if (!failed_.load(std::memory_order_relaxed))
+                        {
+                            try
+                            {
+                                function(context, worker, chunk);
+                            }
+                            catch (...)
+                            {
+                                std::lock_guard<std::mutex> lock(mutex_);
+                                if (!exception_) exception_ = std::current_exception();
+                                failed_.store(true, std::memory_order_relaxed);
+                            }
+                        }
+                        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        {
+                            // The lock ensures the caller is either waiting or yet to check pending_
+                            std::lock_guard<std::mutex> lock(mutex_);
+                            done_.notify_one();
+                        }
+                    }
+                }
+
+                /// Body of the pool thread with the specified worker index.
+                void run_worker(int worker)
+                {
+                    is_pool_thread() = true;
+                    uint64_t seen = 0;
+                    while (true)
+                    {
+                        work_stealing_pool::chunk_function function;
+                        void* context;
+                        {
+                            std::unique_lock<std::mutex> lock(mutex_);
+                            work_.wait(lock, [this, seen]() { return generation_ != seen; });
+                            seen = generation_;
+                            if (worker >= operation_worker_count_) continue;
+                            function = function_;
+                            context = context_;
+                            ++active_;
+                        }
+
+                        participate(worker, function, context);
+
+                        // Objects created by chunks and released by other threads are merged
+                        // here because the pool thread may not create objects again for a while
+                        reference_counter::merge_queued_reference_counts();
+
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        if (--active_ == 0) idle_.notify_all();
+                    }
+                }
+
+                /// True for the pool threads and for threads running an operation.
+                static bool& is_pool_thread()
+                {
+                    static thread_local bool value = false;
+                    return value;
+                }
+            };
+
+            work_stealing_pool_state& get_work_stealing_pool_state()
+            {
+                static work_stealing_pool_state* state = new work_stealing_pool_state();
+                return *state;
+            }
+        }
+
+        int work_stealing_pool::worker_count()
+        {
+            work_stealing_pool_state& state = get_work_stealing_pool_state();
+            std::lock_guard<std::mutex> lock(state.mutex_);
+            return state.worker_count_;
+        }
+
+        void work_stealing_pool::set_worker_count(int count)
+        {
+            if (count < 1) throw exception("Number of workers must be at least one.");
+
+            work_stealing_pool_state& state = get_work_stealing_pool_state();
+            std::lock_guard<std::mutex> run_lock(state.run_mutex_);
+            std::unique_lock<std::mutex> lock(state.mutex_);
+            state.idle_.wait(lock, [&state]() { return state.active_ == 0; });
+            state.resize(count);
+        }
+
+        void work_stealing_pool::run(int chunk_count, int max_worker_count, chunk_function function, void* context)
+        {
+            if (chunk_count > max_chunk_count) throw exception("Too many chunks for work_stealing_pool.");
+            if (max_worker_count < 1) throw exception("Number of workers must be at least one.");
+            if (chunk_count <= 0) return;
+
+            work_stealing_pool_state& state = get_work_stealing_pool_state();
+            if (chunk_count == 1 || work_stealing_pool_state::is_pool_thread())
+            {
+                for (int chunk = 0; chunk < chunk_count; ++chunk) function(context, 0, chunk);
+                return;
+            }
+
+            std::unique_lock<std::mutex> run_lock(state.run_mutex_);
+            int worker_count = std::min(state.worker_count_, max_worker_count);
+            if (worker_count == 1)
+            {
+                run_lock.unlock();
+                for (int chunk = 0; chunk < chunk_count; ++chunk) function(context, 0, chunk);
+                return;
+            }
+
+            {
+                // Pool threads still leaving the previous operation may hold its
+                // function, so the ranges are only reset once they have all left
+                std::unique_lock<std::mutex> lock(state.mutex_);
+                state.idle_.wait(lock, [&state]() { return state.active_ == 0; });
+
+                for (int worker = 0; worker < worker_count; ++worker)
+                {
+                    state.ranges_[worker].reset(
+                        static_cast<int>(int64_t(chunk_count) * worker / worker_count),
+                        static_cast<int>(int64_t(chunk_count) * (worker + 1) / worker_count));
+                }
+                state.operation_worker_count_ = worker_count;
+                state.function_ = function;
+                state.context_ = context;
+                state.pending_.store(chunk_count, std::memory_order_relaxed);
+                state.failed_.store(false, std::memory_order_relaxed);
+                state.exception_ = nullptr;
+                ++state.generation_;
+            }
+            state.work_.notify_all();
+
+            work_stealing_pool_state::is_pool_thread() = true;
+            state.participate(0, function, context);
+            work_stealing_pool_state::is_pool_thread() = false;
+
+            // Remaining chunks are already running on other workers
+            std::exception_ptr exception;
+            {
+                std::unique_lock<std::mutex> lock(state.mutex_);
+                state.done_.wait(lock, [&state]() { return state.pending_.load(std::memory_order_acquire) == 0; });
+                exception = state.exception_;
+                state.exception_ = nullptr;
+            }
+            if (exception) std::rethrow_exception(exception);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+
+namespace dot
+{
+    namespace detail
+    {
+        /// Runs the chunks of a parallel operation on a pool of threads
+        /// started on first use, by default one fewer than the number of
+        /// hardware threads, with the calling thread as worker zero.
+        ///
+        /// The chunks are divided into one contiguous range per worker.
+        /// Each worker takes chunks from the start of its own range, and
+        /// when its range is empty steals the second half of the range of
+        /// another worker, so that workers with slower chunks are helped
+        /// by the others without a shared queue.
+        ///
+        /// Operations started by different threads run one at a time, and
+        /// an operation started from a chunk runs on the current thread.
+        /// The calling thread runs chunks until none are left to take, then
+        /// sleeps until the chunks running on other workers have completed.
+        /// If a chunk throws, the remaining chunks are skipped and the first
+        /// exception is rethrown to the caller after all workers have stopped.
+        class DOT_CLASS work_stealing_pool final
+        {
+        public: // TYPEDEF
+
+            /// Function that runs the chunk with the specified index on the worker
+            /// with the specified index, which is less than the maximum number of
+            /// workers passed to run(...).
+            typedef void (*chunk_function)(void* context, int worker, int chunk);
+
+        public: // CONSTANTS
+
+            /// Maximum number of chunks of one operation.
+            static constexpr int max_chunk_count = (1 << 23) - 1;
+
+        private: // CONSTRUCTORS
+
+            work_stealing_pool() = delete;
+            work_stealing_pool(const work_stealing_pool&) = delete;
+            work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+        public: // STATIC
+
+            /// Number of workers including the calling thread.
+            static int worker_count();
+
+            /// Set the number of workers including the calling thread, starting
+            /// additional threads if necessary. Waits for the current operation.
+            ///
+            /// Error if the count is less than one.
+            static void set_worker_count(int count);
+
+            /// Run chunks from zero to chunk_count - 1 on at most max_worker_count
+            /// workers and return when all have completed.
+            ///
+            /// Callers that keep per-worker state should size it from a value of
+            /// worker_count() read once and pass the same value here, because
+            /// set_worker_count(...) may be called by another thread in between.
+            ///
+            /// Error if chunk_count exceeds max_chunk_count.
+            static void run(int chunk_count, int max_worker_count, chunk_function function, void* context);
+
+            /// Run chunks from zero to chunk_count - 1 by calling f(worker, chunk)
+            /// on at most max_worker_count workers and return when all have completed.
+            template <class F>
+            static void run(int chunk_count, int max_worker_count, F& f)
+            {
+                run(chunk_count, max_worker_count, [](void* context, int worker, int chunk) { (*static_cast<F*>(context))(worker, chunk); }, &f);
+            }
+
+            /// Run chunks from zero to chunk_count - 1 by calling f(worker, chunk)
+            /// on all workers and return when all have completed.
+            template <class F>
+            static void run(int chunk_count, F& f)
+            {
+                run(chunk_count, max_chunk_count, f);
+            }
+        };
+    }
+}
@@ -89,12 +89,20 @@ namespace dot
 
     string local_date::to_string() const
     {
-        boost::posix_time::time_facet* facet = new boost::posix_time::time_facet();
-        facet->format("%Y-%m-%d");
-        std::stringstream stream;
-        stream.imbue(std::locale(std::locale::classic(), facet));
-        stream << this->at_midnight();
-        return stream.str();
+        char buffer[to_string_length];
+        to_chars(buffer);
+        return make_string(std::string_view(buffer, to_string_length));
+    }
+
+    void local_date::to_chars(char* buffer) const
+    {
+        // yyyy-MM-dd
+        boost::gregorian::date::ymd_type ymd = year_month_day();
+        detail::write_digits(buffer, ymd.year, 4);
+        buffer[4] = '-';
+        detail::write_digits(buffer + 5, ymd.month, 2);
+        buffer[7] = '-';
+        detail::write_digits(buffer + 8, ymd.day, 2);
     }
 
     period local_date::minus(const local_date& date) const
@@ -24,6 +24,9 @@ limitations under the License.
 #pragma once
 
 #include <dot/declare.hpp>
+#include <fmt/core.h>
+#include <dot/system/string.hpp>
+#include <dot/detail/sort.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
@@ -41,6 +44,11 @@ namespace dot
     {
         typedef local_date self;
 
+    public: // CONSTANTS
+
+        /// Number of characters in the string returned by to_string().
+        static constexpr int to_string_length = 10;
+
     public: // CONSTRUCTORS
 
         /// In C\# local date is a struct, and as all structs it has default constructor
@@ -81,6 +89,13 @@ namespace dot
         /// String that represents the current object.
         string to_string() const;
 
+        /// Writes the characters returned by to_string(), in yyyy-MM-dd format,
+        /// to the buffer without allocating memory. The buffer must have room
+        /// for to_string_length characters, no null character is written.
+        ///
+        /// This method does not have a counterpart in C#.
+        void to_chars(char* buffer) const;
+
         /// Subtracts the specified date from this date, returning the result as a period with units of years, months and days. Fluent alternative to operator-().
         period minus(const local_date& date) const;
 
@@ -149,4 +164,33 @@ namespace dot
         /// Subtracts the specified period from the date. This is a convenience operator over the Minus(period) method.
         local_date operator-(const period& period) const;
     };
+
+    namespace detail
+    {
+        /// Dates are sorted by radix sort of the day number.
+        template <>
+        struct radix_key<local_date>
+        {
+            static constexpr bool value = true;
+            typedef std::uint32_t type;
+
+            static type get(const local_date& key) { return static_cast<type>(key.day_number()); }
+        };
+    }
+}
+
+namespace fmt
+{
+    /// Writes the date in the format of to_string() without allocating memory.
+    template <>
+    struct formatter<dot::local_date> : dot::detail::formatter_base
+    {
+        template <class FormatContext>
+        auto format(const dot::local_date& value, FormatContext& ctx)
+        {
+            char text[dot::local_date::to_string_length];
+            value.to_chars(text);
+            return dot::detail::format_into(ctx, [&](internal::buffer& out) { dot::detail::format_text(out, spec_, std::string_view(text, sizeof(text))); });
+        }
+    };
 }
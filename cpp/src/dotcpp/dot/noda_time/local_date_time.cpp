@@ -94,12 +94,17 @@ namespace dot
 
     string local_date_time::to_string() const
     {
-        boost::posix_time::time_facet* facet = new boost::posix_time::time_facet();
-        facet->format("%Y-%m-%d %H:%M:%S.%f");
-        std::stringstream stream;
-        stream.imbue(std::locale(std::locale::classic(), facet));
-        stream << *this;
-        return stream.str().substr(0, 23);
+        char buffer[to_string_length];
+        to_chars(buffer);
+        return make_string(std::string_view(buffer, to_string_length));
+    }
+
+    void local_date_time::to_chars(char* buffer) const
+    {
+        // yyyy-MM-dd HH:mm:ss.fff
+        local_date(date()).to_chars(buffer);
+        buffer[local_date::to_string_length] = ' ';
+        local_time(*this).to_chars(buffer + local_date::to_string_length + 1);
     }
 
     period local_date_time::Minus(const local_date_time& local_date_time) const
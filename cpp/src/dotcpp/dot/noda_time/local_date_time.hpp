@@ -24,6 +24,8 @@ limitations under the License.
 #pragma once
 
 #include <dot/declare.hpp>
+#include <fmt/core.h>
+#include <dot/system/string.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <dot/noda_time/local_time.hpp>
@@ -43,6 +45,11 @@ namespace dot
     class DOT_CLASS local_date_time : public boost::posix_time::ptime
     {
         typedef local_date_time self;
+
+    public: // CONSTANTS
+
+        /// Number of characters in the string returned by to_string().
+        static constexpr int to_string_length = 23;
         typedef boost::posix_time::ptime base;
         friend local_date;
         friend local_time;
@@ -126,6 +133,13 @@ namespace dot
         /// String that represents the current object.
         string to_string() const;
 
+        /// Writes the characters returned by to_string(), in yyyy-MM-dd HH:mm:ss.fff format,
+        /// to the buffer without allocating memory. The buffer must have room
+        /// for to_string_length characters, no null character is written.
+        ///
+        /// This method does not have a counterpart in C#.
+        void to_chars(char* buffer) const;
+
         /// Subtracts the specified date/time from this date/time, returning the result as a period. Fluent alternative to operator-().
         period Minus(const local_date_time& local_date_time) const;
 
@@ -208,3 +222,19 @@ namespace dot
         local_date_time operator-(const period& period) const;
     };
 }
+
+namespace fmt
+{
+    /// Writes the date and time in the format of to_string() without allocating memory.
+    template <>
+    struct formatter<dot::local_date_time> : dot::detail::formatter_base
+    {
+        template <class FormatContext>
+        auto format(const dot::local_date_time& value, FormatContext& ctx)
+        {
+            char text[dot::local_date_time::to_string_length];
+            value.to_chars(text);
+            return dot::detail::format_into(ctx, [&](internal::buffer& out) { dot::detail::format_text(out, spec_, std::string_view(text, sizeof(text))); });
+        }
+    };
+}
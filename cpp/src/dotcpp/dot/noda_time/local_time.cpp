@@ -91,12 +91,22 @@ namespace dot
 
     string local_time::to_string() const
     {
-        boost::posix_time::time_facet* facet = new boost::posix_time::time_facet();
-        facet->format("%H:%M:%S.%f");
-        std::stringstream stream;
-        stream.imbue(std::locale(std::locale::classic(), facet));
-        stream << *this;
-        return stream.str().substr(0, 12);
+        char buffer[to_string_length];
+        to_chars(buffer);
+        return make_string(std::string_view(buffer, to_string_length));
+    }
+
+    void local_time::to_chars(char* buffer) const
+    {
+        // HH:mm:ss.fff with milliseconds truncated
+        boost::posix_time::time_duration time = time_of_day();
+        detail::write_digits(buffer, static_cast<int>(time.hours()), 2);
+        buffer[2] = ':';
+        detail::write_digits(buffer + 3, static_cast<int>(time.minutes()), 2);
+        buffer[5] = ':';
+        detail::write_digits(buffer + 6, static_cast<int>(time.seconds()), 2);
+        buffer[8] = '.';
+        detail::write_digits(buffer + 9, static_cast<int>(time.total_milliseconds() % 1000), 3);
     }
 
     period local_time::Minus(const local_time& time) const
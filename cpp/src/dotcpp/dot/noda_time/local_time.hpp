@@ -24,6 +24,8 @@ limitations under the License.
 #pragma once
 
 #include <dot/declare.hpp>
+#include <fmt/core.h>
+#include <dot/system/string.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
@@ -41,6 +43,11 @@ namespace dot
     {
         typedef local_time self;
 
+    public: // CONSTANTS
+
+        /// Number of characters in the string returned by to_string().
+        static constexpr int to_string_length = 12;
+
     public: // CONSTRUCTORS
 
         /// Because in C\# local_date_time is a struct, it has default constructor
@@ -97,6 +104,13 @@ namespace dot
         /// String that represents the current object.
         string to_string() const;
 
+        /// Writes the characters returned by to_string(), in HH:mm:ss.fff format,
+        /// to the buffer without allocating memory. The buffer must have room
+        /// for to_string_length characters, no null character is written.
+        ///
+        /// This method does not have a counterpart in C#.
+        void to_chars(char* buffer) const;
+
         /// Subtracts the specified time from this time, returning the result as a period. Fluent alternative to operator-().
         period Minus(const local_time& time) const;
 
@@ -162,3 +176,19 @@ namespace dot
         operator boost::posix_time::time_duration() const;
     };
 }
+
+namespace fmt
+{
+    /// Writes the time in the format of to_string() without allocating memory.
+    template <>
+    struct formatter<dot::local_time> : dot::detail::formatter_base
+    {
+        template <class FormatContext>
+        auto format(const dot::local_time& value, FormatContext& ctx)
+        {
+            char text[dot::local_time::to_string_length];
+            value.to_chars(text);
+            return dot::detail::format_into(ctx, [&](internal::buffer& out) { dot::detail::format_text(out, spec_, std::string_view(text, sizeof(text))); });
+        }
+    };
+}
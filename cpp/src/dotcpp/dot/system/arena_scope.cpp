@@ -0,0 +1,238 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/precompiled.hpp>
+#include <dot/implement.hpp>
+#include <dot/system/arena_scope.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace dot
+{
+    namespace detail
+    {
+        /// Block of memory from which arena_scope allocates objects.
+        ///
+        /// The live count is offset by arena_chunk::scope_bias while the
+        /// owning scope exists, so that deleting objects never brings it to
+        /// zero before the scope ends. Allocations, and releases by the thread
+        /// of the owning scope, are counted without atomic operations and added
+        /// to the live count once, when the scope ends.
+        class arena_chunk
+        {
+        public: // CONSTANTS
+
+            /// Offset of the live count while the owning scope exists.
+            static constexpr std::int64_t scope_bias = std::int64_t(1) << 48;
+
+        public: // FIELDS
+
+            /// While the owning scope exists, scope_bias minus the number of
+            /// released allocations. After the scope ends, the number of
+            /// allocations not yet released.
+            std::atomic<std::int64_t> live_count_ = scope_bias;
+
+            /// Number of allocations made from this chunk by the owning scope.
+            std::int64_t allocated_count_ = 0;
+
+            /// Number of allocations released by the thread of the owning scope
+            /// while it is the innermost scope.
+            std::int64_t released_count_ = 0;
+
+            /// Owning scope, or nullptr after the scope ends.
+            std::atomic<arena_scope*> scope_ = nullptr;
+
+            /// Chunk allocated before this one by the same scope.
+            arena_chunk* previous_ = nullptr;
+        };
+
+        namespace
+        {
+            /// Size of each chunk including the chunk header.
+            const size_t arena_chunk_size = 64 * 1024;
+
+            /// Alignment of each allocation.
+            const size_t arena_alignment = alignof(std::max_align_t);
+
+            /// Offset of the first allocation from the start of the chunk.
+            const size_t arena_chunk_header_size = (sizeof(arena_chunk) + arena_alignment - 1) / arena_alignment * arena_alignment;
+
+            /// Larger allocations are made from the global heap.
+            const size_t arena_max_allocation_size = (arena_chunk_size - arena_chunk_header_size) / 8;
+
+            /// Innermost scope of the current thread.
+            thread_local arena_scope* current_arena_scope_ = nullptr;
+
+            /// Maximum number of chunks kept by each thread for reuse.
+            const size_t arena_max_spare_chunk_count = 16;
+
+            /// Memory of released chunks kept by the current thread for reuse,
+            /// linked through the first bytes of each chunk.
+            thread_local void* spare_arena_chunks_ = nullptr;
+
+            /// Number of chunks in spare_arena_chunks_.
+            thread_local size_t spare_arena_chunk_count_ = 0;
+
+            /// Releases spare chunks on thread exit.
+            struct spare_arena_chunk_guard
+            {
+                ~spare_arena_chunk_guard()
+                {
+                    while (spare_arena_chunks_ != nullptr)
+                    {
+                        void* memory = spare_arena_chunks_;
+                        spare_arena_chunks_ = *static_cast<void**>(memory);
+                        ::operator delete(memory);
+                    }
+
+                    // Chunks released after this point are not kept
+                    spare_arena_chunk_count_ = arena_max_spare_chunk_count;
+                }
+            };
+
+            /// Create chunk, reusing the memory of a released chunk if possible.
+            arena_chunk* new_arena_chunk()
+            {
+                void* memory = spare_arena_chunks_;
+                if (memory != nullptr)
+                {
+                    spare_arena_chunks_ = *static_cast<void**>(memory);
+                    --spare_arena_chunk_count_;
+                }
+                else
+                {
+                    memory = ::operator new(arena_chunk_size);
+                }
+                return new (memory) arena_chunk();
+            }
+
+            /// Delete chunk, keeping its memory for reuse by the current thread
+            /// so that repeated scopes do not return to the global heap.
+            void delete_arena_chunk(arena_chunk* chunk)
+            {
+                chunk->~arena_chunk();
+                if (spare_arena_chunk_count_ < arena_max_spare_chunk_count)
+                {
+                    static thread_local spare_arena_chunk_guard guard;
+
+                    *reinterpret_cast<void**>(chunk) = spare_arena_chunks_;
+                    spare_arena_chunks_ = chunk;
+                    ++spare_arena_chunk_count_;
+                }
+                else
+                {
+                    ::operator delete(chunk);
+                }
+            }
+        }
+    }
+
+    arena_scope::arena_scope()
+        : previous_(detail::current_arena_scope_)
+    {
+        detail::current_arena_scope_ = this;
+    }
+
+    arena_scope::~arena_scope()
+    {
+        detail::current_arena_scope_ = previous_;
+
+        // Replace the scope bias by the number of allocations, the chunk
+        // is deleted here unless it holds objects that escaped the scope
+        detail::arena_chunk* chunk = chunk_;
+        while (chunk != nullptr)
+        {
+            detail::arena_chunk* previous = chunk->previous_;
+            chunk->scope_.store(nullptr, std::memory_order_relaxed);
+            std::int64_t delta = chunk->allocated_count_ - chunk->released_count_ - detail::arena_chunk::scope_bias;
+            if (chunk->live_count_.fetch_add(delta, std::memory_order_acq_rel) + delta == 0) detail::delete_arena_chunk(chunk);
+            chunk = previous;
+        }
+    }
+
+    size_t arena_scope::live_count() const
+    {
+        std::int64_t result = 0;
+        for (detail::arena_chunk* chunk = chunk_; chunk != nullptr; chunk = chunk->previous_)
+        {
+            result += chunk->allocated_count_ - chunk->released_count_ + chunk->live_count_.load(std::memory_order_acquire) - detail::arena_chunk::scope_bias;
+        }
+        return static_cast<size_t>(result);
+    }
+
+    size_t arena_scope::reserved_bytes() const
+    {
+        size_t result = 0;
+        for (detail::arena_chunk* chunk = chunk_; chunk != nullptr; chunk = chunk->previous_) result += detail::arena_chunk_size;
+        return result;
+    }
+
+    arena_scope* arena_scope::current()
+    {
+        return detail::current_arena_scope_;
+    }
+
+    void* arena_scope::allocate(size_t size, detail::arena_chunk*& chunk)
+    {
+        arena_scope* scope = detail::current_arena_scope_;
+        if (scope == nullptr || size > detail::arena_max_allocation_size) return nullptr;
+
+        size = (size + detail::arena_alignment - 1) / detail::arena_alignment * detail::arena_alignment;
+        if (static_cast<size_t>(scope->end_ - scope->next_) < size)
+        {
+            detail::arena_chunk* new_chunk = detail::new_arena_chunk();
+            new_chunk->previous_ = scope->chunk_;
+            new_chunk->scope_.store(scope, std::memory_order_relaxed);
+            scope->chunk_ = new_chunk;
+            scope->next_ = reinterpret_cast<char*>(new_chunk) + detail::arena_chunk_header_size;
+            scope->end_ = reinterpret_cast<char*>(new_chunk) + detail::arena_chunk_size;
+        }
+
+        void* result = scope->next_;
+        scope->next_ += size;
+        ++scope->chunk_->allocated_count_;
+        chunk = scope->chunk_;
+        return result;
+    }
+
+    void arena_scope::release(detail::arena_chunk* chunk)
+    {
+        arena_scope* scope = detail::current_arena_scope_;
+        if (scope != nullptr && chunk->scope_.load(std::memory_order_relaxed) == scope)
+        {
+            // Released by the thread of the owning scope, if this empties
+            // the most recent chunk its memory is reused for new allocations
+            if (++chunk->released_count_ == chunk->allocated_count_ && chunk == scope->chunk_
+                && chunk->live_count_.load(std::memory_order_relaxed) == detail::arena_chunk::scope_bias)
+            {
+                chunk->allocated_count_ = 0;
+                chunk->released_count_ = 0;
+                scope->next_ = reinterpret_cast<char*>(chunk) + detail::arena_chunk_header_size;
+            }
+        }
+        else if (chunk->live_count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            detail::delete_arena_chunk(chunk);
+        }
+    }
+}
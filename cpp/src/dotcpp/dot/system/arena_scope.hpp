@@ -0,0 +1,119 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+
+namespace dot
+{
+    class reference_counter;
+    namespace detail { class arena_chunk; }
+
+    /// While an instance of this class exists, objects derived from
+    /// reference_counter that are created by the current thread are
+    /// bump allocated from an arena owned by the scope instead of
+    /// the global heap. The arena memory is released in bulk when
+    /// the scope ends.
+    ///
+    /// Objects that escape the scope remain valid. Each arena chunk
+    /// is released only after the scope has ended and all objects
+    /// allocated from it have been deleted, on any thread.
+    ///
+    /// Scopes can be nested, in which case objects are allocated from
+    /// the innermost scope. Scopes must be created as local variables
+    /// and destroyed in reverse order of creation on the same thread.
+    ///
+    /// Example:
+    ///
+    /// {
+    ///     arena_scope scope;
+    ///     object value = 1.0; // Allocated from the arena
+    /// }
+    class DOT_CLASS arena_scope
+    {
+        friend class reference_counter;
+
+    private: // FIELDS
+
+        /// Enclosing scope of the current thread, or nullptr if none.
+        arena_scope* previous_;
+
+        /// Most recent chunk, earlier chunks are linked from it.
+        detail::arena_chunk* chunk_ = nullptr;
+
+        /// Next free byte in the most recent chunk.
+        char* next_ = nullptr;
+
+        /// End of the most recent chunk.
+        char* end_ = nullptr;
+
+    public: // CONSTRUCTORS
+
+        /// Makes this scope the innermost scope of the current thread.
+        arena_scope();
+
+    public: // DESTRUCTOR
+
+        /// Restores the enclosing scope and releases the chunks
+        /// that do not hold objects that escaped the scope.
+        ~arena_scope();
+
+    public: // METHODS
+
+        /// Number of objects allocated in this scope that have not been
+        /// deleted yet. When called at the end of the scope, this is the
+        /// number of objects that escape the scope.
+        size_t live_count() const;
+
+        /// Number of bytes reserved by this scope from the global heap.
+        size_t reserved_bytes() const;
+
+    public: // STATIC
+
+        /// Innermost scope of the current thread, or nullptr if none.
+        static arena_scope* current();
+
+    private: // STATIC
+
+        /// Allocate memory from the innermost scope of the current thread.
+        ///
+        /// Returns nullptr if there is no scope or the size is too large
+        /// for the arena, otherwise sets chunk to the chunk that must be
+        /// passed to release(...) when the memory is no longer used.
+        static void* allocate(size_t size, detail::arena_chunk*& chunk);
+
+        /// Release memory allocated from the specified chunk.
+        static void release(detail::arena_chunk* chunk);
+
+    private: // CONSTRUCTORS
+
+        /// Prevent copying scope.
+        arena_scope(const arena_scope&) = delete;
+
+    private: // OPERATORS
+
+        /// Prevent assignment of scope.
+        arena_scope& operator=(const arena_scope&) = delete;
+    };
+}
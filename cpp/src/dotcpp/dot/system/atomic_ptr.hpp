@@ -0,0 +1,279 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+#include <cstdint>
+#include <dot/system/ptr.hpp>
+#include <dot/system/object.hpp>
+
+namespace dot
+{
+    /// Holds ptr(T) that can be loaded and replaced by multiple threads
+    /// at the same time without a lock, similar to std::atomic(std::shared_ptr).
+    ///
+    /// A reader must not increment the reference count of an object that
+    /// a writer has already replaced and released, since the object may
+    /// have been deleted in between. To prevent this, the slot uses split
+    /// reference counting. The pointer and a local count occupy the same
+    /// 64-bit word. A reader first increments the local count together with
+    /// reading the pointer, which prevents the writer from releasing the
+    /// object, then increments the reference count of the object, and
+    /// finally decrements the local count back. A writer that replaces the
+    /// pointer while readers are in progress adds their number to the
+    /// reference count of the object before releasing its own reference,
+    /// and each such reader decrements the reference count instead of the
+    /// local count. Readers never wait for writers or each other.
+    ///
+    /// The pointer must fit into the low 48 bits of the word, which holds
+    /// on x64 and ARM64 with the default virtual address size, otherwise
+    /// storing it throws an exception. A load throws an exception when
+    /// 32767 other loads are already in progress, half of the 16-bit local
+    /// count, so that the loads that increment the count before they check
+    /// it cannot overflow it into the pointer. Objects that use
+    /// single_threaded reference counting mode, including those created
+    /// while cycle_collector is enabled, cannot be stored. Values stored inline by
+    /// object are boxed into a heap object when stored, so that loads
+    /// return the boxed instance.
+    ///
+    /// This class does not have a counterpart in C#.
+    template <class T>
+    class atomic_ptr
+    {
+    private: // CONSTANTS
+
+        /// Number of low bits of the word holding the pointer.
+        static constexpr int pointer_bits_ = sizeof(void*) == 8 ? 48 : 32;
+
+        /// Mask of the pointer in the word.
+        static constexpr std::uint64_t pointer_mask_ = (std::uint64_t(1) << pointer_bits_) - 1;
+
+        /// Increment of the word corresponding to one load in progress.
+        static constexpr std::uint64_t local_unit_ = std::uint64_t(1) << pointer_bits_;
+
+        /// Number of loads in progress at which a further load throws, half
+        /// of the range of the local count.
+        static constexpr std::uint64_t max_local_count_ = (std::uint64_t(1) << (63 - pointer_bits_)) - 1;
+
+        static_assert(sizeof(void*) == 8 || sizeof(void*) == 4, "atomic_ptr requires 32-bit or 64-bit pointers.");
+        static_assert(sizeof(std::uintptr_t) <= sizeof(std::uint64_t), "Pointer does not fit into the word of atomic_ptr.");
+        static_assert(64 - pointer_bits_ >= 16, "Local count of atomic_ptr must have at least 16 bits.");
+
+    private: // FIELDS
+
+        /// Pointer in the low bits and the number of loads in progress in the high bits,
+        /// modified by load() which is logically const.
+        mutable std::atomic<std::uint64_t> word_;
+
+    public: // CONSTRUCTORS
+
+        /// Create empty slot.
+        atomic_ptr() : word_(0) {}
+
+        /// Create slot holding the specified pointer.
+        atomic_ptr(const ptr<T>& value) : word_(pack(retain(value.ptr_))) {}
+
+        atomic_ptr(const atomic_ptr&) = delete;
+        atomic_ptr& operator=(const atomic_ptr&) = delete;
+
+    public: // DESTRUCTOR
+
+        /// Releases the pointer held by the slot.
+        ~atomic_ptr() { ptr<T>::decrement(unpack(word_.load(std::memory_order_acquire))); }
+
+    public: // METHODS
+
+        /// Returns the pointer held by the slot.
+        ptr<T> load() const
+        {
+            // Reserve the object before reading the pointer, so that a writer
+            // replacing it concurrently does not release the object
+            std::uint64_t word = word_.fetch_add(local_unit_, std::memory_order_acquire);
+            T* p = unpack(word);
+            ptr<T> result = adopt(retain(p));
+
+            // The reservation is returned as usual before throwing, the reference
+            // taken above is released by the destructor of result
+            bool overflow = (word >> pointer_bits_) >= max_local_count_;
+
+            // Return the reservation, unless a writer has replaced the pointer and
+            // added the reservation to the reference count of the object. If the
+            // same object has been stored again, returning the reservation instead
+            // of decrementing the reference count leaves the total unchanged
+            std::uint64_t current = word + local_unit_;
+            while ((current & pointer_mask_) == (word & pointer_mask_) && current >= local_unit_)
+            {
+                if (word_.compare_exchange_weak(current, current - local_unit_, std::memory_order_relaxed))
+                {
+                    if (overflow) throw dot::exception("Too many concurrent loads from atomic_ptr.");
+                    return result;
+                }
+            }
+            ptr<T>::decrement(p);
+            if (overflow) throw dot::exception("Too many concurrent loads from atomic_ptr.");
+            return result;
+        }
+
+        /// Replaces the pointer held by the slot.
+        void store(const ptr<T>& value)
+        {
+            exchange(value);
+        }
+
+        /// Replaces the pointer held by the slot and returns the previous one.
+        ptr<T> exchange(const ptr<T>& value)
+        {
+            std::uint64_t previous = word_.exchange(pack(retain(value.ptr_)), std::memory_order_acq_rel);
+            return release(previous);
+        }
+
+        /// Replaces the pointer held by the slot with desired if it is the same
+        /// instance as expected and returns true, otherwise assigns the pointer
+        /// held by the slot to expected and returns false.
+        bool compare_exchange(ptr<T>& expected, const ptr<T>& desired)
+        {
+            std::uint64_t desired_word = pack(retain(desired.ptr_));
+            std::uint64_t current = word_.load(std::memory_order_relaxed);
+
+            // Loads in progress change the local count, retry while the pointer matches
+            while (unpack(current) == expected.ptr_)
+            {
+                if (word_.compare_exchange_weak(current, desired_word, std::memory_order_acq_rel, std::memory_order_relaxed))
+                {
+                    release(current);
+                    return true;
+                }
+            }
+
+            ptr<T>::decrement(unpack(desired_word));
+            expected = load();
+            return false;
+        }
+
+        /// True if the operations of the slot are lock free on this platform.
+        bool is_lock_free() const { return word_.is_lock_free(); }
+
+    public: // OPERATORS
+
+        /// Returns the pointer held by the slot.
+        operator ptr<T>() const { return load(); }
+
+        /// Replaces the pointer held by the slot.
+        atomic_ptr& operator=(const ptr<T>& value) { store(value); return *this; }
+
+    private: // STATIC
+
+        /// Increment the reference count of the object and return the pointer.
+        /// An inline value is boxed first, because its payload may occupy
+        /// the high bits of the word that hold the local count. Error if the
+        /// object uses single_threaded reference counting mode, which includes
+        /// objects tracked by cycle_collector, because loads from other threads
+        /// would update its count without atomic operations.
+        static T* retain(T* p)
+        {
+            if constexpr (std::is_same<T, object_impl>::value)
+            {
+                if (detail::is_inline_value(p)) p = detail::box_inline_value(p);
+            }
+            ptr<T>::increment(p);
+            if (p != nullptr && p->get_reference_count_mode() == reference_count_mode::single_threaded)
+            {
+                ptr<T>::decrement(p);
+                throw dot::exception("Objects in single_threaded reference counting mode cannot be stored in atomic_ptr.");
+            }
+            return p;
+        }
+
+        /// Creates ptr(T) taking over a reference that has already been counted.
+        static ptr<T> adopt(T* p)
+        {
+            ptr<T> result;
+            result.ptr_ = p;
+            return result;
+        }
+
+        /// Takes over the reference held by a replaced word, counting the
+        /// loads still in progress as references to the object.
+        static ptr<T> release(std::uint64_t word)
+        {
+            T* p = unpack(word);
+            for (std::uint64_t i = word >> pointer_bits_; i > 0; --i) ptr<T>::increment(p);
+            return adopt(p);
+        }
+
+        /// Combines the pointer with zero local count.
+        static std::uint64_t pack(T* p)
+        {
+            std::uint64_t word = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p));
+            if (word & ~pointer_mask_)
+            {
+                ptr<T>::decrement(p);
+                throw dot::exception("Pointer does not fit into atomic_ptr.");
+            }
+            return word;
+        }
+
+        /// Pointer held by the word.
+        static T* unpack(std::uint64_t word)
+        {
+            return reinterpret_cast<T*>(static_cast<std::uintptr_t>(word & pointer_mask_));
+        }
+    };
+
+    /// Holds object that can be loaded and replaced by multiple threads
+    /// at the same time without a lock, see atomic_ptr for details.
+    ///
+    /// This class does not have a counterpart in C#.
+    class atomic_object : public atomic_ptr<object_impl>
+    {
+        typedef atomic_ptr<object_impl> base;
+
+    public: // CONSTRUCTORS
+
+        /// Create empty slot.
+        atomic_object() = default;
+
+        /// Create slot holding the specified object.
+        atomic_object(const object& value) : base(value) {}
+
+    public: // METHODS
+
+        /// Returns the object held by the slot.
+        object load() const { return base::load(); }
+
+        /// Replaces the object held by the slot.
+        void store(const object& value) { base::store(value); }
+
+        /// Replaces the object held by the slot and returns the previous one.
+        object exchange(const object& value) { return base::exchange(value); }
+
+    public: // OPERATORS
+
+        /// Returns the object held by the slot.
+        operator object() const { return load(); }
+
+        /// Replaces the object held by the slot.
+        atomic_object& operator=(const object& value) { store(value); return *this; }
+    };
+}
@@ -35,10 +35,10 @@ namespace dot
 
     bool bool_impl::equals(object obj)
     {
-        if (this == &(*obj)) return true;
+        if (!obj.is_inline() && this == &(*obj)) return true;
         if (obj.is<ptr<bool_impl>>())
         {
-            return value_ == obj.as<ptr<bool_impl>>()->value_;
+            return value_ == bool(obj);
         }
 
         return false;
@@ -0,0 +1,181 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+#include <dot/system/ptr.hpp>
+#include <dot/system/exception.hpp>
+
+namespace dot
+{
+    /// Non-owning reference to an object held by ptr.
+    ///
+    /// borrowed_ptr does not change the reference count when it is created,
+    /// copied or destroyed. It is used for parameters and local variables whose
+    /// lifetime is strictly nested inside the lifetime of an owning ptr, which
+    /// avoids a pair of atomic increment and decrement operations per copy.
+    ///
+    /// A borrowed_ptr must not be stored beyond the lifetime of the owner.
+    /// Convert it to ptr to obtain an owning pointer when the reference must be kept.
+    template <class T>
+    class borrowed_ptr
+    {
+        template<class R> friend class borrowed_ptr;
+
+    public: // TYPEDEF
+
+        typedef T element_type;
+        typedef T* pointer_type;
+
+    private: // FIELDS
+
+        T* ptr_;
+
+    public: // CONSTRUCTORS
+
+        /// Create empty reference.
+        borrowed_ptr() : ptr_(nullptr) {}
+
+        /// Create empty reference from nullptr.
+        borrowed_ptr(nullptr_t) : ptr_(nullptr) {}
+
+        /// Borrow the object at the pointer. The caller must ensure that
+        /// the object remains alive while the reference is in use.
+        explicit borrowed_ptr(T* p) : ptr_(p) {}
+
+        /// Borrow the object held by ptr to the same or derived type (does not use dynamic cast).
+        ///
+        /// An inline value held by ptr is first replaced by a heap object, which is borrowed.
+        template <class R>
+        borrowed_ptr(const ptr<R>& rhs, typename std::enable_if<std::is_base_of<T, R>::value>::type* p = 0) : ptr_(detail::materialize(&rhs.ptr_)) {}
+
+        /// Explicit conversion from ptr to base or sibling type (uses dynamic cast).
+        ///
+        /// An inline value held by ptr is first replaced by a heap object, which is borrowed.
+        /// Error message if the cast fails because the two types are unrelated.
+        template <class R>
+        explicit borrowed_ptr(const ptr<R>& rhs, typename std::enable_if<!std::is_base_of<T, R>::value>::type* p = 0) : ptr_(cast(materialize_for_cast(rhs))) {}
+
+        /// Implicit conversion from derived to base reference (does not use dynamic cast).
+        template <class R>
+        borrowed_ptr(const borrowed_ptr<R>& rhs, typename std::enable_if<std::is_base_of<T, R>::value>::type* p = 0) : ptr_(rhs.ptr_) {}
+
+        /// Explicit conversion from base to derived or sibling reference (uses dynamic cast).
+        ///
+        /// Error message if the cast fails because the two types are unrelated.
+        template <class R>
+        explicit borrowed_ptr(const borrowed_ptr<R>& rhs, typename std::enable_if<!std::is_base_of<T, R>::value>::type* p = 0) : ptr_(cast(rhs.ptr_)) {}
+
+    public: // METHODS
+
+        /// Dynamic cast to type R, returns 0 if the cast fails.
+        template <class R>
+        R as() const
+        {
+            if (detail::is_inline_value(ptr_)) return ptr<T>(ptr_).template as<R>();
+            return detail::fast_cast<typename R::element_type>(ptr_);
+        }
+
+        /// Returns true if reference points to object of type R, and false otherwise.
+        template <class R>
+        bool is() const
+        {
+            if (detail::is_inline_value(ptr_)) return ptr<T>(ptr_).template is<R>();
+            return detail::fast_cast<typename R::element_type>(ptr_);
+        }
+
+        /// Returns true if reference is empty, and false otherwise.
+        bool is_empty() const { return !ptr_; }
+
+    public: // OPERATORS
+
+        /// Pointer dereference.
+        ///
+        /// Error if the reference was created from a raw pointer holding an inline value.
+        T& operator*() const { return *get(); }
+
+        /// Pointer dereference.
+        ///
+        /// Error if the reference was created from a raw pointer holding an inline value.
+        T* operator->() const { return get(); }
+
+        /// Returns true if the argument references the same instance as self.
+        bool operator==(const borrowed_ptr<T>& rhs) const { return ptr_ == rhs.ptr_; }
+
+        /// Returns true if the argument does not reference the same instance as self.
+        bool operator!=(const borrowed_ptr<T>& rhs) const { return ptr_ != rhs.ptr_; }
+
+        /// Supports borrowed_ptr == nullptr.
+        bool operator==(nullptr_t) const { return ptr_ == nullptr; }
+
+        /// Supports borrowed_ptr != nullptr.
+        bool operator!=(nullptr_t) const { return ptr_ != nullptr; }
+
+        /// Convert to owning pointer, incrementing the reference count.
+        operator ptr<T>() const { return ptr<T>(ptr_); }
+
+    private: // METHODS
+
+        /// Pointer to the borrowed heap object, error if empty or an inline value.
+        T* get() const
+        {
+            if (!ptr_)
+                throw dot::exception("Pointer is not initialized");
+            if (detail::is_inline_value(ptr_))
+                throw dot::exception("Pointer holds an inline value which cannot be dereferenced.");
+            return ptr_;
+        }
+
+        /// Object held by ptr, replacing an inline value by a heap object only
+        /// if it can be cast to T, error otherwise.
+        template <class R>
+        static R* materialize_for_cast(const ptr<R>& rhs)
+        {
+            if (detail::is_inline_value(rhs.ptr_) && !rhs.template is<ptr<T>>())
+                throw dot::exception("Cast cannot be performed.");
+            return detail::materialize(&rhs.ptr_);
+        }
+
+        /// Dynamic cast from base to derived, error if the argument is not null and the cast fails.
+        template <class R>
+        static T* cast(R* p)
+        {
+            // If argument is null, result should also remain null
+            if (!p) return nullptr;
+
+            // Inline value has no heap object that could be borrowed
+            if (detail::is_inline_value(p))
+                throw dot::exception("Cast cannot be performed.");
+
+            // Perform dynamic cast from base to derived
+            T* result = detail::fast_cast<T>(p);
+
+            // Check that dynamic cast succeeded
+            if (!result)
+                throw dot::exception("Cast cannot be performed.");
+
+            return result;
+        }
+    };
+}
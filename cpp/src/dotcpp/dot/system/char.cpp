@@ -29,13 +29,27 @@ limitations under the License.
 
 namespace dot
 {
+    string Char::to_string() const
+    {
+        char buffer[4];
+        int size = detail::encode_utf8(is_surrogate(*this) ? 0xFFFD : value_, buffer);
+        return make_string(std::string_view(buffer, size));
+    }
+
+    std::ostream& operator<<(std::ostream& stream, Char value)
+    {
+        char buffer[4];
+        int size = detail::encode_utf8(Char::is_surrogate(value) ? 0xFFFD : char16_t(value), buffer);
+        return stream.write(buffer, size);
+    }
+
     bool char_impl::equals(object obj)
     {
-        if (this == &(*obj)) return true;
+        if (!obj.is_inline() && this == &(*obj)) return true;
 
         if (obj.is<ptr<char_impl>>())
         {
-            return value_ == obj.as<ptr<char_impl>>()->value_;
+            return value_ == char(obj);
         }
 
         return false;
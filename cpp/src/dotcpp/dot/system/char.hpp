@@ -24,25 +24,300 @@ limitations under the License.
 #pragma once
 
 #include <dot/declare.hpp>
-#include <dot/detail/const_string_base.hpp>
+#include <dot/detail/char_tables.hpp>
 #include <dot/system/object_impl.hpp>
 
 namespace dot
 {
-    /// Represents a single character of a UTF-8 string.
+    class string;
+
+    /// Represents a character as a UTF-16 code unit.
     ///
-    /// It can be represented by a variable number of
-    /// bytes and is stored in std::string rather than char. 
-    class Char : detail::const_string_base
+    /// Similar to System.Char, this is a 16-bit value type. Characters outside
+    /// the Basic Multilingual Plane are represented by a surrogate pair of two
+    /// Char values. The character properties and case mappings are looked up in
+    /// tables generated from the Unicode Character Database, using the simple
+    /// (single code unit) mappings of the invariant culture.
+    class Char
     {
-        typedef detail::const_string_base base;
+        char16_t value_ = 0;
+
+    public: // CONSTANTS
+
+        /// Largest possible value of a Char.
+        static constexpr char16_t max_value = 0xFFFF;
+
+        /// Smallest possible value of a Char.
+        static constexpr char16_t min_value = 0;
 
     public: // CONSTRUCTORS
 
-        /// Create from a single ASCII character.
-        Char(char c) : base(std::to_string(c)) {}
+        /// Create null character.
+        constexpr Char() noexcept = default;
+
+        /// Create from a single byte, interpreted as a Latin-1 character
+        /// so that ASCII characters keep their value.
+        constexpr Char(char value) noexcept : value_(static_cast<unsigned char>(value)) {}
+
+        /// Create from UTF-16 code unit.
+        constexpr Char(char16_t value) noexcept : value_(value) {}
+
+    public: // METHODS
+
+        /// Returns the hash code for this instance.
+        size_t hash_code() const noexcept { return value_; }
+
+        /// Compares this instance to a specified Char and returns a negative
+        /// number, zero, or a positive number if it precedes, equals or follows
+        /// it in ordinal order.
+        int compare_to(Char value) const noexcept { return int(value_) - int(value.value_); }
+
+        /// Returns the character encoded as UTF-8, lone surrogates
+        /// are replaced by U+FFFD.
+        DOT_CLASS string to_string() const;
+
+    public: // STATIC
+
+        /// Indicates whether the character is a decimal digit.
+        static bool is_digit(Char c)
+        {
+            if (c.value_ < 0x80) return unsigned(c.value_ - u'0') < 10u;
+            return (detail::char_tables::entry(c.value_) & detail::char_tables::digit_flag) != 0;
+        }
+
+        /// Indicates whether the character is a letter.
+        static bool is_letter(Char c)
+        {
+            if (c.value_ < 0x80) return unsigned((c.value_ | 0x20) - u'a') < 26u;
+            return (detail::char_tables::entry(c.value_) & detail::char_tables::letter_flag) != 0;
+        }
+
+        /// Indicates whether the character is a letter or a decimal digit.
+        static bool is_letter_or_digit(Char c)
+        {
+            return (detail::char_tables::entry(c.value_) & (detail::char_tables::letter_flag | detail::char_tables::digit_flag)) != 0;
+        }
+
+        /// Indicates whether the character is an uppercase letter.
+        static bool is_upper(Char c)
+        {
+            return (detail::char_tables::entry(c.value_) & detail::char_tables::upper_flag) != 0;
+        }
+
+        /// Indicates whether the character is a lowercase letter.
+        static bool is_lower(Char c)
+        {
+            return (detail::char_tables::entry(c.value_) & detail::char_tables::lower_flag) != 0;
+        }
+
+        /// Indicates whether the character is white space.
+        static bool is_white_space(Char c)
+        {
+            if (c.value_ < 0x80) return c.value_ == u' ' || unsigned(c.value_ - u'\t') < 5u;
+            return (detail::char_tables::entry(c.value_) & detail::char_tables::white_space_flag) != 0;
+        }
+
+        /// Indicates whether the character is a punctuation mark.
+        static bool is_punctuation(Char c)
+        {
+            return (detail::char_tables::entry(c.value_) & detail::char_tables::punctuation_flag) != 0;
+        }
+
+        /// Indicates whether the character is a high or low surrogate.
+        static constexpr bool is_surrogate(Char c) noexcept { return (c.value_ & 0xF800) == 0xD800; }
+
+        /// Indicates whether the character is a high surrogate, the first code unit of a surrogate pair.
+        static constexpr bool is_high_surrogate(Char c) noexcept { return (c.value_ & 0xFC00) == 0xD800; }
+
+        /// Indicates whether the character is a low surrogate, the second code unit of a surrogate pair.
+        static constexpr bool is_low_surrogate(Char c) noexcept { return (c.value_ & 0xFC00) == 0xDC00; }
+
+        /// Indicates whether the two characters form a surrogate pair.
+        static constexpr bool is_surrogate_pair(Char high, Char low) noexcept { return is_high_surrogate(high) && is_low_surrogate(low); }
+
+        /// Converts the value of a surrogate pair into a Unicode code point.
+        static constexpr int convert_to_utf32(Char high, Char low) noexcept
+        {
+            return 0x10000 + ((high.value_ - 0xD800) << 10) + (low.value_ - 0xDC00);
+        }
+
+        /// Converts the character to its uppercase equivalent.
+        static Char to_upper(Char c)
+        {
+            if (c.value_ < 0x80) return unsigned(c.value_ - u'a') < 26u ? char16_t(c.value_ - 0x20) : c.value_;
+            return detail::char_tables::to_upper(c.value_);
+        }
+
+        /// Converts the character to its lowercase equivalent.
+        static Char to_lower(Char c)
+        {
+            if (c.value_ < 0x80) return unsigned(c.value_ - u'A') < 26u ? char16_t(c.value_ + 0x20) : c.value_;
+            return detail::char_tables::to_lower(c.value_);
+        }
+
+    public: // OPERATORS
+
+        /// Value of the UTF-16 code unit.
+        constexpr operator char16_t() const noexcept { return value_; }
+
+        /// Writes the character encoded as UTF-8 to the stream.
+        friend DOT_CLASS std::ostream& operator<<(std::ostream& stream, Char value);
     };
 
+    static_assert(sizeof(Char) == 2 && std::is_trivially_copyable<Char>::value, "Char must be a 16-bit value type.");
+
+    namespace detail
+    {
+        /// Decodes the UTF-8 sequence at the beginning of the range and sets size to
+        /// its number of bytes. Invalid or truncated sequences and encoded surrogates
+        /// decode as U+FFFD with the size of one byte.
+        inline char32_t decode_utf8(const char* begin, const char* end, int& size) noexcept
+        {
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(begin);
+            unsigned char lead = p[0];
+            size = 1;
+            if (lead < 0x80) return lead;
+
+            int count;
+            char32_t result;
+            char32_t minimum;
+            if ((lead & 0xE0) == 0xC0) { count = 1; result = lead & 0x1F; minimum = 0x80; }
+            else if ((lead & 0xF0) == 0xE0) { count = 2; result = lead & 0x0F; minimum = 0x800; }
+            else if ((lead & 0xF8) == 0xF0) { count = 3; result = lead & 0x07; minimum = 0x10000; }
+            else return 0xFFFD;
+
+            if (end - begin <= count) return 0xFFFD;
+            for (int i = 1; i <= count; ++i)
+            {
+                if ((p[i] & 0xC0) != 0x80) return 0xFFFD;
+                result = (result << 6) | (p[i] & 0x3F);
+            }
+            if (result < minimum || result > 0x10FFFF || (result >= 0xD800 && result < 0xE000)) return 0xFFFD;
+
+            size = count + 1;
+            return result;
+        }
+
+        /// Writes the code point encoded as UTF-8 and returns the number of bytes written,
+        /// the buffer must have space for four bytes.
+        inline int encode_utf8(char32_t value, char* out) noexcept
+        {
+            if (value < 0x80)
+            {
+                out[0] = static_cast<char>(value);
+                return 1;
+            }
+            if (value < 0x800)
+            {
+                out[0] = static_cast<char>(0xC0 | (value >> 6));
+                out[1] = static_cast<char>(0x80 | (value & 0x3F));
+                return 2;
+            }
+            if (value < 0x10000)
+            {
+                out[0] = static_cast<char>(0xE0 | (value >> 12));
+                out[1] = static_cast<char>(0x80 | ((value >> 6) & 0x3F));
+                out[2] = static_cast<char>(0x80 | (value & 0x3F));
+                return 3;
+            }
+            out[0] = static_cast<char>(0xF0 | (value >> 18));
+            out[1] = static_cast<char>(0x80 | ((value >> 12) & 0x3F));
+            out[2] = static_cast<char>(0x80 | ((value >> 6) & 0x3F));
+            out[3] = static_cast<char>(0x80 | (value & 0x3F));
+            return 4;
+        }
+
+        /// Forward iterator over the UTF-16 code units of UTF-8 characters,
+        /// decoding them without allocation. Characters outside the Basic
+        /// Multilingual Plane are returned as two surrogate code units.
+        class utf16_iterator
+        {
+            const char* pos_ = nullptr;
+            const char* end_ = nullptr;
+            char32_t code_point_ = 0;
+            int size_ = 0;
+            bool low_ = false;
+
+        public: // TYPEDEF
+
+            typedef std::forward_iterator_tag iterator_category;
+            typedef Char value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const Char* pointer;
+            typedef Char reference;
+
+        public: // CONSTRUCTORS
+
+            /// Create end iterator.
+            utf16_iterator() = default;
+
+            /// Create iterator at the beginning of the range.
+            utf16_iterator(const char* begin, const char* end) noexcept : pos_(begin), end_(end) { decode(); }
+
+        public: // OPERATORS
+
+            /// Code unit at the current position.
+            Char operator*() const noexcept
+            {
+                if (code_point_ < 0x10000) return char16_t(code_point_);
+                if (low_) return char16_t(0xDC00 + ((code_point_ - 0x10000) & 0x3FF));
+                return char16_t(0xD800 + ((code_point_ - 0x10000) >> 10));
+            }
+
+            /// Move to the next code unit.
+            utf16_iterator& operator++() noexcept
+            {
+                if (code_point_ >= 0x10000 && !low_)
+                {
+                    low_ = true;
+                }
+                else
+                {
+                    pos_ += size_;
+                    low_ = false;
+                    decode();
+                }
+                return *this;
+            }
+
+            /// Move to the next code unit.
+            utf16_iterator operator++(int) noexcept { utf16_iterator result = *this; ++*this; return result; }
+
+            /// True if both iterators are at the same code unit.
+            bool operator==(const utf16_iterator& rhs) const noexcept { return pos_ == rhs.pos_ && low_ == rhs.low_; }
+
+            /// True if the iterators are at different code units.
+            bool operator!=(const utf16_iterator& rhs) const noexcept { return !operator==(rhs); }
+
+        private: // METHODS
+
+            void decode() noexcept
+            {
+                if (pos_ < end_) code_point_ = decode_utf8(pos_, end_, size_);
+            }
+        };
+
+        /// Range of the UTF-16 code units of UTF-8 characters.
+        class utf16_range
+        {
+            const char* begin_;
+            const char* end_;
+
+        public: // CONSTRUCTORS
+
+            /// Create from the range of UTF-8 characters.
+            utf16_range(const char* begin, const char* end) noexcept : begin_(begin), end_(end) {}
+
+        public: // METHODS
+
+            /// Iterator at the first code unit.
+            utf16_iterator begin() const noexcept { return utf16_iterator(begin_, end_); }
+
+            /// Iterator after the last code unit.
+            utf16_iterator end() const noexcept { return utf16_iterator(end_, end_); }
+        };
+    }
+
     /// Wrapper around char to make it convertible to object (boxing).
     class char_impl : public virtual object_impl
     {
@@ -23,26 +23,149 @@ limitations under the License.
 
 #pragma once
 
-#include <unordered_map>
+#include <dot/detail/flat_hash_table.hpp>
 #include <dot/system/exception.hpp>
 #include <dot/system/collections/generic/list.hpp>
 
 namespace dot
 {
-    template <class key_t, class value_t> class dictionary_impl;
-    template <class key_t, class value_t> using dictionary = ptr<dictionary_impl<key_t, value_t>>;
+    template <class key_t, class value_t, class hash_t = std::hash<key_t>, class equal_t = std::equal_to<key_t>> class dictionary_impl;
+    template <class key_t, class value_t, class hash_t = std::hash<key_t>, class equal_t = std::equal_to<key_t>>
+    using dictionary = ptr<dictionary_impl<key_t, value_t, hash_t, equal_t>>;
+
+    namespace detail
+    {
+        /// Read-only view of the keys or the values of a dictionary returned by
+        /// keys() and values(), the counterpart of KeyCollection and ValueCollection
+        /// in C#. The view holds a reference to the dictionary and reflects its
+        /// current contents, without copying the keys or values.
+        template <class dictionary_t, bool is_key>
+        class dictionary_view
+            : public query_methods<dictionary_view<dictionary_t, is_key>,
+                std::conditional_t<is_key, typename dictionary_t::key_type, typename dictionary_t::mapped_type>>
+        {
+            typedef typename dictionary_t::iterator base_iterator;
+
+            ptr<dictionary_t> dictionary_;
+
+        public: // TYPEDEF
+
+            typedef std::conditional_t<is_key, typename dictionary_t::key_type, typename dictionary_t::mapped_type> value_type;
+
+            /// Forward iterator over the keys or values in the order of the dictionary.
+            class iterator
+            {
+                base_iterator iter_;
+
+            public:
+
+                typedef std::forward_iterator_tag iterator_category;
+                typedef typename dictionary_view::value_type value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const value_type* pointer;
+                typedef const value_type& reference;
+
+                iterator() = default;
+                explicit iterator(base_iterator iter) : iter_(iter) {}
+
+                reference operator*() const
+                {
+                    if constexpr (is_key) return iter_->first;
+                    else return iter_->second;
+                }
+
+                pointer operator->() const { return &**this; }
+
+                iterator& operator++()
+                {
+                    ++iter_;
+                    return *this;
+                }
+
+                iterator operator++(int)
+                {
+                    iterator result = *this;
+                    ++iter_;
+                    return result;
+                }
+
+                friend bool operator==(const iterator& lhs, const iterator& rhs) { return lhs.iter_ == rhs.iter_; }
+                friend bool operator!=(const iterator& lhs, const iterator& rhs) { return lhs.iter_ != rhs.iter_; }
+            };
+
+        public: // CONSTRUCTORS
+
+            /// Create view of the dictionary.
+            explicit dictionary_view(ptr<dictionary_t> dictionary) : dictionary_(std::move(dictionary)) {}
+
+        public: // METHODS
+
+            /// Gets the number of elements contained in the view.
+            int count() const { return dictionary_->count(); }
+
+            /// Determines whether the view contains the specified element, which
+            /// is a hash lookup for keys and a linear search for values.
+            bool contains(const value_type& item) const
+            {
+                if constexpr (is_key) return dictionary_->contains_key(item);
+                else return dictionary_->contains_value(item);
+            }
+
+            /// Creates a list containing the elements of the view.
+            list<value_type> to_list() const
+            {
+                list<value_type> result = make_list<value_type>();
+                result->set_capacity(count());
+                for (const value_type& x : *this) result->add(x);
+                return result;
+            }
+
+            iterator begin() const { return iterator(dictionary_->begin()); }
+            iterator end() const { return iterator(dictionary_->end()); }
+
+            /// Passes the elements to f until f returns false, and returns false if and
+            /// only if f did, which makes the view a source of query.
+            template <class F>
+            bool visit(F&& f) const
+            {
+                for (const value_type& x : *this)
+                    if (!f(x)) return false;
+                return true;
+            }
+        };
+    }
 
     /// Represents a collection of keys and values.
-    template <class key_t, class value_t>
+    ///
+    /// The hash_t and equal_t template arguments specify how keys are hashed
+    /// and compared, similar to the IEqualityComparer argument of the C#
+    /// constructor, for example string_comparer::ordinal_ignore_case.
+    ///
+    /// Entries are stored in a flat open addressing hash table without an
+    /// allocation per entry, see detail::flat_hash_table. Adding an entry may
+    /// move the other entries and invalidate references to them, and the
+    /// order of enumeration is unspecified.
+    template <class key_t, class value_t, class hash_t, class equal_t>
     class dictionary_impl
         : public virtual object_impl
-        , public std::unordered_map<key_t, value_t>
+        , public detail::flat_hash_table<detail::flat_hash_map_policy<key_t, value_t>, hash_t, equal_t>
+        , public detail::query_methods<dictionary_impl<key_t, value_t, hash_t, equal_t>, std::pair<const key_t, value_t>>
     {
-        typedef dictionary_impl<key_t, value_t> self;
-        typedef std::unordered_map<key_t, value_t> base;
+        typedef dictionary_impl<key_t, value_t, hash_t, equal_t> self;
+        typedef detail::flat_hash_table<detail::flat_hash_map_policy<key_t, value_t>, hash_t, equal_t> base;
+
+        template <class key_t_, class value_t_, class hash_t_, class equal_t_>
+        friend dictionary<key_t_, value_t_, hash_t_, equal_t_> make_dictionary();
+
+    public: // TYPEDEF
+
+        typedef value_t mapped_type;
 
-        template <class key_t_, class value_t_>
-        friend dictionary<key_t_, value_t_> make_dictionary();
+        /// View of the keys returned by keys().
+        typedef detail::dictionary_view<self, true> key_collection;
+
+        /// View of the values returned by values().
+        typedef detail::dictionary_view<self, false> value_collection;
 
     private: // CONSTRUCTORS
 
@@ -54,38 +177,29 @@ namespace dot
     public: // PROPERTIES
 
         /// Gets the number of key/value pairs contained in the dictionary.
-        int count() { return this->size(); }
+        int count() { return static_cast<int>(this->size()); }
 
-        /// Gets a collection containing the keys in the dictionary.
-        list<key_t> keys()
-        {
-            list<key_t> list = make_list<key_t>();
-            for (auto& x : *this) list->add(x.first);
-            return list;
-        }
+        /// Gets a view of the keys in the dictionary, which reflects
+        /// subsequent changes to the dictionary.
+        key_collection keys() { return key_collection(self_ptr()); }
 
-        /// Gets a collection containing the values in the dictionary.
-        list<value_t> values()
-        {
-            list<value_t> list = make_list<value_t>();
-            for (auto& x : *this) list->add(x.second);
-            return list;
-        }
+        /// Gets a view of the values in the dictionary, which reflects
+        /// subsequent changes to the dictionary.
+        value_collection values() { return value_collection(self_ptr()); }
 
     public: // METHODS
 
         /// Adds the specified key and value to the dictionary.
         void add(const key_t& key, const value_t& value)
         {
-            this->add(std::pair<key_t, value_t>(key, value));
+            if (!this->emplace_key(key, key, value).second)
+                throw exception("An element with the same key already exists in the dictionary");
         }
 
         /// Adds the specified value to the ICollection with the specified key.
         void add(const std::pair<key_t, value_t>& key_value_pair)
         {
-            auto res = this->insert(key_value_pair);
-            if (!res.second)
-                throw exception("An element with the same key already exists in the dictionary");
+            add(key_value_pair.first, key_value_pair.second);
         }
 
         /// Determines whether the dictionary contains the specified key.
@@ -123,16 +237,59 @@ namespace dot
             return false;
         }
 
+        /// Ensures that the dictionary can hold up to a specified number
+        /// of entries without further expansion of its backing storage.
+        /// Returns the number of entries it can hold, error if capacity is negative.
+        int ensure_capacity(int capacity)
+        {
+            if (capacity < 0) throw exception("Capacity must not be negative.");
+            this->reserve(static_cast<size_t>(capacity));
+            return static_cast<int>(std::min<size_t>(this->max_load(), std::numeric_limits<int>::max()));
+        }
+
+        /// Sets the capacity of the dictionary to what it would be if it had been
+        /// originally initialized with all its entries.
+        void trim_excess()
+        {
+            this->rehash(0);
+        }
+
     public: // OPERATORS
 
-        /// Gets or sets the value associated with the specified key.
+        /// Gets or sets the value associated with the specified key. Adding the key
+        /// may grow the dictionary, which invalidates references to other values.
         value_t& operator[](const key_t& key)
         {
-            return base::operator[](key);
+            return this->emplace_key(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple()).first->second;
         }
+
+    private: // METHODS
+
+        /// Pointer to this dictionary held by the views.
+        dictionary<key_t, value_t, hash_t, equal_t> self_ptr() { return this; }
     };
 
     /// Initializes a new instance of dictionary.
-    template <class key_t, class value_t>
-    inline dictionary<key_t, value_t> make_dictionary() { return new dictionary_impl<key_t, value_t>(); }
+    template <class key_t, class value_t, class hash_t = std::hash<key_t>, class equal_t = std::equal_to<key_t>>
+    inline dictionary<key_t, value_t, hash_t, equal_t> make_dictionary() { return new dictionary_impl<key_t, value_t, hash_t, equal_t>(); }
+
+    template <class source_t>
+    template <class K>
+    auto query<source_t>::to_dictionary(K key_selector)
+    {
+        return to_dictionary(std::move(key_selector), [](const value_type& x) { return x; });
+    }
+
+    template <class source_t>
+    template <class K, class V>
+    auto query<source_t>::to_dictionary(K key_selector, V value_selector)
+    {
+        auto result = make_dictionary<detail::selector_result_t<K, const value_type&>, detail::selector_result_t<V, const value_type&>>();
+        visit([&](auto&& x)
+        {
+            result->add(detail::invoke_selector(key_selector, x), detail::invoke_selector(value_selector, x));
+            return true;
+        });
+        return result;
+    }
 }
@@ -23,24 +23,34 @@ limitations under the License.
 
 #pragma once
 
-#include <unordered_set>
+#include <dot/detail/flat_hash_table.hpp>
 #include <dot/system/exception.hpp>
 #include <dot/system/collections/generic/list.hpp>
 
 namespace dot
 {
-    template <class T> class hash_set_impl;
-    template <class T> using hash_set = ptr<hash_set_impl<T>>;
+    template <class T, class hash_t = std::hash<T>, class equal_t = std::equal_to<T>> class hash_set_impl;
+    template <class T, class hash_t = std::hash<T>, class equal_t = std::equal_to<T>> using hash_set = ptr<hash_set_impl<T, hash_t, equal_t>>;
 
     /// Represents a set of values.
-    template <class T>
-    class hash_set_impl : public virtual object_impl, public std::unordered_set<T>
+    ///
+    /// The hash_t and equal_t template arguments specify how values are hashed
+    /// and compared, similar to the IEqualityComparer argument of the C#
+    /// constructor, for example string_comparer::ordinal_ignore_case.
+    ///
+    /// Elements are stored in a flat open addressing hash table without an
+    /// allocation per element, see detail::flat_hash_table.
+    template <class T, class hash_t, class equal_t>
+    class hash_set_impl
+        : public virtual object_impl
+        , public detail::flat_hash_table<detail::flat_hash_set_policy<T>, hash_t, equal_t>
+        , public detail::query_methods<hash_set_impl<T, hash_t, equal_t>, T>
     {
-        typedef hash_set_impl<T> self;
-        typedef std::unordered_set<T> base;
+        typedef hash_set_impl<T, hash_t, equal_t> self;
+        typedef detail::flat_hash_table<detail::flat_hash_set_policy<T>, hash_t, equal_t> base;
 
-        template <class R> friend hash_set<R> make_hash_set();
-        template <class R> friend hash_set<R> make_hash_set(list<R> collection);
+        template <class R, class hash_r, class equal_r> friend hash_set<R, hash_r, equal_r> make_hash_set();
+        template <class R, class hash_r, class equal_r> friend hash_set<R, hash_r, equal_r> make_hash_set(list<R> collection);
 
     protected: // CONSTRUCTORS
 
@@ -60,15 +70,14 @@ namespace dot
     public: // PROPERTIES
 
         /// Gets the number of elements that are contained in the set.
-        int count() { return this->size(); }
+        int count() { return static_cast<int>(this->size()); }
 
     public: // METHODS
 
         /// Adds the specified element to a set.
         void add(const T& item)
         {
-            std::pair<typename base::iterator, bool> res = this->insert(item);
-            //return res.second;
+            this->insert(item);
         }
 
         /// Determines whether a HashSet object contains the specified element.
@@ -88,7 +97,7 @@ namespace dot
         /// it contains,rounded up to a nearby, implementation-specific value.
         void trim_excess()
         {
-            this->reserve(this->size());
+            this->rehash(0);
         }
 
         /// Searches the set for a given value and returns the equal value it finds, if any.
@@ -108,7 +117,7 @@ namespace dot
         {
             for (T const& item : other)
             {
-                this->Remove(item);
+                this->remove(item);
             }
         }
 
@@ -128,9 +137,20 @@ namespace dot
         }
     };
 
-    template <class T>
-    inline hash_set<T> make_hash_set() { return new hash_set_impl<T>(); }
+    /// Initializes a new instance of the HashSet class that is empty.
+    template <class T, class hash_t = std::hash<T>, class equal_t = std::equal_to<T>>
+    inline hash_set<T, hash_t, equal_t> make_hash_set() { return new hash_set_impl<T, hash_t, equal_t>(); }
 
-    template <class T>
-    inline hash_set<T> make_hash_set(list<T> collection) { return new hash_set_impl<T>(collection); }
+    /// Initializes a new instance of the HashSet class that contains elements copied from the specified collection.
+    template <class T, class hash_t = std::hash<T>, class equal_t = std::equal_to<T>>
+    inline hash_set<T, hash_t, equal_t> make_hash_set(list<T> collection) { return new hash_set_impl<T, hash_t, equal_t>(collection); }
+
+    template <class source_t>
+    template <class hash_t, class equal_t>
+    auto query<source_t>::to_hash_set()
+    {
+        hash_set<value_type, hash_t, equal_t> result = make_hash_set<value_type, hash_t, equal_t>();
+        visit([&](auto&& x) { result->add(x); return true; });
+        return result;
+    }
 }
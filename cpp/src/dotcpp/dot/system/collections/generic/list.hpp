@@ -25,6 +25,9 @@ limitations under the License.
 
 #include <dot/system/ptr.hpp>
 #include <dot/system/collections/list_base.hpp>
+#include <dot/system/span.hpp>
+#include <dot/system/linq/query.hpp>
+#include <dot/system/linq/parallel_query.hpp>
 
 namespace dot
 {
@@ -32,8 +35,13 @@ namespace dot
     class type_builder_impl; using type_builder = ptr<type_builder_impl>;
 
     /// Represents a strongly typed collection of objects that can be accessed by index.
+    ///
+    /// Typed element access through operator[] and as_span() is not virtual
+    /// and can be inlined, while untyped access through list_base_impl
+    /// remains polymorphic. LINQ operators such as where(...) and order_by(...)
+    /// return a lazily evaluated query.
     template <class T>
-    class list_impl : public virtual object_impl, public std::vector<T>, public list_base_impl
+    class list_impl : public virtual object_impl, public std::vector<T>, public list_base_impl, public detail::query_methods<list_impl<T>, T>
     {
         template <class R> friend list<R> make_list();
         template <class R> friend list<R> make_list(const std::vector<R> & obj);
@@ -59,7 +67,7 @@ namespace dot
         /// Construct from vector using move semantics.
         ///
         /// This constructor is private. Use make_list(...) function instead.
-        explicit list_impl(std::vector<T>&& obj) : base(obj) {}
+        explicit list_impl(std::vector<T>&& obj) : base(std::move(obj)) {}
 
         /// Construct from initializer list.
         ///
@@ -103,6 +111,84 @@ namespace dot
             return false;
         }
 
+        /// Sorts the elements in the entire list using the default comparer.
+        ///
+        /// Integer, double and local_date elements are sorted by radix sort,
+        /// and lists with at least detail::parallel_sort_threshold elements
+        /// by parallel merge sort on detail::work_stealing_pool. NaN is less
+        /// than other doubles, as in C#.
+        void sort() { detail::sort_values<T>(*this); }
+
+        /// Sorts the elements in the entire list using the comparison, which returns
+        /// int that is a negative number, zero or a positive number if the first element
+        /// is less than, equal to or greater than the second, or by the key returned by
+        /// the selector, which may be a lambda or a pointer to member. Comparisons that
+        /// return bool or another type are rejected at compile time.
+        ///
+        /// Sort by key is stable and calls the selector once per element, then
+        /// sorts the keys as order_by(...) does. Sort by comparison is not stable
+        /// and calls the comparison on the current thread only.
+        template <class F>
+        void sort(F comparison_or_key_selector)
+        {
+            if constexpr (std::is_invocable<F&, const T&, const T&>::value)
+            {
+                static_assert(std::is_same<std::invoke_result_t<F&, const T&, const T&>, int>::value,
+                    "Comparison passed to sort(...) must return int, not bool or another type.");
+                std::sort(this->begin(), this->end(),
+                    [&comparison_or_key_selector](const T& lhs, const T& rhs) { return comparison_or_key_selector(lhs, rhs) < 0; });
+            }
+            else
+            {
+                detail::key_comparer<detail::identity_comparer, F, false> comparer(detail::identity_comparer(), std::move(comparison_or_key_selector));
+                detail::sort_by_keys<T>(*this, comparer.make_keys(static_cast<const base&>(*this)));
+            }
+        }
+
+        /// Searches the entire sorted list for an element using the default comparer
+        /// and returns the zero-based index of the element, if found; otherwise,
+        /// a negative number that is the bitwise complement of the index of the
+        /// next element that is larger than item or, if there is no larger element,
+        /// the bitwise complement of count().
+        int binary_search(const T& item) const
+        {
+            return binary_search(item, [](const T& lhs, const T& rhs) { return detail::compare_sort_keys(lhs, rhs); });
+        }
+
+        /// Searches the entire list sorted by the comparison for an element and returns
+        /// the zero-based index of the element, if found; otherwise, the bitwise
+        /// complement of the index of the next element that is larger than item.
+        template <class F>
+        int binary_search(const T& item, F comparison) const
+        {
+            auto iter = std::lower_bound(this->begin(), this->end(), item, [&comparison](const T& lhs, const T& rhs) { return comparison(lhs, rhs) < 0; });
+            int index = static_cast<int>(iter - this->begin());
+            return iter != this->end() && comparison(*iter, item) == 0 ? index : ~index;
+        }
+
+        /// Span over the elements of the list, invalidated when the list
+        /// is reallocated, for example when an element is added beyond
+        /// the current capacity.
+        ///
+        /// This method does not have a counterpart in C#, the equivalent
+        /// is CollectionsMarshal.AsSpan(list).
+        span<T> as_span() { return span<T>(this->data(), static_cast<int>(this->size())); }
+
+        /// Read-only span over the elements of the list, invalidated when
+        /// the list is reallocated.
+        ///
+        /// This method does not have a counterpart in C#.
+        span<const T> as_span() const { return span<const T>(this->data(), static_cast<int>(this->size())); }
+
+        /// Enables parallelization of a query over the elements of the list.
+        ///
+        /// Objects held by the list must not use single_threaded reference
+        /// counting mode, see parallel_query.
+        parallel_query<T, detail::identity_stage> as_parallel()
+        {
+            return parallel_query<T, detail::identity_stage>(list<T>(this), detail::identity_stage(), false);
+        }
+
     public: // VIRTUAL METHODS
 
         /// Get object from collection by index.
@@ -132,10 +218,10 @@ namespace dot
     public: // OPERATORS
 
         /// Gets or sets the element at the specified index (const version).
-        virtual const T& operator[](int i) const { return base::operator[](i); }
+        const T& operator[](int i) const { return base::operator[](i); }
 
         /// Gets or sets the element at the specified index (non-const version).
-        virtual T& operator[](int i) { return base::operator[](i); }
+        T& operator[](int i) { return base::operator[](i); }
 
     public: // REFLECTION
 
@@ -0,0 +1,280 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/precompiled.hpp>
+#include <dot/implement.hpp>
+#include <dot/system/cycle_collector.hpp>
+#include <dot/system/type.hpp>
+#include <dot/system/reflection/field_info.hpp>
+#include <dot/system/collections/generic/list.hpp>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace dot
+{
+    namespace detail
+    {
+        namespace
+        {
+            /// Number of possible roots processed between checks of the pause limit.
+            const size_t cycle_collector_batch_size = 64;
+
+            /// Possible roots recorded by the current thread, created on first use.
+            thread_local std::unordered_set<reference_counter*>* possible_roots = nullptr;
+
+            /// Set when the possible roots of the current thread have been released
+            /// on thread exit, after which objects are no longer recorded.
+            thread_local bool possible_roots_released = false;
+
+            /// Releases the possible roots of the current thread on thread exit.
+            struct possible_roots_guard
+            {
+                ~possible_roots_guard()
+                {
+                    delete possible_roots;
+                    possible_roots = nullptr;
+                    possible_roots_released = true;
+                }
+            };
+
+            /// Possible roots of the current thread, or nullptr after thread exit.
+            std::unordered_set<reference_counter*>* get_possible_roots()
+            {
+                if (possible_roots == nullptr && !possible_roots_released)
+                {
+                    static thread_local possible_roots_guard guard;
+                    possible_roots = new std::unordered_set<reference_counter*>();
+                }
+                return possible_roots;
+            }
+
+            /// State of an object traced by cycle_collector.
+            struct cycle_collector_node
+            {
+                /// Object traced.
+                reference_counter* obj_;
+
+                /// Reference count less the number of references from other traced objects.
+                long long count_;
+
+                /// Object is reachable from outside of the traced subgraph.
+                bool alive_;
+
+                /// Parent in the union-find forest used to count cycles.
+                size_t parent_;
+            };
+
+            /// Root of the union-find tree containing the node.
+            size_t find_cycle(std::vector<cycle_collector_node>& nodes, size_t i)
+            {
+                while (nodes[i].parent_ != i)
+                {
+                    nodes[i].parent_ = nodes[nodes[i].parent_].parent_;
+                    i = nodes[i].parent_;
+                }
+                return i;
+            }
+        }
+    }
+
+    void cycle_collector::enable()
+    {
+        detail::is_cycle_collection_enabled() = true;
+    }
+
+    void cycle_collector::disable()
+    {
+        detail::is_cycle_collection_enabled() = false;
+    }
+
+    bool cycle_collector::is_enabled()
+    {
+        return detail::is_cycle_collection_enabled();
+    }
+
+    size_t cycle_collector::possible_root_count()
+    {
+        return detail::possible_roots != nullptr ? detail::possible_roots->size() : 0;
+    }
+
+    cycle_collector_stats cycle_collector::collect()
+    {
+        return collect(std::numeric_limits<size_t>::max(), std::chrono::microseconds::max());
+    }
+
+    cycle_collector_stats cycle_collector::collect(std::chrono::microseconds max_pause)
+    {
+        return collect(detail::cycle_collector_batch_size, max_pause);
+    }
+
+    void cycle_collector::add_possible_root(reference_counter* obj)
+    {
+        std::unordered_set<reference_counter*>* roots = detail::get_possible_roots();
+        if (roots == nullptr) return;
+
+        roots->insert(obj);
+        obj->shared_count_.store(obj->shared_count_.load(std::memory_order_relaxed) | reference_counter::buffered_flag_, std::memory_order_relaxed);
+    }
+
+    void cycle_collector::remove_possible_root(reference_counter* obj)
+    {
+        if (detail::possible_roots != nullptr) detail::possible_roots->erase(obj);
+    }
+
+    cycle_collector_stats cycle_collector::collect(size_t batch_size, std::chrono::microseconds max_pause)
+    {
+        using clock = std::chrono::steady_clock;
+        const bool is_limited = max_pause != std::chrono::microseconds::max();
+        const clock::time_point start = clock::now();
+
+        // Calls fn(child) for each tracked object referenced by the fields of obj
+        auto for_each_child = [](reference_counter* obj, auto&& fn)
+        {
+            object_impl* parent = dynamic_cast<object_impl*>(obj);
+            if (parent == nullptr) return;
+
+            for (const field_info& field : parent->get_type()->get_fields())
+            {
+                object_impl* child = field->get_reference(borrowed_ptr<object_impl>(parent));
+                if (child != nullptr && (child->shared_count_.load(std::memory_order_relaxed) & reference_counter::tracked_flag_)) fn(child);
+            }
+        };
+
+        cycle_collector_stats stats;
+        std::unordered_set<reference_counter*>* roots = detail::get_possible_roots();
+        bool is_first_batch = true;
+        while (roots != nullptr && !roots->empty())
+        {
+            if (is_limited && !is_first_batch && clock::now() - start >= max_pause) break;
+            is_first_batch = false;
+
+            std::vector<detail::cycle_collector_node> nodes;
+            std::unordered_map<reference_counter*, size_t> index;
+
+            // Take a batch of roots, objects recorded while the batch is
+            // processed are left for the next batch
+            auto iter = roots->begin();
+            while (iter != roots->end() && nodes.size() < batch_size)
+            {
+                reference_counter* obj = *iter;
+                obj->shared_count_.store(obj->shared_count_.load(std::memory_order_relaxed) & ~reference_counter::buffered_flag_, std::memory_order_relaxed);
+                index.emplace(obj, nodes.size());
+                nodes.push_back({ obj, obj->reference_count(), false, nodes.size() });
+                iter = roots->erase(iter);
+            }
+
+            // Trace the subgraph reachable from the roots and subtract
+            // references between traced objects from their counts, the
+            // actual reference counts are not modified
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                for_each_child(nodes[i].obj_, [&nodes, &index](reference_counter* child)
+                {
+                    auto found = index.find(child);
+                    if (found == index.end())
+                    {
+                        found = index.emplace(child, nodes.size()).first;
+                        nodes.push_back({ child, child->reference_count(), false, nodes.size() });
+                    }
+                    --nodes[found->second].count_;
+                });
+            }
+            stats.traced_count += nodes.size();
+
+            // Objects referenced from outside and everything reachable from them are alive
+            std::vector<size_t> pending;
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                if (nodes[i].count_ > 0)
+                {
+                    nodes[i].alive_ = true;
+                    pending.push_back(i);
+                }
+            }
+            while (!pending.empty())
+            {
+                size_t i = pending.back();
+                pending.pop_back();
+                for_each_child(nodes[i].obj_, [&nodes, &index, &pending](reference_counter* child)
+                {
+                    size_t j = index[child];
+                    if (!nodes[j].alive_)
+                    {
+                        nodes[j].alive_ = true;
+                        pending.push_back(j);
+                    }
+                });
+            }
+
+            // Remaining objects are garbage, count connected groups as cycles
+            std::vector<reference_counter*> garbage;
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                if (nodes[i].alive_) continue;
+
+                garbage.push_back(nodes[i].obj_);
+                for_each_child(nodes[i].obj_, [&nodes, &index, i](reference_counter* child)
+                {
+                    size_t a = detail::find_cycle(nodes, i);
+                    size_t b = detail::find_cycle(nodes, index[child]);
+                    if (a != b) nodes[b].parent_ = a;
+                });
+            }
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                if (!nodes[i].alive_ && detail::find_cycle(nodes, i) == i) ++stats.cycle_count;
+            }
+
+            // Hold a reference to each garbage object while the references between
+            // them are cleared, then release it to delete the object
+            for (reference_counter* obj : garbage) obj->increment_reference_count();
+            for (reference_counter* obj : garbage)
+            {
+                object_impl* parent = dynamic_cast<object_impl*>(obj);
+                if (parent == nullptr) continue;
+
+                for (const field_info& field : parent->get_type()->get_fields())
+                {
+                    field->clear_reference(borrowed_ptr<object_impl>(parent));
+                }
+            }
+            for (reference_counter* obj : garbage)
+            {
+                if (obj->reference_count() == 1)
+                {
+                    stats.reclaimed_bytes += obj->allocated_size();
+                    ++stats.object_count;
+                }
+                obj->decrement_reference_count();
+            }
+
+            // Refresh in case the roots were released by a destructor on thread exit
+            roots = detail::possible_roots;
+        }
+
+        stats.pending_root_count = roots != nullptr ? roots->size() : 0;
+        return stats;
+    }
+}
@@ -0,0 +1,125 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+#include <chrono>
+
+namespace dot
+{
+    class reference_counter;
+
+    /// Result of a call to cycle_collector::collect(...).
+    struct DOT_CLASS cycle_collector_stats
+    {
+        /// Number of garbage cycles reclaimed, where each connected group
+        /// of unreachable objects is counted as one cycle.
+        size_t cycle_count = 0;
+
+        /// Number of objects reclaimed.
+        size_t object_count = 0;
+
+        /// Number of bytes reclaimed, including the allocation headers.
+        size_t reclaimed_bytes = 0;
+
+        /// Number of objects visited while tracing the graph.
+        size_t traced_count = 0;
+
+        /// Number of possible roots left for the next call because
+        /// the pause limit has been reached.
+        size_t pending_root_count = 0;
+    };
+
+    /// Reclaims cycles of objects that reference each other through
+    /// their fields and are no longer referenced from outside the cycle.
+    ///
+    /// Reference counting alone never releases such cycles. Objects created
+    /// by a thread while the collector is enabled on that thread are tracked.
+    /// When the count of a tracked object is decremented to a value other
+    /// than zero, the object is recorded as a possible root of a garbage
+    /// cycle. collect() performs trial deletion starting from the possible
+    /// roots: the count of each object reachable from them is reduced by
+    /// the number of references from other objects in the same subgraph,
+    /// and objects left without references from outside the subgraph or
+    /// from objects still alive are deleted.
+    ///
+    /// The graph is traced using the fields registered with type_builder,
+    /// references held in other ways, such as list elements, are treated
+    /// as references from outside and keep their objects alive.
+    ///
+    /// Tracked objects use single_threaded reference counting mode and
+    /// must not be shared with other threads, which atomic_ptr and parallel
+    /// queries reject with an exception. The collector only reclaims
+    /// objects tracked by the thread that calls collect(...).
+    ///
+    /// This class does not have a counterpart in C#.
+    class DOT_CLASS cycle_collector final
+    {
+        friend class reference_counter;
+
+    private: // CONSTRUCTORS
+
+        cycle_collector() = delete;
+        cycle_collector(const cycle_collector&) = delete;
+        cycle_collector& operator=(const cycle_collector&) = delete;
+
+    public: // STATIC
+
+        /// Track objects created by the current thread after this call.
+        static void enable();
+
+        /// Stop tracking objects created by the current thread after this call.
+        /// Objects created while the collector was enabled remain tracked.
+        static void disable();
+
+        /// True if objects created by the current thread are tracked.
+        static bool is_enabled();
+
+        /// Number of possible roots recorded by the current thread.
+        static size_t possible_root_count();
+
+        /// Reclaim garbage cycles reachable from all possible roots
+        /// recorded by the current thread.
+        static cycle_collector_stats collect();
+
+        /// Reclaim garbage cycles reachable from the possible roots recorded
+        /// by the current thread, processing the roots in batches and stopping
+        /// before the next batch once max_pause has elapsed. Roots left
+        /// unprocessed are reported in pending_root_count and processed
+        /// by the next call.
+        static cycle_collector_stats collect(std::chrono::microseconds max_pause);
+
+    private: // STATIC
+
+        /// Record a possible root of a garbage cycle.
+        static void add_possible_root(reference_counter* obj);
+
+        /// Remove a possible root that is about to be deleted.
+        static void remove_possible_root(reference_counter* obj);
+
+        /// Process the possible roots in batches of the specified size
+        /// until all roots are processed or max_pause has elapsed.
+        static cycle_collector_stats collect(size_t batch_size, std::chrono::microseconds max_pause);
+    };
+}
@@ -0,0 +1,197 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/precompiled.hpp>
+#include <dot/implement.hpp>
+#include <dot/system/deferred_reclaimer.hpp>
+#include <dot/detail/reference_counter.hpp>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dot
+{
+    namespace detail
+    {
+        namespace
+        {
+            /// Queue shared by the threads that release objects and the background thread.
+            class deferred_reclaimer_queue
+            {
+            public: // FIELDS
+
+                /// Protects all other fields.
+                std::mutex mutex_;
+
+                /// Signaled when objects are added to an empty queue.
+                std::condition_variable work_;
+
+                /// Signaled when the background thread has deleted a batch.
+                std::condition_variable done_;
+
+                /// Objects waiting for the background thread.
+                std::vector<reference_counter*> queue_;
+
+                /// Number of objects queued since the start of the process.
+                size_t enqueued_count_ = 0;
+
+                /// Number of objects deleted by the background thread.
+                size_t deleted_count_ = 0;
+
+                /// True once the background thread has been started.
+                bool started_ = false;
+
+                /// True once static objects are being destroyed at exit, objects
+                /// released after that are deleted by the releasing thread.
+                bool stopping_ = false;
+
+                /// Background thread, joined at exit by deferred_reclaimer_shutdown.
+                std::thread thread_;
+            };
+
+            /// Queue is never deleted so that it remains available
+            /// to the background thread until the process exits.
+            deferred_reclaimer_queue& get_deferred_reclaimer_queue()
+            {
+                static deferred_reclaimer_queue* queue = new deferred_reclaimer_queue();
+                return *queue;
+            }
+
+            /// Stops the background thread when static objects are destroyed at exit,
+            /// after it has deleted the objects remaining in the queue.
+            struct deferred_reclaimer_shutdown
+            {
+                ~deferred_reclaimer_shutdown()
+                {
+                    deferred_reclaimer_queue& queue = get_deferred_reclaimer_queue();
+                    {
+                        std::lock_guard<std::mutex> lock(queue.mutex_);
+                        queue.stopping_ = true;
+                    }
+                    queue.work_.notify_one();
+                    if (queue.thread_.joinable()) queue.thread_.join();
+                }
+            };
+
+            /// Body of the background thread, deletes queued objects in batches
+            /// until the queue is empty after deferred_reclaimer_shutdown has started.
+            void run_deferred_reclaimer(deferred_reclaimer_queue& queue)
+            {
+                std::vector<reference_counter*> batch;
+                while (true)
+                {
+                    {
+                        std::unique_lock<std::mutex> lock(queue.mutex_);
+                        queue.deleted_count_ += batch.size();
+                        if (!batch.empty()) queue.done_.notify_all();
+
+                        batch.clear();
+                        queue.work_.wait(lock, [&queue]() { return !queue.queue_.empty() || queue.stopping_; });
+                        if (queue.queue_.empty()) return;
+                        batch.swap(queue.queue_);
+                    }
+
+                    // Objects released by the destructors are deleted by this thread
+                    for (reference_counter* p : batch) delete p;
+                }
+            }
+        }
+    }
+
+    void deferred_reclaimer::enable()
+    {
+        detail::is_deferred_release_enabled() = true;
+    }
+
+    void deferred_reclaimer::disable()
+    {
+        detail::is_deferred_release_enabled() = false;
+    }
+
+    bool deferred_reclaimer::is_enabled()
+    {
+        return detail::is_deferred_release_enabled();
+    }
+
+    size_t deferred_reclaimer::pending_count()
+    {
+        detail::deferred_reclaimer_queue& queue = detail::get_deferred_reclaimer_queue();
+        std::lock_guard<std::mutex> lock(queue.mutex_);
+        return queue.enqueued_count_ - queue.deleted_count_;
+    }
+
+    void deferred_reclaimer::flush()
+    {
+        detail::deferred_reclaimer_queue& queue = detail::get_deferred_reclaimer_queue();
+        size_t target = 0;
+        while (true)
+        {
+            // Destructors run by the background thread may have returned
+            // objects owned by this thread for merge, which queues them again
+            reference_counter::merge_queued_reference_counts();
+
+            std::unique_lock<std::mutex> lock(queue.mutex_);
+            if (target != 0 && queue.enqueued_count_ == target) break;
+
+            target = queue.enqueued_count_;
+            queue.done_.wait(lock, [&queue, target]() { return queue.deleted_count_ >= target; });
+            if (target == 0) break;
+        }
+    }
+
+    void deferred_reclaimer::enqueue(reference_counter* obj)
+    {
+        detail::deferred_reclaimer_queue& queue = detail::get_deferred_reclaimer_queue();
+        bool was_empty = false;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex_);
+            if (!queue.stopping_)
+            {
+                was_empty = queue.queue_.empty();
+                queue.queue_.push_back(obj);
+                ++queue.enqueued_count_;
+
+                if (!queue.started_)
+                {
+                    // Constructed before the thread starts, so that it is destroyed at exit
+                    static detail::deferred_reclaimer_shutdown shutdown;
+                    queue.started_ = true;
+                    queue.thread_ = std::thread(detail::run_deferred_reclaimer, std::ref(queue));
+                }
+                obj = nullptr;
+            }
+        }
+
+        // Background thread has stopped at exit
+        if (obj != nullptr)
+        {
+            delete obj;
+            return;
+        }
+
+        // The background thread only waits when the queue is empty
+        if (was_empty) queue.work_.notify_one();
+    }
+}
@@ -0,0 +1,86 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+
+namespace dot
+{
+    class reference_counter;
+
+    /// Destroys objects released by latency sensitive threads on a
+    /// background thread, so that the release of the last reference
+    /// to a large object graph does not run the destructors of the
+    /// whole graph on the thread that released it.
+    ///
+    /// When deferred release is enabled on a thread, objects whose
+    /// reference count is decremented to zero by that thread are queued
+    /// rather than deleted. A background thread, started on first use,
+    /// takes the queue in batches and deletes the objects. Objects
+    /// released by their destructors are deleted by the background
+    /// thread directly, except those in biased mode owned by another
+    /// thread, which are returned to the owner thread for merge as usual
+    /// and queued again when the owner merges them. Objects in
+    /// single_threaded mode are always deleted by the releasing thread.
+    ///
+    /// This class does not have a counterpart in C#.
+    class DOT_CLASS deferred_reclaimer final
+    {
+        friend class reference_counter;
+
+    private: // CONSTRUCTORS
+
+        deferred_reclaimer() = delete;
+        deferred_reclaimer(const deferred_reclaimer&) = delete;
+        deferred_reclaimer& operator=(const deferred_reclaimer&) = delete;
+
+    public: // STATIC
+
+        /// Defer the destruction of objects released by the current thread after this call.
+        static void enable();
+
+        /// Delete objects released by the current thread after this call immediately.
+        static void disable();
+
+        /// True if objects released by the current thread are destroyed by the background thread.
+        static bool is_enabled();
+
+        /// Number of objects queued and not yet deleted.
+        static size_t pending_count();
+
+        /// Wait until all objects queued before this call, and objects
+        /// released by their destructors to the current thread, are deleted.
+        ///
+        /// This method is intended for tests. Objects still queued when static
+        /// objects are destroyed at exit are deleted before the background
+        /// thread is joined, and objects released after that are deleted by
+        /// the releasing thread.
+        static void flush();
+
+    private: // STATIC
+
+        /// Queue the object for deletion by the background thread.
+        static void enqueue(reference_counter* obj);
+    };
+}
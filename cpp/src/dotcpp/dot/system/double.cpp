@@ -26,16 +26,21 @@ limitations under the License.
 #include <dot/system/double.hpp>
 #include <dot/system/string.hpp>
 #include <dot/system/type.hpp>
+#include <dot/system/exception.hpp>
+#include <dot/detail/parse_number.hpp>
+#include <charconv>
+#include <cmath>
+#include <cstring>
 
 namespace dot
 {
     bool double_impl::equals(object obj)
     {
-        if (this == &(*obj)) return true;
+        if (!obj.is_inline() && this == &(*obj)) return true;
 
         if (obj.is<ptr<double_impl>>())
         {
-            return value_ == obj.as<ptr<double_impl>>()->value_;
+            return value_ == double(obj);
         }
 
         return false;
@@ -48,7 +53,8 @@ namespace dot
 
     string double_impl::to_string()
     {
-        return std::to_string(value_);
+        char buffer[max_chars];
+        return make_string(std::string_view(buffer, to_chars(buffer, value_) - buffer));
     }
 
     type double_impl::typeof()
@@ -63,6 +69,171 @@ namespace dot
 
     double double_impl::parse(string s)
     {
-        return std::stod(*s);
+        if (s == nullptr) throw exception("String to parse is null.");
+
+        double result;
+        if (!try_parse(*s, result)) throw exception("Input string was not in a correct format.");
+        return result;
+    }
+
+    bool double_impl::try_parse(std::string_view s, double& result)
+    {
+        s = detail::trim_number_white_space(s);
+        bool negative = false;
+        if (!s.empty() && (s.front() == '+' || s.front() == '-'))
+        {
+            negative = s.front() == '-';
+            s.remove_prefix(1);
+        }
+        if (s.empty()) return false;
+
+        // Symbols of the invariant culture, compared ignoring case as in .NET
+        auto is_symbol = [s](std::string_view symbol)
+        {
+            if (s.size() != symbol.size()) return false;
+            for (size_t i = 0; i < s.size(); ++i)
+                if ((s[i] | 0x20) != symbol[i]) return false;
+            return true;
+        };
+        if (is_symbol("infinity") || s == "\xe2\x88\x9e")
+        {
+            result = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+            return true;
+        }
+        if (is_symbol("nan"))
+        {
+            result = std::numeric_limits<double>::quiet_NaN();
+            return true;
+        }
+
+        // from_chars accepts neither a sign here nor symbols, which are handled above,
+        // but it does accept hexadecimal exponents and symbols such as inf, which are
+        // excluded by requiring a digit or decimal point first
+        if (!(s.front() >= '0' && s.front() <= '9') && s.front() != '.') return false;
+
+        // Group separators are only allowed before the decimal point
+        char buffer[256];
+        size_t separators = s.find_first_of(",.eE");
+        if (separators != std::string_view::npos && s[separators] == ',')
+        {
+            size_t size = 0;
+            size_t i = 0;
+            for (; i < s.size() && s[i] != '.' && s[i] != 'e' && s[i] != 'E'; ++i)
+            {
+                if (s[i] == ',') continue;
+                if (size == sizeof(buffer)) return false;
+                buffer[size++] = s[i];
+            }
+            if (size + s.size() - i > sizeof(buffer)) return false;
+            std::memcpy(buffer + size, s.data() + i, s.size() - i);
+            s = std::string_view(buffer, size + s.size() - i);
+        }
+
+        double value;
+        auto [end, error] = std::from_chars(s.data(), s.data() + s.size(), value, std::chars_format::general);
+        if (end != s.data() + s.size()) return false;
+        if (error == std::errc::result_out_of_range)
+        {
+            // Overflow becomes infinity and underflow becomes zero as in .NET Core 3.0
+            // and later, distinguished by the decimal exponent of the first significant digit
+            size_t exponent_pos = s.find_first_of("eE");
+            std::string_view mantissa = s.substr(0, exponent_pos);
+            size_t point = std::min(mantissa.find('.'), mantissa.size());
+            size_t first = mantissa.find_first_not_of("0.");
+            long long order = first < point ? static_cast<long long>(point - first) - 1 : static_cast<long long>(point) - static_cast<long long>(first);
+
+            long long exponent = 0;
+            if (exponent_pos != std::string_view::npos)
+            {
+                const char* begin = s.data() + exponent_pos + 1;
+                if (*begin == '+') ++begin;
+                if (std::from_chars(begin, s.data() + s.size(), exponent).ec != std::errc())
+                    exponent = *begin == '-' ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+            }
+            value = order + exponent > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+        }
+        else if (error != std::errc()) return false;
+
+        result = negative ? -value : value;
+        return true;
+    }
+
+    char* double_impl::to_chars(char* buffer, double value)
+    {
+        if (std::isnan(value))
+        {
+            std::memcpy(buffer, "NaN", 3);
+            return buffer + 3;
+        }
+        char* p = buffer;
+        if (std::signbit(value))
+        {
+            *p++ = '-';
+            value = -value;
+        }
+        if (std::isinf(value))
+        {
+            std::memcpy(p, "Infinity", 8);
+            return p + 8;
+        }
+        if (value == 0)
+        {
+            *p = '0';
+            return p + 1;
+        }
+
+        // Shortest digits that round trip, in the form d.dddde[+-]xx
+        char digits[32];
+        char* end = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::scientific).ptr;
+        char* e = static_cast<char*>(std::memchr(digits, 'e', end - digits));
+        int exponent = 0;
+        std::from_chars(e + 2, end, exponent);
+        if (e[1] == '-') exponent = -exponent;
+
+        // Collect significant digits without the decimal point
+        char mantissa[20];
+        int count = 0;
+        mantissa[count++] = digits[0];
+        for (char* d = digits + 2; d < e; ++d) mantissa[count++] = *d;
+
+        if (exponent >= 15 || exponent < -4)
+        {
+            *p++ = mantissa[0];
+            if (count > 1)
+            {
+                *p++ = '.';
+                std::memcpy(p, mantissa + 1, count - 1);
+                p += count - 1;
+            }
+            *p++ = 'E';
+            *p++ = exponent < 0 ? '-' : '+';
+            int magnitude = exponent < 0 ? -exponent : exponent;
+            if (magnitude < 10) *p++ = '0';
+            return std::to_chars(p, p + 3, magnitude).ptr;
+        }
+        else if (exponent < 0)
+        {
+            *p++ = '0';
+            *p++ = '.';
+            std::memset(p, '0', -exponent - 1);
+            p += -exponent - 1;
+            std::memcpy(p, mantissa, count);
+            return p + count;
+        }
+        else if (count <= exponent + 1)
+        {
+            std::memcpy(p, mantissa, count);
+            p += count;
+            std::memset(p, '0', exponent + 1 - count);
+            return p + exponent + 1 - count;
+        }
+        else
+        {
+            std::memcpy(p, mantissa, exponent + 1);
+            p += exponent + 1;
+            *p++ = '.';
+            std::memcpy(p, mantissa + exponent + 1, count - exponent - 1);
+            return p + count - exponent - 1;
+        }
     }
 }
@@ -47,11 +47,39 @@ namespace dot
         /// Tolerance used in comparison.
         static constexpr double tolerance = 1e-10;
 
+        /// Maximum number of characters written by to_chars(...).
+        ///
+        /// This constant does not have a counterpart in C#.
+        static constexpr int max_chars = 24;
+
     public: // STATIC
 
         /// Converts the string representation of a number to its double-precision floating-point number equivalent.
+        ///
+        /// Error if the string is null or is not in the format accepted by try_parse(...).
         static double parse(string s);
 
+        /// Converts the string representation of a number to its double-precision
+        /// floating-point number equivalent. A return value indicates whether the
+        /// conversion succeeded.
+        ///
+        /// The format is that of NumberStyles.Float | NumberStyles.AllowThousands
+        /// in the invariant culture, including the symbols Infinity, -Infinity and
+        /// NaN. Values outside the range of double become infinity or zero.
+        /// If the conversion fails, result is not changed.
+        static bool try_parse(std::string_view s, double& result);
+
+        /// Writes the shortest representation of the value that parses back to
+        /// the same value to the buffer, which must have space for max_chars
+        /// characters, and returns the end of the characters.
+        ///
+        /// The format is that of double.ToString() in .NET Core 3.0 and later
+        /// with the invariant culture: fixed notation when the decimal exponent
+        /// is between -4 and 14, otherwise scientific notation such as 1E+15.
+        ///
+        /// This method does not have a counterpart in C#.
+        static char* to_chars(char* buffer, double value);
+
     public: // METHODS
 
         /// Returns a value indicating whether this instance is equal to a specified object.
@@ -51,7 +51,7 @@ namespace dot
     {
         if (obj->get_type()->equals(get_type()))
         {
-            enum_base* en = dynamic_cast<enum_base*>(obj.operator->());
+            borrowed_ptr<enum_base> en(obj);
             return en->value_ == value_;
         }
         return false;
@@ -60,7 +60,7 @@ namespace dot
     object enum_base::parse(type enumType, string value)
     {
         object enum_obj = activator::create_instance(enumType);
-        enum_base* en = dynamic_cast<enum_base*>(enum_obj.operator->());
+        borrowed_ptr<enum_base> en(enum_obj);
         auto valuesMap = en->get_enum_map();
 
         int intValue = 0;
@@ -51,7 +51,7 @@ namespace dot
         /// Returns a value indicating whether this instance is equal to a specified object.
         bool equals(object obj) override
         {
-            if (this == &(*obj)) return true;
+            if (!obj.is_inline() && this == &(*obj)) return true;
 
             if (obj.is<ptr<enum_impl<T>>>())
             {
@@ -0,0 +1,367 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+#include <dot/detail/work_stealing_pool.hpp>
+#include <dot/system/linq/query.hpp>
+
+namespace dot
+{
+    template <class T, class stages_t> class parallel_query;
+    template <class T, class stages_t, class comparer_t> class parallel_ordered_query;
+
+    namespace detail
+    {
+        /// Stages of parallel_query before the first operator.
+        struct identity_stage
+        {
+            template <class Q>
+            Q operator()(Q q) const { return q; }
+        };
+
+        /// Value of a worker padded to a cache line, so that workers
+        /// updating adjacent values do not slow each other down.
+        template <class T>
+        struct alignas(64) worker_local
+        {
+            T value;
+        };
+
+        /// Division of a range of elements into contiguous chunks for
+        /// work_stealing_pool. The chunk size depends only on the number
+        /// of elements and workers, so that chunk boundaries and therefore
+        /// the results of ordered operations do not vary between runs.
+        ///
+        /// The number of workers is read once on construction, and the
+        /// chunks run on at most that many workers even if it changes.
+        class chunk_partition
+        {
+            int count_;
+            int worker_count_;
+            int chunk_size_;
+            int chunk_count_;
+
+        public:
+
+            /// Minimum number of elements per chunk.
+            static constexpr int min_chunk_size = 64;
+
+            /// Maximum number of chunks per worker, which lets the workers that
+            /// finish early take over the chunks of the others.
+            static constexpr int chunks_per_worker = 16;
+
+            explicit chunk_partition(int count) : count_(count), worker_count_(work_stealing_pool::worker_count())
+            {
+                int max_chunk_count = worker_count_ * chunks_per_worker;
+                int chunk_count = std::max(1, std::min(max_chunk_count, (count + min_chunk_size - 1) / min_chunk_size));
+                chunk_size_ = std::max(1, (count + chunk_count - 1) / chunk_count);
+                chunk_count_ = (count + chunk_size_ - 1) / chunk_size_;
+            }
+
+            /// Number of workers that run the chunks, each worker index is less than this.
+            int worker_count() const { return worker_count_; }
+
+            /// Number of chunks, zero if there are no elements.
+            int chunk_count() const { return chunk_count_; }
+
+            /// Index of the first element of the chunk.
+            int begin(int chunk) const { return chunk * chunk_size_; }
+
+            /// Index past the last element of the chunk.
+            int end(int chunk) const { return std::min(count_, (chunk + 1) * chunk_size_); }
+        };
+
+        /// True if the element may be copied by several threads at the same time,
+        /// which is not the case for objects in single_threaded reference counting mode.
+        template <class T>
+        bool is_shareable_element(const T& x)
+        {
+            if constexpr (is_ptr<T>::value)
+            {
+                object_impl* obj = referenced_object(x);
+                return obj == nullptr || obj->get_reference_count_mode() != reference_count_mode::single_threaded;
+            }
+            else
+            {
+                return true;
+            }
+        }
+    }
+
+    /// Query whose operators run in parallel on work_stealing_pool, the
+    /// counterpart of ParallelQuery returned by AsParallel() in C#.
+    ///
+    /// The elements of the list are divided into contiguous chunks. For each
+    /// chunk, the operators are fused into a sequential query over the chunk
+    /// as in query, and each worker accumulates the results of its chunks
+    /// locally before they are combined. The list must not be modified while
+    /// the query runs, and the selectors, predicates and actions are called
+    /// concurrently from several threads.
+    ///
+    /// The workers copy the elements, so objects held by the list must use
+    /// atomic or biased reference counting, and the query throws an exception
+    /// for an element in single_threaded mode, for example one created while
+    /// cycle_collector is enabled. The same applies to objects reached from
+    /// the elements by the selectors and predicates, which are not checked.
+    ///
+    /// Unless as_ordered() is called, the order of the elements produced by
+    /// to_list() and the order in which aggregate(...) and sum() combine the
+    /// results of the workers is unspecified. After as_ordered(), results are
+    /// combined in the order of the chunks, which preserves the order of the
+    /// elements and makes floating point sums identical between runs.
+    template <class T, class stages_t>
+    class parallel_query
+    {
+        template <class R, class S> friend class parallel_query;
+        template <class R, class S, class C> friend class parallel_ordered_query;
+
+        list<T> source_;
+        stages_t stages_;
+        bool ordered_;
+
+    public: // TYPEDEF
+
+        /// Type of the elements produced by the query.
+        typedef typename decltype(std::declval<const stages_t&>()(std::declval<query<detail::span_source<T>>>()))::value_type value_type;
+
+    public: // CONSTRUCTORS
+
+        /// Create query over the list applying the stages to each chunk.
+        parallel_query(list<T> source, stages_t stages, bool ordered)
+            : source_(std::move(source)), stages_(std::move(stages)), ordered_(ordered)
+        {}
+
+    public: // METHODS
+
+        /// Enables treatment of the sequence as if it were ordered.
+        auto as_ordered() const
+        {
+            return parallel_query<T, stages_t>(source_, stages_, true);
+        }
+
+        /// Filters the sequence in parallel based on a predicate.
+        template <class P>
+        auto where(P predicate) const
+        {
+            auto stages = [stages = stages_, predicate = std::move(predicate)](auto q) { return stages(std::move(q)).where(predicate); };
+            return parallel_query<T, decltype(stages)>(source_, std::move(stages), ordered_);
+        }
+
+        /// Projects in parallel each element of the sequence into a new form.
+        template <class S>
+        auto select(S selector) const
+        {
+            auto stages = [stages = stages_, selector = std::move(selector)](auto q) { return stages(std::move(q)).select(selector); };
+            return parallel_query<T, decltype(stages)>(source_, std::move(stages), ordered_);
+        }
+
+        /// Sorts the elements of the sequence in parallel in ascending order according to a key.
+        template <class S>
+        auto order_by(S key_selector) const
+        {
+            typedef detail::key_comparer<detail::identity_comparer, S, false> comparer_t;
+            return parallel_ordered_query<T, stages_t, comparer_t>(*this, comparer_t(detail::identity_comparer(), std::move(key_selector)));
+        }
+
+        /// Sorts the elements of the sequence in parallel in descending order according to a key.
+        template <class S>
+        auto order_by_descending(S key_selector) const
+        {
+            typedef detail::key_comparer<detail::identity_comparer, S, true> comparer_t;
+            return parallel_ordered_query<T, stages_t, comparer_t>(*this, comparer_t(detail::identity_comparer(), std::move(key_selector)));
+        }
+
+        /// Invokes in parallel the specified action for each element,
+        /// in no particular order even after as_ordered().
+        ///
+        /// The counterpart of this method in C# is ForAll.
+        template <class F>
+        void for_each(F action)
+        {
+            detail::chunk_partition partition(source_->count());
+            run(partition, [&action](int, int, auto q)
+            {
+                q.visit([&action](auto&& x) { action(std::forward<decltype(x)>(x)); return true; });
+            });
+        }
+
+        /// Applies in parallel an accumulator function over the sequence.
+        ///
+        /// Each worker, or each chunk after as_ordered(), starts from a copy
+        /// of the seed and accumulates its elements using func, then the
+        /// partial results are combined using combine. The seed must be the
+        /// identity of combine, for example zero for a sum.
+        template <class A, class F, class C>
+        A aggregate(A seed, F func, C combine)
+        {
+            detail::chunk_partition partition(source_->count());
+            int partial_count = ordered_ ? partition.chunk_count() : partition.worker_count();
+            std::vector<detail::worker_local<A>> partials(partial_count, detail::worker_local<A>{ seed });
+            std::vector<char> used(partial_count, false);
+
+            run(partition, [&](int worker, int chunk, auto q)
+            {
+                int index = ordered_ ? chunk : worker;
+                used[index] = true;
+                A& partial = partials[index].value;
+                q.visit([&](auto&& x) { partial = func(std::move(partial), std::forward<decltype(x)>(x)); return true; });
+            });
+
+            bool empty = true;
+            for (int i = 0; i < partial_count; ++i)
+            {
+                if (!used[i]) continue;
+                seed = empty ? std::move(partials[i].value) : combine(std::move(seed), std::move(partials[i].value));
+                empty = false;
+            }
+            return seed;
+        }
+
+        /// Computes in parallel the sum of the sequence, which is zero for an empty sequence.
+        value_type sum()
+        {
+            auto add = [](value_type lhs, const value_type& rhs) { return lhs + rhs; };
+            return aggregate(value_type(), add, add);
+        }
+
+        /// Returns the number of elements in the sequence.
+        int count()
+        {
+            return aggregate(0, [](int result, auto&&) { return result + 1; }, [](int lhs, int rhs) { return lhs + rhs; });
+        }
+
+        /// Creates a list from the sequence, in the order of the source after as_ordered().
+        list<value_type> to_list()
+        {
+            return make_list<value_type>(to_vector());
+        }
+
+    private: // METHODS
+
+        /// Run f(worker, chunk, query) for each chunk in parallel, where query
+        /// is the sequential query over the elements of the chunk.
+        template <class F>
+        void run(const detail::chunk_partition& partition, F&& f)
+        {
+            // Elements are read through a raw pointer to avoid
+            // contention on the reference count of the list
+            const T* data = source_->data();
+            auto chunk_function = [&](int worker, int chunk)
+            {
+                if constexpr (detail::is_ptr<T>::value)
+                {
+                    for (const T* p = data + partition.begin(chunk); p != data + partition.end(chunk); ++p)
+                    {
+                        if (!detail::is_shareable_element(*p))
+                            throw exception("Elements of a parallel query must not use single_threaded reference counting mode.");
+                    }
+                }
+
+                detail::span_source<T> span(data + partition.begin(chunk), data + partition.end(chunk));
+                f(worker, chunk, stages_(query<detail::span_source<T>>(span)));
+            };
+            detail::work_stealing_pool::run(partition.chunk_count(), partition.worker_count(), chunk_function);
+        }
+
+        /// Elements of the sequence, in the order of the source after as_ordered().
+        std::vector<value_type> to_vector()
+        {
+            detail::chunk_partition partition(source_->count());
+            int buffer_count = ordered_ ? partition.chunk_count() : partition.worker_count();
+            std::vector<detail::worker_local<std::vector<value_type>>> buffers(buffer_count);
+
+            run(partition, [&](int worker, int chunk, auto q)
+            {
+                std::vector<value_type>& buffer = buffers[ordered_ ? chunk : worker].value;
+                q.visit([&buffer](auto&& x) { buffer.push_back(std::forward<decltype(x)>(x)); return true; });
+            });
+
+            if (buffer_count == 1) return std::move(buffers[0].value);
+
+            size_t size = 0;
+            for (auto& buffer : buffers) size += buffer.value.size();
+            std::vector<value_type> result;
+            result.reserve(size);
+            for (auto& buffer : buffers)
+                for (value_type& x : buffer.value) result.push_back(std::move(x));
+            return result;
+        }
+    };
+
+    /// Parallel query whose elements are sorted by order_by(...) or
+    /// order_by_descending(...), the counterpart of OrderedParallelQuery in C#.
+    ///
+    /// The elements are sorted when to_list() is called. The keys are extracted
+    /// once per element, then blocks of elements are sorted by a stable sort in
+    /// parallel and merged in parallel pairwise, so that elements with equal keys
+    /// keep the order of the source. Integer, double and local_date keys are
+    /// sorted by radix sort on the calling thread instead.
+    template <class T, class stages_t, class comparer_t>
+    class parallel_ordered_query
+    {
+        typedef parallel_query<T, stages_t> query_type;
+
+        query_type query_;
+        comparer_t comparer_;
+
+    public: // TYPEDEF
+
+        /// Type of the elements produced by the query.
+        typedef typename query_type::value_type value_type;
+
+    public: // CONSTRUCTORS
+
+        /// Create query that sorts the elements of the parallel query using the comparer.
+        parallel_ordered_query(query_type query, comparer_t comparer) : query_(std::move(query)), comparer_(std::move(comparer)) {}
+
+    public: // METHODS
+
+        /// Performs a subsequent ordering of the elements in ascending order according to a key.
+        template <class S>
+        auto then_by(S key_selector) const
+        {
+            typedef detail::key_comparer<comparer_t, S, false> next_t;
+            return parallel_ordered_query<T, stages_t, next_t>(query_, next_t(comparer_, std::move(key_selector)));
+        }
+
+        /// Performs a subsequent ordering of the elements in descending order according to a key.
+        template <class S>
+        auto then_by_descending(S key_selector) const
+        {
+            typedef detail::key_comparer<comparer_t, S, true> next_t;
+            return parallel_ordered_query<T, stages_t, next_t>(query_, next_t(comparer_, std::move(key_selector)));
+        }
+
+        /// Creates a sorted list from the sequence.
+        list<value_type> to_list()
+        {
+            std::vector<value_type> items = query_.as_ordered().to_vector();
+            std::vector<int> order = detail::sort_order(comparer_.make_keys(items), static_cast<int>(items.size()), true);
+
+            detail::apply_sort_order(items, order);
+            return make_list<value_type>(std::move(items));
+        }
+    };
+}
@@ -0,0 +1,862 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+#include <dot/system/ptr.hpp>
+#include <dot/system/exception.hpp>
+#include <dot/system/object_impl.hpp>
+#include <dot/detail/sort.hpp>
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace dot
+{
+    template <class T> class list_impl; template <class T> using list = ptr<list_impl<T>>;
+    template <class T> list<T> make_list();
+    template <class T> list<T> make_list(std::vector<T>&& obj);
+    template <class key_t, class value_t, class hash_t, class equal_t> class dictionary_impl;
+    template <class T, class hash_t, class equal_t> class hash_set_impl;
+    template <class source_t> class query;
+    template <class source_t, class comparer_t> class ordered_query;
+    template <class key_t, class element_t> class grouping_impl;
+    template <class key_t, class element_t> using grouping = ptr<grouping_impl<key_t, element_t>>;
+
+    /// Collection of elements that have a common key, produced by query::group_by(...).
+    ///
+    /// Unlike IGrouping in C#, the grouping is not itself a sequence,
+    /// its elements are accessed as a list using elements().
+    template <class key_t, class element_t>
+    class grouping_impl final : public virtual object_impl
+    {
+        template <class K, class E> friend grouping<K, E> make_grouping(K key, list<E> elements);
+
+        key_t key_;
+        list<element_t> elements_;
+
+    private: // CONSTRUCTORS
+
+        /// Create grouping from key and elements.
+        ///
+        /// This constructor is private. Use make_grouping(...) function instead.
+        grouping_impl(key_t key, list<element_t> elements) : key_(std::move(key)), elements_(std::move(elements)) {}
+
+    public: // PROPERTIES
+
+        /// Gets the key of the grouping.
+        const key_t& key() const { return key_; }
+
+        /// Elements of the grouping in the order of the source sequence.
+        ///
+        /// This method does not have a counterpart in C#.
+        list<element_t> elements() const { return elements_; }
+    };
+
+    /// Create grouping from key and elements.
+    template <class key_t, class element_t>
+    grouping<key_t, element_t> make_grouping(key_t key, list<element_t> elements)
+    {
+        return new grouping_impl<key_t, element_t>(std::move(key), std::move(elements));
+    }
+
+    namespace detail
+    {
+        /// Invoke selector for the element. Pointers to members are applied
+        /// to the referenced object when the element is ptr, so that key
+        /// selectors such as &foo_impl::a can be used for list(foo).
+        template <class F, class X>
+        decltype(auto) invoke_selector(F& selector, X&& x)
+        {
+            if constexpr (std::is_member_pointer<std::decay_t<F>>::value && is_ptr<std::decay_t<X>>::value)
+                return std::invoke(selector, *x);
+            else
+                return std::invoke(selector, std::forward<X>(x));
+        }
+
+        /// Type of the query element for a value of type T returned by a selector,
+        /// specialized for expression types that must not outlive the selector.
+        template <class T>
+        struct query_element { typedef T type; };
+
+        /// Type of the value returned by the selector for the element.
+        template <class F, class X>
+        using selector_result_t = typename query_element<std::decay_t<decltype(invoke_selector(std::declval<F&>(), std::declval<X>()))>>::type;
+
+        /// True if T is query or ordered_query.
+        template <class T>
+        struct is_query : std::false_type {};
+
+        template <class source_t>
+        struct is_query<query<source_t>> : std::true_type {};
+
+        template <class source_t, class comparer_t>
+        struct is_query<ordered_query<source_t, comparer_t>> : std::true_type {};
+
+        /// Sequence of elements returned by the selector of select_many(...),
+        /// dereferenced if the selector returns ptr to a collection.
+        template <class C>
+        decltype(auto) query_range(C& collection)
+        {
+            if constexpr (is_ptr<C>::value) return *collection;
+            else return (collection);
+        }
+
+        /// Sources implement the protocol used by query. Each source defines
+        /// value_type and the method visit(f), which passes the elements to f
+        /// until f returns false, and returns false if and only if f did.
+        /// Sources are composed by value and their lambdas are inlined, so
+        /// a chain of operators runs as a single loop over the collection.
+
+        /// Source of query over all elements of a collection, which keeps
+        /// the collection alive for as long as the query exists.
+        template <class collection_t>
+        class collection_source
+        {
+            ptr<collection_t> collection_;
+
+        public:
+            typedef typename collection_t::value_type value_type;
+
+            explicit collection_source(ptr<collection_t> collection) : collection_(std::move(collection)) {}
+
+            template <class F>
+            bool visit(F&& f)
+            {
+                for (const auto& x : *collection_)
+                    if (!f(x)) return false;
+                return true;
+            }
+        };
+
+        /// Source of query over a contiguous range of elements, which does
+        /// not keep the owner of the elements alive.
+        template <class T>
+        class span_source
+        {
+            const T* begin_;
+            const T* end_;
+
+        public:
+            typedef T value_type;
+
+            span_source(const T* begin, const T* end) : begin_(begin), end_(end) {}
+
+            template <class F>
+            bool visit(F&& f)
+            {
+                for (const T* p = begin_; p != end_; ++p)
+                    if (!f(*p)) return false;
+                return true;
+            }
+        };
+
+        /// Source for query::where(...).
+        template <class source_t, class predicate_t>
+        class where_source
+        {
+            source_t source_;
+            predicate_t predicate_;
+
+        public:
+            typedef typename source_t::value_type value_type;
+
+            where_source(source_t source, predicate_t predicate) : source_(std::move(source)), predicate_(std::move(predicate)) {}
+
+            template <class F>
+            bool visit(F&& f)
+            {
+                return source_.visit([&](auto&& x) { return !invoke_selector(predicate_, x) || f(std::forward<decltype(x)>(x)); });
+            }
+        };
+
+        /// Source for query::select(...).
+        template <class source_t, class selector_t>
+        class select_source
+        {
+            source_t source_;
+            selector_t selector_;
+
+        public:
+            typedef selector_result_t<selector_t, const typename source_t::value_type&> value_type;
+
+            select_source(source_t source, selector_t selector) : source_(std::move(source)), selector_(std::move(selector)) {}
+
+            template <class F>
+            bool visit(F&& f)
+            {
+                if constexpr (std::is_same<value_type, std::decay_t<decltype(invoke_selector(selector_, std::declval<const typename source_t::value_type&>()))>>::value)
+                    return source_.visit([&](auto&& x) { return f(invoke_selector(selector_, std::forward<decltype(x)>(x))); });
+                else
+                    return source_.visit([&](auto&& x) { return f(value_type(invoke_selector(selector_, std::forward<decltype(x)>(x)))); });
+            }
+        };
+
+        /// Source for query::select_many(...).
+        template <class source_t, class selector_t>
+        class select_many_source
+        {
+            typedef selector_result_t<selector_t, const typename source_t::value_type&> collection_type;
+
+            source_t source_;
+            selector_t selector_;
+
+            template <class C, class = void>
+            struct element { typedef std::decay_t<decltype(*std::begin(query_range(std::declval<C&>())))> type; };
+
+            template <class C>
+            struct element<C, std::enable_if_t<is_query<C>::value>> { typedef typename C::value_type type; };
+
+        public:
+            typedef typename element<collection_type>::type value_type;
+
+            select_many_source(source_t source, selector_t selector) : source_(std::move(source)), selector_(std::move(selector)) {}
+
+            template <class F>
+            bool visit(F&& f)
+            {
+                return source_.visit([&](auto&& x)
+                {
+                    auto&& collection = invoke_selector(selector_, std::forward<decltype(x)>(x));
+                    if constexpr (is_query<collection_type>::value)
+                    {
+                        return collection.visit(f);
+                    }
+                    else
+                    {
+                        for (auto&& y : query_range(collection))
+                            if (!f(y)) return false;
+                        return true;
+                    }
+                });
+            }
+        };
+
+        /// Source for query::take(...).
+        template <class source_t>
+        class take_source
+        {
+            source_t source_;
+            int count_;
+
+        public:
+            typedef typename source_t::value_type value_type;
+
+            take_source(source_t source, int count) : source_(std::move(source)), count_(count) {}
+
+            template <class F>
+            bool visit(F&& f)
+            {
+                if (count_ <= 0) return true;
+
+                // Stopping the source after the last element is not reported to the caller
+                int remaining = count_;
+                bool result = true;
+                source_.visit([&](auto&& x)
+                {
+                    result = f(std::forward<decltype(x)>(x));
+                    return result && --remaining > 0;
+                });
+                return result;
+            }
+        };
+
+        /// Source for query::skip(...).
+        template <class source_t>
+        class skip_source
+        {
+            source_t source_;
+            int count_;
+
+        public:
+            typedef typename source_t::value_type value_type;
+
+            skip_source(source_t source, int count) : source_(std::move(source)), count_(count) {}
+
+            template <class F>
+            bool visit(F&& f)
+            {
+                int skipped = 0;
+                return source_.visit([&](auto&& x)
+                {
+                    if (skipped < count_)
+                    {
+                        ++skipped;
+                        return true;
+                    }
+                    return f(std::forward<decltype(x)>(x));
+                });
+            }
+        };
+
+        /// Source for query::distinct(...).
+        template <class source_t, class hash_t, class equal_t>
+        class distinct_source
+        {
+            source_t source_;
+
+        public:
+            typedef typename source_t::value_type value_type;
+
+            explicit distinct_source(source_t source) : source_(std::move(source)) {}
+
+            template <class F>
+            bool visit(F&& f)
+            {
+                std::unordered_set<value_type, hash_t, equal_t> seen;
+                return source_.visit([&](auto&& x) { return !seen.insert(x).second || f(std::forward<decltype(x)>(x)); });
+            }
+        };
+
+        /// Source for query::group_by(...), which reads the entire source
+        /// before producing groups in the order of their first element.
+        template <class source_t, class selector_t>
+        class group_by_source
+        {
+            typedef typename source_t::value_type element_type;
+            typedef selector_result_t<selector_t, const element_type&> key_type;
+
+            source_t source_;
+            selector_t selector_;
+
+        public:
+            typedef grouping<key_type, element_type> value_type;
+
+            group_by_source(source_t source, selector_t selector) : source_(std::move(source)), selector_(std::move(selector)) {}
+
+            template <class F>
+            bool visit(F&& f)
+            {
+                std::vector<value_type> groups;
+                std::unordered_map<key_type, size_t> index;
+                source_.visit([&](auto&& x)
+                {
+                    auto [iter, inserted] = index.try_emplace(invoke_selector(selector_, x), groups.size());
+                    if (inserted) groups.push_back(make_grouping(iter->first, make_list<element_type>()));
+                    groups[iter->second]->elements()->add(x);
+                    return true;
+                });
+
+                for (value_type& group : groups)
+                    if (!f(group)) return false;
+                return true;
+            }
+        };
+
+        /// First comparer of order_by(...), which considers all elements equal.
+        struct identity_comparer
+        {
+            template <class T>
+            empty_sort_keys make_keys(const std::vector<T>&) { return empty_sort_keys(); }
+        };
+
+        /// Comparer of order_by(...) and then_by(...), which compares the keys
+        /// of the elements if they are equal according to the previous comparer.
+        ///
+        /// The selector is called once per element by make_keys(items), which
+        /// returns the keys of all comparers in the order of the elements, so
+        /// that the sort compares the stored keys without calling the selectors.
+        template <class previous_t, class selector_t, bool descending>
+        class key_comparer
+        {
+            previous_t previous_;
+            selector_t selector_;
+
+        public:
+            key_comparer(previous_t previous, selector_t selector) : previous_(std::move(previous)), selector_(std::move(selector)) {}
+
+            template <class T>
+            auto make_keys(const std::vector<T>& items)
+            {
+                typedef selector_result_t<selector_t, const T&> key_type;
+
+                std::vector<key_type> keys;
+                keys.reserve(items.size());
+                for (const T& x : items) keys.emplace_back(invoke_selector(selector_, x));
+                return sort_keys<decltype(previous_.make_keys(items)), key_type, descending>(previous_.make_keys(items), std::move(keys));
+            }
+        };
+
+        /// Source for ordered_query, which reads the entire source before
+        /// producing elements sorted by a stable sort. The positions of the
+        /// elements are sorted rather than the elements, which may not be
+        /// assignable, for example pairs with a const key.
+        template <class source_t, class comparer_t>
+        class ordered_source
+        {
+            template <class S, class C> friend class dot::ordered_query;
+
+            source_t source_;
+            comparer_t comparer_;
+
+        public:
+            typedef typename source_t::value_type value_type;
+
+            ordered_source(source_t source, comparer_t comparer) : source_(std::move(source)), comparer_(std::move(comparer)) {}
+
+            template <class F>
+            bool visit(F&& f)
+            {
+                std::vector<value_type> items;
+                source_.visit([&](auto&& x) { items.push_back(std::forward<decltype(x)>(x)); return true; });
+
+                int count = static_cast<int>(items.size());
+                std::vector<int> order = sort_order(comparer_.make_keys(items), count, count >= parallel_sort_threshold);
+
+                for (int i : order)
+                    if (!f(items[i])) return false;
+                return true;
+            }
+        };
+    }
+
+    /// Lazily evaluated sequence of elements produced by LINQ operators,
+    /// the counterpart of the IEnumerable returned by System.Linq.Enumerable.
+    ///
+    /// Operators such as where(...) and select(...) return a new query and
+    /// do not read the collection. Methods such as to_list() and sum() read
+    /// it in a single pass with all operators fused into one loop, without
+    /// intermediate collections. Selectors and predicates are stored by value
+    /// and called directly, so that they can be inlined. Selectors may be
+    /// lambdas or pointers to members, the latter are applied to the object
+    /// referenced by the element if the element is ptr.
+    ///
+    /// The query holds a reference to the source collection and is evaluated
+    /// again every time a method that reads it is called. Adding or removing
+    /// elements of the collection while the query reads it is not permitted.
+    template <class source_t>
+    class query
+    {
+        template <class S, class C> friend class ordered_query;
+
+    protected: // FIELDS
+
+        source_t source_;
+
+    public: // TYPEDEF
+
+        typedef typename source_t::value_type value_type;
+
+    public: // CONSTRUCTORS
+
+        /// Create query from source.
+        explicit query(source_t source) : source_(std::move(source)) {}
+
+    public: // METHODS
+
+        /// Filters the sequence based on a predicate.
+        template <class P>
+        auto where(P predicate)
+        {
+            return query<detail::where_source<source_t, P>>(detail::where_source<source_t, P>(source_, std::move(predicate)));
+        }
+
+        /// Projects each element of the sequence into a new form.
+        template <class S>
+        auto select(S selector)
+        {
+            return query<detail::select_source<source_t, S>>(detail::select_source<source_t, S>(source_, std::move(selector)));
+        }
+
+        /// Projects each element of the sequence to a collection or query
+        /// and flattens the resulting sequences into one sequence.
+        template <class S>
+        auto select_many(S selector)
+        {
+            return query<detail::select_many_source<source_t, S>>(detail::select_many_source<source_t, S>(source_, std::move(selector)));
+        }
+
+        /// Returns the specified number of elements from the start of the sequence.
+        auto take(int count)
+        {
+            return query<detail::take_source<source_t>>(detail::take_source<source_t>(source_, count));
+        }
+
+        /// Bypasses the specified number of elements and returns the remaining elements.
+        auto skip(int count)
+        {
+            return query<detail::skip_source<source_t>>(detail::skip_source<source_t>(source_, count));
+        }
+
+        /// Returns distinct elements of the sequence in the order of their first
+        /// occurrence, using the specified hash and equality comparers, for example
+        /// string_comparer::ordinal_ignore_case.
+        template <class hash_t = std::hash<value_type>, class equal_t = std::equal_to<value_type>>
+        auto distinct()
+        {
+            return query<detail::distinct_source<source_t, hash_t, equal_t>>(detail::distinct_source<source_t, hash_t, equal_t>(source_));
+        }
+
+        /// Groups the elements of the sequence according to the key selector.
+        template <class S>
+        auto group_by(S key_selector)
+        {
+            return query<detail::group_by_source<source_t, S>>(detail::group_by_source<source_t, S>(source_, std::move(key_selector)));
+        }
+
+        /// Sorts the elements of the sequence in ascending order according to a key.
+        /// The sort is stable, elements with equal keys keep their order.
+        template <class S>
+        auto order_by(S key_selector)
+        {
+            typedef detail::key_comparer<detail::identity_comparer, S, false> comparer_t;
+            return ordered_query<source_t, comparer_t>(source_, comparer_t(detail::identity_comparer(), std::move(key_selector)));
+        }
+
+        /// Sorts the elements of the sequence in descending order according to a key.
+        /// The sort is stable, elements with equal keys keep their order.
+        template <class S>
+        auto order_by_descending(S key_selector)
+        {
+            typedef detail::key_comparer<detail::identity_comparer, S, true> comparer_t;
+            return ordered_query<source_t, comparer_t>(source_, comparer_t(detail::identity_comparer(), std::move(key_selector)));
+        }
+
+        /// Creates a list from the sequence.
+        list<value_type> to_list()
+        {
+            list<value_type> result = make_list<value_type>();
+            visit([&](auto&& x) { result->add(std::forward<decltype(x)>(x)); return true; });
+            return result;
+        }
+
+        /// Creates a dictionary from the sequence according to the key selector.
+        /// Error if the selector produces duplicate keys.
+        ///
+        /// This method is defined in dictionary.hpp, which must be included to use it.
+        template <class K>
+        auto to_dictionary(K key_selector);
+
+        /// Creates a dictionary from the sequence according to the key and value
+        /// selectors. Error if the key selector produces duplicate keys.
+        ///
+        /// This method is defined in dictionary.hpp, which must be included to use it.
+        template <class K, class V>
+        auto to_dictionary(K key_selector, V value_selector);
+
+        /// Creates a hash set from the sequence using the specified hash and equality comparers.
+        ///
+        /// This method is defined in hash_set.hpp, which must be included to use it.
+        template <class hash_t = std::hash<value_type>, class equal_t = std::equal_to<value_type>>
+        auto to_hash_set();
+
+        /// Determines whether the sequence contains any elements.
+        bool any()
+        {
+            return !visit([](auto&&) { return false; });
+        }
+
+        /// Determines whether any element of the sequence satisfies a condition.
+        template <class P>
+        bool any(P predicate)
+        {
+            return !visit([&](auto&& x) { return !detail::invoke_selector(predicate, x); });
+        }
+
+        /// Determines whether all elements of the sequence satisfy a condition.
+        template <class P>
+        bool all(P predicate)
+        {
+            return visit([&](auto&& x) { return static_cast<bool>(detail::invoke_selector(predicate, x)); });
+        }
+
+        /// Returns the number of elements in the sequence.
+        int count()
+        {
+            int result = 0;
+            visit([&](auto&&) { ++result; return true; });
+            return result;
+        }
+
+        /// Returns the number of elements in the sequence that satisfy a condition.
+        template <class P>
+        int count(P predicate)
+        {
+            int result = 0;
+            visit([&](auto&& x) { if (detail::invoke_selector(predicate, x)) ++result; return true; });
+            return result;
+        }
+
+        /// Computes the sum of the sequence, which is zero for an empty sequence.
+        value_type sum()
+        {
+            value_type result = value_type();
+            visit([&](auto&& x) { result += x; return true; });
+            return result;
+        }
+
+        /// Computes the sum of the values obtained by invoking the selector
+        /// on each element of the sequence.
+        template <class S>
+        auto sum(S selector)
+        {
+            detail::selector_result_t<S, const value_type&> result = detail::selector_result_t<S, const value_type&>();
+            visit([&](auto&& x) { result += detail::invoke_selector(selector, x); return true; });
+            return result;
+        }
+
+        /// Returns the minimum value in the sequence. Error if the sequence is empty.
+        value_type min()
+        {
+            return aggregate([](const value_type& lhs, const value_type& rhs) { return rhs < lhs ? rhs : lhs; });
+        }
+
+        /// Returns the minimum of the values obtained by invoking the selector
+        /// on each element of the sequence. Error if the sequence is empty.
+        template <class S>
+        auto min(S selector)
+        {
+            return select(std::move(selector)).min();
+        }
+
+        /// Returns the maximum value in the sequence. Error if the sequence is empty.
+        value_type max()
+        {
+            return aggregate([](const value_type& lhs, const value_type& rhs) { return lhs < rhs ? rhs : lhs; });
+        }
+
+        /// Returns the maximum of the values obtained by invoking the selector
+        /// on each element of the sequence. Error if the sequence is empty.
+        template <class S>
+        auto max(S selector)
+        {
+            return select(std::move(selector)).max();
+        }
+
+        /// Applies an accumulator function over the sequence, using the first
+        /// element as the initial value. Error if the sequence is empty.
+        template <class F>
+        value_type aggregate(F func)
+        {
+            std::optional<value_type> result;
+            visit([&](auto&& x)
+            {
+                if (result) result.emplace(func(*result, std::forward<decltype(x)>(x)));
+                else result.emplace(std::forward<decltype(x)>(x));
+                return true;
+            });
+            if (!result) throw exception("Sequence contains no elements.");
+            return *result;
+        }
+
+        /// Applies an accumulator function over the sequence, using the
+        /// specified seed as the initial value.
+        template <class A, class F>
+        A aggregate(A seed, F func)
+        {
+            visit([&](auto&& x) { seed = func(std::move(seed), std::forward<decltype(x)>(x)); return true; });
+            return seed;
+        }
+
+        /// Returns the first element of the sequence, or a default value
+        /// (null for ptr) if the sequence is empty.
+        value_type first_or_default()
+        {
+            std::optional<value_type> result;
+            visit([&](auto&& x) { result.emplace(std::forward<decltype(x)>(x)); return false; });
+            return result ? *result : value_type();
+        }
+
+        /// Returns the first element of the sequence that satisfies a condition,
+        /// or a default value (null for ptr) if no such element is found.
+        template <class P>
+        value_type first_or_default(P predicate)
+        {
+            return where(std::move(predicate)).first_or_default();
+        }
+
+        /// Passes the elements of the sequence to f until f returns false,
+        /// and returns false if and only if f did.
+        ///
+        /// This method does not have a counterpart in C#.
+        template <class F>
+        bool visit(F&& f)
+        {
+            return source_.visit(std::forward<F>(f));
+        }
+    };
+
+    /// Query whose elements are sorted by order_by(...) or order_by_descending(...),
+    /// the counterpart of IOrderedEnumerable in C#.
+    ///
+    /// Subsequent keys added by then_by(...) are compared when the previous keys
+    /// are equal, and all keys are applied in a single sort when the query is read.
+    /// Each key selector is called once per element. Integer, double and local_date
+    /// keys are sorted by radix sort, and sequences of other keys with at least
+    /// detail::parallel_sort_threshold elements by parallel merge sort, in which
+    /// case the keys are compared concurrently from several threads.
+    template <class source_t, class comparer_t>
+    class ordered_query : public query<detail::ordered_source<source_t, comparer_t>>
+    {
+        typedef query<detail::ordered_source<source_t, comparer_t>> base;
+
+    public: // CONSTRUCTORS
+
+        /// Create query that sorts the elements of the source using the comparer.
+        ordered_query(source_t source, comparer_t comparer)
+            : base(detail::ordered_source<source_t, comparer_t>(std::move(source), std::move(comparer)))
+        {}
+
+    public: // METHODS
+
+        /// Performs a subsequent ordering of the elements in ascending order according to a key.
+        template <class S>
+        auto then_by(S key_selector)
+        {
+            typedef detail::key_comparer<comparer_t, S, false> next_t;
+            return ordered_query<source_t, next_t>(this->source_.source_, next_t(this->source_.comparer_, std::move(key_selector)));
+        }
+
+        /// Performs a subsequent ordering of the elements in descending order according to a key.
+        template <class S>
+        auto then_by_descending(S key_selector)
+        {
+            typedef detail::key_comparer<comparer_t, S, true> next_t;
+            return ordered_query<source_t, next_t>(this->source_.source_, next_t(this->source_.comparer_, std::move(key_selector)));
+        }
+    };
+
+    namespace detail
+    {
+        /// Query operators of a collection, each of which starts a query
+        /// over all elements of the collection. The derived class must be
+        /// a reference type created by a make_... function, or a value type
+        /// that is itself a source such as the views of dictionary, and
+        /// element_t is the type of its elements.
+        template <class derived_t, class element_t>
+        class query_methods
+        {
+        public: // METHODS
+
+            /// Returns a query over all elements of the collection.
+            auto as_enumerable()
+            {
+                if constexpr (std::is_base_of<object_impl, derived_t>::value)
+                    return query<collection_source<derived_t>>(collection_source<derived_t>(ptr<derived_t>(static_cast<derived_t*>(this))));
+                else
+                    return query<derived_t>(*static_cast<derived_t*>(this));
+            }
+
+            /// Filters the elements based on a predicate.
+            template <class P>
+            auto where(P predicate) { return as_enumerable().where(std::move(predicate)); }
+
+            /// Projects each element into a new form.
+            template <class S>
+            auto select(S selector) { return as_enumerable().select(std::move(selector)); }
+
+            /// Projects each element to a collection or query and flattens
+            /// the resulting sequences into one sequence.
+            template <class S>
+            auto select_many(S selector) { return as_enumerable().select_many(std::move(selector)); }
+
+            /// Returns the specified number of elements from the start.
+            auto take(int count) { return as_enumerable().take(count); }
+
+            /// Bypasses the specified number of elements and returns the remaining elements.
+            auto skip(int count) { return as_enumerable().skip(count); }
+
+            /// Returns distinct elements using the specified hash and equality comparers.
+            template <class hash_t = std::hash<element_t>, class equal_t = std::equal_to<element_t>>
+            auto distinct() { return as_enumerable().template distinct<hash_t, equal_t>(); }
+
+            /// Groups the elements according to the key selector.
+            template <class S>
+            auto group_by(S key_selector) { return as_enumerable().group_by(std::move(key_selector)); }
+
+            /// Sorts the elements in ascending order according to a key.
+            template <class S>
+            auto order_by(S key_selector) { return as_enumerable().order_by(std::move(key_selector)); }
+
+            /// Sorts the elements in descending order according to a key.
+            template <class S>
+            auto order_by_descending(S key_selector) { return as_enumerable().order_by_descending(std::move(key_selector)); }
+
+            /// Creates a list from the elements.
+            auto to_list() { return as_enumerable().to_list(); }
+
+            /// Creates a hash set using the specified hash and equality comparers.
+            template <class hash_t = std::hash<element_t>, class equal_t = std::equal_to<element_t>>
+            auto to_hash_set() { return as_enumerable().template to_hash_set<hash_t, equal_t>(); }
+
+            /// Creates a dictionary according to the key selector.
+            template <class K>
+            auto to_dictionary(K key_selector) { return as_enumerable().to_dictionary(std::move(key_selector)); }
+
+            /// Creates a dictionary according to the key and value selectors.
+            template <class K, class V>
+            auto to_dictionary(K key_selector, V value_selector) { return as_enumerable().to_dictionary(std::move(key_selector), std::move(value_selector)); }
+
+            /// Determines whether the collection contains any elements.
+            bool any() { return as_enumerable().any(); }
+
+            /// Determines whether any element satisfies a condition.
+            template <class P>
+            bool any(P predicate) { return as_enumerable().any(std::move(predicate)); }
+
+            /// Determines whether all elements satisfy a condition.
+            template <class P>
+            bool all(P predicate) { return as_enumerable().all(std::move(predicate)); }
+
+            /// Computes the sum of the elements.
+            auto sum() { return as_enumerable().sum(); }
+
+            /// Computes the sum of the values obtained by invoking the selector on each element.
+            template <class S>
+            auto sum(S selector) { return as_enumerable().sum(std::move(selector)); }
+
+            /// Returns the minimum element. Error if the collection is empty.
+            auto min() { return as_enumerable().min(); }
+
+            /// Returns the minimum of the values obtained by invoking the selector on each element.
+            template <class S>
+            auto min(S selector) { return as_enumerable().min(std::move(selector)); }
+
+            /// Returns the maximum element. Error if the collection is empty.
+            auto max() { return as_enumerable().max(); }
+
+            /// Returns the maximum of the values obtained by invoking the selector on each element.
+            template <class S>
+            auto max(S selector) { return as_enumerable().max(std::move(selector)); }
+
+            /// Applies an accumulator function using the first element as the initial value.
+            template <class F>
+            auto aggregate(F func) { return as_enumerable().aggregate(std::move(func)); }
+
+            /// Applies an accumulator function using the specified seed as the initial value.
+            template <class A, class F>
+            A aggregate(A seed, F func) { return as_enumerable().aggregate(std::move(seed), std::move(func)); }
+
+            /// Returns the first element, or a default value if the collection is empty.
+            auto first_or_default() { return as_enumerable().first_or_default(); }
+
+            /// Returns the first element that satisfies a condition, or a default value.
+            template <class P>
+            auto first_or_default(P predicate) { return as_enumerable().first_or_default(std::move(predicate)); }
+        };
+    }
+}
@@ -24,6 +24,9 @@ limitations under the License.
 #include <dot/precompiled.hpp>
 #include <dot/implement.hpp>
 #include <dot/system/long.hpp>
+#include <dot/system/exception.hpp>
+#include <dot/detail/parse_number.hpp>
+#include <charconv>
 #include <dot/system/string.hpp>
 #include <dot/system/type.hpp>
 
@@ -31,11 +34,11 @@ namespace dot
 {
     bool long_impl::equals(object obj)
     {
-        if (this == &(*obj)) return true;
+        if (!obj.is_inline() && this == &(*obj)) return true;
 
         if (obj.is<ptr<long_impl>>())
         {
-            return value_ == obj.as<ptr<long_impl>>()->value_;
+            return value_ == int64_t(obj);
         }
 
         return false;
@@ -48,7 +51,8 @@ namespace dot
 
     string long_impl::to_string()
     {
-        return std::to_string(value_);
+        char buffer[max_chars];
+        return make_string(std::string_view(buffer, to_chars(buffer, value_) - buffer));
     }
 
     type long_impl::typeof()
@@ -63,6 +67,20 @@ namespace dot
 
     int64_t long_impl::parse(string s)
     {
-        return std::stoll(*s);
+        if (s == nullptr) throw exception("String to parse is null.");
+
+        int64_t result;
+        if (!try_parse(*s, result)) throw exception("Input string was not in a correct format or represents a number outside the range of the type.");
+        return result;
+    }
+
+    bool long_impl::try_parse(std::string_view s, int64_t& result)
+    {
+        return detail::try_parse_integer(s, result);
+    }
+
+    char* long_impl::to_chars(char* buffer, int64_t value)
+    {
+        return std::to_chars(buffer, buffer + max_chars, value).ptr;
     }
 }
@@ -44,11 +44,33 @@ namespace dot
         /// Sentinel value representing uninitialized state.
         static constexpr int64_t empty = INT64_MIN;
 
+        /// Maximum number of characters written by to_chars(...).
+        ///
+        /// This constant does not have a counterpart in C#.
+        static constexpr int max_chars = 20;
+
     public: // STATIC
 
         /// Converts the string representation of a number to its 64-bit signed integer equivalent.
+        ///
+        /// Error if the string is null, is not in the format accepted by try_parse(...),
+        /// or represents a number outside the range of the type.
         static int64_t parse(string s);
 
+        /// Converts the string representation of a number to its 64-bit signed integer
+        /// equivalent. A return value indicates whether the conversion succeeded.
+        ///
+        /// The format is that of NumberStyles.Integer in the invariant culture:
+        /// optional leading and trailing white space, an optional leading sign
+        /// and decimal digits. If the conversion fails, result is not changed.
+        static bool try_parse(std::string_view s, int64_t& result);
+
+        /// Writes the decimal representation of the value to the buffer, which must
+        /// have space for max_chars characters, and returns the end of the characters.
+        ///
+        /// This method does not have a counterpart in C#.
+        static char* to_chars(char* buffer, int64_t value);
+
     public: // METHODS
 
         /// Returns a value indicating whether this instance is equal to a specified object.
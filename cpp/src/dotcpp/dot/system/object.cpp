@@ -32,9 +32,209 @@ limitations under the License.
 #include <dot/noda_time/local_time.hpp>
 #include <dot/noda_time/local_date.hpp>
 #include <dot/noda_time/local_date_time.hpp>
+#include <atomic>
+#include <cstring>
 
 namespace dot
 {
+    namespace detail
+    {
+        namespace
+        {
+            /// Type of the value held inline, stored in bits 1 to 3 of the pointer.
+            enum inline_value_tag : std::uint64_t
+            {
+                inline_bool_tag = 0,
+                inline_char_tag = 1,
+                inline_int_tag = 2,
+                inline_long_tag = 3,
+                inline_double_tag = 4
+            };
+
+            /// Values are stored inline only when the pointer has 64 bits.
+            const bool inline_values_enabled = sizeof(std::uintptr_t) >= sizeof(std::uint64_t);
+
+            /// Number of low bits taken by the inline flag and the type tag.
+            const int inline_payload_shift = 4;
+
+            /// Range of signed integers that fit into the 60 bit payload.
+            const std::int64_t inline_long_max = (std::int64_t(1) << 59) - 1;
+            const std::int64_t inline_long_min = -inline_long_max - 1;
+
+            /// Range of double exponents that fit into the 7 bit exponent field of the payload.
+            const std::uint64_t inline_double_min_exponent = 0x3C0;
+            const std::uint64_t inline_double_max_exponent = 0x43E;
+            const std::uint64_t double_mantissa_mask = (std::uint64_t(1) << 52) - 1;
+
+            /// Create inline value from the tag and the payload whose top 4 bits are discarded.
+            object_impl* make_inline_value(inline_value_tag tag, std::uint64_t payload)
+            {
+                std::uint64_t bits = (payload << inline_payload_shift) | (tag << 1) | 1;
+                return reinterpret_cast<object_impl*>(static_cast<std::uintptr_t>(bits));
+            }
+
+            /// Type tag of the inline value.
+            inline_value_tag get_inline_tag(object_impl* p)
+            {
+                return inline_value_tag((reinterpret_cast<std::uintptr_t>(p) >> 1) & 7);
+            }
+
+            /// Payload of the inline value, zero extended.
+            std::uint64_t get_inline_payload(object_impl* p)
+            {
+                return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p)) >> inline_payload_shift;
+            }
+
+            /// Payload of the inline value, sign extended.
+            std::int64_t get_inline_signed_payload(object_impl* p)
+            {
+                return static_cast<std::int64_t>(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p))) >> inline_payload_shift;
+            }
+
+            /// Returns the payload of the inline value, error if it has a different tag.
+            std::uint64_t get_inline_payload(object_impl* p, inline_value_tag tag)
+            {
+                if (get_inline_tag(p) != tag) throw exception("Cast cannot be performed.");
+                return get_inline_payload(p);
+            }
+
+            /// Decode double from the payload created by box_value(double).
+            double decode_inline_double(std::uint64_t payload)
+            {
+                std::uint64_t sign = (payload >> 59) & 1;
+                std::uint64_t field = (payload >> 52) & 0x7F;
+                std::uint64_t exponent = field == 0 ? 0 : field - 1 + inline_double_min_exponent;
+                std::uint64_t bits = (sign << 63) | (exponent << 52) | (payload & double_mantissa_mask);
+                double result;
+                std::memcpy(&result, &bits, sizeof(result));
+                return result;
+            }
+
+            object_impl* box_value(bool value)
+            {
+                if (!inline_values_enabled) return new bool_impl(value);
+                return make_inline_value(inline_bool_tag, value ? 1 : 0);
+            }
+
+            object_impl* box_value(char value)
+            {
+                if (!inline_values_enabled) return new char_impl(value);
+                return make_inline_value(inline_char_tag, static_cast<unsigned char>(value));
+            }
+
+            object_impl* box_value(int value)
+            {
+                if (!inline_values_enabled) return new int_impl(value);
+                return make_inline_value(inline_int_tag, static_cast<std::uint64_t>(static_cast<std::int64_t>(value)));
+            }
+
+            object_impl* box_value(int64_t value)
+            {
+                if (!inline_values_enabled || value < inline_long_min || value > inline_long_max) return new long_impl(value);
+                return make_inline_value(inline_long_tag, static_cast<std::uint64_t>(value));
+            }
+
+            object_impl* box_value(double value)
+            {
+                if (inline_values_enabled)
+                {
+                    std::uint64_t bits;
+                    std::memcpy(&bits, &value, sizeof(bits));
+                    std::uint64_t exponent = (bits >> 52) & 0x7FF;
+                    std::uint64_t mantissa = bits & double_mantissa_mask;
+
+                    // Zero uses field value 0, other representable exponents are shifted to start from 1
+                    std::uint64_t field;
+                    if (exponent == 0 && mantissa == 0) field = 0;
+                    else if (exponent >= inline_double_min_exponent && exponent <= inline_double_max_exponent) field = exponent - inline_double_min_exponent + 1;
+                    else return new double_impl(value);
+
+                    return make_inline_value(inline_double_tag, ((bits >> 63) << 59) | (field << 52) | mantissa);
+                }
+                return new double_impl(value);
+            }
+        }
+
+        /// Returns new heap object with zero reference count holding the inline value.
+        object_impl* box_inline_value(object_impl* p)
+        {
+            switch (get_inline_tag(p))
+            {
+            case inline_bool_tag: return new bool_impl(get_inline_payload(p) != 0);
+            case inline_char_tag: return new char_impl(static_cast<char>(get_inline_payload(p)));
+            case inline_int_tag: return new int_impl(static_cast<int>(get_inline_signed_payload(p)));
+            case inline_long_tag: return new long_impl(get_inline_signed_payload(p));
+            case inline_double_tag: return new double_impl(decode_inline_double(get_inline_payload(p)));
+            default: throw exception("Unknown inline value type.");
+            }
+        }
+
+        /// Returns heap object of the same type as the inline value, used for type checks.
+        object_impl* inline_value_prototype(object_impl* p)
+        {
+            // The prototypes are intentionally never deleted so they remain valid during static destruction
+            static object_impl* const prototypes[] =
+            {
+                new bool_impl(false),
+                new char_impl(0),
+                new int_impl(0),
+                new long_impl(0),
+                new double_impl(0.0)
+            };
+
+            inline_value_tag tag = get_inline_tag(p);
+            if (tag > inline_double_tag) throw exception("Unknown inline value type.");
+            return prototypes[tag];
+        }
+
+        /// Returns the hash code of the inline value without creating a heap copy.
+        size_t inline_value_hash_code(object_impl* p)
+        {
+            switch (get_inline_tag(p))
+            {
+            case inline_bool_tag: return std::hash<bool>()(get_inline_payload(p) != 0);
+            case inline_char_tag: return std::hash<char>()(static_cast<char>(get_inline_payload(p)));
+            case inline_int_tag: return std::hash<int>()(static_cast<int>(get_inline_signed_payload(p)));
+            case inline_long_tag: return std::hash<int64_t>()(get_inline_signed_payload(p));
+            case inline_double_tag: return std::hash<double>()(decode_inline_double(get_inline_payload(p)));
+            default: throw exception("Unknown inline value type.");
+            }
+        }
+
+        /// Returns true if the inline value is equal to the other object without creating a heap copy.
+        bool inline_value_equals(object_impl* p, object_impl* other)
+        {
+            if (other == nullptr) return false;
+            if (p == other) return true;
+
+            // Heap object compares itself to the inline value, which it unboxes without a heap copy
+            if (!is_inline_value(other)) return other->equals(object(ptr<object_impl>(p)));
+
+            // Other inline values are equal only to an identical payload, except positive and negative zero
+            if (get_inline_tag(p) != get_inline_tag(other)) return false;
+            if (get_inline_tag(p) != inline_double_tag) return false;
+            return decode_inline_double(get_inline_payload(p)) == decode_inline_double(get_inline_payload(other));
+        }
+
+        /// Replaces the inline value at the address by a heap object holding the value.
+        object_impl* materialize_inline_value(object_impl** slot)
+        {
+            static_assert(sizeof(std::atomic<object_impl*>) == sizeof(object_impl*) && std::atomic<object_impl*>::is_always_lock_free,
+                "Pointer must be replaceable by an atomic operation.");
+            std::atomic<object_impl*>& target = *reinterpret_cast<std::atomic<object_impl*>*>(slot);
+
+            object_impl* p = target.load(std::memory_order_acquire);
+            if (!is_inline_value(p)) return p;
+
+            object_impl* boxed = box_inline_value(p);
+            boxed->increment_reference_count();
+            if (target.compare_exchange_strong(p, boxed, std::memory_order_acq_rel)) return boxed;
+
+            // Another thread has replaced the inline value first, use its heap object
+            boxed->decrement_reference_count();
+            return p;
+        }
+    }
 
     /// Construct object from nullptr.
     object::object(nullptr_t) : base(nullptr) {}
@@ -42,29 +242,35 @@ namespace dot
     /// Construct object from ptr(object_impl).
     object::object(const ptr<object_impl>& p) : base(p) {}
 
+    /// Construct object from ptr(object_impl) using move semantics.
+    object::object(ptr<object_impl>&& p) : base(std::move(p)) {}
+
     /// Construct object from object_impl pointer.
     object::object(object_impl* value) : base(value) {}
 
     /// Construct object from string.
     object::object(const string& value) : base(value) {}
 
+    /// Construct object from string using move semantics.
+    object::object(string&& value) : base(std::move(value)) {}
+
     /// Construct object from const string.
     object::object(const char* value) : base(string(value)) {}
 
     /// Construct object from bool by boxing.
-    object::object(bool value) : base(new bool_impl(value)) {}
+    object::object(bool value) : base(detail::box_value(value)) {}
 
     /// Construct object from double by boxing.
-    object::object(double value) : base(new double_impl(value)) {}
+    object::object(double value) : base(detail::box_value(value)) {}
 
     /// Construct object from int by boxing.
-    object::object(int value) : base(new int_impl(value)) {}
+    object::object(int value) : base(detail::box_value(value)) {}
 
     /// Construct object from int by boxing.
-    object::object(int64_t value) : base(new long_impl(value)) {}
+    object::object(int64_t value) : base(detail::box_value(value)) {}
 
     /// Construct object from char by boxing.
-    object::object(char value) : base(new char_impl(value)) {}
+    object::object(char value) : base(detail::box_value(value)) {}
 
     /// Construct object from local_minute by boxing.
     object::object(const local_minute & value) : base(new struct_wrapper_impl<local_minute>(value)) {}
@@ -90,26 +296,32 @@ namespace dot
     /// Assign ptr(T) to object.
     object& object::operator=(const ptr<object_impl>& p) { base::operator=(p); return *this; }
 
+    /// Assign ptr(T) to object using move semantics.
+    object& object::operator=(ptr<object_impl>&& p) { base::operator=(std::move(p)); return *this; }
+
     /// Assign string to object by boxing.
     object& object::operator=(const string& value) { base::operator=(value); return *this; }
 
+    /// Assign string to object using move semantics.
+    object& object::operator=(string&& value) { base::operator=(std::move(value)); return *this; }
+
     /// Assign const string to object by boxing.
     object& object::operator=(const char* value) { base::operator=(string(value)); return *this; }
 
     /// Assign bool to object by boxing.
-    object& object::operator=(bool value) { base::operator=(new bool_impl(value)); return *this; }
+    object& object::operator=(bool value) { base::operator=(detail::box_value(value)); return *this; }
 
     /// Assign double to object by boxing.
-    object& object::operator=(double value) { base::operator=(new double_impl(value)); return *this; }
+    object& object::operator=(double value) { base::operator=(detail::box_value(value)); return *this; }
 
     /// Assign int to object by boxing.
-    object& object::operator=(int value) { base::operator=(new int_impl(value)); return *this; }
+    object& object::operator=(int value) { base::operator=(detail::box_value(value)); return *this; }
 
     /// Assign int to object by boxing.
-    object& object::operator=(int64_t value) { base::operator=(new long_impl(value)); return *this; }
+    object& object::operator=(int64_t value) { base::operator=(detail::box_value(value)); return *this; }
 
     /// Assign int to object by boxing.
-    object& object::operator=(char value) { base::operator=(new char_impl(value)); return *this; }
+    object& object::operator=(char value) { base::operator=(detail::box_value(value)); return *this; }
 
     /// Assign local_minute to object by boxing.
     object& object::operator=(const local_minute& value) { base::operator=(new struct_wrapper_impl<local_minute>(value)); return *this; }
@@ -124,37 +336,67 @@ namespace dot
     object& object::operator=(const local_date_time& value) { base::operator=(new struct_wrapper_impl<local_date_time>(value)); return *this; }
 
     /// Convert object to bool by unboxing. Error if object does is not a boxed double.
-    object::operator bool() const { return ptr<bool_impl>(*this)->value_; }
+    object::operator bool() const
+    {
+        if (is_inline()) return detail::get_inline_payload(ptr_, detail::inline_bool_tag) != 0;
+        return borrowed_ptr<bool_impl>(*this)->value_;
+    }
 
     /// Convert object to double by unboxing. Error if object does is not a boxed double.
-    object::operator double() const { return ptr<double_impl>(*this)->value_; }
+    object::operator double() const
+    {
+        if (is_inline()) return detail::decode_inline_double(detail::get_inline_payload(ptr_, detail::inline_double_tag));
+        return borrowed_ptr<double_impl>(*this)->value_;
+    }
 
     /// Convert object to int by unboxing. Error if object does is not a boxed int.
-    object::operator int() const { return ptr<int_impl>(*this)->value_; }
+    object::operator int() const
+    {
+        if (is_inline())
+        {
+            detail::get_inline_payload(ptr_, detail::inline_int_tag);
+            return static_cast<int>(detail::get_inline_signed_payload(ptr_));
+        }
+        return borrowed_ptr<int_impl>(*this)->value_;
+    }
 
     /// Convert object to long by unboxing. Error if object does is not a boxed long.
-    object::operator int64_t() const { return ptr<long_impl>(*this)->value_; }
+    object::operator int64_t() const
+    {
+        if (is_inline())
+        {
+            detail::get_inline_payload(ptr_, detail::inline_long_tag);
+            return detail::get_inline_signed_payload(ptr_);
+        }
+        return borrowed_ptr<long_impl>(*this)->value_;
+    }
 
     /// Convert object to long by unboxing. Error if object does is not a boxed long.
-    object::operator char() const { return ptr<char_impl>(*this)->value_; }
+    object::operator char() const
+    {
+        if (is_inline()) return static_cast<char>(detail::get_inline_payload(ptr_, detail::inline_char_tag));
+        return borrowed_ptr<char_impl>(*this)->value_;
+    }
 
     /// Convert object to local_minute by unboxing. Error if object does is not a boxed local_minute.
-    object::operator local_minute() const { return *ptr<struct_wrapper_impl<local_minute>>(*this); }
+    object::operator local_minute() const { return *borrowed_ptr<struct_wrapper_impl<local_minute>>(*this); }
 
     /// Convert object to local_time by unboxing. Error if object does is not a boxed local_time.
-    object::operator local_time() const { return *ptr<struct_wrapper_impl<local_time>>(*this); }
+    object::operator local_time() const { return *borrowed_ptr<struct_wrapper_impl<local_time>>(*this); }
 
     /// Convert object to local_date by unboxing. Error if object does is not a boxed local_date.
-    object::operator local_date() const { return *ptr<struct_wrapper_impl<local_date>>(*this); }
+    object::operator local_date() const { return *borrowed_ptr<struct_wrapper_impl<local_date>>(*this); }
 
     /// Convert object to local_date_time by unboxing. Error if object does is not a boxed local_date_time.
-    object::operator local_date_time() const { return *ptr<struct_wrapper_impl<local_date_time>>(*this); }
+    object::operator local_date_time() const { return *borrowed_ptr<struct_wrapper_impl<local_date_time>>(*this); }
 
     /// Convert object to string by unboxing. Error if object does is not a boxed string.
-    object::operator string() const { return *ptr<string_impl>(*this); }
+    object::operator string() const { return borrowed_ptr<string_impl>(*this).operator->(); }
 
     bool object::ReferenceEquals(object objA, object objB)
     {
-        return &(*objA) == &(*objB);
+        // Inline values have no identity, and like values boxed separately in C# are never the same instance
+        if (objA.is_inline() || objB.is_inline()) return false;
+        return static_cast<const ptr<object_impl>&>(objA) == static_cast<const ptr<object_impl>&>(objB);
     }
 }
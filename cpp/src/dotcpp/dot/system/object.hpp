@@ -25,6 +25,7 @@ limitations under the License.
 
 #include <dot/declare.hpp>
 #include <dot/system/ptr.hpp>
+#include <dot/system/borrowed_ptr.hpp>
 #include <dot/system/object_impl.hpp>
 #include <dot/system/exception.hpp>
 #include <dot/system/string.hpp>
@@ -44,12 +45,26 @@ namespace dot
 
     namespace detail
     {
-        template<class W, class T> class inherit_to_string;
-        template<class W, class T> class inherit_get_hashcode;
-        template<class W, class T> class inherit_equals;
+        template<class T> struct has_to_string;
+        template<class T> struct has_get_hashcode;
+        template<class T> struct has_equals;
     }
 
     /// Adds support for boxing value types to ptr(object_impl).
+    ///
+    /// Values of type bool, char, int, int64_t and double are stored inline
+    /// in the pointer rather than in a heap object whenever they fit into
+    /// 60 bits (all bool, char and int values, int64_t values below 2^59 in
+    /// magnitude, and double values that are zero or have magnitude between
+    /// 2^-63 and 2^64). Unboxing, hashing and comparing an inline value does
+    /// not access the heap. The first dereference using operator-> or
+    /// operator* replaces the inline value by a heap object holding it,
+    /// which the object then references like any other boxed value, and
+    /// a cast to the type of the heap object, e.g. ptr(int_impl), creates
+    /// a heap object for the result of the cast.
+    ///
+    /// Inline values have no identity, so ReferenceEquals returns false
+    /// for them, as it does for values boxed separately in C#.
     class DOT_CLASS object : public ptr<object_impl>
     {
         typedef ptr<object_impl> base;
@@ -68,16 +83,30 @@ namespace dot
         /// Construct object from ptr(object_impl).
         object(const ptr<object_impl>& p);
 
+        /// Construct object from ptr(object_impl) using move semantics.
+        object(ptr<object_impl>&& p);
+
         /// Construct object from ptr(T).
         template <class T>
         object(const ptr<T>& p) : base(p) {}
 
+        /// Construct object from ptr(T) using move semantics.
+        template <class T>
+        object(ptr<T>&& p) : base(std::move(p)) {}
+
         /// Construct object from object_impl pointer.
         object(object_impl* value);
 
         /// Construct object from string.
         object(const string& value);
 
+        /// Construct object from string using move semantics.
+        object(string&& value);
+
+        /// Construct object from the string created by concatenation.
+        template <class L, class R>
+        object(const string_concat<L, R>&& value) : object(std::move(value).to_string()) {}
+
         /// Construct object from const string.
         object(const char* value);
 
@@ -118,7 +147,7 @@ namespace dot
 
         /// Construct object from struct wrapper, boxing the value if necessary.
         template <typename T>
-        object(struct_wrapper<T> value) : base(value) {}
+        object(struct_wrapper<T> value) : base(std::move(value)) {}
 
         /// Construct object from tuple, boxing the value if necessary.
         template <typename ... T>
@@ -126,12 +155,18 @@ namespace dot
 
     public: // METHODS
 
+        /// Returns true if the value is stored inline rather than in a heap object,
+        /// which is false after the first dereference.
+        ///
+        /// This method does not have a counterpart in C#.
+        bool is_inline() const { return detail::is_inline_value(ptr_); }
+
         /// Convert object to enum. Error if object does is not a boxed T.
         ///
         /// This method does not have a counterpart in C#. It provides a more
         /// convenient alternative to unboxing than using cast to enum_impl(T).
         template <class T>
-        T to_enum(typename std::enable_if<std::is_enum<T>::value>::type* enableif = 0) const { return ptr<enum_impl<T>>(*this)->value(); }
+        T to_enum(typename std::enable_if<std::is_enum<T>::value>::type* enableif = 0) const { return borrowed_ptr<enum_impl<T>>(*this)->value(); }
 
     public: // OPERATORS
 
@@ -147,9 +182,15 @@ namespace dot
         /// Assign ptr(T) to object.
         object& operator=(const ptr<object_impl>& p);
 
+        /// Assign ptr(T) to object using move semantics.
+        object& operator=(ptr<object_impl>&& p);
+
         /// Assign string to object by boxing.
         object& operator=(const string& value);
 
+        /// Assign string to object using move semantics.
+        object& operator=(string&& value);
+
         /// Assign const string to object by boxing.
         object& operator=(const char* value);
 
@@ -228,7 +269,7 @@ namespace dot
         operator std::tuple<T...>() const { return *this->as<struct_wrapper<std::tuple<T...>>>(); } // TODO - replace as by cast_to?
 
         template <class T, class enabled = typename std::enable_if<std::is_enum<T>::value>::type* >
-        operator T() const { return ptr<enum_impl<T>>(*this)->value(); }
+        operator T() const { return borrowed_ptr<enum_impl<T>>(*this)->value(); }
 
         /// Convert object to string by unboxing. Error if object does is not a boxed string.
         operator string() const;
@@ -251,13 +292,13 @@ namespace dot
 namespace dot
 {
     /// Wraps struct into object.
+    ///
+    /// Methods to_string, hash_code and equals of the struct, if present,
+    /// override the corresponding methods of object_impl.
     template <class T>
     class struct_wrapper_impl
         : public virtual object_impl
         , public T
-        , public detail::inherit_to_string<struct_wrapper_impl<T>, T>
-        , public detail::inherit_get_hashcode<struct_wrapper_impl<T>, T>
-        , public detail::inherit_equals<struct_wrapper_impl<T>, T>
     {
     public:
         struct_wrapper_impl(const T& value) : T(value) {}
@@ -273,11 +314,23 @@ namespace dot
             return typeof();
         }
 
-        virtual string to_string() override { return detail::inherit_to_string<struct_wrapper_impl<T>, T>::to_string(); }
+        virtual string to_string() override
+        {
+            if constexpr (detail::has_to_string<T>::value) return T::to_string();
+            else return object_impl::to_string();
+        }
 
-        virtual size_t hash_code() override { return detail::inherit_get_hashcode<struct_wrapper_impl<T>, T>::hash_code(); }
+        virtual size_t hash_code() override
+        {
+            if constexpr (detail::has_get_hashcode<T>::value) return T::hash_code();
+            else return object_impl::hash_code();
+        }
 
-        bool equals(object obj) override { return detail::inherit_equals<struct_wrapper_impl<T>, T>::equals(obj); }
+        bool equals(object obj) override
+        {
+            if constexpr (detail::has_equals<T>::value) return T::equals(obj);
+            else return object_impl::equals(obj);
+        }
     };
 }
 
@@ -36,7 +36,7 @@ namespace dot
     /// can override this method to compare by value.
     bool object_impl::equals(object obj)
     {
-        return this == &(*obj);
+        return !obj.is_inline() && this == &(*obj);
     }
 
     /// Serves as the default hash function.
@@ -34,6 +34,12 @@ namespace dot
 
     /// All classes with reference semantics should derive from this type.
     /// It works with ptr to provide an emulation of reference semantics in C++.
+    ///
+    /// Classes that may be combined with interfaces derive from this type
+    /// virtually. Final classes with a single base, such as the boxed value
+    /// types and string_impl, derive from it non-virtually so that they do
+    /// not need a second virtual table pointer, keeping the header of small
+    /// objects to the virtual table pointer and the reference count word.
     class DOT_CLASS object_impl : public reference_counter
     {
         template<typename T>
@@ -71,4 +77,24 @@ namespace dot
         /// to string.
         virtual string to_string();
     };
+
+    /// Derive from this type in addition to object_impl to use the specified
+    /// reference counting mode for all instances of the derived type,
+    /// regardless of reference_counter::default_reference_count_mode().
+    ///
+    /// Example:
+    ///
+    /// class sample_impl : public virtual object_impl,
+    ///     public reference_count_policy<reference_count_mode::single_threaded>
+    template <reference_count_mode mode>
+    class reference_count_policy : public virtual object_impl
+    {
+    protected: // CONSTRUCTORS
+
+        /// Sets the reference counting mode before the object is assigned to ptr.
+        reference_count_policy()
+        {
+            this->set_reference_count_mode(mode);
+        }
+    };
 }
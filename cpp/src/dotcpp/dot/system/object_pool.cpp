@@ -0,0 +1,295 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/precompiled.hpp>
+#include <dot/implement.hpp>
+#include <dot/system/object_pool.hpp>
+#include <cstddef>
+#include <mutex>
+
+namespace dot
+{
+    namespace detail
+    {
+        namespace
+        {
+            /// Difference between consecutive size classes, also the alignment of each block.
+            const size_t object_pool_granularity = alignof(std::max_align_t);
+
+            /// Larger allocations are made from the global heap.
+            const size_t object_pool_max_size = 512;
+
+            /// Number of size classes.
+            const size_t object_pool_class_count = object_pool_max_size / object_pool_granularity;
+
+            /// Number of bytes reserved from the global heap when a free list is empty.
+            const size_t object_pool_reserve_size = 16 * 1024;
+
+            /// Alignment of object_pool_cache, the size class is stored in the low bits of the tag.
+            const size_t object_pool_cache_alignment = 64;
+
+            static_assert(object_pool_class_count <= object_pool_cache_alignment, "Size class does not fit into the tag.");
+        }
+
+        /// Free block of the pool, linked through its first bytes.
+        struct object_pool_block
+        {
+            object_pool_block* next_;
+        };
+
+        /// Free lists and counters of a thread.
+        ///
+        /// Counters are updated only by the thread that uses the cache, without
+        /// atomic read-modify-write operations, and read by object_pool::get_stats().
+        class alignas(object_pool_cache_alignment) object_pool_cache
+        {
+        public: // FIELDS
+
+            /// Free lists of the thread, one per size class.
+            object_pool_block* free_[object_pool_class_count];
+
+            /// Blocks released by other threads, one list per size class.
+            std::atomic<object_pool_block*> remote_free_[object_pool_class_count];
+
+            /// Counters reported by object_pool::get_stats().
+            std::atomic<size_t> allocation_count_ = 0;
+            std::atomic<size_t> hit_count_ = 0;
+            std::atomic<size_t> heap_allocation_count_ = 0;
+            std::atomic<size_t> remote_release_count_ = 0;
+            std::atomic<size_t> reserved_bytes_ = 0;
+
+            /// Blocks of this cache released by threads that have no cache, counted
+            /// as remote releases. Updated by those threads with atomic addition.
+            std::atomic<size_t> detached_release_count_ = 0;
+
+            /// Values of the counters at the last object_pool::reset_stats(), subtracted
+            /// by object_pool::get_stats(). The counters themselves are never reset by
+            /// other threads, whose stores could be overwritten by the owner thread.
+            /// Accessed only under the mutex of object_pool_registry.
+            size_t allocation_count_base_ = 0;
+            size_t hit_count_base_ = 0;
+            size_t heap_allocation_count_base_ = 0;
+            size_t remote_release_count_base_ = 0;
+            size_t detached_release_count_base_ = 0;
+
+            /// Next cache in the list of all caches.
+            object_pool_cache* next_ = nullptr;
+
+            /// Next cache in the list of caches available for reuse.
+            object_pool_cache* next_free_ = nullptr;
+
+        public: // CONSTRUCTORS
+
+            object_pool_cache()
+            {
+                for (size_t i = 0; i < object_pool_class_count; ++i)
+                {
+                    free_[i] = nullptr;
+                    remote_free_[i].store(nullptr, std::memory_order_relaxed);
+                }
+            }
+
+        public: // METHODS
+
+            /// Increment counter updated only by the current thread.
+            static void increment(std::atomic<size_t>& counter, size_t value = 1)
+            {
+                counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+            }
+
+            /// Refill empty free list for the size class, first from the blocks
+            /// released by other threads, then from a new block of memory.
+            void refill(size_t index)
+            {
+                free_[index] = remote_free_[index].exchange(nullptr, std::memory_order_acquire);
+                if (free_[index] != nullptr) return;
+
+                size_t block_size = (index + 1) * object_pool_granularity;
+                size_t block_count = object_pool_reserve_size / block_size;
+                char* memory = static_cast<char*>(::operator new(block_count * block_size));
+                increment(reserved_bytes_, block_count * block_size);
+
+                object_pool_block* first = nullptr;
+                for (size_t i = block_count; i-- > 0;)
+                {
+                    object_pool_block* block = reinterpret_cast<object_pool_block*>(memory + i * block_size);
+                    block->next_ = first;
+                    first = block;
+                }
+                free_[index] = first;
+            }
+        };
+
+        namespace
+        {
+            /// List of all caches and of caches available for reuse.
+            struct object_pool_registry
+            {
+                std::mutex mutex_;
+                object_pool_cache* first_ = nullptr;
+                object_pool_cache* first_free_ = nullptr;
+            };
+
+            /// Registry is never deleted so that it remains available
+            /// to threads exiting during static destruction.
+            object_pool_registry& get_object_pool_registry()
+            {
+                static object_pool_registry* registry = new object_pool_registry();
+                return *registry;
+            }
+
+            /// Cache of the current thread, or nullptr if not attached yet.
+            thread_local object_pool_cache* current_object_pool_cache_ = nullptr;
+
+            /// Set when the current thread has returned its cache for reuse,
+            /// allocations after this point are made from the global heap.
+            thread_local bool object_pool_cache_detached_ = false;
+
+            /// Returns the cache of the current thread to the registry on thread exit.
+            struct object_pool_cache_guard
+            {
+                ~object_pool_cache_guard()
+                {
+                    object_pool_cache_detached_ = true;
+                    object_pool_cache* cache = current_object_pool_cache_;
+                    current_object_pool_cache_ = nullptr;
+                    if (cache == nullptr) return;
+
+                    object_pool_registry& registry = get_object_pool_registry();
+                    std::lock_guard<std::mutex> lock(registry.mutex_);
+                    cache->next_free_ = registry.first_free_;
+                    registry.first_free_ = cache;
+                }
+            };
+
+            /// Cache of the current thread, attaching one if necessary.
+            /// Returns nullptr if the thread is exiting.
+            object_pool_cache* attach_object_pool_cache()
+            {
+                if (object_pool_cache_detached_) return nullptr;
+
+                static thread_local object_pool_cache_guard guard;
+
+                object_pool_registry& registry = get_object_pool_registry();
+                std::lock_guard<std::mutex> lock(registry.mutex_);
+                object_pool_cache* cache = registry.first_free_;
+                if (cache != nullptr)
+                {
+                    registry.first_free_ = cache->next_free_;
+                }
+                else
+                {
+                    cache = new object_pool_cache();
+                    cache->next_ = registry.first_;
+                    registry.first_ = cache;
+                }
+
+                current_object_pool_cache_ = cache;
+                return cache;
+            }
+        }
+    }
+
+    object_pool_stats object_pool::get_stats()
+    {
+        object_pool_stats result;
+        detail::object_pool_registry& registry = detail::get_object_pool_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex_);
+        for (detail::object_pool_cache* cache = registry.first_; cache != nullptr; cache = cache->next_)
+        {
+            result.allocation_count += cache->allocation_count_.load(std::memory_order_relaxed) - cache->allocation_count_base_;
+            result.hit_count += cache->hit_count_.load(std::memory_order_relaxed) - cache->hit_count_base_;
+            result.heap_allocation_count += cache->heap_allocation_count_.load(std::memory_order_relaxed) - cache->heap_allocation_count_base_;
+            result.remote_release_count += cache->remote_release_count_.load(std::memory_order_relaxed) - cache->remote_release_count_base_;
+            result.remote_release_count += cache->detached_release_count_.load(std::memory_order_relaxed) - cache->detached_release_count_base_;
+            result.reserved_bytes += cache->reserved_bytes_.load(std::memory_order_relaxed);
+        }
+        result.miss_count = result.allocation_count - result.hit_count;
+        return result;
+    }
+
+    void object_pool::reset_stats()
+    {
+        detail::object_pool_registry& registry = detail::get_object_pool_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex_);
+        for (detail::object_pool_cache* cache = registry.first_; cache != nullptr; cache = cache->next_)
+        {
+            cache->allocation_count_base_ = cache->allocation_count_.load(std::memory_order_relaxed);
+            cache->hit_count_base_ = cache->hit_count_.load(std::memory_order_relaxed);
+            cache->heap_allocation_count_base_ = cache->heap_allocation_count_.load(std::memory_order_relaxed);
+            cache->remote_release_count_base_ = cache->remote_release_count_.load(std::memory_order_relaxed);
+            cache->detached_release_count_base_ = cache->detached_release_count_.load(std::memory_order_relaxed);
+        }
+    }
+
+    void* object_pool::allocate(size_t size, std::uintptr_t& tag)
+    {
+        detail::object_pool_cache* cache = detail::current_object_pool_cache_;
+        if (cache == nullptr)
+        {
+            cache = detail::attach_object_pool_cache();
+            if (cache == nullptr) return nullptr;
+        }
+
+        if (size > detail::object_pool_max_size)
+        {
+            detail::object_pool_cache::increment(cache->heap_allocation_count_);
+            return nullptr;
+        }
+
+        size_t index = (size - 1) / detail::object_pool_granularity;
+        detail::object_pool_cache::increment(cache->allocation_count_);
+
+        if (cache->free_[index] != nullptr) detail::object_pool_cache::increment(cache->hit_count_);
+        else cache->refill(index);
+
+        detail::object_pool_block* block = cache->free_[index];
+        cache->free_[index] = block->next_;
+        tag = reinterpret_cast<std::uintptr_t>(cache) | index;
+        return block;
+    }
+
+    void object_pool::release(void* p, std::uintptr_t tag)
+    {
+        detail::object_pool_cache* owner = reinterpret_cast<detail::object_pool_cache*>(tag & ~std::uintptr_t(detail::object_pool_cache_alignment - 1));
+        size_t index = tag & (detail::object_pool_cache_alignment - 1);
+        detail::object_pool_block* block = static_cast<detail::object_pool_block*>(p);
+
+        detail::object_pool_cache* cache = detail::current_object_pool_cache_;
+        if (owner == cache)
+        {
+            block->next_ = cache->free_[index];
+            cache->free_[index] = block;
+            return;
+        }
+
+        // Return to the owner, which collects the blocks when its own free list is empty
+        block->next_ = owner->remote_free_[index].load(std::memory_order_relaxed);
+        while (!owner->remote_free_[index].compare_exchange_weak(block->next_, block, std::memory_order_release, std::memory_order_relaxed));
+
+        // A thread that has no cache counts the release on the owner rather than
+        // attaching a cache under the registry mutex only to hold the counter
+        if (cache != nullptr) detail::object_pool_cache::increment(cache->remote_release_count_);
+        else owner->detached_release_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,102 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+#include <cstdint>
+
+namespace dot
+{
+    class reference_counter;
+
+    /// Counters of object_pool, summed over all threads.
+    struct DOT_CLASS object_pool_stats
+    {
+        /// Number of allocations requested from the pool, excluding
+        /// allocations too large for the pool.
+        size_t allocation_count = 0;
+
+        /// Number of allocations served from the free list of the current thread.
+        size_t hit_count = 0;
+
+        /// Number of allocations that required draining memory released
+        /// by other threads or reserving a new block of memory.
+        size_t miss_count = 0;
+
+        /// Number of allocations too large for the pool, made from the global heap.
+        size_t heap_allocation_count = 0;
+
+        /// Number of releases by a thread other than the one that allocated the memory.
+        size_t remote_release_count = 0;
+
+        /// Number of bytes reserved by the pool from the global heap.
+        size_t reserved_bytes = 0;
+
+        /// Fraction of pool allocations served from the free list of the current thread.
+        double hit_rate() const { return allocation_count ? double(hit_count) / allocation_count : 0.0; }
+    };
+
+    /// Thread local size class pools used to allocate objects derived
+    /// from reference_counter outside of arena_scope.
+    ///
+    /// Each thread allocates from its own free lists without locking.
+    /// Memory released by another thread is returned to the free lists
+    /// of the allocating thread, which collects it the next time its own
+    /// free list for the same size class is empty. Free lists of a thread
+    /// that has exited are reused by the next thread. Memory reserved by
+    /// the pool is never returned to the global heap.
+    class DOT_CLASS object_pool final
+    {
+        friend class reference_counter;
+
+    private: // CONSTRUCTORS
+
+        object_pool() = delete;
+        object_pool(const object_pool&) = delete;
+        object_pool& operator=(const object_pool&) = delete;
+
+    public: // STATIC
+
+        /// Counters of the pool summed over all threads. Counters of threads
+        /// other than the current one may be slightly out of date.
+        static object_pool_stats get_stats();
+
+        /// Reset all counters except reserved bytes to zero.
+        ///
+        /// May be called while other threads allocate, their allocations
+        /// concurrent with the call are counted either before or after it.
+        static void reset_stats();
+
+    private: // STATIC
+
+        /// Allocate memory from the pools of the current thread.
+        ///
+        /// Returns nullptr if the size is too large for the pool, otherwise
+        /// sets tag to the value that must be passed to release(...).
+        static void* allocate(size_t size, std::uintptr_t& tag);
+
+        /// Release memory allocated from the pool.
+        static void release(void* p, std::uintptr_t tag);
+    };
+}
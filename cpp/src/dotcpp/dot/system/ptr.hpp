@@ -24,13 +24,91 @@ limitations under the License.
 #pragma once
 
 #include <dot/declare.hpp>
+#include <cstdint>
 #include <dot/detail/reference_counter.hpp>
+#include <dot/detail/cast_cache.hpp>
 #include <dot/system/exception.hpp>
 
 namespace dot
 {
     class Null;
     class exception;
+    class object;
+    class object_impl;
+
+    namespace detail
+    {
+        /// Returns true if the pointer holds a value stored inline by object
+        /// rather than the address of a heap object. Only pointers to
+        /// object_impl can hold inline values, see object for details.
+        template <class T>
+        bool is_inline_value(T* p)
+        {
+            if constexpr (std::is_same<T, object_impl>::value) return (reinterpret_cast<std::uintptr_t>(p) & 1) != 0;
+            else return false;
+        }
+
+        /// Creates a heap object holding the inline value, with zero reference count.
+        DOT_CLASS object_impl* box_inline_value(object_impl* p);
+
+        /// Returns a heap object of the same type as the inline value. It is
+        /// used for type checks that do not require a heap copy of the value.
+        DOT_CLASS object_impl* inline_value_prototype(object_impl* p);
+
+        /// Returns the hash code of the inline value without creating a heap copy.
+        /// It is the same as hash_code() of the heap object holding the value.
+        DOT_CLASS size_t inline_value_hash_code(object_impl* p);
+
+        /// Returns true if the inline value is equal to the other object,
+        /// without creating a heap copy of either inline value.
+        DOT_CLASS bool inline_value_equals(object_impl* p, object_impl* other);
+
+        /// Replaces the inline value held at the address by a heap object holding
+        /// the value and returns the heap object, whose reference is then held
+        /// at the address. Returns the object held at the address if it is not
+        /// an inline value. Safe to call concurrently for the same address.
+        DOT_CLASS object_impl* materialize_inline_value(object_impl** slot);
+
+        /// Returns the object held at the address, replacing an inline value by
+        /// a heap object holding the value. Only pointers to object_impl can hold
+        /// inline values.
+        template <class T>
+        T* materialize(T* const* slot)
+        {
+            if constexpr (std::is_same<T, object_impl>::value)
+            {
+                if (is_inline_value(*slot)) return materialize_inline_value(const_cast<T**>(slot));
+            }
+            return *slot;
+        }
+    }
+
+    template <class T> class ptr;
+    template <class T> class atomic_ptr;
+
+    namespace detail
+    {
+        /// Returns the object referenced by the pointer without taking a reference,
+        /// or nullptr if the pointer is empty or holds an inline value.
+        template <class T>
+        object_impl* referenced_object(const ptr<T>& p);
+
+        /// Hash code of the referenced object, used by std::hash.
+        template <class T>
+        size_t ptr_hash_code(const ptr<T>& p);
+
+        /// True if the referenced objects are equal, used by std::equal_to.
+        template <class T>
+        bool ptr_equals(const ptr<T>& lhs, const ptr<T>& rhs);
+
+        /// True if T is ptr(R) or a class derived from it, such as object or string.
+        template <class T, class = void>
+        struct is_ptr : std::false_type {};
+
+        /// True if T is ptr(R) or a class derived from it, such as object or string.
+        template <class T>
+        struct is_ptr<T, std::void_t<typename T::element_type>> : std::is_base_of<ptr<typename T::element_type>, T> {};
+    }
 
     /// Reference counted smart pointer based on std::shared_ptr
     /// with emulation of selected features of .NET references including
@@ -39,6 +117,12 @@ namespace dot
     class ptr
     {
         template<class R> friend class ptr;
+        template<class R> friend class borrowed_ptr;
+        template<class R> friend class atomic_ptr;
+        template<class R> friend object_impl* detail::referenced_object(const ptr<R>& p);
+        template<class R> friend size_t detail::ptr_hash_code(const ptr<R>& p);
+        template<class R> friend bool detail::ptr_equals(const ptr<R>& lhs, const ptr<R>& rhs);
+        friend class object;
 
     public: // TYPEDEF
 
@@ -69,6 +153,14 @@ namespace dot
         /// Copy constructor for the pointer (does not copy T).
         ptr(const ptr<T>& rhs);
 
+        /// Move constructor for the pointer, takes over the reference held
+        /// by the argument without changing the reference count.
+        ptr(ptr<T>&& rhs) noexcept;
+
+        /// Implicit move conversion from derived to base pointer (does not use dynamic cast
+        /// and does not change the reference count).
+        template <class R> ptr(ptr<R>&& rhs, typename std::enable_if<std::is_base_of<T, R>::value>::type* p = 0) noexcept;
+
     public: // DESTRUCTOR
 
         /// Decrements reference count if not empty.
@@ -85,14 +177,20 @@ namespace dot
         bool is() const;
 
         /// Returns true if pointer holds object, and false otherwise.
-        bool is_empty();
+        bool is_empty() const;
 
     public: // OPERATORS
 
         /// Pointer dereference.
+        ///
+        /// An inline value is replaced by a heap object holding the value
+        /// on first dereference, see object for details.
         T& operator*() const;
 
         /// Pointer dereference.
+        ///
+        /// An inline value is replaced by a heap object holding the value
+        /// on first dereference, see object for details.
         T* operator->() const;
 
         /// Returns true if the argument contains
@@ -119,6 +217,12 @@ namespace dot
         /// Assign pointer of the same type.
         ptr<T>& operator=(const ptr<T>& rhs);
 
+        /// Move assign pointer of the same type without changing the reference count.
+        ptr<T>& operator=(ptr<T>&& rhs) noexcept;
+
+        /// Move assign pointer to derived type without changing the reference count.
+        template <class R> ptr<T>& operator=(ptr<R>&& rhs) noexcept;
+
         /// Const indexer operator for arrays.
         template <class I>
         decltype(auto) operator[](I const& i) const;
@@ -126,18 +230,38 @@ namespace dot
         /// Non-const indexer operator for arrays.
         template <class I>
         decltype(auto) operator[](I const& i);
+
+    private: // STATIC
+
+        /// Increment reference count unless the pointer is null or holds an inline value.
+        static void increment(T* p) { if (p && !detail::is_inline_value(p)) p->increment_reference_count(); }
+
+        /// Decrement reference count unless the pointer is null or holds an inline value.
+        static void decrement(T* p) { if (p && !detail::is_inline_value(p)) p->decrement_reference_count(); }
     };
 
     template <class T> ptr<T>::ptr() : ptr_(nullptr) {}
-    template <class T> ptr<T>::ptr(T* p) : ptr_(p) { if (ptr_) ptr_->increment_reference_count(); }
-    template <class T> template <class R> ptr<T>::ptr(const ptr<R>& rhs, typename std::enable_if<std::is_base_of<T, R>::value>::type* p) : ptr_(rhs.ptr_) { if (ptr_) ptr_->increment_reference_count(); }
+    template <class T> ptr<T>::ptr(T* p) : ptr_(p) { increment(ptr_); }
+    template <class T> template <class R> ptr<T>::ptr(const ptr<R>& rhs, typename std::enable_if<std::is_base_of<T, R>::value>::type* p) : ptr_(rhs.ptr_) { increment(ptr_); }
     template <class T> template <class R> ptr<T>::ptr(const ptr<R>& rhs, typename std::enable_if<!std::is_base_of<T, R>::value>::type* p) : ptr_(nullptr)
     {
         // If argument is null, ptr_ should also remain null
         if (rhs.ptr_)
         {
+            // Inline value is copied to the heap before the cast
+            ptr<R> boxed;
+            R* source = rhs.ptr_;
+            if constexpr (std::is_same<R, object_impl>::value)
+            {
+                if (detail::is_inline_value(source))
+                {
+                    boxed = detail::box_inline_value(source);
+                    source = boxed.ptr_;
+                }
+            }
+
             // Perform dynamic cast from base to derived
-            T* p = dynamic_cast<T*>(rhs.ptr_);
+            T* p = detail::fast_cast<T>(source);
 
             // Check that dynamic cast succeeded
             if (!p)
@@ -150,32 +274,93 @@ namespace dot
             ptr_->increment_reference_count();
         }
     }
-    template <class T> ptr<T>::ptr(const ptr<T>& rhs) : ptr_(rhs.ptr_) { if (ptr_) ptr_->increment_reference_count(); }
-    template <class T> ptr<T>::~ptr() { if (ptr_) ptr_->decrement_reference_count(); }
-    template <class T> template <class R> R ptr<T>::as() const { typename R::pointer_type p = dynamic_cast<typename R::pointer_type>(ptr_); return p; }
-    template <class T> template <class R> bool ptr<T>::is() const { return dynamic_cast<typename R::pointer_type>(ptr_); }
+    template <class T> ptr<T>::ptr(const ptr<T>& rhs) : ptr_(rhs.ptr_) { increment(ptr_); }
+    template <class T> ptr<T>::ptr(ptr<T>&& rhs) noexcept : ptr_(rhs.ptr_) { rhs.ptr_ = nullptr; }
+    template <class T> template <class R> ptr<T>::ptr(ptr<R>&& rhs, typename std::enable_if<std::is_base_of<T, R>::value>::type* p) noexcept : ptr_(rhs.ptr_) { rhs.ptr_ = nullptr; }
+    template <class T> ptr<T>::~ptr() { decrement(ptr_); }
+    template <class T> template <class R> R ptr<T>::as() const
+    {
+        if constexpr (std::is_same<T, object_impl>::value)
+        {
+            if (detail::is_inline_value(ptr_))
+            {
+                // Heap copy of the inline value is created only if the cast succeeds
+                if (!detail::fast_cast<typename R::element_type>(detail::inline_value_prototype(ptr_))) return R();
+                return R(ptr<T>(detail::box_inline_value(ptr_)));
+            }
+        }
+
+        typename R::pointer_type p = detail::fast_cast<typename R::element_type>(ptr_);
+        return p;
+    }
+    template <class T> template <class R> bool ptr<T>::is() const
+    {
+        if constexpr (std::is_same<T, object_impl>::value)
+        {
+            if (detail::is_inline_value(ptr_)) return detail::fast_cast<typename R::element_type>(detail::inline_value_prototype(ptr_));
+        }
+        return detail::fast_cast<typename R::element_type>(ptr_);
+    }
     template <class T> T& ptr<T>::operator*() const
     {
         if (!ptr_)
             throw dot::exception("Pointer is not initialized");
-        return *ptr_;
+        return *detail::materialize(&ptr_);
     }
     template <class T> T* ptr<T>::operator->() const
     {
         if (!ptr_)
             throw dot::exception("Pointer is not initialized");
-        return ptr_;
+        return detail::materialize(&ptr_);
+    }
+    template <class T> object_impl* detail::referenced_object(const ptr<T>& p)
+    {
+        if (p.ptr_ == nullptr || detail::is_inline_value(p.ptr_)) return nullptr;
+        return p.ptr_;
+    }
+    template <class T> size_t detail::ptr_hash_code(const ptr<T>& p)
+    {
+        if constexpr (std::is_same<T, object_impl>::value)
+        {
+            if (detail::is_inline_value(p.ptr_)) return detail::inline_value_hash_code(p.ptr_);
+        }
+        return p->hash_code();
+    }
+    template <class T> bool detail::ptr_equals(const ptr<T>& lhs, const ptr<T>& rhs)
+    {
+        if constexpr (std::is_same<T, object_impl>::value)
+        {
+            if (detail::is_inline_value(lhs.ptr_)) return detail::inline_value_equals(lhs.ptr_, rhs.ptr_);
+        }
+        return lhs->equals(rhs);
     }
     template <class T> bool ptr<T>::operator==(const ptr<T>& rhs) const { return ptr_ == rhs.ptr_; } // TODO check when comparison is performed by value
     template <class T> bool ptr<T>::operator!=(const ptr<T>& rhs) const { return ptr_ != rhs.ptr_; } // TODO check when comparison is performed by value
     template <class T> bool ptr<T>::operator==(nullptr_t) const { return ptr_ == nullptr; }
     template <class T> bool ptr<T>::operator!=(nullptr_t) const { return ptr_ != nullptr; }
-    template <class T> ptr<T>& ptr<T>::operator=(T* rhs) { if (ptr_) ptr_->decrement_reference_count(); if (rhs) rhs->increment_reference_count(); ptr_ = rhs; return *this; }
-    template <class T> template <class R> ptr<T>& ptr<T>::operator=(const ptr<R>& rhs) { if (ptr_) ptr_->decrement_reference_count(); if (rhs.ptr_) rhs.ptr_->increment_reference_count(); ptr_ = rhs.ptr_; return *this; }
-    template <class T> ptr<T>& ptr<T>::operator=(const ptr<T>& rhs) { if (ptr_) ptr_->decrement_reference_count(); if (rhs.ptr_) rhs.ptr_->increment_reference_count(); ptr_ = rhs.ptr_; return *this; }
+    template <class T> ptr<T>& ptr<T>::operator=(T* rhs) { increment(rhs); decrement(ptr_); ptr_ = rhs; return *this; }
+    template <class T> template <class R> ptr<T>& ptr<T>::operator=(const ptr<R>& rhs) { T* p = rhs.ptr_; increment(p); decrement(ptr_); ptr_ = p; return *this; }
+    template <class T> ptr<T>& ptr<T>::operator=(const ptr<T>& rhs) { increment(rhs.ptr_); decrement(ptr_); ptr_ = rhs.ptr_; return *this; }
+    template <class T> ptr<T>& ptr<T>::operator=(ptr<T>&& rhs) noexcept
+    {
+        // Detach from rhs before releasing the current object so that self-move is a no-op
+        T* p = rhs.ptr_;
+        rhs.ptr_ = nullptr;
+        decrement(ptr_);
+        ptr_ = p;
+        return *this;
+    }
+    template <class T> template <class R> ptr<T>& ptr<T>::operator=(ptr<R>&& rhs) noexcept
+    {
+        T* p = rhs.ptr_;
+        rhs.ptr_ = nullptr;
+        decrement(ptr_);
+        ptr_ = p;
+        return *this;
+    }
     template <class T> template <class I> decltype(auto) ptr<T>::operator[](I const& i) const { return (*ptr_)[i]; }
     template <class T> template <class I> decltype(auto) ptr<T>::operator[](I const& i) { return (*ptr_)[i]; }
-    template <class T> bool ptr<T>::is_empty() { return !ptr_; }
+    template <class T> bool ptr<T>::is_empty() const { return !ptr_; }
 
     /// Implements begin() used by STL and similar algorithms.
     template <class T>
@@ -214,7 +399,7 @@ namespace std
     {
         size_t operator()(const dot::ptr<T>& obj) const
         {
-            return obj->hash_code();
+            return dot::detail::ptr_hash_code(obj);
         }
     };
 
@@ -224,7 +409,7 @@ namespace std
     {
         bool operator()(const dot::ptr<T>& lhs, const dot::ptr<T>& rhs) const
         {
-            return lhs->equals(rhs);
+            return dot::detail::ptr_equals(lhs, rhs);
         }
     };
 }
@@ -33,14 +33,14 @@ limitations under the License.
 
 namespace dot
 {
-    object activator::create_instance(type t)
+    object activator::create_instance(const type& t)
     {
         return create_instance(t, nullptr);
     }
 
-    object activator::create_instance(type t, list<object> params)
+    object activator::create_instance(const type& t, const list<object>& params)
     {
-        list<constructor_info> ctors = t->get_constructors();
+        const list<constructor_info>& ctors = t->get_constructors();
 
         // If no constructors
         if (ctors.is_empty() || ctors->count() == 0)
@@ -56,9 +56,9 @@ namespace dot
             params_count = params->count();
         }
 
-        for (auto ctor : ctors)
+        for (const constructor_info& ctor : ctors)
         {
-            auto ctor_params = ctor->get_parameters();
+            const list<parameter_info>& ctor_params = ctor->get_parameters();
             bool matches = true;
 
             // Continue if different parameters count
@@ -92,12 +92,12 @@ namespace dot
         return best_ctor->invoke(params);
     }
 
-    object activator::create_instance(string assembly_name, string type_name)
+    object activator::create_instance(const string& assembly_name, const string& type_name)
     {
         return create_instance(type_impl::get_type_of(type_name), nullptr);
     }
 
-    object activator::create_instance(string assembly_name, string type_name, list<object> params)
+    object activator::create_instance(const string& assembly_name, const string& type_name, const list<object>& params)
     {
         return create_instance(type_impl::get_type_of(type_name), params);
     }
@@ -41,15 +41,15 @@ namespace dot
     public: // METHODS
 
         /// Creates an instance of the specified type using that type's default constructor.
-        static object create_instance(type t);
+        static object create_instance(const type& t);
 
         /// Creates an instance of the specified type using the constructor that best matches the specified parameters.
-        static object create_instance(type t, list<object> params);
+        static object create_instance(const type& t, const list<object>& params);
 
         /// Creates an instance of the type whose name is specified, using the named assembly and default constructor.
-        static object create_instance(string assembly_name, string type_name);
+        static object create_instance(const string& assembly_name, const string& type_name);
 
         /// Creates an instance of the type whose name is specified, using the named assembly and default constructor.
-        static object create_instance(string assembly_name, string type_name, list<object> params);
+        static object create_instance(const string& assembly_name, const string& type_name, const list<object>& params);
     };
 }
@@ -43,13 +43,13 @@ namespace dot
         virtual string to_string() override { return "ConstructorInfo"; }
 
         /// Gets the parameters of this constructor.
-        virtual list<parameter_info> get_parameters()
+        virtual const list<parameter_info>& get_parameters()
         {
             return parameters;
         }
 
         /// Invokes specified constructor with given parameters.
-        virtual object invoke(list<object>) = 0;
+        virtual object invoke(const list<object>& params) = 0;
 
     protected: // CONSTRUCTORS
 
@@ -82,13 +82,13 @@ namespace dot
 
         /// Invokes the constructor reflected by this ConstructorInfo instance.
         template <int ... I>
-        object invoke_impl(list<object> params, detail::index_sequence<I...>)
+        object invoke_impl(const list<object>& params, detail::index_sequence<I...>)
         {
             return (*ptr_)(params[I]...);
         }
 
         /// Invokes the constructor reflected by this ConstructorInfo instance.
-        virtual object invoke(list<object> params)
+        virtual object invoke(const list<object>& params) override
         {
             if ((params.is_empty() && parameters->count() != 0) || (!params.is_empty() && (params->count() != parameters->count())))
                 throw exception("Wrong number of parameters for constructor " + this->declaring_type->name + "." + this->name);
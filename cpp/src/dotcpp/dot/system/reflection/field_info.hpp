@@ -24,6 +24,7 @@ limitations under the License.
 #pragma once
 
 #include <dot/system/exception.hpp>
+#include <dot/system/borrowed_ptr.hpp>
 #include <dot/system/reflection/member_info.hpp>
 
 namespace dot
@@ -44,10 +45,24 @@ namespace dot
         virtual string to_string() override { return "field_info"; }
 
         /// Returns the field value of a specified object.
-        virtual object get_value(object obj) = 0;
+        virtual object get_value(borrowed_ptr<object_impl> obj) = 0;
 
         /// Sets the field value of a specified object.
-        virtual void set_value(object obj, object value) = 0;
+        virtual void set_value(borrowed_ptr<object_impl> obj, const object& value) = 0;
+
+        /// Returns the object referenced by the field of a specified object
+        /// without taking a reference, or nullptr if the field is empty or
+        /// does not hold a reference. Used by cycle_collector to trace the
+        /// object graph.
+        ///
+        /// This method does not have a counterpart in C#.
+        virtual object_impl* get_reference(borrowed_ptr<object_impl> obj) = 0;
+
+        /// Resets the field of a specified object to an empty reference if the field
+        /// holds a reference. Used by cycle_collector to break garbage cycles.
+        ///
+        /// This method does not have a counterpart in C#.
+        virtual void clear_reference(borrowed_ptr<object_impl> obj) = 0;
 
     protected: // CONSTRUCTORS
 
@@ -91,15 +106,28 @@ namespace dot
     private: // METHODS
 
         /// Returns the field value of a specified object.
-        virtual object get_value(object obj) override
+        virtual object get_value(borrowed_ptr<object_impl> obj) override
         {
-            return (*ptr<class_>(obj)).*field_;
+            return (*borrowed_ptr<class_>(obj)).*field_;
         }
 
         /// Sets the field value of a specified object.
-        virtual void set_value(object obj, object value) override
+        virtual void set_value(borrowed_ptr<object_impl> obj, const object& value) override
+        {
+            (*borrowed_ptr<class_>(obj)).*field_ = (field_type_t)value;
+        }
+
+        /// Returns the object referenced by the field of a specified object without taking a reference.
+        virtual object_impl* get_reference(borrowed_ptr<object_impl> obj) override
+        {
+            if constexpr (detail::is_ptr<field_type_t>::value) return detail::referenced_object((*borrowed_ptr<class_>(obj)).*field_);
+            else return nullptr;
+        }
+
+        /// Resets the field of a specified object to an empty reference if the field holds a reference.
+        virtual void clear_reference(borrowed_ptr<object_impl> obj) override
         {
-            (*ptr<class_>(obj)).*field_ = (field_type_t)value;
+            if constexpr (detail::is_ptr<field_type_t>::value) (*borrowed_ptr<class_>(obj)).*field_ = field_type_t();
         }
     };
 
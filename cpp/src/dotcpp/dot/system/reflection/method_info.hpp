@@ -23,6 +23,7 @@ limitations under the License.
 
 #pragma once
 
+#include <dot/system/borrowed_ptr.hpp>
 #include <dot/system/reflection/member_info.hpp>
 #include <dot/system/reflection/parameter_info.hpp>
 #include <dot/system/exception.hpp>
@@ -52,7 +53,10 @@ namespace dot
         }
 
         /// Invokes specified method with given parameters.
-        virtual object invoke(object, list<object>) = 0;
+        ///
+        /// The instance is passed as borrowed_ptr and the parameters by reference,
+        /// so invoking a method does not change the reference count of either.
+        virtual object invoke(borrowed_ptr<object_impl> obj, const list<object>& params) = 0;
 
         /// Gets the return type of this method.
         type return_type; // TODO - convert to method
@@ -92,21 +96,21 @@ namespace dot
 
         /// Invokes the method reflected by this method_info instance.
         template <int ... I>
-        object invoke_impl(object obj, list<object> params, detail::index_sequence<I...>, std::false_type)
+        object invoke_impl(borrowed_ptr<object_impl> obj, const list<object>& params, detail::index_sequence<I...>, std::false_type)
         {
-            return ((*ptr<class_>(obj)).*ptr_)(params[I]...);
+            return ((*borrowed_ptr<class_>(obj)).*ptr_)(params[I]...);
         }
 
         /// Invokes the method reflected by this method_info instance.
         template <int ... I>
-        object invoke_impl(object obj, list<object> params, detail::index_sequence<I...>, std::true_type)
+        object invoke_impl(borrowed_ptr<object_impl> obj, const list<object>& params, detail::index_sequence<I...>, std::true_type)
         {
-            ((*ptr<class_>(obj)).*ptr_)(params[I]...);
+            ((*borrowed_ptr<class_>(obj)).*ptr_)(params[I]...);
             return object();
         }
 
         /// Invokes the method reflected by this MethodInfo instance.
-        virtual object invoke(object obj, list<object> params)
+        virtual object invoke(borrowed_ptr<object_impl> obj, const list<object>& params) override
         {
             if (params->count() != parameters->count())
                 throw exception("Wrong number of parameters for method " + this->declaring_type->name + "." + this->name);
@@ -144,21 +148,21 @@ namespace dot
 
         /// Invokes the method reflected by this MethodInfo instance.
         template <int ... I>
-        object invoke_impl(object obj, list<object> params, detail::index_sequence<I...>, std::false_type)
+        object invoke_impl(borrowed_ptr<object_impl> obj, const list<object>& params, detail::index_sequence<I...>, std::false_type)
         {
             return (*ptr_)(params[I]...);
         }
 
         /// Invokes the method reflected by this MethodInfo instance.
         template <int ... I>
-        object invoke_impl(object obj, list<object> params, detail::index_sequence<I...>, std::true_type)
+        object invoke_impl(borrowed_ptr<object_impl> obj, const list<object>& params, detail::index_sequence<I...>, std::true_type)
         {
             (*ptr_)(params[I]...);
             return object();
         }
 
         /// Invokes the method reflected by this MethodInfo instance.
-        virtual object invoke(object obj, list<object> params)
+        virtual object invoke(borrowed_ptr<object_impl> obj, const list<object>& params) override
         {
             if (params->count() != parameters->count())
                 throw exception("Wrong number of parameters for method " + this->declaring_type->name + "." + this->name);
@@ -0,0 +1,123 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+#include <dot/system/exception.hpp>
+#include <type_traits>
+
+namespace dot
+{
+    /// Provides a type-safe representation of a contiguous region of
+    /// memory owned by another object, such as the elements of a list.
+    ///
+    /// The span is a value type holding a pointer and a length. Element
+    /// access is not virtual and does not check for null, so loops over
+    /// a span compile to the same code as loops over a raw array and can
+    /// be vectorized. Use span<const T> for read-only access.
+    ///
+    /// The span does not keep its owner alive, and is invalidated by any
+    /// operation that reallocates the storage of the owner, for example
+    /// adding elements to a list beyond its capacity.
+    template <class T>
+    class span
+    {
+        typedef span<T> self;
+
+    public: // TYPEDEF
+
+        typedef T element_type;
+        typedef std::remove_cv_t<T> value_type;
+        typedef T* iterator;
+        typedef T* pointer;
+        typedef T& reference;
+
+    private: // FIELDS
+
+        /// First element, or nullptr for an empty span.
+        T* data_ = nullptr;
+
+        /// Number of elements.
+        int length_ = 0;
+
+    public: // CONSTRUCTORS
+
+        /// Create empty span.
+        span() = default;
+
+        /// Create span over the specified number of elements starting at the pointer.
+        span(T* data, int length) : data_(data), length_(length) {}
+
+        /// Create read-only span from span of non-const elements.
+        template <class R, class = std::enable_if_t<std::is_same<const R, T>::value>>
+        span(const span<R>& rhs) : data_(rhs.data()), length_(rhs.length()) {}
+
+    public: // PROPERTIES
+
+        /// The number of elements in the span.
+        int length() const noexcept { return length_; }
+
+        /// Returns a value that indicates whether the span is empty.
+        bool is_empty() const noexcept { return length_ == 0; }
+
+        /// Pointer to the first element.
+        ///
+        /// This method does not have a counterpart in C#.
+        T* data() const noexcept { return data_; }
+
+    public: // METHODS
+
+        /// Forms a slice out of the current span starting at the specified index.
+        ///
+        /// Error if the index is outside the span.
+        self slice(int start) const
+        {
+            if (start < 0 || start > length_) throw exception("Slice is outside the span.");
+            return self(data_ + start, length_ - start);
+        }
+
+        /// Forms a slice out of the current span starting at the specified
+        /// index for the specified length.
+        ///
+        /// Error if the range is outside the span.
+        self slice(int start, int length) const
+        {
+            if (start < 0 || length < 0 || start > length_ || length > length_ - start) throw exception("Slice is outside the span.");
+            return self(data_ + start, length);
+        }
+
+        /// Iterator to the first element.
+        T* begin() const noexcept { return data_; }
+
+        /// Iterator past the last element.
+        T* end() const noexcept { return data_ + length_; }
+
+    public: // OPERATORS
+
+        /// Gets the element at the specified index.
+        ///
+        /// The index is not checked, which is the responsibility of the caller.
+        T& operator[](int index) const noexcept { return data_[index]; }
+    };
+}
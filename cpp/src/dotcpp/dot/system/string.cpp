@@ -26,12 +26,65 @@ limitations under the License.
 #include <fmt/format.h>
 #include <dot/implement.hpp>
 #include <dot/system/string.hpp>
+#include <dot/system/string_slice.hpp>
+#include <dot/system/string_split_options.hpp>
+#include <dot/detail/string_kernels.hpp>
 #include <dot/system/object.hpp>
+#include <dot/system/collections/generic/list.hpp>
 #include <dot/system/nullable.hpp>
 #include <dot/system/type.hpp>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
 
 namespace dot
 {
+    namespace detail
+    {
+        namespace
+        {
+            /// Number of independently locked shards of the intern pool.
+            const size_t string_intern_shard_count = 16;
+
+            /// Interned strings with the same shard index, hashed using the cached hash code.
+            class string_intern_shard
+            {
+            public: // FIELDS
+
+                /// Shared for lookup, exclusive for insertion.
+                std::shared_mutex mutex_;
+
+                /// Interned strings of the shard.
+                std::unordered_set<string> strings_;
+            };
+
+            /// Intern pool, never deleted so that interned strings
+            /// remain valid during the destruction of static objects.
+            string_intern_shard* get_string_intern_pool()
+            {
+                static string_intern_shard* pool = new string_intern_shard[string_intern_shard_count];
+                return pool;
+            }
+
+            /// Shard of the intern pool for the hash code, using its high bits
+            /// so that the choice of shard does not correlate with the bucket.
+            string_intern_shard& get_string_intern_shard(size_t hash_code)
+            {
+                return get_string_intern_pool()[(hash_code >> (sizeof(size_t) * 8 - 8)) % string_intern_shard_count];
+            }
+
+            /// White space characters used by trim and by split without separators,
+            /// the same as those accepted by is_string_white_space.
+            const char string_white_space[] = " \t\n\v\f\r";
+
+            /// Convert position returned by the kernels to the index returned by string methods.
+            int to_string_index(size_t pos)
+            {
+                return pos == std::string_view::npos ? -1 : static_cast<int>(pos);
+            }
+        }
+    }
+
     /// Empty string.
     string string::empty = make_string("");
 
@@ -54,19 +107,74 @@ namespace dot
 
     bool string_impl::equals(object obj)
     {
-        if (this == &(*obj)) return true;
+        string other = obj.as<string>();
+        if (other == nullptr) return false;
+        return equals(*other);
+    }
+
+    string_impl* string_impl::allocate(size_t length)
+    {
+        void* memory = reference_counter::operator new(sizeof(string_impl) + length + 1);
+        string_impl* result = ::new (memory) string_impl(length);
+        result->chars()[length] = 0;
+        return result;
+    }
 
-        if (obj.is<string>())
+    string_impl* string_impl::create(std::string_view value)
+    {
+        string_impl* result = allocate(value.size());
+        if (!value.empty()) std::memcpy(result->chars(), value.data(), value.size());
+        return result;
+    }
+
+    size_t string_impl::compute_hash_code()
+    {
+        // Concurrent callers compute the same value, so the result can be merged without a lock
+        size_t result = std::hash<std::string_view>()(view()) >> hash_shift_;
+        hash_state_.fetch_or((result << hash_shift_) | hash_computed_flag_, std::memory_order_relaxed);
+        return result;
+    }
+
+    bool string_impl::compute_is_ascii() const
+    {
+        // Check eight bytes at a time for the high bit
+        const char* p = data();
+        const char* end = p + length_;
+        std::uint64_t bits = 0;
+        for (; end - p >= 8; p += 8)
         {
-            return *this == *obj.as<string>();
+            std::uint64_t word;
+            std::memcpy(&word, p, 8);
+            bits |= word;
         }
+        for (; p < end; ++p) bits |= static_cast<unsigned char>(*p);
 
-        return false;
+        bool result = (bits & 0x8080808080808080ull) == 0;
+        hash_state_.fetch_or(ascii_checked_flag_ | (result ? ascii_flag_ : 0), std::memory_order_relaxed);
+        return result;
     }
 
-    size_t string_impl::hash_code()
+    int string_impl::utf16_length() const
     {
-        return std::hash<std::string>()(*this);
+        if (is_ascii()) return static_cast<int>(length_);
+
+        // Each character takes one code unit, except those encoded by four bytes
+        int result = 0;
+        for (detail::utf16_iterator iter(data(), data() + length_), end(data() + length_, data() + length_); iter != end; ++iter) ++result;
+        return result;
+    }
+
+    Char string_impl::utf16_at(int index) const
+    {
+        if (index >= 0)
+        {
+            int remaining = index;
+            for (Char c : utf16())
+            {
+                if (remaining-- == 0) return c;
+            }
+        }
+        throw exception("Index was outside the bounds of the string.");
     }
 
     string string_impl::to_string()
@@ -78,52 +186,232 @@ namespace dot
     /// string matches the specified string.
     bool string_impl::ends_with(const string& value)
     {
-        int p = length() - value->length();
-        if (p >= 0 && substr(p, value->length()) == *value)
-            return true;
-        return false;
+        return length_ >= value->length_ && std::memcmp(data() + length_ - value->length_, value->data(), value->length_) == 0;
     }
 
     /// Determines whether the beginning of this
     /// string matches the specified string.
     bool string_impl::starts_with(const string& value)
     {
-        int p = length() - value->length();
-        if (p >= 0 && substr(0, value->length()) == *value)
-            return true;
-        return false;
+        return length_ >= value->length_ && std::memcmp(data(), value->data(), value->length_) == 0;
     }
 
     /// Retrieves a substring which starts at the specified
     /// character position and has the specified length.
     string string_impl::substring(int startIndex, int length)
     {
+        if (startIndex == 0 && size_t(length) == length_) return this;
         return make_string(this->substr(startIndex, length));
     }
 
+    string_slice string_impl::slice(int startIndex, int length)
+    {
+        return string_slice(this, startIndex, length);
+    }
+
+    list<string> string_impl::split(char separator) const
+    {
+        list<string> result = make_list<string>();
+        size_t start = 0;
+        while (true)
+        {
+            size_t pos = detail::find_byte(data() + start, length_ - start, separator);
+            if (pos == npos)
+            {
+                result->add(make_string(substr(start)));
+                return result;
+            }
+            result->add(make_string(substr(start, pos)));
+            start += pos + 1;
+        }
+    }
+
+    list<string> string_impl::split(const list<string>& separator, const string_split_options& options) const
+    {
+        // Separators in list order and the set of their first bytes,
+        // white space characters if there are no separators
+        std::vector<std::string_view> separators;
+        std::string first_bytes;
+        if (separator != nullptr)
+        {
+            for (const string& value : *separator)
+            {
+                if (value == nullptr || value->empty()) continue;
+                separators.push_back(value->view());
+                if (first_bytes.find(value->data()[0]) == std::string::npos) first_bytes += value->data()[0];
+            }
+        }
+        if (separators.empty())
+        {
+            for (const char& c : detail::string_white_space) if (c != 0) separators.push_back(std::string_view(&c, 1));
+            first_bytes = detail::string_white_space;
+        }
+
+        bool remove_empty = options == string_split_options::RemoveEmptyEntries;
+        list<string> result = make_list<string>();
+        size_t start = 0;
+        size_t search = 0;
+        while (true)
+        {
+            size_t pos = detail::find_any_byte(data() + search, length_ - search, first_bytes.data(), first_bytes.size());
+            if (pos == npos) break;
+            pos += search;
+
+            size_t separator_length = 0;
+            for (std::string_view value : separators)
+            {
+                if (view().compare(pos, value.size(), value) == 0)
+                {
+                    separator_length = value.size();
+                    break;
+                }
+            }
+
+            if (separator_length == 0)
+            {
+                search = pos + 1;
+                continue;
+            }
+            if (!remove_empty || pos > start) result->add(make_string(substr(start, pos - start)));
+            start = search = pos + separator_length;
+        }
+        if (!remove_empty || start < length_) result->add(make_string(substr(start)));
+        return result;
+    }
+
+    string string_impl::to_lower() const
+    {
+        string_impl* result = allocate(length_);
+        detail::to_lower_ascii(data(), result->chars(), length_);
+        return result;
+    }
+
+    string string_impl::to_upper() const
+    {
+        string_impl* result = allocate(length_);
+        detail::to_upper_ascii(data(), result->chars(), length_);
+        return result;
+    }
+
+    string string_impl::trim()
+    {
+        size_t first = 0;
+        size_t last = length_;
+        while (first < last && detail::is_string_white_space(data()[first])) ++first;
+        while (last > first && detail::is_string_white_space(data()[last - 1])) --last;
+        if (first == 0 && last == length_) return this;
+        return make_string(substr(first, last - first));
+    }
+
+    int string_impl::compare_to(const string& strB) const
+    {
+        if (strB == nullptr) return 1;
+        int result = std::memcmp(data(), strB->data(), std::min(length_, strB->length_));
+        if (result != 0) return result < 0 ? -1 : 1;
+        if (length_ == strB->length_) return 0;
+        return length_ < strB->length_ ? -1 : 1;
+    }
+
     int string_impl::index_of_any(list<char> anyOf)
     {
-        size_t pos = find_first_of(anyOf->data(), 0, anyOf->size());
-        if (pos != std::string::npos)
-            return pos;
-        return -1;
+        return detail::to_string_index(detail::find_any_byte(data(), length_, anyOf->data(), anyOf->size()));
+    }
+
+    int string_impl::index_of(char value) const
+    {
+        return detail::to_string_index(detail::find_byte(data(), length_, value));
+    }
+
+    int string_impl::index_of(char value, int startIndex) const
+    {
+        if (startIndex < 0 || size_t(startIndex) > length_) throw exception("Start index is outside the string.");
+        size_t pos = detail::find_byte(data() + startIndex, length_ - startIndex, value);
+        return pos == npos ? -1 : startIndex + static_cast<int>(pos);
+    }
+
+    int string_impl::index_of(const string& value) const
+    {
+        return index_of(value, 0);
+    }
+
+    int string_impl::index_of(const string& value, int startIndex) const
+    {
+        if (value == nullptr) throw exception("String to find is null.");
+        if (startIndex < 0 || size_t(startIndex) > length_) throw exception("Start index is outside the string.");
+        size_t pos = detail::find_bytes(data() + startIndex, length_ - startIndex, value->data(), value->length_);
+        return pos == npos ? -1 : startIndex + static_cast<int>(pos);
+    }
+
+    int string_impl::last_index_of(char value) const
+    {
+        return detail::to_string_index(detail::find_last_byte(data(), length_, value));
+    }
+
+    int string_impl::last_index_of(const string& value) const
+    {
+        if (value == nullptr) throw exception("String to find is null.");
+        return detail::to_string_index(detail::find_last_bytes(data(), length_, value->data(), value->length_));
+    }
+
+    bool string_impl::contains(string const& s) const
+    {
+        if (s == nullptr) throw exception("String to find is null.");
+        return detail::find_bytes(data(), length_, s->data(), s->length_) != npos;
     }
 
     string string_impl::remove(int startIndex)
     {
-        return make_string(*this)->erase(startIndex);
+        return make_string(substr(0, startIndex));
     }
 
     string string_impl::remove(int startIndex, int count)
     {
-        return make_string(*this)->erase(startIndex, count);
+        std::string_view prefix = substr(0, startIndex);
+        std::string_view suffix = substr(std::min(length_, size_t(startIndex) + count));
+
+        string_impl* result = allocate(prefix.size() + suffix.size());
+        std::memcpy(result->chars(), prefix.data(), prefix.size());
+        std::memcpy(result->chars() + prefix.size(), suffix.data(), suffix.size());
+        return result;
+    }
+
+    string string_impl::replace(const string& oldValue, const string& newValue) const
+    {
+        if (oldValue == nullptr || oldValue->empty()) throw exception("String to replace is null or empty.");
+        std::string_view old_view = oldValue->view();
+        std::string_view new_view = newValue != nullptr ? newValue->view() : std::string_view();
+
+        // Count occurrences first so that the result is allocated once with the final length
+        size_t count = 0;
+        for (size_t start = 0;; ++count)
+        {
+            size_t pos = detail::find_bytes(data() + start, length_ - start, old_view.data(), old_view.size());
+            if (pos == npos) break;
+            start += pos + old_view.size();
+        }
+        if (count == 0) return const_cast<string_impl*>(this);
+
+        string_impl* result = allocate(length_ - count * old_view.size() + count * new_view.size());
+        char* target = result->chars();
+        size_t start = 0;
+        while (true)
+        {
+            size_t pos = detail::find_bytes(data() + start, length_ - start, old_view.data(), old_view.size());
+            if (pos == npos) break;
+            std::memcpy(target, data() + start, pos);
+            std::memcpy(target + pos, new_view.data(), new_view.size());
+            target += pos + new_view.size();
+            start += pos + old_view.size();
+        }
+        std::memcpy(target, data() + start, length_ - start);
+        return result;
     }
 
     string string_impl::replace(const char oldChar, const char newChar) const
     {
-        string make_str = *this;
-        std::replace(make_str->begin(), make_str->end(), oldChar, newChar);
-        return make_str;
+        string_impl* result = allocate(length_);
+        std::replace_copy(begin(), end(), result->chars(), oldChar, newChar);
+        return result;
     }
 
     bool string::is_null_or_empty(string value)
@@ -133,6 +421,48 @@ namespace dot
         return false;
     }
 
+    string string::intern(const string& str)
+    {
+        if (str == nullptr) throw exception("String to intern is null.");
+        if (str->is_interned()) return str;
+
+        detail::string_intern_shard& shard = detail::get_string_intern_shard(str->hash_code());
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex_);
+            auto iter = shard.strings_.find(str);
+            if (iter != shard.strings_.end()) return *iter;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(shard.mutex_);
+        auto iter = shard.strings_.find(str);
+        if (iter != shard.strings_.end()) return *iter;
+
+        // The pool is shared by all threads, a string in single_threaded
+        // mode is copied rather than added to the pool
+        string result = str;
+        if (str->get_reference_count_mode() == reference_count_mode::single_threaded)
+        {
+            string_impl* copy = string_impl::create(*str);
+            copy->set_reference_count_mode(reference_count_mode::atomic);
+            result = copy;
+        }
+        result->hash_state_.fetch_or(string_impl::interned_flag_, std::memory_order_relaxed);
+        shard.strings_.insert(result);
+        return result;
+    }
+
+    string string::is_interned(const string& str)
+    {
+        if (str == nullptr) throw exception("String to check is null.");
+        if (str->is_interned()) return str;
+
+        detail::string_intern_shard& shard = detail::get_string_intern_shard(str->hash_code());
+        std::shared_lock<std::shared_mutex> lock(shard.mutex_);
+        auto iter = shard.strings_.find(str);
+        if (iter != shard.strings_.end()) return *iter;
+        return string();
+    }
+
     /// Case sensitive comparison to object.
     bool string::operator==(const object& rhs) const
     {
@@ -152,8 +482,74 @@ namespace dot
     }
 
     /// Non-template implementation of string.Format.
-    std::string string::format_impl(fmt::string_view format_str, fmt::format_args args)
+    string string::format_impl(fmt::string_view format_str, fmt::format_args args)
+    {
+        // Format into a stack buffer and copy once into the string
+        fmt::memory_buffer buffer;
+        fmt::vformat_to(buffer, format_str, args);
+        return string_impl::create(std::string_view(buffer.data(), buffer.size()));
+    }
+
+    void detail::format_to(fmt::internal::buffer& out, fmt::string_view format_str, fmt::format_args args)
+    {
+        fmt::vformat_to(out, format_str, args);
+    }
+
+    void detail::format_text(fmt::internal::buffer& out, fmt::string_view spec, std::string_view text)
+    {
+        if (spec.size() == 0)
+        {
+            out.append(text.data(), text.data() + text.size());
+            return;
+        }
+        format_value(out, spec, fmt::make_format_args(fmt::string_view(text.data(), text.size())));
+    }
+
+    void detail::format_value(fmt::internal::buffer& out, fmt::string_view spec, fmt::format_args args)
     {
-        return fmt::vformat(format_str, args);
+        // Replacement field for the single argument with the specification
+        fmt::basic_memory_buffer<char, 32> field;
+        field.push_back('{');
+        if (spec.size() != 0)
+        {
+            field.push_back(':');
+            field.append(spec.data(), spec.data() + spec.size());
+        }
+        field.push_back('}');
+        fmt::vformat_to(out, fmt::string_view(field.data(), field.size()), args);
+    }
+
+    string string::concat(const list<string>& values)
+    {
+        return join_impl(std::string_view(), values);
+    }
+
+    string string::join(const string& separator, const list<string>& values)
+    {
+        return join_impl(detail::concat_view(separator), values);
+    }
+
+    string string::join(char separator, const list<string>& values)
+    {
+        return join_impl(std::string_view(&separator, 1), values);
+    }
+
+    string string::join_impl(std::string_view separator, const list<string>& values)
+    {
+        if (values == nullptr) throw exception("List of strings to join is null.");
+
+        // Measure first so that the result is allocated once
+        size_t length = 0;
+        for (const string& value : *values) length += detail::concat_view(value).size();
+        if (!values->empty()) length += separator.size() * (values->size() - 1);
+
+        string_impl* result = string_impl::allocate(length);
+        char* out = result->chars();
+        for (size_t i = 0; i < values->size(); ++i)
+        {
+            if (i > 0) out = detail::concat_write(separator, out);
+            out = detail::concat_write(detail::concat_view((*values)[i]), out);
+        }
+        return result;
     }
 }
@@ -25,13 +25,15 @@ limitations under the License.
 
 #include <dot/declare.hpp>
 #include <fmt/core.h>
-#include <dot/detail/const_string_base.hpp>
 #include <dot/system/ptr.hpp>
 #include <dot/system/char.hpp>
 
 namespace dot
 {
     class string_impl; class string;
+    class string_slice;
+    template <class L, class R> class string_concat;
+    class format_template_impl; using format_template = ptr<format_template_impl>;
     template <class T> class list_impl; template <class T> using list = ptr<list_impl<T>>;
     template <class T> class nullable;
     enum class string_split_options;
@@ -40,31 +42,178 @@ namespace dot
     /// Immutable string type.
     ///
     /// The string is encoded internally as UTF-8.
-    class DOT_CLASS string_impl : public virtual object_impl, public detail::const_string_base
+    ///
+    /// Similar to System.String, the object header, the length, the cached
+    /// hash code and the characters followed by a terminating null character
+    /// occupy a single allocation. Instances are created by make_string(...)
+    /// and the methods that return a new string, never directly using new.
+    ///
+    /// Dereferencing string returns string_impl, which provides the const
+    /// methods of std::string used most often and converts implicitly to
+    /// std::string_view without a copy. It also converts implicitly to
+    /// std::string, making a copy, so that existing code which passes *s
+    /// to a function accepting const std::string& continues to compile.
+    /// Such code should be changed to accept std::string_view instead.
+    ///
+    /// The hash code is computed on first use and cached.
+    ///
+    /// Storage and indexing policy: the characters are stored as UTF-8, and
+    /// length(), the positions accepted and returned by the search methods,
+    /// substring(...) and the begin()/end() iterators count bytes. Only the
+    /// methods that return Char count UTF-16 code units as System.String
+    /// does: operator[] takes the index of a UTF-16 code unit and utf16()
+    /// enumerates them. For strings that contain only ASCII characters, which
+    /// is determined on first use and cached, both counts are the same and
+    /// operator[] takes constant time. For other strings operator[] decodes
+    /// the characters preceding the index, so loops over the characters of
+    /// such strings should use utf16() instead.
+    class DOT_CLASS string_impl : public virtual object_impl
     {
         typedef string_impl self;
-        typedef detail::const_string_base base;
-        friend string make_string(const std::string& rhs);
+        friend class string;
+        friend string make_string(std::string_view rhs);
         friend string make_string(const char* rhs);
+        template <class L, class R> friend class string_concat;
+        friend class string_builder_impl;
 
-    public: // CONSTRUCTORS
+    public: // TYPEDEF
+
+        typedef char value_type;
+        typedef size_t size_type;
+        typedef const char* const_iterator;
+        typedef const char* iterator;
+
+    public: // CONSTANTS
+
+        /// Value returned by find methods when nothing is found.
+        static constexpr size_t npos = std::string_view::npos;
+
+    private: // CONSTANTS
+
+        /// Hash code has been computed and is stored in the bits above hash_shift_.
+        static constexpr size_t hash_computed_flag_ = 1;
+
+        /// String is the instance held by the intern pool.
+        static constexpr size_t interned_flag_ = 2;
+
+        /// String has been checked for non-ASCII characters.
+        static constexpr size_t ascii_checked_flag_ = 4;
+
+        /// String contains only ASCII characters, only set together with ascii_checked_flag_.
+        static constexpr size_t ascii_flag_ = 8;
+
+        /// Shift of the cached hash code relative to the flags.
+        static constexpr int hash_shift_ = 4;
+
+    private: // FIELDS
+
+        /// Cached hash code shifted left by hash_shift_, together with the flags.
+        mutable std::atomic<size_t> hash_state_ = 0;
+
+        /// Number of bytes excluding the terminating null character.
+        size_t length_;
+
+        // The characters follow the object in the same allocation
 
-        /// Creates an empty string.
-        string_impl() {}
+    private: // CONSTRUCTORS
 
-        /// Create from a single Unicode character.
-        string_impl(const Char& value);
+        /// Create with the specified length, the characters
+        /// are written by allocate(...) or its caller.
+        explicit string_impl(size_t length) noexcept : length_(length) {}
 
-        /// Initializes from std::string or string literal.
+    public: // METHODS (STD::STRING)
+
+        /// Number of bytes in the UTF-8 representation.
+        size_t size() const noexcept { return length_; }
+
+        /// Number of bytes in the UTF-8 representation.
+        size_t length() const noexcept { return length_; }
+
+        /// True if the string has no characters.
+        bool empty() const noexcept { return length_ == 0; }
+
+        /// Pointer to the characters, followed by a null character.
+        const char* data() const noexcept { return reinterpret_cast<const char*>(this + 1); }
+
+        /// Pointer to the characters, followed by a null character.
+        const char* c_str() const noexcept { return data(); }
+
+        /// Iterator to the first byte.
+        const_iterator begin() const noexcept { return data(); }
+
+        /// Iterator past the last byte.
+        const_iterator end() const noexcept { return data() + length_; }
+
+        /// Iterator to the first byte.
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        /// Iterator past the last byte.
+        const_iterator cend() const noexcept { return end(); }
+
+        /// Byte at the specified position, error if out of range.
+        char at(size_t pos) const { return view().at(pos); }
+
+        /// Characters of the string without a copy.
+        std::string_view view() const noexcept { return std::string_view(data(), length_); }
+
+        /// True if the string contains only ASCII characters, in which case the
+        /// number of UTF-16 code units is the same as the number of bytes.
+        /// The result is computed on first call and cached.
+        ///
+        /// This method does not have a counterpart in C#.
+        bool is_ascii() const
+        {
+            size_t state = hash_state_.load(std::memory_order_relaxed);
+            if (state & ascii_checked_flag_) return (state & ascii_flag_) != 0;
+            return compute_is_ascii();
+        }
+
+        /// Number of UTF-16 code units, which is the value of System.String.Length.
+        ///
+        /// This method does not have a counterpart in C#.
+        int utf16_length() const;
+
+        /// Range of the UTF-16 code units of the string as Char values,
+        /// decoded without allocation. This is the equivalent of enumerating
+        /// System.String.
         ///
-        /// This constructor is private. Use make_string(str) function instead.
-        string_impl(const std::string& value) : base(value) {}
+        /// This method does not have a counterpart in C#.
+        detail::utf16_range utf16() const noexcept { return detail::utf16_range(data(), data() + length_); }
+
+        /// View of the bytes in the specified range, error if pos is out of range.
+        std::string_view substr(size_t pos = 0, size_t count = npos) const { return view().substr(pos, count); }
+
+        /// Position of the first occurrence of value at or after pos, or npos.
+        size_t find(std::string_view value, size_t pos = 0) const noexcept { return view().find(value, pos); }
+
+        /// Position of the first occurrence of value at or after pos, or npos.
+        size_t find(char value, size_t pos = 0) const noexcept { return view().find(value, pos); }
+
+        /// Position of the last occurrence of value at or before pos, or npos.
+        size_t rfind(std::string_view value, size_t pos = npos) const noexcept { return view().rfind(value, pos); }
 
-        /// Create from const char*, null pointer is converted to to empty value.
-        string_impl(const char* value) : base(value) {}
+        /// Position of the last occurrence of value at or before pos, or npos.
+        size_t rfind(char value, size_t pos = npos) const noexcept { return view().rfind(value, pos); }
 
-        /// Create from a single 8-bit character.
-        string_impl(char value) : base(std::to_string(value)) {}
+        /// Position of the first byte equal to any of the specified bytes, or npos.
+        size_t find_first_of(std::string_view values, size_t pos = 0) const noexcept { return view().find_first_of(values, pos); }
+
+        /// Position of the first byte equal to any of the count bytes at values, or npos.
+        size_t find_first_of(const char* values, size_t pos, size_t count) const noexcept { return view().find_first_of(values, pos, count); }
+
+        /// Position of the last byte equal to any of the specified bytes, or npos.
+        size_t find_last_of(std::string_view values, size_t pos = npos) const noexcept { return view().find_last_of(values, pos); }
+
+        /// Compares bytes with the argument, returns negative, zero or positive value.
+        int compare(std::string_view value) const noexcept { return view().compare(value); }
+
+    public: // CONVERSIONS
+
+        /// Characters of the string without a copy.
+        operator std::string_view() const noexcept { return view(); }
+
+        /// Copy of the characters, for existing code that accepts const std::string&.
+        operator std::string() const { return std::string(data(), length_); }
 
     public: // METHODS
 
@@ -72,8 +221,39 @@ namespace dot
         /// which must also be a string object, have the same value.
         bool equals(object obj) override;
 
-        /// Returns the hash code for this string.
-        virtual size_t hash_code() override;
+        /// Determines whether this instance and another string have the same value.
+        ///
+        /// Two different interned instances never have the same value, and
+        /// strings whose hash codes have been computed are compared by hash
+        /// code first.
+        bool equals(const string_impl& other) const
+        {
+            if (this == &other) return true;
+
+            size_t lhs_state = hash_state_.load(std::memory_order_relaxed);
+            size_t rhs_state = other.hash_state_.load(std::memory_order_relaxed);
+            if (lhs_state & rhs_state & interned_flag_) return false;
+            if ((lhs_state & rhs_state & hash_computed_flag_) && (lhs_state >> hash_shift_) != (rhs_state >> hash_shift_)) return false;
+
+            return length_ == other.length_ && std::memcmp(data(), other.data(), length_) == 0;
+        }
+
+        /// Returns the hash code for this string, computed on first call.
+        virtual size_t hash_code() override
+        {
+            size_t state = hash_state_.load(std::memory_order_relaxed);
+            if (state & hash_computed_flag_) return state >> hash_shift_;
+            return compute_hash_code();
+        }
+
+        /// True if this instance is the one held by the intern pool,
+        /// see string::intern(...).
+        ///
+        /// This method does not have a counterpart in C#.
+        bool is_interned() const
+        {
+            return (hash_state_.load(std::memory_order_relaxed) & interned_flag_) != 0;
+        }
 
         /// Returns this instance of string; no actual conversion is performed.
         virtual string to_string() override;
@@ -90,15 +270,55 @@ namespace dot
         /// character position and has the specified length.
         string substring(int startIndex, int length);
 
+        /// Returns a slice of the characters which starts at the specified
+        /// character position and has the specified length, sharing the
+        /// storage of this string instead of copying the characters.
+        ///
+        /// This method does not have a counterpart in C#.
+        string_slice slice(int startIndex, int length);
+
         /// Compares this instance with a specified string object and indicates
         /// whether this instance precedes, follows, or appears in the same position
         /// in the sort order as the specified string.
-        int compare_to(const string& strB) const; // TODO - implement
+        ///
+        /// The comparison is ordinal, comparing the bytes of the UTF-8
+        /// representation. Null string precedes any other string.
+        int compare_to(const string& strB) const;
 
         /// Reports the zero-based index of the first occurrence in this instance of any
         /// character in a specified array of Unicode characters.
         int index_of_any(list<char> anyOf);
 
+        /// Reports the zero-based index of the first occurrence
+        /// of the specified character in this string, or -1.
+        int index_of(char value) const;
+
+        /// Reports the zero-based index of the first occurrence of the specified
+        /// character in this string at or after startIndex, or -1.
+        int index_of(char value, int startIndex) const;
+
+        /// Reports the zero-based index of the first occurrence
+        /// of the specified string in this string, or -1.
+        ///
+        /// The search is ordinal. Empty value is found at position zero.
+        int index_of(const string& value) const;
+
+        /// Reports the zero-based index of the first occurrence of the specified
+        /// string in this string at or after startIndex, or -1.
+        ///
+        /// The search is ordinal. Empty value is found at startIndex.
+        int index_of(const string& value, int startIndex) const;
+
+        /// Reports the zero-based index of the last occurrence
+        /// of the specified character in this string, or -1.
+        int last_index_of(char value) const;
+
+        /// Reports the zero-based index of the last occurrence
+        /// of the specified string in this string, or -1.
+        ///
+        /// The search is ordinal. Empty value is found at the end of the string.
+        int last_index_of(const string& value) const;
+
         /// Returns a new string in which all the characters in the current instance, beginning
         /// at a specified position and continuing through the last position, have been deleted.
         string remove(int startIndex);
@@ -109,7 +329,9 @@ namespace dot
 
         /// Returns a new string in which all occurrences of a specified string
         /// in the current instance are replaced with another specified string.
-        string replace(const string& oldValue, const string& newValue) const; // TODO - implement
+        ///
+        /// Null newValue is treated as empty string, error if oldValue is null or empty.
+        string replace(const string& oldValue, const string& newValue) const;
 
         /// Returns a new string in which all occurrences of a specified character
         /// in this instance are replaced with another specified character.
@@ -117,37 +339,88 @@ namespace dot
 
         /// Returns a string array that contains the substrings of the current string
         /// that are delimited by any of the specified 8-bit characters.
-        list<string> split(char separator) const;  // TODO - implement
+        list<string> split(char separator) const;
 
         /// Returns a string array that contains the substrings in
         /// this string that are delimited by any of the specified strings.
         /// A parameter specifies whether to return empty array elements.
-        list<string> split(const list<string>& separator, const string_split_options& options) const; // TODO - implement
+        ///
+        /// At each position, the separators are compared in the order in which
+        /// they appear in the list. Empty separators are ignored, and if the list
+        /// is null or contains no separators, white space characters are used.
+        list<string> split(const list<string>& separator, const string_split_options& options) const;
 
         /// Indicates whether the argument occurs within this string.
-        bool contains(string const& s) const; // TODO - implement
+        bool contains(string const& s) const;
 
         /// Returns a copy of this string converted to lowercase.
-        string to_lower() const; // TODO - implement
+        ///
+        /// Only ASCII letters are converted, multibyte UTF-8 characters are copied unchanged.
+        string to_lower() const;
 
         /// Returns a copy of this string converted to uppercase.
-        string to_upper() const; // TODO - implement
+        ///
+        /// Only ASCII letters are converted, multibyte UTF-8 characters are copied unchanged.
+        string to_upper() const;
+
+        /// Removes all leading and trailing white space characters from the current string.
+        ///
+        /// Returns this instance if there is nothing to remove.
+        string trim();
 
     public: // OPERATORS
 
-        /// Gets the Char object at a specified position in the current string object.
-        Char operator[](int index) const;
+        /// Gets the UTF-16 code unit at the specified position, counted in
+        /// UTF-16 code units, in the current string object.
+        ///
+        /// Takes constant time for strings that contain only ASCII characters,
+        /// see is_ascii(), and time proportional to the index otherwise.
+        Char operator[](int index) const
+        {
+            if (index >= 0 && static_cast<size_t>(index) < length_ && is_ascii()) return data()[index];
+            return utf16_at(index);
+        }
+
+        /// Case sensitive comparison of bytes.
+        friend bool operator==(const string_impl& lhs, std::string_view rhs) noexcept { return lhs.view() == rhs; }
+
+        /// Case sensitive comparison of bytes.
+        friend bool operator!=(const string_impl& lhs, std::string_view rhs) noexcept { return lhs.view() != rhs; }
 
-        /// Returns a string containing characters from lhs followed by the characters from rhs.
-        friend string operator+(const string& lhs, const string& rhs);
+        /// Ordinal comparison of bytes.
+        friend bool operator<(const string_impl& lhs, std::string_view rhs) noexcept { return lhs.view() < rhs; }
 
-        /// Returns a string containing characters from lhs followed by the characters from rhs.
-        friend bool operator<(const string& lhs, const string& rhs);
+        /// Writes the characters to the stream.
+        friend std::ostream& operator<<(std::ostream& stream, const string_impl& value) { return stream << value.view(); }
 
     public: // REFLECTION
 
         virtual type get_type();
         static type typeof();
+
+    private: // METHODS
+
+        /// Compute and cache the hash code.
+        size_t compute_hash_code();
+
+        /// Check the characters and cache the result of is_ascii().
+        bool compute_is_ascii() const;
+
+        /// Implementation of operator[] for strings with non-ASCII characters,
+        /// error if the index is out of range.
+        Char utf16_at(int index) const;
+
+        /// Characters of the string, only written before the string is shared.
+        char* chars() noexcept { return reinterpret_cast<char*>(this + 1); }
+
+    private: // STATIC
+
+        /// Create a string with the specified length and writes the terminating
+        /// null character. The caller writes the characters before sharing it.
+        static string_impl* allocate(size_t length);
+
+        /// Create a string with a copy of the characters.
+        static string_impl* create(std::string_view value);
     };
 
     /// Pointer to string_impl that has additional constructors compared to ptr(string)
@@ -170,14 +443,20 @@ namespace dot
         string(string_impl* p) : base(p) {}
 
         /// Create from std::string.
-        string(const std::string& rhs) : base(new string_impl(rhs)) {}
+        string(const std::string& rhs) : base(string_impl::create(rhs)) {}
 
-        /// Create from string literal.
-        string(const char* rhs) : base(new string_impl(rhs)) {}
+        /// Create from std::string_view.
+        string(std::string_view rhs) : base(string_impl::create(rhs)) {}
+
+        /// Create from string literal, null pointer is converted to empty value.
+        string(const char* rhs) : base(string_impl::create(rhs != nullptr ? std::string_view(rhs) : std::string_view())) {}
 
         /// Copy constructor.
         string(const string& rhs) : base(rhs) {}
 
+        /// Move constructor, does not change the reference count.
+        string(string&& rhs) noexcept : base(std::move(rhs)) {}
+
         /// Supports cast (explicit constructor) from object.
         ///
         /// Error if object does is not a boxed int.
@@ -191,13 +470,60 @@ namespace dot
         template <typename ...Args>
         static string format(const string& format_string, const Args& ...args);
 
+        /// Replaces format entries in the format string parsed by make_format_template(...)
+        /// with the string representation of objects in the argument array.
+        ///
+        /// Defined in format_template.hpp, which must be included to use this method.
+        template <typename ...Args>
+        static string format(const format_template& compiled_format, const Args& ...args);
+
         /// Indicates whether the specified string is null or an string.Empty string.
         static bool is_null_or_empty(string value);
 
+        /// Retrieves the instance held by the intern pool for the value
+        /// of the specified string, adding the string to the pool if the
+        /// value is not there yet.
+        ///
+        /// The pool is shared by all threads and is never cleared. Interned
+        /// strings are compared using their addresses when both operands are
+        /// interned, so values that are used repeatedly as keys, such as type,
+        /// field and enum names, should be interned once when registered.
+        static string intern(const string& str);
+
+        /// Retrieves the instance held by the intern pool for the value
+        /// of the specified string, or null if the value is not interned.
+        static string is_interned(const string& str);
+
+        /// Concatenates the specified strings, string literals, std::string or
+        /// std::string_view values using a single allocation. Null strings are
+        /// treated as empty.
+        template <typename ...Args>
+        static string concat(const Args& ...values);
+
+        /// Concatenates the elements of the list using a single allocation.
+        /// Null elements are treated as empty.
+        static string concat(const list<string>& values);
+
+        /// Concatenates the elements of the list, using the specified separator
+        /// between each element, using a single allocation. Null elements and
+        /// null separator are treated as empty.
+        static string join(const string& separator, const list<string>& values);
+
+        /// Concatenates the elements of the list, using the specified separator
+        /// between each element, using a single allocation. Null elements are
+        /// treated as empty.
+        static string join(char separator, const list<string>& values);
+
     public: // OPERATORS
 
+        /// Copy assignment.
+        string& operator=(const string& rhs) { base::operator=(rhs); return *this; }
+
+        /// Move assignment, does not change the reference count.
+        string& operator=(string&& rhs) noexcept { base::operator=(std::move(rhs)); return *this; }
+
         /// Case sensitive comparison to std::string.
-        bool operator==(const std::string& rhs) const { string_impl& impl = base::operator*(); return impl == rhs; }
+        bool operator==(const std::string& rhs) const { string_impl& impl = base::operator*(); return impl == std::string_view(rhs); }
 
         /// Case sensitive comparison to std::string.
         bool operator!=(const std::string& rhs) const { return !operator==(rhs); }
@@ -209,7 +535,7 @@ namespace dot
         bool operator!=(const char* rhs) const { return !operator==(rhs); }
 
         /// Case sensitive comparison to string literal.
-        bool operator==(const ptr<string_impl>& rhs) const { return *this == *rhs; }
+        bool operator==(const ptr<string_impl>& rhs) const { return base::operator*().equals(*rhs); }
 
         /// Case sensitive comparison to string literal.
         bool operator!=(const ptr<string_impl>& rhs) const { return !operator==(rhs); }
@@ -223,50 +549,341 @@ namespace dot
     private: // STATIC
 
         /// Non-template implementation of string.Format.
-        static std::string format_impl(fmt::string_view format_str, fmt::format_args args);
+        static string format_impl(fmt::string_view format_str, fmt::format_args args);
+
+        /// Common implementation of join(...) and concat(list).
+        static string join_impl(std::string_view separator, const list<string>& values);
     };
 
-    /// Create from std::string or string literal using new
-    inline string make_string(const std::string& rhs) { return new string_impl(rhs); }
+    /// Create from std::string, std::string_view or the characters of another string.
+    inline string make_string(std::string_view rhs) { return string_impl::create(rhs); }
 
-    /// Create from std::string or string literal using new
-    inline string make_string(const char* rhs) { return new string_impl(rhs); }
+    /// Create from string literal, null pointer is converted to empty value.
+    inline string make_string(const char* rhs) { return string_impl::create(rhs != nullptr ? std::string_view(rhs) : std::string_view()); }
 
-    /// Returns a string containing characters from lhs followed by the characters from rhs.
-    inline string operator+(const string& lhs, const string& rhs) { return make_string(*lhs + *rhs); }
+    namespace detail
+    {
+        /// True if the byte is a white space character removed by trim, which
+        /// unlike std::isspace does not depend on the locale.
+        inline bool is_string_white_space(char c)
+        {
+            return c == ' ' || (c >= '\t' && c <= '\r');
+        }
+
+        /// Characters of an operand of concatenation, which can be string, string
+        /// literal, std::string or std::string_view. Null string or pointer is
+        /// treated as empty.
+        template <class T>
+        std::string_view concat_view(const T& value)
+        {
+            if constexpr (std::is_same<T, string>::value)
+            {
+                return value != nullptr ? value->view() : std::string_view();
+            }
+            else if constexpr (std::is_convertible<const T&, const char*>::value)
+            {
+                const char* chars = value;
+                return chars != nullptr ? std::string_view(chars) : std::string_view();
+            }
+            else
+            {
+                return std::string_view(value);
+            }
+        }
+
+        /// True if the type is string_concat.
+        template <class T> struct is_string_concat : std::false_type {};
+        template <class L, class R> struct is_string_concat<string_concat<L, R>> : std::true_type {};
+
+        /// Query selectors that concatenate strings produce string elements,
+        /// because string_concat refers to its operands.
+        template <class T> struct query_element;
+        template <class L, class R> struct query_element<string_concat<L, R>> { typedef string type; };
+
+        /// True if the type is string or string_concat, at least one operand
+        /// of operator+ must be of such type for it to create string_concat.
+        template <class T>
+        struct is_concat_string : std::bool_constant<std::is_same<T, string>::value || is_string_concat<T>::value> {};
+
+        /// True if the type can be an operand of operator+ creating string_concat.
+        template <class T>
+        struct is_concat_operand : std::bool_constant<is_concat_string<T>::value || std::is_convertible<const T&, std::string_view>::value> {};
+
+        /// Operand stored by string_concat, which is a pointer to the nested
+        /// expression for string_concat and the characters for all other types.
+        template <class T>
+        auto concat_operand(const T& value)
+        {
+            if constexpr (is_string_concat<T>::value) return &value;
+            else return concat_view(value);
+        }
+
+        /// Number of characters in the operand.
+        inline size_t concat_size(std::string_view value) { return value.size(); }
+
+        /// Number of characters in the nested expression.
+        template <class L, class R>
+        size_t concat_size(const string_concat<L, R>* value) { return value->length(); }
+
+        /// Copy the characters of the operand and return the end of the copied characters.
+        inline char* concat_write(std::string_view value, char* out)
+        {
+            if (!value.empty()) std::memcpy(out, value.data(), value.size());
+            return out + value.size();
+        }
+
+        /// Copy the characters of the nested expression and return the end of the copied characters.
+        template <class L, class R>
+        char* concat_write(const string_concat<L, R>* value, char* out) { return value->write(out); }
+
+        /// Write the characters of the operand to the stream.
+        inline std::ostream& concat_print(std::ostream& stream, std::string_view value) { return stream << value; }
+
+        /// Write the characters of the nested expression to the stream.
+        template <class L, class R>
+        std::ostream& concat_print(std::ostream& stream, const string_concat<L, R>* value) { return value->print(stream); }
+    }
+
+    /// Result of operator+ applied to strings, which holds the operands
+    /// until it is converted to string and creates the result using a
+    /// single allocation, regardless of the number of operands.
+    ///
+    /// The operands are referenced without a copy, so the expression must
+    /// be converted to string before the end of the full expression that
+    /// created it. All methods and conversions apply only to a temporary,
+    /// so that an expression stored using auto, which would outlive its
+    /// operands, cannot be used.
+    ///
+    /// This class does not have a counterpart in C#.
+    template <class L, class R>
+    class [[nodiscard]] string_concat
+    {
+        template <class L2, class R2> friend class string_concat;
+        template <class L2, class R2> friend size_t detail::concat_size(const string_concat<L2, R2>* value);
+        template <class L2, class R2> friend char* detail::concat_write(const string_concat<L2, R2>* value, char* out);
+        template <class L2, class R2> friend std::ostream& detail::concat_print(std::ostream& stream, const string_concat<L2, R2>* value);
+
+    private: // FIELDS
+
+        L lhs_;
+        R rhs_;
+
+    public: // CONSTRUCTORS
+
+        /// Create from the operands returned by detail::concat_operand(...).
+        string_concat(const L& lhs, const R& rhs) : lhs_(lhs), rhs_(rhs) {}
+
+        string_concat(const string_concat&) = delete;
+        string_concat& operator=(const string_concat&) = delete;
+
+    public: // METHODS
+
+        /// Total number of characters in the operands.
+        size_t size() const&& { return length(); }
+
+        /// Create string with the characters of all operands.
+        string to_string() const&& { return concatenate(); }
+
+    public: // OPERATORS
+
+        /// Create string with the characters of all operands.
+        operator string() const&& { return concatenate(); }
+
+        /// Call a method of the string created from the expression.
+        string operator->() const&& { return concatenate(); }
+
+        /// Case sensitive comparison of the string created from the expression.
+        template <class T>
+        bool operator==(const T& rhs) const&& { return concatenate() == rhs; }
+
+        /// Case sensitive comparison of the string created from the expression.
+        template <class T>
+        bool operator!=(const T& rhs) const&& { return concatenate() != rhs; }
+
+        /// Writes the characters of all operands to the stream.
+        friend std::ostream& operator<<(std::ostream& stream, const string_concat&& value) { return value.print(stream); }
+
+    private: // METHODS
+
+        /// Total number of characters in the operands.
+        size_t length() const { return detail::concat_size(lhs_) + detail::concat_size(rhs_); }
+
+        /// Create string with the characters of all operands.
+        string concatenate() const
+        {
+            string_impl* result = string_impl::allocate(length());
+            write(result->chars());
+            return result;
+        }
+
+        /// Copy the characters of all operands and return the end of the copied characters.
+        char* write(char* out) const { return detail::concat_write(rhs_, detail::concat_write(lhs_, out)); }
+
+        /// Write the characters of all operands to the stream.
+        std::ostream& print(std::ostream& stream) const { return detail::concat_print(detail::concat_print(stream, lhs_), rhs_); }
+    };
+
+    /// Returns an expression which creates a string containing characters from lhs
+    /// followed by the characters from rhs when converted to string.
+    ///
+    /// The operands can be string, string literal, std::string, std::string_view
+    /// or another concatenation expression, and at least one of them must be
+    /// string or concatenation expression. Null string is treated as empty.
+    template <class L, class R, class = std::enable_if_t<detail::is_concat_operand<L>::value && detail::is_concat_operand<R>::value
+        && (detail::is_concat_string<L>::value || detail::is_concat_string<R>::value)>>
+    inline auto operator+(const L& lhs, const R& rhs)
+    {
+        typedef decltype(detail::concat_operand(lhs)) lhs_type;
+        typedef decltype(detail::concat_operand(rhs)) rhs_type;
+        return string_concat<lhs_type, rhs_type>(detail::concat_operand(lhs), detail::concat_operand(rhs));
+    }
+
+    template <typename ...Args>
+    string string::concat(const Args& ...values)
+    {
+        size_t length = (size_t(0) + ... + detail::concat_view(values).size());
+        string_impl* result = string_impl::allocate(length);
+        char* out = result->chars();
+        ((out = detail::concat_write(detail::concat_view(values), out)), ...);
+        return result;
+    }
 
     /// Returns a string containing characters from lhs followed by the characters from rhs.
     inline bool operator<(const string& lhs, const string& rhs) { return *lhs < *rhs; }
 
-    /// Helper class for fmt::format arguments conversion
-    template <class T>
+    namespace detail
+    {
+        /// Writes the value as count decimal digits with leading zeros,
+        /// the value must be non-negative and fit into count digits.
+        inline void write_digits(char* buffer, int value, int count)
+        {
+            for (int i = count - 1; i >= 0; --i, value /= 10) buffer[i] = char('0' + value % 10);
+        }
+
+        /// Appends the result of formatting the arguments to the buffer.
+        DOT_CLASS void format_to(fmt::internal::buffer& out, fmt::string_view format_str, fmt::format_args args);
+
+        /// Appends the text to the buffer, applying the format specification
+        /// of a replacement field such as width and alignment if not empty.
+        DOT_CLASS void format_text(fmt::internal::buffer& out, fmt::string_view spec, std::string_view text);
+
+        /// Appends the single argument to the buffer, applying the format
+        /// specification of a replacement field if not empty.
+        DOT_CLASS void format_value(fmt::internal::buffer& out, fmt::string_view spec, fmt::format_args args);
+
+        /// Buffer that receives the output of the formatter, which is the buffer
+        /// of the result when the formatter is called by string::format(...).
+        template <class FormatContext, class Writer>
+        auto format_into(FormatContext& ctx, Writer writer)
+        {
+            if constexpr (std::is_same<typename FormatContext::iterator, std::back_insert_iterator<fmt::internal::buffer>>::value)
+            {
+                writer(fmt::internal::get_container(ctx.out()));
+                return ctx.out();
+            }
+            else
+            {
+                std::string text;
+                fmt::internal::container_buffer<std::string> out(text);
+                writer(out);
+                return std::copy(text.begin(), text.end(), ctx.out());
+            }
+        }
+
+        /// Base of fmt::formatter specializations for dot types, keeps the format
+        /// specification of the replacement field to apply it to the output.
+        ///
+        /// Nested replacement fields such as {0:{1}} are not supported.
+        struct formatter_base
+        {
+            /// Format specification following the colon, empty if none.
+            fmt::string_view spec_;
+
+            /// Stores the format specification up to the closing brace.
+            template <class ParseContext>
+            constexpr auto parse(ParseContext& ctx)
+            {
+                auto begin = ctx.begin();
+                auto end = begin;
+                while (end != ctx.end() && *end != '}')
+                {
+                    if (*end == '{') throw exception("Nested replacement fields are not supported for dot types.");
+                    ++end;
+                }
+                spec_ = fmt::string_view(begin, static_cast<size_t>(end - begin));
+                return end;
+            }
+        };
+
+        /// Reference to a pointer passed to fmt in place of the pointer itself,
+        /// because types such as object convert implicitly to numbers and bool.
+        template <class T>
+        struct ptr_format_arg
+        {
+            /// Pointer to the formatted pointer, valid during the formatting call.
+            const T* value_;
+        };
+    }
+
+    /// Helper class for fmt::format arguments conversion, passes
+    /// the argument to fmt by reference without a copy.
+    template <class T, class = void>
     struct format_forward {
-        static inline auto convert(const T& t) { return t; }
+        static inline const T& convert(const T& t) { return t; }
     };
 
-    /// Helper class for fmt::format arguments conversion
-    template<>
-    struct format_forward<string> {
-        static inline const std::string& convert(const string& s) { return *s; }
+    /// Helper class for fmt::format arguments conversion, passes pointers
+    /// other than string by reference to be written using to_string().
+    template <class T>
+    struct format_forward<T, std::enable_if_t<detail::is_ptr<T>::value && !std::is_same<T, string>::value>> {
+        static inline detail::ptr_format_arg<T> convert(const T& o) { return { &o }; }
     };
 
-    /// Helper class for fmt::format arguments conversion
-    template<class T>
-    struct format_forward<ptr<T>> {
-        static inline std::string convert(const ptr<T>& o) { return *o->to_string(); }
+    template<typename ...Args>
+    string string::format(const string& format_string, const Args& ...args)
+    {
+        return format_impl(fmt::string_view(format_string->data(), format_string->size()), fmt::make_format_args(format_forward<Args>::convert(args)...));
+    }
+}
+
+namespace fmt
+{
+    /// Writes the characters of string without a copy, null string is written as empty.
+    template <>
+    struct formatter<dot::string> : dot::detail::formatter_base
+    {
+        template <class FormatContext>
+        auto format(const dot::string& value, FormatContext& ctx)
+        {
+            std::string_view text = value != nullptr ? value->view() : std::string_view();
+            return dot::detail::format_into(ctx, [&](internal::buffer& out) { dot::detail::format_text(out, spec_, text); });
+        }
     };
 
-    /// Helper class for fmt::format arguments conversion
-    template<class T>
-    struct format_forward<nullable<T>> {
-        static inline T convert(const nullable<T>& o) { return o.value_or_default(); }
+    /// Writes the result of to_string() of the object, null pointer is written as empty.
+    template <class T>
+    struct formatter<dot::detail::ptr_format_arg<T>> : dot::detail::formatter_base
+    {
+        template <class FormatContext>
+        auto format(const dot::detail::ptr_format_arg<T>& arg, FormatContext& ctx)
+        {
+            const T& value = *arg.value_;
+            dot::string text = value != nullptr ? value->to_string() : dot::string();
+            return dot::detail::format_into(ctx, [&](internal::buffer& out) { dot::detail::format_text(out, spec_, text != nullptr ? text->view() : std::string_view()); });
+        }
     };
 
-    template<typename ...Args>
-    string string::format(const string& format_string, const Args& ...args)
+    /// Writes the value, or the default value of T if empty, using the format specification for T.
+    template <class T>
+    struct formatter<dot::nullable<T>> : dot::detail::formatter_base
     {
-        return format_impl(*format_string, fmt::make_format_args(format_forward<Args>::convert(args)...));
-    }
+        template <class FormatContext>
+        auto format(const dot::nullable<T>& value, FormatContext& ctx)
+        {
+            T v = value.value_or_default();
+            return dot::detail::format_into(ctx, [&](internal::buffer& out) { dot::detail::format_value(out, spec_, make_format_args(dot::format_forward<T>::convert(v))); });
+        }
+    };
 }
 
 namespace std
@@ -278,6 +895,11 @@ namespace std
 
     /// Implements equal_to struct used by STL unordered_map for string.
     template <>
-    struct equal_to<dot::string> : public equal_to<dot::ptr<dot::string_impl>>
-    {};
+    struct equal_to<dot::string>
+    {
+        bool operator()(const dot::string& lhs, const dot::string& rhs) const
+        {
+            return lhs == rhs;
+        }
+    };
 }
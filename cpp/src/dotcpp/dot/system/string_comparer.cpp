@@ -0,0 +1,142 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/precompiled.hpp>
+#include <dot/implement.hpp>
+#include <dot/system/string_comparer.hpp>
+#include <dot/detail/string_kernels.hpp>
+
+namespace dot
+{
+    namespace
+    {
+        /// Initial state of the case-insensitive hash.
+        const std::uint64_t hash_seed = 0x243F6A8885A308D3ull;
+
+        /// Mix the length into the hash state, so that strings which differ
+        /// only by trailing zero bytes have different hash codes.
+        size_t finish_hash(std::uint64_t state, size_t length)
+        {
+            state = (state ^ length) * 0x9E3779B97F4A7C15ull;
+            return static_cast<size_t>(state ^ (state >> 29));
+        }
+
+        /// Compare the UTF-16 code units converted to uppercase.
+        int compare_upper_utf16(const string_impl& lhs, const string_impl& rhs)
+        {
+            detail::utf16_range lhs_range = lhs.utf16();
+            detail::utf16_range rhs_range = rhs.utf16();
+            detail::utf16_iterator lhs_iter = lhs_range.begin(), lhs_end = lhs_range.end();
+            detail::utf16_iterator rhs_iter = rhs_range.begin(), rhs_end = rhs_range.end();
+            for (; lhs_iter != lhs_end && rhs_iter != rhs_end; ++lhs_iter, ++rhs_iter)
+            {
+                Char a = *lhs_iter;
+                Char b = *rhs_iter;
+                if (a == b) continue;
+
+                int result = Char::to_upper(a).compare_to(Char::to_upper(b));
+                if (result != 0) return result;
+            }
+            if (lhs_iter != lhs_end) return 1;
+            if (rhs_iter != rhs_end) return -1;
+            return 0;
+        }
+    }
+
+    bool string_comparer::ordinal::equals(const string& lhs, const string& rhs)
+    {
+        if (lhs == nullptr || rhs == nullptr) return lhs == nullptr && rhs == nullptr;
+        return lhs->equals(*rhs);
+    }
+
+    size_t string_comparer::ordinal::hash_code(const string& value)
+    {
+        return value != nullptr ? value->hash_code() : 0;
+    }
+
+    int string_comparer::ordinal::compare(const string& lhs, const string& rhs)
+    {
+        if (lhs == nullptr || rhs == nullptr) return (lhs != nullptr) - (rhs != nullptr);
+        return lhs->compare_to(rhs);
+    }
+
+    bool string_comparer::ordinal_ignore_case::equals(const string& lhs, const string& rhs)
+    {
+        if (lhs == nullptr || rhs == nullptr) return lhs == nullptr && rhs == nullptr;
+
+        // Bytes that are equal ignoring the case of ASCII letters decode to
+        // characters that are equal ignoring case, whatever the encoding
+        if (lhs->length() == rhs->length() && detail::find_mismatch_ignore_case_ascii(lhs->data(), rhs->data(), lhs->length()) == std::string_view::npos) return true;
+        if (lhs->is_ascii() && rhs->is_ascii()) return false;
+
+        return compare_upper_utf16(*lhs, *rhs) == 0;
+    }
+
+    size_t string_comparer::ordinal_ignore_case::hash_code(const string& value)
+    {
+        if (value == nullptr) return 0;
+        if (value->is_ascii()) return finish_hash(detail::hash_upper_ascii(value->data(), value->length(), hash_seed), value->length());
+
+        // Hash the UTF-8 encoding of the characters converted to uppercase,
+        // which is the same as the bytes converted by the kernel for ASCII,
+        // writing it to a buffer passed to the kernel in parts of 32 bytes
+        char buffer[40];
+        size_t buffered = 0;
+        size_t length = 0;
+        std::uint64_t state = hash_seed;
+        const char* p = value->data();
+        const char* end = p + value->length();
+        while (p < end)
+        {
+            int size;
+            char32_t code_point = detail::decode_utf8(p, end, size);
+            p += size;
+            if (code_point < 0x10000) code_point = Char::to_upper(char16_t(code_point));
+            buffered += detail::encode_utf8(code_point, buffer + buffered);
+
+            if (buffered >= 32)
+            {
+                state = detail::hash_upper_ascii(buffer, 32, state);
+                std::memmove(buffer, buffer + 32, buffered - 32);
+                buffered -= 32;
+                length += 32;
+            }
+        }
+        state = detail::hash_upper_ascii(buffer, buffered, state);
+        return finish_hash(state, length + buffered);
+    }
+
+    int string_comparer::ordinal_ignore_case::compare(const string& lhs, const string& rhs)
+    {
+        if (lhs == nullptr || rhs == nullptr) return (lhs != nullptr) - (rhs != nullptr);
+
+        if (lhs->is_ascii() && rhs->is_ascii())
+        {
+            size_t size = std::min(lhs->length(), rhs->length());
+            size_t pos = detail::find_mismatch_ignore_case_ascii(lhs->data(), rhs->data(), size);
+            if (pos != std::string_view::npos) return Char::to_upper(lhs->data()[pos]).compare_to(Char::to_upper(rhs->data()[pos]));
+            return (lhs->length() > size) - (rhs->length() > size);
+        }
+        return compare_upper_utf16(*lhs, *rhs);
+    }
+}
@@ -0,0 +1,100 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+#include <dot/system/string.hpp>
+
+namespace dot
+{
+    /// Represents a string comparison operation that uses specific case rules.
+    ///
+    /// The comparers are stateless types rather than objects, so that they can
+    /// be used as both the hash and the equality template arguments of
+    /// dictionary and hash_set, or of the standard unordered containers:
+    ///
+    /// \code
+    /// auto symbols = make_dictionary<string, int, string_comparer::ordinal_ignore_case, string_comparer::ordinal_ignore_case>();
+    /// \endcode
+    ///
+    /// Null strings are equal to each other and precede all other strings.
+    class DOT_CLASS string_comparer final
+    {
+    private: // CONSTRUCTORS
+
+        string_comparer() = delete;
+
+    public: // COMPARERS
+
+        /// Compares strings by the bytes of their UTF-8 representation.
+        ///
+        /// The hash code is the one cached by the string.
+        struct DOT_CLASS ordinal
+        {
+            /// Indicates whether two strings are equal.
+            static bool equals(const string& lhs, const string& rhs);
+
+            /// Returns the hash code for the string, or zero for a null string.
+            static size_t hash_code(const string& value);
+
+            /// Compares two strings and returns a negative number, zero, or a
+            /// positive number if lhs precedes, equals or follows rhs.
+            static int compare(const string& lhs, const string& rhs);
+
+            /// Returns the hash code for the string.
+            size_t operator()(const string& value) const { return hash_code(value); }
+
+            /// Indicates whether two strings are equal.
+            bool operator()(const string& lhs, const string& rhs) const { return equals(lhs, rhs); }
+        };
+
+        /// Compares strings by their UTF-16 code units converted to uppercase
+        /// using the simple case mappings of Char::to_upper(...), as
+        /// System.StringComparer.OrdinalIgnoreCase does.
+        ///
+        /// The strings are compared and hashed in place without creating a
+        /// converted copy. Strings that contain only ASCII characters, see
+        /// string_impl::is_ascii(), are converted by vector kernels; other
+        /// strings are decoded one character at a time.
+        struct DOT_CLASS ordinal_ignore_case
+        {
+            /// Indicates whether two strings are equal ignoring case.
+            static bool equals(const string& lhs, const string& rhs);
+
+            /// Returns the hash code for the string that is the same for all
+            /// strings that are equal ignoring case, or zero for a null string.
+            static size_t hash_code(const string& value);
+
+            /// Compares two strings ignoring case and returns a negative number,
+            /// zero, or a positive number if lhs precedes, equals or follows rhs.
+            static int compare(const string& lhs, const string& rhs);
+
+            /// Returns the hash code for the string.
+            size_t operator()(const string& value) const { return hash_code(value); }
+
+            /// Indicates whether two strings are equal ignoring case.
+            bool operator()(const string& lhs, const string& rhs) const { return equals(lhs, rhs); }
+        };
+    };
+}
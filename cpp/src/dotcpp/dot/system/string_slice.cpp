@@ -0,0 +1,85 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/precompiled.hpp>
+#include <dot/implement.hpp>
+#include <dot/system/string_slice.hpp>
+#include <dot/system/exception.hpp>
+
+namespace dot
+{
+    string_slice::string_slice(const string& parent, size_t start_index, size_t length)
+        : parent_(parent)
+    {
+        size_t parent_length = parent != nullptr ? parent->length() : 0;
+        if (start_index > parent_length || length > parent_length - start_index)
+            throw exception("Slice is outside the string.");
+        if (parent != nullptr) view_ = parent->view().substr(start_index, length);
+    }
+
+    string_slice string_slice::slice(size_t start_index, size_t length) const
+    {
+        if (start_index > view_.size()) throw exception("Slice is outside the string.");
+        if (length == npos) length = view_.size() - start_index;
+        else if (length > view_.size() - start_index) throw exception("Slice is outside the string.");
+
+        string_slice result;
+        result.parent_ = parent_;
+        result.view_ = view_.substr(start_index, length);
+        return result;
+    }
+
+    string_slice string_slice::trim() const
+    {
+        size_t first = 0;
+        size_t last = view_.size();
+        while (first < last && detail::is_string_white_space(view_[first])) ++first;
+        while (last > first && detail::is_string_white_space(view_[last - 1])) --last;
+        return slice(first, last - first);
+    }
+
+    string_slice string_slice::take_token(char separator)
+    {
+        size_t pos = view_.find(separator);
+        string_slice result;
+        result.parent_ = parent_;
+        if (pos == npos)
+        {
+            result.view_ = view_;
+            view_ = view_.substr(view_.size());
+        }
+        else
+        {
+            result.view_ = view_.substr(0, pos);
+            view_ = view_.substr(pos + 1);
+        }
+        return result;
+    }
+
+    string string_slice::materialize() const
+    {
+        if (parent_ == nullptr) return make_string("");
+        if (view_.size() == parent_->length()) return parent_;
+        return make_string(view_);
+    }
+}
@@ -0,0 +1,201 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+#include <dot/system/string.hpp>
+
+namespace dot
+{
+    /// Read-only range of characters of a string that shares the
+    /// storage of its parent instead of copying the characters.
+    ///
+    /// The slice holds a reference to the parent string, so the parent
+    /// remains alive for as long as the slice or any slice created from
+    /// it. Creating, copying and trimming a slice never allocates memory,
+    /// which makes it suitable for tokenizing fixed-width and delimited
+    /// text. Use materialize() to obtain a string that no longer refers
+    /// to the parent when a small slice is kept after a large parent
+    /// would otherwise be released.
+    ///
+    /// This class does not have a counterpart in C#.
+    class DOT_CLASS string_slice
+    {
+        typedef string_slice self;
+
+    public: // TYPEDEF
+
+        typedef char value_type;
+        typedef size_t size_type;
+        typedef const char* const_iterator;
+        typedef const char* iterator;
+
+    public: // CONSTANTS
+
+        /// Value returned by find methods when nothing is found.
+        static constexpr size_t npos = std::string_view::npos;
+
+    private: // FIELDS
+
+        /// String whose storage is shared, or null for an empty slice.
+        string parent_;
+
+        /// Characters of the slice within the parent.
+        std::string_view view_;
+
+    public: // CONSTRUCTORS
+
+        /// Create empty slice that does not refer to a string.
+        string_slice() = default;
+
+        /// Create slice of all characters of the string.
+        ///
+        /// Null string is converted to empty slice.
+        string_slice(const string& parent)
+            : parent_(parent)
+            , view_(parent != nullptr ? parent->view() : std::string_view())
+        {}
+
+        /// Create slice of the specified range of characters of the string.
+        ///
+        /// Error if the range is outside the string.
+        string_slice(const string& parent, size_t start_index, size_t length);
+
+    public: // METHODS
+
+        /// String whose storage is shared, or null for an empty slice
+        /// created without a string.
+        const string& parent() const noexcept { return parent_; }
+
+        /// Position of the first character of the slice within the parent.
+        size_t offset() const noexcept { return parent_ != nullptr ? size_t(view_.data() - parent_->data()) : 0; }
+
+        /// Number of bytes in the UTF-8 representation.
+        size_t size() const noexcept { return view_.size(); }
+
+        /// Number of bytes in the UTF-8 representation.
+        size_t length() const noexcept { return view_.size(); }
+
+        /// True if the slice has no characters.
+        bool empty() const noexcept { return view_.empty(); }
+
+        /// Pointer to the characters, not followed by a null character
+        /// unless the slice ends at the end of the parent.
+        const char* data() const noexcept { return view_.data(); }
+
+        /// Iterator to the first byte.
+        const_iterator begin() const noexcept { return view_.data(); }
+
+        /// Iterator past the last byte.
+        const_iterator end() const noexcept { return view_.data() + view_.size(); }
+
+        /// Characters of the slice, valid while the slice or its parent is alive.
+        std::string_view view() const noexcept { return view_; }
+
+        /// Slice of the specified range of characters of this slice,
+        /// sharing the same parent.
+        ///
+        /// Error if the range is outside this slice.
+        string_slice slice(size_t start_index, size_t length = npos) const;
+
+        /// Position of the first occurrence of value at or after pos, or npos.
+        size_t find(std::string_view value, size_t pos = 0) const noexcept { return view_.find(value, pos); }
+
+        /// Position of the first occurrence of value at or after pos, or npos.
+        size_t find(char value, size_t pos = 0) const noexcept { return view_.find(value, pos); }
+
+        /// True if the slice begins with the specified characters.
+        bool starts_with(std::string_view value) const noexcept { return view_.substr(0, value.size()) == value; }
+
+        /// True if the slice ends with the specified characters.
+        bool ends_with(std::string_view value) const noexcept { return view_.size() >= value.size() && view_.substr(view_.size() - value.size()) == value; }
+
+        /// Slice without the leading and trailing white space characters.
+        string_slice trim() const;
+
+        /// Returns the characters before the first occurrence of the separator
+        /// and removes them together with the separator from this slice. If
+        /// the separator does not occur, returns the entire slice and leaves
+        /// this slice empty.
+        ///
+        /// Calling this method until the slice is empty enumerates the fields
+        /// of delimited text without allocating memory. Because the separator
+        /// is removed together with the token, a separator at the end of the
+        /// text does not produce an empty last field.
+        string_slice take_token(char separator);
+
+        /// String with the characters of the slice that does not refer to the parent,
+        /// except when the slice covers the entire parent and the parent is returned.
+        ///
+        /// Returns empty string for an empty slice.
+        string materialize() const;
+
+    public: // CONVERSIONS
+
+        /// Characters of the slice without a copy.
+        operator std::string_view() const noexcept { return view_; }
+
+    public: // OPERATORS
+
+        /// Byte at the specified position, not checked.
+        char operator[](size_t index) const noexcept { return view_[index]; }
+
+        /// Case sensitive comparison of bytes.
+        friend bool operator==(const string_slice& lhs, const string_slice& rhs) noexcept { return lhs.view_ == rhs.view_; }
+
+        /// Case sensitive comparison of bytes.
+        friend bool operator!=(const string_slice& lhs, const string_slice& rhs) noexcept { return lhs.view_ != rhs.view_; }
+
+        /// Case sensitive comparison of bytes.
+        friend bool operator==(const string_slice& lhs, std::string_view rhs) noexcept { return lhs.view_ == rhs; }
+
+        /// Case sensitive comparison of bytes.
+        friend bool operator!=(const string_slice& lhs, std::string_view rhs) noexcept { return lhs.view_ != rhs; }
+
+        /// Case sensitive comparison of bytes, a slice is never equal to null.
+        friend bool operator==(const string_slice& lhs, const char* rhs) noexcept { return rhs != nullptr && lhs.view_ == rhs; }
+
+        /// Case sensitive comparison of bytes, a slice is never equal to null.
+        friend bool operator!=(const string_slice& lhs, const char* rhs) noexcept { return !(lhs == rhs); }
+
+        /// Ordinal comparison of bytes.
+        friend bool operator<(const string_slice& lhs, const string_slice& rhs) noexcept { return lhs.view_ < rhs.view_; }
+
+        /// Writes the characters to the stream.
+        friend std::ostream& operator<<(std::ostream& stream, const string_slice& value) { return stream << value.view_; }
+    };
+}
+
+namespace std
+{
+    /// Implements hash struct used by STL unordered_map for string_slice.
+    template <>
+    struct hash<dot::string_slice>
+    {
+        size_t operator()(const dot::string_slice& value) const
+        {
+            return hash<string_view>()(value.view());
+        }
+    };
+}
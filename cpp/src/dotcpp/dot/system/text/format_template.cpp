@@ -0,0 +1,153 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/precompiled.hpp>
+#define FMT_HEADER_ONLY
+#include <fmt/format.h>
+#include <dot/implement.hpp>
+#include <dot/system/text/format_template.hpp>
+#include <dot/system/exception.hpp>
+
+namespace dot
+{
+    format_template_impl::format_template_impl(const string& format)
+        : format_(format)
+    {
+        if (format == nullptr) throw exception("Format string is null.");
+
+        std::string_view input = format->view();
+        int next_auto_index = 0;
+        bool has_auto_index = false;
+        bool has_manual_index = false;
+
+        // Appends text to the last segment if it is text, otherwise starts a new text segment
+        auto add_text = [this](std::string_view text)
+        {
+            if (text.empty()) return;
+            if (segments_.empty() || segments_.back().arg_index_ != -1) segments_.push_back({ text_.size(), 0, -1, false });
+            text_.append(text);
+            segments_.back().length_ += text.size();
+        };
+
+        size_t pos = 0;
+        while (pos < input.size())
+        {
+            size_t brace = input.find_first_of("{}", pos);
+            if (brace == std::string_view::npos)
+            {
+                add_text(input.substr(pos));
+                break;
+            }
+            add_text(input.substr(pos, brace - pos));
+
+            // Escaped brace
+            if (brace + 1 < input.size() && input[brace + 1] == input[brace])
+            {
+                add_text(input.substr(brace, 1));
+                pos = brace + 2;
+                continue;
+            }
+            if (input[brace] == '}') throw exception("Unmatched '}' in format string.");
+
+            size_t close = input.find('}', brace);
+            if (close == std::string_view::npos) throw exception("Unmatched '{' in format string.");
+            std::string_view field = input.substr(brace + 1, close - brace - 1);
+            if (field.find('{') != std::string_view::npos) throw exception("Nested replacement fields are not supported by format_template.");
+
+            // Argument index followed by optional format specification
+            size_t colon = field.find(':');
+            std::string_view index_text = field.substr(0, colon);
+            int arg_index = 0;
+            if (index_text.empty())
+            {
+                arg_index = next_auto_index++;
+                has_auto_index = true;
+            }
+            else
+            {
+                for (char c : index_text)
+                {
+                    if (c < '0' || c > '9') throw exception("Argument index in format string must be a number.");
+                    arg_index = arg_index * 10 + (c - '0');
+                    if (arg_index >= argument_index_limit) throw exception("Argument index in format string must be less than 1000000.");
+                }
+                has_manual_index = true;
+            }
+            if (has_auto_index && has_manual_index) throw exception("Format string cannot mix automatic and manual argument indexing.");
+            minimum_argument_count_ = std::max(minimum_argument_count_, arg_index + 1);
+
+            // Replacement field with explicit index, used when it has a format specification
+            bool has_spec = colon != std::string_view::npos;
+            segment s = { text_.size(), 0, arg_index, has_spec };
+            if (has_spec)
+            {
+                text_ += '{';
+                text_ += std::to_string(arg_index);
+                text_.append(field.substr(colon));
+                text_ += '}';
+                s.length_ = text_.size() - s.offset_;
+            }
+            segments_.push_back(s);
+            pos = close + 1;
+        }
+    }
+
+    string format_template_impl::format_impl(fmt::format_args args, size_t arg_count) const
+    {
+        fmt::memory_buffer buffer;
+        format_to_impl(buffer, args, arg_count);
+        return make_string(std::string_view(buffer.data(), buffer.size()));
+    }
+
+    void format_template_impl::format_to_impl(fmt::internal::buffer& out, fmt::format_args args, size_t arg_count) const
+    {
+        if (arg_count < size_t(minimum_argument_count_))
+            throw exception("Format string requires more arguments than were passed.");
+
+        // Context without format string, used to format arguments
+        // that have no format specification the same way as fmt does
+        // for an empty replacement field
+        typedef fmt::back_insert_range<fmt::internal::buffer> range;
+        fmt::format_context context(range(out).begin(), fmt::string_view(), args);
+
+        const char* text = text_.data();
+        for (const segment& s : segments_)
+        {
+            if (s.arg_index_ == -1)
+            {
+                out.append(text + s.offset_, text + s.offset_ + s.length_);
+            }
+            else if (s.has_spec_)
+            {
+                fmt::vformat_to(out, fmt::string_view(text + s.offset_, s.length_), args);
+            }
+            else
+            {
+                fmt::basic_format_arg<fmt::format_context> arg = args.get(s.arg_index_);
+                fmt::internal::custom_formatter<char, fmt::format_context> custom(context);
+                if (!fmt::visit_format_arg(custom, arg))
+                    fmt::visit_format_arg(fmt::arg_formatter<range>(context), arg);
+            }
+        }
+    }
+}
@@ -0,0 +1,144 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <dot/declare.hpp>
+#include <fmt/core.h>
+#include <dot/system/string.hpp>
+
+namespace dot
+{
+    class format_template_impl; using format_template = ptr<format_template_impl>;
+
+    /// Composite format string that is parsed once and can then be used
+    /// to format arguments repeatedly without parsing it again.
+    ///
+    /// The format string uses the same syntax as string::format(...).
+    /// Text between replacement fields is unescaped and copied into the
+    /// output without scanning it, and replacement fields without format
+    /// specification are formatted without parsing. Errors in the format
+    /// string are reported when the template is created rather than when
+    /// it is used.
+    ///
+    /// Similar to System.Text.CompositeFormat.
+    class DOT_CLASS format_template_impl final : public virtual object_impl
+    {
+        typedef format_template_impl self;
+        friend format_template make_format_template(const string& format);
+
+    public: // CONSTANTS
+
+        /// Argument indices must be less than this limit, the same as in C#.
+        static constexpr int argument_index_limit = 1000000;
+
+    private: // FIELDS
+
+        /// Part of the format string, either text copied into the output
+        /// or a replacement field.
+        struct segment
+        {
+            /// Position of the text or the replacement field in text_.
+            size_t offset_;
+
+            /// Length of the text or the replacement field in text_.
+            size_t length_;
+
+            /// Index of the argument, or -1 for text.
+            int arg_index_;
+
+            /// True if the replacement field has a format specification
+            /// and is formatted by parsing the field stored in text_.
+            bool has_spec_;
+        };
+
+        /// The format string passed to make_format_template(...).
+        string format_;
+
+        /// Unescaped text and replacement fields with explicit argument indices.
+        std::string text_;
+
+        /// Parts of the format string in order.
+        std::vector<segment> segments_;
+
+        /// One more than the largest argument index used by the format string.
+        int minimum_argument_count_ = 0;
+
+    private: // CONSTRUCTORS
+
+        /// Parses the format string, error if it is not valid.
+        ///
+        /// This constructor is private. Use make_format_template(...) function instead.
+        explicit format_template_impl(const string& format);
+
+    public: // PROPERTIES
+
+        /// The format string from which this instance was created.
+        string format_string() const { return format_; }
+
+        /// The minimum number of arguments that must be passed to a formatting
+        /// operation using this instance.
+        int minimum_argument_count() const { return minimum_argument_count_; }
+
+    public: // METHODS
+
+        /// Replaces the replacement fields with the string representation of the arguments.
+        ///
+        /// Error if fewer than minimum_argument_count() arguments are passed.
+        template <typename ...Args>
+        string format(const Args& ...args) const
+        {
+            return format_impl(fmt::make_format_args(format_forward<Args>::convert(args)...), sizeof...(Args));
+        }
+
+        /// Appends the result of replacing the replacement fields with the
+        /// string representation of the arguments to the buffer.
+        ///
+        /// Error if fewer than minimum_argument_count() arguments are passed.
+        template <typename ...Args>
+        void format_to(fmt::internal::buffer& out, const Args& ...args) const
+        {
+            format_to_impl(out, fmt::make_format_args(format_forward<Args>::convert(args)...), sizeof...(Args));
+        }
+
+        /// The format string from which this instance was created.
+        virtual string to_string() override { return format_; }
+
+    private: // METHODS
+
+        /// Non-template implementation of format(...).
+        string format_impl(fmt::format_args args, size_t arg_count) const;
+
+        /// Non-template implementation of format_to(...).
+        void format_to_impl(fmt::internal::buffer& out, fmt::format_args args, size_t arg_count) const;
+    };
+
+    /// Parses the format string once for repeated use, error if it is not valid.
+    inline format_template make_format_template(const string& format) { return new format_template_impl(format); }
+
+    template<typename ...Args>
+    string string::format(const format_template& compiled_format, const Args& ...args)
+    {
+        return compiled_format->format(args...);
+    }
+}
@@ -0,0 +1,183 @@
+﻿/*
+Copyright (C) 2015-present The DotCpp Authors.
+
+This file is part of .C++, a native C++ implementation of
+popular .NET class library APIs developed to facilitate
+code reuse between C# and C++.
+
+    http://github.com/dotcpp/dotcpp (source)
+    http://dotcpp.org (documentation)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <dot/precompiled.hpp>
+#include <dot/implement.hpp>
+#include <dot/system/text/string_builder.hpp>
+#include <dot/system/exception.hpp>
+
+namespace dot
+{
+    namespace detail
+    {
+        string_builder_buffer::string_builder_buffer(string_builder_impl& builder)
+            : builder_(builder)
+        {
+            if (builder_.chunks_.empty()) builder_.add_chunk(string_builder_impl::default_capacity_);
+            set(builder_.free_begin(), builder_.free_size());
+        }
+
+        void string_builder_buffer::commit()
+        {
+            builder_.commit(size());
+        }
+
+        void string_builder_buffer::grow(std::size_t capacity)
+        {
+            builder_.add_chunk(capacity, data(), size());
+            set(builder_.free_begin(), builder_.free_size());
+        }
+    }
+
+    int string_builder_impl::capacity() const
+    {
+        return static_cast<int>(length_ + free_size());
+    }
+
+    string string_builder_impl::to_string()
+    {
+        string_impl* result = string_impl::allocate(length_);
+        char* out = result->chars();
+        for (const chunk& c : chunks_)
+        {
+            if (c.size_ > 0) std::memcpy(out, c.storage_->data(), c.size_);
+            out += c.size_;
+        }
+        return result;
+    }
+
+    string string_builder_impl::move_to_string()
+    {
+        string result;
+        if (chunks_.size() == 1 && chunks_.front().size_ * 2 >= chunks_.front().storage_->length_)
+        {
+            // Shrink the storage to the used part, the memory after the terminator is not used
+            chunk& c = chunks_.front();
+            string_impl* storage = &*c.storage_;
+            storage->length_ = c.size_;
+            storage->chars()[c.size_] = 0;
+            result = c.storage_;
+        }
+        else
+        {
+            result = to_string();
+        }
+
+        chunks_.clear();
+        length_ = 0;
+        reset_free_space();
+        return result;
+    }
+
+    int string_builder_impl::ensure_capacity(int capacity)
+    {
+        if (capacity < 0) throw exception("Capacity must not be negative.");
+
+        size_t required = static_cast<size_t>(capacity);
+        if (length_ == 0)
+        {
+            // Storage of the exact capacity, so that move_to_string() does not copy
+            if (required > 0 && (chunks_.empty() || chunks_.back().storage_->length_ < required))
+            {
+                chunks_.clear();
+                chunks_.push_back(chunk{ string_impl::allocate(required), 0 });
+                reset_free_space();
+            }
+        }
+        else if (length_ + free_size() < required)
+        {
+            add_chunk(required - length_);
+        }
+        return this->capacity();
+    }
+
+    void string_builder_impl::append_chunked(std::string_view value)
+    {
+        const char* source = value.data();
+        size_t size = value.size();
+
+        size_t available = free_size();
+        if (available > 0)
+        {
+            size_t count = std::min(available, size);
+            std::memcpy(free_begin(), source, count);
+            commit(count);
+            source += count;
+            size -= count;
+        }
+
+        if (size > 0)
+        {
+            add_chunk(size);
+            std::memcpy(free_begin(), source, size);
+            commit(size);
+        }
+    }
+
+    void string_builder_impl::clear()
+    {
+        if (chunks_.size() > 1) chunks_.erase(chunks_.begin(), chunks_.end() - 1);
+        if (!chunks_.empty()) chunks_.back().size_ = 0;
+        length_ = 0;
+        reset_free_space();
+    }
+
+    std::ostream& operator<<(std::ostream& stream, const string_builder_impl& value)
+    {
+        for (const string_builder_impl::chunk& c : value.chunks_)
+        {
+            stream.write(c.storage_->data(), static_cast<std::streamsize>(c.size_));
+        }
+        return stream;
+    }
+
+    void string_builder_impl::reset_free_space()
+    {
+        if (chunks_.empty())
+        {
+            cursor_ = nullptr;
+            limit_ = nullptr;
+        }
+        else
+        {
+            chunk& last = chunks_.back();
+            cursor_ = last.storage_->chars() + last.size_;
+            limit_ = last.storage_->chars() + last.storage_->length_;
+        }
+    }
+
+    void string_builder_impl::add_chunk(size_t capacity, const char* source, size_t size)
+    {
+        // Each chunk doubles the capacity until it reaches the maximum
+        size_t growth = std::min(std::max(length_, default_capacity_), max_chunk_capacity_);
+        capacity = std::max(capacity, growth);
+
+        string storage = string_impl::allocate(capacity);
+        if (size > 0) std::memcpy(storage->chars(), source, size);
+
+        // The source may be the free space of the last chunk, so it is replaced after the copy
+        if (!chunks_.empty() && chunks_.back().size_ == 0) chunks_.back() = chunk{ storage, 0 };
+        else chunks_.push_back(chunk{ storage, 0 });
+        reset_free_space();
+    }
+}
@@ -24,19 +24,98 @@ limitations under the License.
 #pragma once
 
 #include <dot/declare.hpp>
+#include <charconv>
 #include <fmt/core.h>
 #include <dot/system/string.hpp>
 #include <dot/system/environment.hpp>
+#include <dot/system/text/format_template.hpp>
 
 namespace dot
 {
     class string_builder_impl; using string_builder = ptr<string_builder_impl>;
 
+    namespace detail
+    {
+        /// Output buffer of fmt that writes directly into the free space
+        /// of the last chunk of string_builder. If the output does not fit,
+        /// the part written so far is moved to a new chunk large enough
+        /// for the requested capacity.
+        class DOT_CLASS string_builder_buffer final : public fmt::internal::buffer
+        {
+            string_builder_impl& builder_;
+
+        public: // CONSTRUCTORS
+
+            /// Create buffer over the free space of the builder.
+            explicit string_builder_buffer(string_builder_impl& builder);
+
+        public: // METHODS
+
+            /// Add the characters written to the buffer to the length of the builder.
+            /// Characters are discarded if the buffer is destroyed without commit.
+            void commit();
+
+        protected: // METHODS
+
+            /// Move the characters written so far to a new chunk with at least the specified capacity.
+            virtual void grow(std::size_t capacity) override;
+        };
+    }
+
     /// Builds a string incrementally.
-    class string_builder_impl final : public virtual object_impl, public std::string
+    ///
+    /// Characters are stored in a list of chunks rather than in a single
+    /// buffer, so that appending never copies the characters appended
+    /// before. Each new chunk has the capacity equal to the current length
+    /// up to max_chunk_capacity_, so the number of chunks grows as the
+    /// logarithm of the length for small strings and linearly for large
+    /// ones. Values are formatted by fmt directly into the free space of
+    /// the last chunk without creating temporary strings.
+    ///
+    /// to_string() copies the chunks into a new string once. move_to_string()
+    /// hands over the chunk as the string without copying when the content
+    /// fits into a single chunk, which can be ensured by specifying the
+    /// expected length in make_string_builder(capacity) or ensure_capacity(...).
+    class DOT_CLASS string_builder_impl final : public virtual object_impl
     {
-        typedef std::string base;
+        typedef string_builder_impl self;
         friend string_builder make_string_builder();
+        friend string_builder make_string_builder(int capacity);
+        friend class detail::string_builder_buffer;
+
+    private: // CONSTANTS
+
+        /// Capacity of the first chunk when the capacity is not specified.
+        static constexpr size_t default_capacity_ = 16;
+
+        /// Maximum capacity of chunks allocated as the builder grows. A larger
+        /// chunk is only allocated when a single value does not fit into it.
+        static constexpr size_t max_chunk_capacity_ = 1 << 20;
+
+    private: // FIELDS
+
+        /// Part of the characters, stored in a string whose length is the
+        /// capacity of the chunk and whose first size_ characters are used.
+        struct chunk
+        {
+            /// Storage of the chunk, referenced only by the builder.
+            string storage_;
+
+            /// Number of characters used.
+            size_t size_;
+        };
+
+        /// Chunks in order, only the last one has free space.
+        std::vector<chunk> chunks_;
+
+        /// Total number of characters in all chunks.
+        size_t length_ = 0;
+
+        /// Beginning of the free space of the last chunk.
+        char* cursor_ = nullptr;
+
+        /// End of the free space of the last chunk.
+        char* limit_ = nullptr;
 
     private: // CONSTRUCTORS
 
@@ -46,16 +125,38 @@ namespace dot
         /// function with matching signature instead.
         string_builder_impl() = default;
 
+    public: // PROPERTIES
+
+        /// Gets the length of the current string_builder object.
+        int length() const { return static_cast<int>(length_); }
+
+        /// Gets the maximum number of characters that can be contained in the memory
+        /// allocated by the current instance without allocating another chunk.
+        int capacity() const;
+
     public: // METHODS
 
         /// A string representing the current type.
-        virtual string to_string() override
-        {
-            // Returns a copy of the string, not a reference to the same string
-            // Further changes to string_builder will not affect the previously
-            // returned string.
-            return make_string(*this);
-        }
+        ///
+        /// Returns a copy of the characters. Further changes to
+        /// string_builder will not affect the previously returned string.
+        virtual string to_string() override;
+
+        /// Returns the characters as a string and clears this instance.
+        ///
+        /// If the characters are stored in a single chunk that is at least half
+        /// full, the chunk is returned as the string without copying the characters
+        /// and the builder no longer holds memory. Otherwise the characters are
+        /// copied as in to_string().
+        ///
+        /// This method does not have a counterpart in C#.
+        string move_to_string();
+
+        /// Ensures that the capacity of this instance is at least the specified value.
+        ///
+        /// If the builder is empty, its storage is replaced by a single chunk
+        /// of the specified capacity, otherwise a chunk is added for the rest.
+        int ensure_capacity(int capacity);
 
         /// Appends the string returned by processing a composite format string, which contains
         /// zero or more format items, to this instance. Each format item is replaced by the
@@ -63,38 +164,158 @@ namespace dot
         template <typename First, typename ...Args>
         void append_format(const string& format, const First& f, const Args& ...args)
         {
-            *this += *string::format(format, f, args...);
+            detail::string_builder_buffer out(*this);
+            detail::format_to(out, fmt::string_view(format->data(), format->size()), fmt::make_format_args(format_forward<First>::convert(f), format_forward<Args>::convert(args)...));
+            out.commit();
+        }
+
+        /// Appends the string returned by processing a composite format string parsed
+        /// by make_format_template(...), which contains zero or more format items, to
+        /// this instance. Each format item is replaced by the string representation
+        /// of a corresponding object argument.
+        template <typename ...Args>
+        void append_format(const format_template& format, const Args& ...args)
+        {
+            detail::string_builder_buffer out(*this);
+            format->format_to(out, args...);
+            out.commit();
         }
 
         /// Appends the string representation of a specified object to this instance.
+        ///
+        /// Strings, characters, integers and string concatenations are copied
+        /// directly, other values are formatted by fmt into the free space of
+        /// the last chunk.
         template <typename T>
         void append(const T& arg)
         {
-            *this += *string::format("{0}", arg);
+            if constexpr (std::is_same<T, string>::value)
+            {
+                if (arg != nullptr) append(arg->view());
+            }
+            else if constexpr (std::is_same<T, char>::value)
+            {
+                append(std::string_view(&arg, 1));
+            }
+            else if constexpr (std::is_convertible<const T&, std::string_view>::value && !std::is_pointer<T>::value)
+            {
+                append(std::string_view(arg));
+            }
+            else if constexpr (std::is_same<std::decay_t<T>, const char*>::value || std::is_same<std::decay_t<T>, char*>::value)
+            {
+                if (arg != nullptr) append(std::string_view(arg));
+            }
+            else if constexpr (std::is_integral<T>::value && !std::is_same<T, bool>::value)
+            {
+                // Integers are written without the overhead of type erased format arguments
+                char digits[24];
+                std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), arg);
+                append(std::string_view(digits, result.ptr - digits));
+            }
+            else
+            {
+                detail::string_builder_buffer out(*this);
+                detail::format_value(out, fmt::string_view(), fmt::make_format_args(format_forward<T>::convert(arg)));
+                out.commit();
+            }
+        }
+
+        /// Appends the characters to this instance.
+        void append(std::string_view value)
+        {
+            if (value.size() <= free_size())
+            {
+                if (!value.empty()) std::memcpy(cursor_, value.data(), value.size());
+                commit(value.size());
+            }
+            else
+            {
+                append_chunked(value);
+            }
+        }
+
+        /// Appends the characters of the concatenation expression, which are copied
+        /// into the free space without creating the concatenated string.
+        template <class L, class R>
+        void append(const string_concat<L, R>&& value)
+        {
+            size_t size = detail::concat_size(&value);
+            if (size == 0) return;
+            if (size > free_size()) add_chunk(size);
+            detail::concat_write(&value, free_begin());
+            commit(size);
         }
 
-        /// Appends a copy of a specified string and the default
-        /// line terminator, to the end of this instance.
+        /// Concatenation expression stored in a variable refers to destroyed operands.
+        template <class L, class R>
+        void append(const string_concat<L, R>& value) = delete;
+
+        /// Appends the string representation of each argument, as append(...)
+        /// does, followed by the default line terminator to the end of this instance.
+        ///
+        /// The counterpart of this method in C# takes a single argument.
         template <typename ...Args>
-        void append_line(const Args& ...args)
+        void append_line(Args&& ...args)
         {
-            append(args...);
+            (append(std::forward<Args>(args)), ...);
             append_line();
         }
 
         /// Appends the default line terminator, to the end of this instance.
         void append_line()
         {
-            *this += *environment::make_line;
+            append(environment::make_line);
         }
 
         /// Removes all characters from the current string_builder instance.
-        void clear()
+        ///
+        /// The capacity of the last chunk is kept for further appends.
+        void clear();
+
+    public: // OPERATORS
+
+        /// Writes the characters to the stream.
+        friend DOT_CLASS std::ostream& operator<<(std::ostream& stream, const string_builder_impl& value);
+
+    private: // METHODS
+
+        /// Pointer to the free space of the last chunk.
+        char* free_begin() { return cursor_; }
+
+        /// Size of the free space of the last chunk.
+        size_t free_size() const { return static_cast<size_t>(limit_ - cursor_); }
+
+        /// Add the specified number of characters written to the free space
+        /// of the last chunk to its size. Does nothing for zero size, which
+        /// may be committed before the first chunk is added.
+        void commit(size_t size)
         {
-            this->clear();
+            if (size == 0) return;
+            cursor_ += size;
+            chunks_.back().size_ += size;
+            length_ += size;
         }
+
+        /// Fill the free space of the last chunk and add a chunk for the rest.
+        void append_chunked(std::string_view value);
+
+        /// Set the free space to the unused part of the last chunk.
+        void reset_free_space();
+
+        /// Add a chunk with at least the specified capacity, or replace
+        /// the last chunk if it is empty, and copy size characters from
+        /// source to its beginning without adding them to its size.
+        void add_chunk(size_t capacity, const char* source = nullptr, size_t size = 0);
     };
 
     /// Initializes an empty instance of the string_builder class.
     inline string_builder make_string_builder() { return new string_builder_impl(); }
+
+    /// Initializes an empty instance of the string_builder class using the specified capacity.
+    inline string_builder make_string_builder(int capacity)
+    {
+        string_builder result = new string_builder_impl();
+        result->ensure_capacity(capacity);
+        return result;
+    }
 }
@@ -25,6 +25,9 @@ limitations under the License.
 
 #include <dot/declare.hpp>
 #include <dot/system/string.hpp>
+#include <dot/system/int.hpp>
+#include <dot/system/long.hpp>
+#include <dot/system/double.hpp>
 
 namespace dot
 {
@@ -103,4 +106,38 @@ namespace dot
         // };
         return to_string_impl<T>::to_string(value);
     }
+
+    /// Convert int to string without boxing, in the format of int.ToString().
+    template <>
+    struct to_string_impl<int>
+    {
+        static string to_string(const int& value)
+        {
+            char buffer[int_impl::max_chars];
+            return make_string(std::string_view(buffer, int_impl::to_chars(buffer, value) - buffer));
+        }
+    };
+
+    /// Convert long to string without boxing, in the format of long.ToString().
+    template <>
+    struct to_string_impl<int64_t>
+    {
+        static string to_string(const int64_t& value)
+        {
+            char buffer[long_impl::max_chars];
+            return make_string(std::string_view(buffer, long_impl::to_chars(buffer, value) - buffer));
+        }
+    };
+
+    /// Convert double to string without boxing, in the shortest round-trip
+    /// format of double.ToString().
+    template <>
+    struct to_string_impl<double>
+    {
+        static string to_string(const double& value)
+        {
+            char buffer[double_impl::max_chars];
+            return make_string(std::string_view(buffer, double_impl::to_chars(buffer, value) - buffer));
+        }
+    };
 }
\ No newline at end of file
@@ -29,29 +29,134 @@ limitations under the License.
 #include <dot/system/reflection/constructor_info.hpp>
 #include <dot/system/collections/generic/list.hpp>
 #include <dot/system/string.hpp>
+#include <mutex>
 
 namespace dot
 {
-    type type_builder_impl::build()
+    namespace
     {
-        type_->fill(this);
+        /// Pre-order numbering of the registered types, immutable once published.
+        ///
+        /// The descendants of a type are numbered immediately after it, so type
+        /// with number n derives from the type with number m if and only if
+        /// m < n <= last_[m], where last_[m] is the largest number in the
+        /// subtree of m.
+        struct type_numbering
+        {
+            /// Pre-order number by type id.
+            std::vector<int> number_;
+
+            /// Largest pre-order number in the subtree by type id.
+            std::vector<int> last_;
+
+            /// Types in pre-order.
+            std::vector<type_impl*> order_;
+        };
 
-        // Fill derived types map
-        type base_type = base_;
-        while (base_type != nullptr)
+        /// Registry of types and their base types, renumbered when a type is built.
+        class type_hierarchy
         {
-            auto iter = type_impl::get_derived_types_map().find(base_type->full_name());
-            if (iter == type_impl::get_derived_types_map().end())
+        private: // FIELDS
+
+            std::mutex mutex_;
+            std::vector<type_impl*> types_;
+            std::vector<int> base_ids_;
+            std::atomic<bool> dirty_{ false };
+            std::atomic<type_numbering*> numbering_{ nullptr };
+
+            /// Numbering replaced by a newer one, kept because readers may still use it.
+            std::vector<std::unique_ptr<type_numbering>> retired_;
+
+        public: // METHODS
+
+            /// Returns the id of the new type, its base is set later by set_base.
+            int add(type_impl* t)
             {
-                iter = type_impl::get_derived_types_map().insert({base_type->full_name(), make_list<type>()}).first;
+                std::lock_guard<std::mutex> lock(mutex_);
+                types_.push_back(t);
+                base_ids_.push_back(-1);
+                dirty_.store(true, std::memory_order_release);
+                return static_cast<int>(types_.size()) - 1;
             }
-            else if (iter->second == nullptr)
+
+            /// Records the base of the type once it is built.
+            void set_base(int type_id, int base_id)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                base_ids_[type_id] = base_id;
+                dirty_.store(true, std::memory_order_release);
+            }
+
+            /// Returns the current numbering, renumbering first if types were added.
+            const type_numbering& numbering()
+            {
+                if (dirty_.load(std::memory_order_acquire)) renumber();
+                return *numbering_.load(std::memory_order_acquire);
+            }
+
+        private: // METHODS
+
+            /// Assigns pre-order numbers using depth first traversal from the root types.
+            void renumber()
             {
-                iter->second = make_list<type>();
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!dirty_.load(std::memory_order_relaxed)) return;
+
+                int count = static_cast<int>(types_.size());
+                std::vector<std::vector<int>> children(count);
+                std::vector<int> stack;
+                for (int i = count - 1; i >= 0; --i)
+                {
+                    if (base_ids_[i] >= 0) children[base_ids_[i]].push_back(i);
+                    else stack.push_back(i);
+                }
+
+                std::unique_ptr<type_numbering> result(new type_numbering);
+                result->number_.assign(count, 0);
+                result->last_.assign(count, 0);
+                result->order_.reserve(count);
+                std::vector<int> order_ids;
+                order_ids.reserve(count);
+
+                // Ids are pushed in reverse so that siblings are numbered in the order they were registered
+                while (!stack.empty())
+                {
+                    int id = stack.back();
+                    stack.pop_back();
+                    result->number_[id] = static_cast<int>(result->order_.size());
+                    result->order_.push_back(types_[id]);
+                    order_ids.push_back(id);
+                    for (auto child = children[id].rbegin(); child != children[id].rend(); ++child) stack.push_back(*child);
+                }
+
+                // In reverse pre-order each type is visited after all of its derived types
+                for (int number = count - 1; number >= 0; --number)
+                {
+                    int id = order_ids[number];
+                    result->last_[id] = std::max(result->last_[id], number);
+                    if (base_ids_[id] >= 0) result->last_[base_ids_[id]] = std::max(result->last_[base_ids_[id]], result->last_[id]);
+                }
+
+                type_numbering* previous = numbering_.exchange(result.release(), std::memory_order_acq_rel);
+                if (previous) retired_.emplace_back(previous);
+                dirty_.store(false, std::memory_order_release);
             }
-            iter->second->add(type_);
-            base_type = base_type->get_base_type();
+        };
+
+        /// Registry of all types, never destroyed so that it outlives static type objects.
+        type_hierarchy& get_type_hierarchy()
+        {
+            static type_hierarchy* hierarchy = new type_hierarchy;
+            return *hierarchy;
         }
+    }
+
+    type type_builder_impl::build()
+    {
+        type_->fill(this);
+
+        // Register base type for the numbering of the hierarchy
+        if (base_ != nullptr) get_type_hierarchy().set_base(type_->type_id_, base_->type_id_);
 
         return type_;
     }
@@ -65,15 +170,15 @@ namespace dot
                 data->methods_ = make_list<method_info>();
             }
 
-            list<method_info> base_methods = data->base_->get_methods();
+            const list<method_info>& base_methods = data->base_->get_methods();
             list<method_info> make_methods = make_list<method_info>();
-            for (method_info meth_info_data : base_methods)
+            for (const method_info& meth_info_data : base_methods)
             {
 
                 make_methods->add(meth_info_data);
             }
 
-            for (method_info meth_info_data : data->methods_)
+            for (const method_info& meth_info_data : data->methods_)
             {
                 make_methods->add(meth_info_data);
             }
@@ -85,7 +190,7 @@ namespace dot
         {
             this->methods_ = make_list<method_info>(data->methods_->count());
             int i = 0;
-            for (method_info meth_info_data : data->methods_)
+            for (const method_info& meth_info_data : data->methods_)
             {
                 this->methods_[i++] = meth_info_data;
             }
@@ -99,7 +204,7 @@ namespace dot
         {
             this->ctors_ = make_list<constructor_info>(data->ctors_->count());
             int i = 0;
-            for (constructor_info ctor_info_data : data->ctors_)
+            for (const constructor_info& ctor_info_data : data->ctors_)
             {
                 this->ctors_[i++] = ctor_info_data;
             }
@@ -116,15 +221,15 @@ namespace dot
                 data->fields_ = make_list<field_info>();
             }
 
-            list<field_info> base_fields = data->base_->get_fields();
+            const list<field_info>& base_fields = data->base_->get_fields();
             list<field_info> make_fields = make_list<field_info>();
-            for (field_info field_info_data : base_fields)
+            for (const field_info& field_info_data : base_fields)
             {
 
                 make_fields->add(field_info_data);
             }
 
-            for (field_info field_info_data : data->fields_)
+            for (const field_info& field_info_data : data->fields_)
             {
                 make_fields->add(field_info_data);
             }
@@ -136,7 +241,7 @@ namespace dot
         {
             this->fields_ = make_list<field_info>(data->fields_->count());
             int i = 0;
-            for (field_info ctor_info_data : data->fields_)
+            for (const field_info& ctor_info_data : data->fields_)
             {
                 this->fields_[i++] = ctor_info_data;
             }
@@ -150,7 +255,7 @@ namespace dot
         {
             this->interfaces_ = make_list<type>(data->interfaces_->count());
             int i = 0;
-            for (type interface : data->interfaces_)
+            for (const type& interface : data->interfaces_)
             {
                 this->interfaces_[i++] = interface;
             }
@@ -164,7 +269,7 @@ namespace dot
         {
             this->generic_args_ = make_list<type>(data->generic_args_->count());
             int i = 0;
-            for (type arg : data->generic_args_)
+            for (const type& arg : data->generic_args_)
             {
                 this->generic_args_[i++] = arg;
             }
@@ -181,13 +286,15 @@ namespace dot
 
     type_impl::type_impl(string nspace, string name)
     {
-        this->name_space = nspace;
-        this->name = name;
+        this->name_space = string::intern(nspace);
+        this->name = string::intern(name);
+        this->full_name_ = string::intern(nspace + "." + name);
+        this->type_id_ = get_type_hierarchy().add(this);
     }
 
 
     type_builder_impl::type_builder_impl(string name_space, string name, string cpp_name)
-        : full_name_(name_space + "." + name)
+        : full_name_(string::intern(name_space + "." + name))
     {
         type_ = new type_impl(name_space, name);
         type_impl::get_type_map()[full_name_] = type_;
@@ -195,11 +302,11 @@ namespace dot
         type_impl::get_type_map()[cpp_name] = type_;
     }
 
-    method_info type_impl::get_method(string name)
+    method_info type_impl::get_method(const string& name)
     {
         if (methods_.is_empty()) return nullptr;
 
-        for (auto method : methods_)
+        for (const method_info& method : methods_)
         {
             if (method->name == name)
                 return method;
@@ -208,11 +315,11 @@ namespace dot
         return nullptr;
     }
 
-    type type_impl::get_interface(string name)
+    type type_impl::get_interface(const string& name)
     {
         if (interfaces_.is_empty()) return nullptr;
 
-        for (auto interface : interfaces_)
+        for (const type& interface : interfaces_)
         {
             if (interface->name == name)
                 return interface;
@@ -221,11 +328,11 @@ namespace dot
         return nullptr;
     }
 
-    field_info type_impl::get_field(string name)
+    field_info type_impl::get_field(const string& name)
     {
         if (fields_.is_empty()) return nullptr;
 
-        for (auto field : fields_)
+        for (const field_info& field : fields_)
         {
             if (field->name == name)
                 return field;
@@ -235,6 +342,32 @@ namespace dot
 
     }
 
+    bool type_impl::is_subclass_of(type c)
+    {
+        const type_numbering& numbering = get_type_hierarchy().numbering();
+        int number = numbering.number_[type_id_];
+        return numbering.number_[c->type_id_] < number && number <= numbering.last_[c->type_id_];
+    }
+
+    list<type> type_impl::get_derived_types(string name)
+    {
+        auto iter = get_type_map().find(name);
+        if (iter == get_type_map().end()) return nullptr;
+        return get_derived_types(iter->second);
+    }
+
+    list<type> type_impl::get_derived_types(type t)
+    {
+        const type_numbering& numbering = get_type_hierarchy().numbering();
+        int first = numbering.number_[t->type_id_] + 1;
+        int last = numbering.last_[t->type_id_];
+        if (first > last) return nullptr;
+
+        list<type> result = make_list<type>(last - first + 1);
+        for (int i = first; i <= last; ++i) result[i - first] = numbering.order_[i];
+        return result;
+    }
+
     bool type_impl::equals(object obj)
     {
         if (obj.is<type>())
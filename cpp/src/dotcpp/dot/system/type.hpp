@@ -73,6 +73,9 @@ namespace dot
     public: // METHODS
 
         /// Add public field of the current Type.
+        ///
+        /// Error if a field with the same name or member pointer has already been added,
+        /// because cycle_collector would count the references it holds twice.
         template <class class_t, class fld>
         type_builder with_field(string name, fld class_t::*prop)
         {
@@ -80,7 +83,13 @@ namespace dot
             {
                 fields_ = make_list<field_info>();
             }
-            fields_->add(make_field_info<fld, class_t>(name, type_, dot::typeof<fld>(), prop));
+            for (field_info& field : fields_)
+            {
+                ptr<field_info_impl<fld, class_t>> same_type = field.as<ptr<field_info_impl<fld, class_t>>>();
+                if (field->name == name || (same_type != nullptr && same_type->field_ == prop))
+                    throw exception("Field " + name + " is added more than once to type " + full_name_);
+            }
+            fields_->add(make_field_info<fld, class_t>(string::intern(name), type_, dot::typeof<fld>(), prop));
             return this;
         }
 
@@ -105,7 +114,7 @@ namespace dot
                 parameters[i] = make_parameter_info(names[i], param_types[i], i);
             }
 
-            method_info method_info = new member_method_info_impl<class_t, return_t, args...>(name, type_, dot::typeof<return_t>(), mth);
+            method_info method_info = new member_method_info_impl<class_t, return_t, args...>(string::intern(name), type_, dot::typeof<return_t>(), mth);
             method_info->parameters = parameters;
 
             methods_->add(method_info);
@@ -134,7 +143,7 @@ namespace dot
                 parameters[i] = make_parameter_info(names[i], param_types[i], i);
             }
 
-            method_info method_info = new static_method_info_impl<return_t, args...>(name, type_, dot::typeof<return_t>(), mth);
+            method_info method_info = new static_method_info_impl<return_t, args...>(string::intern(name), type_, dot::typeof<return_t>(), mth);
             method_info->parameters = parameters;
 
             methods_->add(method_info);
@@ -267,6 +276,8 @@ namespace dot
         list<type> generic_args_;
         type base_;
         list<field_info> fields_;
+        int type_id_;
+        string full_name_;
 
     public: // PROPERTIES
 
@@ -277,10 +288,12 @@ namespace dot
         string name_space; // TODO - replace by method
 
         /// Gets the fully qualified name of the type, including its namespace but not its assembly.
-        string full_name() const { return string::format("{0}.{1}", this->name_space, this->name); } // TODO - replace by string::Join
+        ///
+        /// The name is interned when the type is created.
+        string full_name() const { return full_name_; }
 
         /// Gets the base type if current type.
-        type get_base_type() { return base_; }
+        const type& get_base_type() { return base_; }
 
         /// Gets a value indicating whether the System.type_t is a class or a delegate; that is, not a value type or interface.
         bool is_class; // TODO - replace by method
@@ -291,28 +304,35 @@ namespace dot
     public: // METHODS
 
         /// Returns methods of the current type.
-        list<method_info> get_methods() { return methods_; }
+        const list<method_info>& get_methods() { return methods_; }
 
         /// Returns constructors of the current type.
-        list<constructor_info> get_constructors() { return ctors_; }
+        const list<constructor_info>& get_constructors() { return ctors_; }
 
         /// Returns fields of the current type.
-        list<field_info> get_fields() { return fields_; }
+        const list<field_info>& get_fields() { return fields_; }
 
         /// Returns interfaces of the current type.
-        list<type> get_interfaces() { return interfaces_; }
+        const list<type>& get_interfaces() { return interfaces_; }
 
         /// Returns interfaces of the current type.
-        list<type> get_generic_arguments() { return generic_args_; }
+        const list<type>& get_generic_arguments() { return generic_args_; }
 
         /// Searches for the public method with the specified name.
-        method_info get_method(string name);
+        method_info get_method(const string& name);
 
         /// Searches for the interface with the specified name.
-        type get_interface(string name);
+        type get_interface(const string& name);
 
         /// Searches for the field with the specified name.
-        field_info get_field(string name);
+        field_info get_field(const string& name);
+
+        /// Determines whether the current type derives from the specified type.
+        ///
+        /// The check takes constant time, it compares the positions of the two
+        /// types in the pre-order numbering of the hierarchy registered using
+        /// type_builder_impl::with_base.
+        bool is_subclass_of(type c);
 
         /// A string representing the name of the current type.
         virtual string to_string() override { return full_name(); }
@@ -320,11 +340,15 @@ namespace dot
         /// Get type_t object for the name.
         static type get_type_of(string name) { return get_type_map()[name]; }
 
-        /// Get derived types list for the name.
-        static list<type> get_derived_types(string name) { return get_derived_types_map()[name]; }
+        /// Get derived types list for the name, null if the type is not registered
+        /// or has no derived types.
+        static list<type> get_derived_types(string name);
 
-        /// Get derived types list for the type.
-        static list<type> get_derived_types(type t) { return get_derived_types_map()[t->full_name()]; }
+        /// Get derived types list for the type, null if it has no derived types.
+        ///
+        /// The derived types occupy a contiguous range of the pre-order
+        /// numbering of the hierarchy, so no search is required.
+        static list<type> get_derived_types(type t);
 
         bool equals(object obj) override;
 
@@ -341,12 +365,6 @@ namespace dot
             return map_;
         }
 
-        static std::map<string, list<type>>& get_derived_types_map()
-        {
-            static std::map<string, list<type>> map_;
-            return map_;
-        }
-
     private: // CONSTRUCTORS
 
         /// Create from builder.